@@ -251,6 +251,35 @@ _rampack_trajectory() {
 	fi
 }
 
+_rampack_estimate() {
+	_split_longopt
+
+	case "$prev" in
+		-h | --help)
+			# there should be no options together with --help, so cancel completion
+			COMPREPLY=()
+			return
+			;;
+		-i | --input)
+			_filedir
+			return
+			;;
+		-V | --verbosity)
+			_rampack_verbosity
+			return
+			;;
+		-c | --cycles)
+			COMPREPLY=()
+			return
+			;;
+	esac
+
+	if [[ "$cur" == -* ]] || [[ "$cur" == "" ]]; then
+		COMPREPLY=($(compgen -W '$( _rampack_parse_help estimate )' -- ${cur}))
+		[[ $COMPREPLY == *= ]] && compopt -o nospace
+	fi
+}
+
 _rampack() {
 	local cur prev words cword
 	_get_comp_words_by_ref -n "=" cur prev words cword
@@ -273,12 +302,15 @@ _rampack() {
 			trajectory)
 				_rampack_trajectory
 				;;
+			estimate)
+				_rampack_estimate
+				;;
 		esac
 
 		return
 	fi
 
-	COMPREPLY=($(compgen -W "casino preview shape-preview trajectory -h --help help -v --version version" -- "$cur"))
+	COMPREPLY=($(compgen -W "casino preview shape-preview trajectory estimate -h --help help -v --version version" -- "$cur"))
 }
 
 
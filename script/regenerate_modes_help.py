@@ -119,7 +119,7 @@ def main():
 
     rampack_exec = sys.argv[1]
     doc_path = sys.argv[2]
-    modes = ['casino', 'preview', 'shape-preview', 'trajectory']
+    modes = ['casino', 'preview', 'shape-preview', 'trajectory', 'estimate']
     help_entries = []
 
     for mode in modes:
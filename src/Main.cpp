@@ -12,8 +12,10 @@
 #include "frontend/modes/PreviewMode.h"
 #include "frontend/modes/ShapePreviewMode.h"
 #include "frontend/modes/TrajectoryMode.h"
+#include "frontend/modes/EstimateMode.h"
 #include "utils/Logger.h"
 #include "utils/Utils.h"
+#include "utils/CpuDispatch.h"
 
 
 namespace {
@@ -50,6 +52,14 @@ namespace {
         std::abort();
     }
 
+#if defined(RAMPACK_GCC) || defined(RAMPACK_CLANG)
+    // Runs before static initializers and main, since the whole program may contain instructions which this CPU does
+    // not support (for example when compiled with -march=native on a different machine)
+    __attribute__((constructor(101))) RAMPACK_BASELINE_TARGET void check_cpu_before_initialization() {
+        ensure_compiled_instruction_set_supported();
+    }
+#endif
+
     int handle_commands(const std::string &cmd, const std::string &mode, int argc, char **argv) {
         if (mode == "-h" || mode == "--help" || mode == "help")
             return HelpMode(logger, cmd).main(argc, argv);
@@ -63,6 +73,8 @@ namespace {
             return ShapePreviewMode(logger).main(argc, argv);
         else if (mode == "trajectory")
             return TrajectoryMode(logger).main(argc, argv);
+        else if (mode == "estimate")
+            return EstimateMode(logger).main(argc, argv);
         logger.error() << "Unknown mode " << mode << ". See " << cmd << " --help" << std::endl;
         return EXIT_FAILURE;
     }
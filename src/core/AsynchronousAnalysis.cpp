@@ -0,0 +1,48 @@
+#include <chrono>
+
+#include "AsynchronousAnalysis.h"
+
+
+AsynchronousAnalysis::~AsynchronousAnalysis() {
+    if (this->pendingAnalysis.valid())
+        this->pendingAnalysis.wait();
+}
+
+void AsynchronousAnalysis::run(const Packing &packing, Analysis analysis) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    this->waitForPendingAnalysis();
+    if (this->snapshot == nullptr)
+        this->snapshot = packing.createSnapshot();
+    else
+        packing.takeSnapshot(*this->snapshot);
+
+    this->pendingAnalysis = std::async(std::launch::async, [analysis = std::move(analysis), this]() {
+        analysis(*this->snapshot);
+    });
+    this->numAnalyses++;
+
+    auto end = std::chrono::high_resolution_clock::now();
+    this->waitingMicroseconds += std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+void AsynchronousAnalysis::wait() {
+    auto start = std::chrono::high_resolution_clock::now();
+    this->waitForPendingAnalysis();
+    auto end = std::chrono::high_resolution_clock::now();
+    this->waitingMicroseconds += std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+void AsynchronousAnalysis::waitForPendingAnalysis() {
+    if (!this->pendingAnalysis.valid())
+        return;
+
+    // get() invalidates the future, so even if it throws, the analysis will not be waited for again
+    this->pendingAnalysis.get();
+}
+
+bool AsynchronousAnalysis::isRunning() const {
+    if (!this->pendingAnalysis.valid())
+        return false;
+    return this->pendingAnalysis.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+}
@@ -0,0 +1,73 @@
+#ifndef RAMPACK_ASYNCHRONOUSANALYSIS_H
+#define RAMPACK_ASYNCHRONOUSANALYSIS_H
+
+#include <memory>
+#include <future>
+#include <functional>
+
+#include "Packing.h"
+
+
+/**
+ * @brief Runs an analysis of the packing (calculation of observables, recording of trajectory, etc.) in a separate
+ * thread on its frozen snapshot, so that the simulation can be continued in the meantime.
+ * @details Only a single analysis is run at a time - starting the next one waits until the previous one is finished.
+ * The snapshot (see Packing::takeSnapshot) is reused by all analyses, so the memory overhead is bounded by a single
+ * copy of the packing.
+ */
+class AsynchronousAnalysis {
+public:
+    /**
+     * @brief The analysis performed on the snapshot.
+     */
+    using Analysis = std::function<void(const Packing &snapshot)>;
+
+private:
+    std::unique_ptr<Packing> snapshot;
+    std::future<void> pendingAnalysis;
+    std::size_t numAnalyses{};
+    double waitingMicroseconds{};
+
+    void waitForPendingAnalysis();
+
+public:
+    AsynchronousAnalysis() = default;
+    AsynchronousAnalysis(const AsynchronousAnalysis &) = delete;
+    AsynchronousAnalysis &operator=(const AsynchronousAnalysis &) = delete;
+
+    /**
+     * @brief Waits for the pending analysis, but without rethrowing its exceptions.
+     */
+    ~AsynchronousAnalysis();
+
+    /**
+     * @brief Takes a snapshot of @a packing and starts @a analysis on it in a separate thread.
+     * @details If the previous analysis is still running, it waits for it first. If the previous analysis has thrown
+     * an exception, it is rethrown.
+     */
+    void run(const Packing &packing, Analysis analysis);
+
+    /**
+     * @brief Waits for the pending analysis (if any) and rethrows its exception if it has thrown one.
+     */
+    void wait();
+
+    /**
+     * @brief Returns @a true if the analysis started by the last run() has not finished yet.
+     */
+    [[nodiscard]] bool isRunning() const;
+
+    /**
+     * @brief Returns the number of analyses started.
+     */
+    [[nodiscard]] std::size_t getNumAnalyses() const { return this->numAnalyses; }
+
+    /**
+     * @brief Returns the time the calling thread has spent waiting for pending analyses and taking snapshots, in
+     * microseconds.
+     */
+    [[nodiscard]] double getWaitingMicroseconds() const { return this->waitingMicroseconds; }
+};
+
+
+#endif //RAMPACK_ASYNCHRONOUSANALYSIS_H
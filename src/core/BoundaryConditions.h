@@ -6,6 +6,7 @@
 #define RAMPACK_BOUNDARYCONDITIONS_H
 
 #include <array>
+#include <memory>
 
 #include "geometry/Vector.h"
 
@@ -39,6 +40,11 @@ public:
      * @brief Returns the closest distance squared between @a position1 and @a position2 according to BC
      */
     [[nodiscard]] virtual double getDistance2(const Vector<3> &position1, const Vector<3> &position2) const = 0;
+
+    /**
+     * @brief Creates a copy of the boundary conditions (including the box they apply to).
+     */
+    [[nodiscard]] virtual std::unique_ptr<BoundaryConditions> clone() const = 0;
 };
 
 #endif //RAMPACK_BOUNDARYCONDITIONS_H
@@ -41,6 +41,12 @@ public:
      * @brief Returns a (short) name of this observable for filenames and reporting.
      */
     [[nodiscard]] virtual std::string getSignatureName() const = 0;
+
+    /**
+     * @brief Returns @a true if the observable relies on snapshots being captured in equal intervals (for example
+     * time correlation functions). In such a case, adaptive sampling in ObservablesCollector is disabled.
+     */
+    [[nodiscard]] virtual bool requiresEquallySpacedSnapshots() const { return false; }
 };
 
 
@@ -33,6 +33,60 @@ DomainDecomposition::DomainDecomposition(const Packing &packing, const Interacti
     this->populateDomains(packing, origin);
 }
 
+double DomainDecomposition::calculateGhostLayerWidth(double range, double totalRange, double ngCellSize) {
+    // Ghost layer is the total interaction range plus the excess size of the neighbour grid cell
+    return totalRange - range + ngCellSize;
+}
+
+bool DomainDecomposition::isAxisDivisible(double boxHeight, std::size_t domainDivisions,
+                                          std::size_t neighbourGridDivisions, double range, double totalRange)
+{
+    if (domainDivisions < 2)
+        return true;
+
+    // The box is thinner than the interaction range in this direction (NG has a single cell with many periodic
+    // images), so it cannot be divided into domains
+    double ngCellSize = boxHeight / neighbourGridDivisions;
+    if (ngCellSize < range)
+        return false;
+
+    // Active region has to be at least as large as NG cell, otherwise not particles will be perturbed
+    double wholeDomainWidthRel = 1. / domainDivisions;
+    double ghostLayerWidthRel = DomainDecomposition::calculateGhostLayerWidth(range, totalRange, ngCellSize)
+                                / boxHeight;
+    double ngCellSizeRel = 1. / neighbourGridDivisions;
+    return wholeDomainWidthRel - ghostLayerWidthRel > ngCellSizeRel;
+}
+
+std::optional<double>
+DomainDecomposition::calculateActiveVolumeFraction(const TriclinicBox &box, const Interaction &interaction,
+                                                   const std::array<std::size_t, 3> &domainDivisions,
+                                                   const std::array<std::size_t, 3> &neighbourGridDivisions)
+{
+    double range = interaction.getRangeRadius();
+    double totalRange = interaction.getTotalRangeRadius();
+    auto boxHeights = box.getHeights();
+
+    double fraction = 1;
+    for (std::size_t coord{}; coord < 3; coord++) {
+        Expects(domainDivisions[coord] > 0);
+        Expects(neighbourGridDivisions[coord] > 0);
+
+        if (!DomainDecomposition::isAxisDivisible(boxHeights[coord], domainDivisions[coord],
+                                                  neighbourGridDivisions[coord], range, totalRange))
+        {
+            return std::nullopt;
+        }
+        if (domainDivisions[coord] < 2)
+            continue;
+
+        double ngCellSize = boxHeights[coord] / neighbourGridDivisions[coord];
+        double ghostLayerWidth = DomainDecomposition::calculateGhostLayerWidth(range, totalRange, ngCellSize);
+        fraction *= 1 - domainDivisions[coord] * ghostLayerWidth / boxHeights[coord];
+    }
+    return fraction;
+}
+
 void DomainDecomposition::prepareDomains(const std::array<std::size_t, 3> &neighbourGridDivisions, double range,
                                          double totalRange, const Vector<3> &origin)
 {
@@ -48,14 +102,13 @@ void DomainDecomposition::prepareDomains(const std::array<std::size_t, 3> &neigh
             continue;
 
         double ngCellSize = boxHeights[coord] / neighbourGridDivisions[coord];
-        Expects(ngCellSize >= range);
         double wholeDomainWidthRel = 1. / this->domainDivisions[coord];
-        // Ghost layer is the total interaction range plus the excess size of the neighbour grid cell
-        double ghostLayerWidthRel = (totalRange - range + ngCellSize) / boxHeights[coord];
+        double ghostLayerWidthRel = DomainDecomposition::calculateGhostLayerWidth(range, totalRange, ngCellSize)
+                                    / boxHeights[coord];
 
-        // Active region has to be at least as large as NG cell, otherwise not particles will be perturbed
-        double ngCellSizeRel = 1. / neighbourGridDivisions[coord];
-        if (wholeDomainWidthRel - ghostLayerWidthRel <= ngCellSizeRel) {
+        if (!DomainDecomposition::isAxisDivisible(boxHeights[coord], this->domainDivisions[coord],
+                                                  neighbourGridDivisions[coord], range, totalRange))
+        {
             throw TooNarrowDomainException(coord, wholeDomainWidthRel * boxHeights[coord],
                                            ghostLayerWidthRel * boxHeights[coord], ngCellSize);
         }
@@ -5,6 +5,7 @@
 #ifndef RAMPACK_DOMAINDECOMPOSITION_H
 #define RAMPACK_DOMAINDECOMPOSITION_H
 
+#include <optional>
 #include <vector>
 
 #include "Packing.h"
@@ -55,6 +56,10 @@ private:
     std::array<std::vector<RegionBounds>, 3> regionBounds;
     std::vector<std::vector<std::size_t>> particlesInRegions;
 
+    [[nodiscard]] static double calculateGhostLayerWidth(double range, double totalRange, double ngCellSize);
+    [[nodiscard]] static bool isAxisDivisible(double boxHeight, std::size_t domainDivisions,
+                                              std::size_t neighbourGridDivisions, double range, double totalRange);
+
     void prepareDomains(const std::array<std::size_t, 3> &neighbourGridDivisions, double range, double totalRange,
                         const Vector<3> &origin);
     void populateDomains(const Packing &packing, const Vector<3> &origin);
@@ -85,6 +90,16 @@ public:
         return this->particlesInRegions[this->coordToIdx(coord)];
     }
 
+    /**
+     * @brief Returns the fraction of the volume of @a box lying in active regions for given @a domainDivisions or
+     * @a std::nullopt if the domains would be too narrow (so that the constructor would throw
+     * TooNarrowDomainException).
+     */
+    [[nodiscard]] static std::optional<double>
+    calculateActiveVolumeFraction(const TriclinicBox &box, const Interaction &interaction,
+                                  const std::array<std::size_t, 3> &domainDivisions,
+                                  const std::array<std::size_t, 3> &neighbourGridDivisions);
+
     /**
      * @brief Checks is @a vector lies within a domain with integer coordinates @a coords
      */
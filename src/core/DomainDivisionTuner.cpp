@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <utility>
+
+#include "DomainDivisionTuner.h"
+#include "DomainDecomposition.h"
+#include "utils/Exceptions.h"
+
+
+DomainDivisionTuner::DomainDivisionTuner(std::size_t tuningEvery, std::size_t benchmarkCycles,
+                                         std::size_t maxCandidates)
+        : tuningEvery{tuningEvery}, benchmarkCycles{benchmarkCycles}, maxCandidates{maxCandidates}
+{
+    Expects(tuningEvery > 0);
+    Expects(benchmarkCycles > 0);
+    Expects(maxCandidates > 0);
+}
+
+std::vector<DomainDivisionTuner::Divisions>
+DomainDivisionTuner::generateCandidates(const Packing &packing, const Interaction &interaction,
+                                        const Divisions &currentDivisions, std::size_t maxDomains,
+                                        std::size_t maxCandidates)
+{
+    Expects(maxDomains > 0);
+    Expects(maxCandidates > 0);
+
+    if (!packing.isNeighbourGridUsed())
+        return {{1, 1, 1}};
+
+    const auto &box = packing.getBox();
+    auto ngDivisions = packing.getNeighbourGridCellDivisions();
+    std::vector<std::pair<double, Divisions>> scoredDivisions;
+    bool isCurrentValid = false;
+    for (std::size_t i = 1; i <= maxDomains; i++) {
+        for (std::size_t j = 1; i*j <= maxDomains; j++) {
+            for (std::size_t k = 1; i*j*k <= maxDomains; k++) {
+                Divisions divisions{i, j, k};
+                auto activeFraction = DomainDecomposition::calculateActiveVolumeFraction(box, interaction, divisions,
+                                                                                         ngDivisions);
+                if (!activeFraction.has_value())
+                    continue;
+
+                if (divisions == currentDivisions)
+                    isCurrentValid = true;
+                else
+                    scoredDivisions.emplace_back(static_cast<double>(i*j*k) * (*activeFraction), divisions);
+            }
+        }
+    }
+
+    // Stable sort keeps the ties in the lexicographic order, so the candidates are reproducible
+    std::stable_sort(scoredDivisions.begin(), scoredDivisions.end(), [](const auto &sd1, const auto &sd2) {
+        return sd1.first > sd2.first;
+    });
+
+    std::vector<Divisions> candidates;
+    if (isCurrentValid)
+        candidates.push_back(currentDivisions);
+    for (const auto &[score, divisions] : scoredDivisions) {
+        if (candidates.size() >= maxCandidates)
+            break;
+        candidates.push_back(divisions);
+    }
+    return candidates;
+}
+
+std::optional<DomainDivisionTuner::Divisions>
+DomainDivisionTuner::startCycle(const Packing &packing, const Interaction &interaction,
+                                const Divisions &currentDivisions)
+{
+    // Cycles are counted also during the benchmark, so that the benchmarks are started every tuningEvery cycles
+    bool isTuningDue = (this->cyclesUntilTuning == 0);
+    if (!isTuningDue)
+        this->cyclesUntilTuning--;
+
+    if (this->isBenchmarking()) {
+        // Candidate is set only in the first cycle of its measurement - if it becomes invalid in the meantime,
+        // Simulation reduces it instead of failing on it repeatedly
+        if (this->benchmarkedCycles > 0)
+            return std::nullopt;
+        return this->candidates[this->candidateSpeeds.size()];
+    }
+
+    if (!isTuningDue)
+        return std::nullopt;
+
+    this->cyclesUntilTuning = this->tuningEvery - 1;
+    this->divisionsBeforeBenchmark = currentDivisions;
+    this->candidateSpeeds.clear();
+    this->candidates = DomainDivisionTuner::generateCandidates(packing, interaction, currentDivisions,
+                                                               packing.getMoveThreads(), this->maxCandidates);
+    if (this->candidates.size() < 2) {
+        this->candidates.clear();
+        return std::nullopt;
+    }
+
+    this->benchmarkedCycles = 0;
+    this->benchmarkedMoves = 0;
+    this->benchmarkedMicroseconds = 0;
+    return this->candidates.front();
+}
+
+bool DomainDivisionTuner::finishCycle(std::size_t numMoves, double microseconds) {
+    if (!this->isBenchmarking())
+        return false;
+
+    this->benchmarkedCycles++;
+    this->benchmarkedMoves += numMoves;
+    this->benchmarkedMicroseconds += microseconds;
+    if (this->benchmarkedCycles < this->benchmarkCycles)
+        return false;
+
+    this->candidateSpeeds.push_back(static_cast<double>(this->benchmarkedMoves) / this->benchmarkedMicroseconds);
+    this->benchmarkedCycles = 0;
+    this->benchmarkedMoves = 0;
+    this->benchmarkedMicroseconds = 0;
+    return !this->isBenchmarking();
+}
+
+DomainDivisionTuner::Divisions DomainDivisionTuner::getBestDivisions() const {
+    if (this->candidateSpeeds.empty())
+        return this->divisionsBeforeBenchmark;
+
+    auto bestIt = std::max_element(this->candidateSpeeds.begin(), this->candidateSpeeds.end());
+    return this->candidates[bestIt - this->candidateSpeeds.begin()];
+}
+
+double DomainDivisionTuner::getBestSpeedup() const {
+    if (this->candidateSpeeds.empty())
+        return 1;
+
+    double bestSpeed = *std::max_element(this->candidateSpeeds.begin(), this->candidateSpeeds.end());
+    return bestSpeed / this->candidateSpeeds.front();
+}
+
+void DomainDivisionTuner::abortBenchmark() {
+    this->candidates.resize(this->candidateSpeeds.size());
+    this->benchmarkedCycles = 0;
+    this->benchmarkedMoves = 0;
+    this->benchmarkedMicroseconds = 0;
+}
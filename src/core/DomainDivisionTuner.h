@@ -0,0 +1,113 @@
+#ifndef RAMPACK_DOMAINDIVISIONTUNER_H
+#define RAMPACK_DOMAINDIVISIONTUNER_H
+
+#include <array>
+#include <optional>
+#include <vector>
+
+#include "Packing.h"
+#include "Interaction.h"
+
+
+/**
+ * @brief Periodically benchmarks a few candidate domain divisions and chooses the fastest one.
+ * @details Every @a tuningEvery cycles, a set of candidates is generated (see DomainDivisionTuner::generateCandidates)
+ * and each of them is used for @a benchmarkCycles cycles, during which the number of molecule moves per microsecond is
+ * measured. When all candidates have been measured, the fastest one can be obtained using
+ * DomainDivisionTuner::getBestDivisions. The current divisions are always the first candidate, so they are kept unless
+ * other ones are faster. Since the optimal divisions depend on the size of the box, they can change during NpT
+ * compression.
+ */
+class DomainDivisionTuner {
+public:
+    using Divisions = std::array<std::size_t, 3>;
+
+    /**
+     * @brief Default number of cycles between consecutive benchmarks.
+     */
+    static constexpr std::size_t DEFAULT_TUNING_EVERY = 1000;
+
+private:
+    std::size_t tuningEvery{};
+    std::size_t benchmarkCycles{};
+    std::size_t maxCandidates{};
+
+    std::size_t cyclesUntilTuning{};
+    Divisions divisionsBeforeBenchmark{};
+    std::vector<Divisions> candidates;
+    std::vector<double> candidateSpeeds;
+    std::size_t benchmarkedCycles{};
+    std::size_t benchmarkedMoves{};
+    double benchmarkedMicroseconds{};
+
+public:
+    /**
+     * @brief Creates the tuner.
+     * @param tuningEvery the number of cycles between the starts of consecutive benchmarks (the first one is started
+     * in the first cycle)
+     * @param benchmarkCycles the number of cycles each candidate is measured for
+     * @param maxCandidates the maximal number of candidates measured in a single benchmark
+     */
+    explicit DomainDivisionTuner(std::size_t tuningEvery, std::size_t benchmarkCycles = 10,
+                                 std::size_t maxCandidates = 4);
+
+    /**
+     * @brief Generates at most @a maxCandidates valid domain divisions for @a packing with at most @a maxDomains
+     * domains.
+     * @details Divisions are ranked by the number of domains times the fraction of the volume in active regions (see
+     * DomainDecomposition::calculateActiveVolumeFraction), which estimates the amount of parallel work. The best ones
+     * are returned, with @a currentDivisions in the first place, if they are valid. If the neighbour grid is not used,
+     * only {1, 1, 1} is returned.
+     */
+    [[nodiscard]] static std::vector<Divisions> generateCandidates(const Packing &packing,
+                                                                   const Interaction &interaction,
+                                                                   const Divisions &currentDivisions,
+                                                                   std::size_t maxDomains, std::size_t maxCandidates);
+
+    /**
+     * @brief Should be invoked before molecule moves in each cycle. It returns the domain divisions which should be
+     * used in the cycle or @a std::nullopt if they should be left intact.
+     * @details If the time of tuning has come, the benchmark is started. It is skipped if there is only a single
+     * candidate.
+     */
+    [[nodiscard]] std::optional<Divisions> startCycle(const Packing &packing, const Interaction &interaction,
+                                                      const Divisions &currentDivisions);
+
+    /**
+     * @brief Should be invoked after molecule moves in each cycle, with the number of performed moves and the time
+     * they took. It returns @a true if the benchmark has just been finished - then
+     * DomainDivisionTuner::getBestDivisions gives its result.
+     */
+    bool finishCycle(std::size_t numMoves, double microseconds);
+
+    /**
+     * @brief Returns @a true if the benchmark is in progress.
+     */
+    [[nodiscard]] bool isBenchmarking() const { return this->candidateSpeeds.size() < this->candidates.size(); }
+
+    /**
+     * @brief Returns the fastest of the candidates from the last (or the current) benchmark. Candidates which were
+     * not measured yet are ignored.
+     */
+    [[nodiscard]] Divisions getBestDivisions() const;
+
+    /**
+     * @brief Returns the speedup of the fastest candidate with respect to the first one (which are the divisions used
+     * before the benchmark, if they were still valid).
+     */
+    [[nodiscard]] double getBestSpeedup() const;
+
+    /**
+     * @brief Returns the domain divisions used before the last (or the current) benchmark was started.
+     */
+    [[nodiscard]] const Divisions &getDivisionsBeforeBenchmark() const { return this->divisionsBeforeBenchmark; }
+
+    /**
+     * @brief Aborts the benchmark in progress. The candidates measured so far are still taken into account by
+     * DomainDivisionTuner::getBestDivisions.
+     */
+    void abortBenchmark();
+};
+
+
+#endif //RAMPACK_DOMAINDIVISIONTUNER_H
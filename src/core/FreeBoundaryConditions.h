@@ -29,6 +29,10 @@ public:
     {
         return (position2 - position1).norm2();
     }
+
+    [[nodiscard]] std::unique_ptr<BoundaryConditions> clone() const override {
+        return std::make_unique<FreeBoundaryConditions>(*this);
+    }
 };
 
 #endif //RAMPACK_FREEBOUNDARYCONDITIONS_H
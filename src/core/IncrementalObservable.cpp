@@ -0,0 +1,30 @@
+#include "IncrementalObservable.h"
+#include "utils/Exceptions.h"
+
+
+IncrementalObservable::IncrementalObservable(std::size_t fullRecalculationPeriod)
+        : fullRecalculationPeriod{fullRecalculationPeriod}
+{
+    Expects(fullRecalculationPeriod > 0);
+}
+
+void IncrementalObservable::calculate(const Packing &packing, double temperature, double pressure,
+                                      const ShapeTraits &shapeTraits)
+{
+    bool canUseIncrementalState = this->upToDate
+        && packing.isListenerAttached(*this)
+        && this->shapeTraits == &shapeTraits
+        && this->calculationsSinceFullRecalculation < this->fullRecalculationPeriod;
+
+    if (canUseIncrementalState) {
+        this->calculateIncrementally(packing, temperature, pressure, shapeTraits);
+        this->calculationsSinceFullRecalculation++;
+        return;
+    }
+
+    // Set before the recalculation, so that invalidation during recalculation is not lost
+    this->upToDate = true;
+    this->shapeTraits = &shapeTraits;
+    this->calculationsSinceFullRecalculation = 1;
+    this->recalculate(packing, temperature, pressure, shapeTraits);
+}
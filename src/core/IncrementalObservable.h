@@ -0,0 +1,88 @@
+#ifndef RAMPACK_INCREMENTALOBSERVABLE_H
+#define RAMPACK_INCREMENTALOBSERVABLE_H
+
+#include <atomic>
+
+#include "Observable.h"
+#include "PackingListener.h"
+
+
+/**
+ * @brief Observable, which can be kept up to date by updating it after each change of the packing, instead of
+ * recalculating it from scratch.
+ * @details When the observable is attached to the Packing it is calculated on (see Packing::attachListener), it is
+ * notified about all accepted moves and Observable::calculate uses the accumulated changes, which is usually O(1)
+ * instead of O(N). To bound the accumulation of floating-point errors, the observable is recalculated from scratch
+ * every @a fullRecalculationPeriod invocations of Observable::calculate. It is also recalculated whenever the
+ * incremental state becomes invalid (see IncrementalObservable::invalidate) or when calculated on a packing it is not
+ * attached to - in that case it behaves just as a normal Observable.
+ */
+class IncrementalObservable : public Observable, public PackingListener {
+private:
+    std::size_t fullRecalculationPeriod{};
+    std::size_t calculationsSinceFullRecalculation{};
+    std::atomic<bool> upToDate{};
+    const ShapeTraits *shapeTraits{};
+
+protected:
+    /**
+     * @brief Recalculates the observable from scratch and resets the incremental state.
+     * @details Parameters are the same as in Observable::calculate.
+     */
+    virtual void recalculate(const Packing &packing, double temperature, double pressure,
+                             const ShapeTraits &shapeTraits) = 0;
+
+    /**
+     * @brief Calculates the observable values using the incremental state accumulated since the last invocation of
+     * recalculate() or calculateIncrementally().
+     * @details Parameters are the same as in Observable::calculate.
+     */
+    virtual void calculateIncrementally(const Packing &packing, double temperature, double pressure,
+                                        const ShapeTraits &shapeTraits) = 0;
+
+    /**
+     * @brief Marks the incremental state as invalid, so the observable will be recalculated from scratch on the next
+     * invocation of Observable::calculate. It can be safely called concurrently.
+     */
+    void invalidate() { this->upToDate = false; }
+
+    /**
+     * @brief Returns @a true if the incremental state is valid and updates should be accumulated.
+     * @details If it returns @a false, the updates can be safely ignored, because the next calculation will be from
+     * scratch anyway.
+     */
+    [[nodiscard]] bool isUpToDate() const { return this->upToDate; }
+
+    /**
+     * @brief Returns ShapeTraits passed in the last recalculation. It should be used only when isUpToDate() returns
+     * @a true.
+     */
+    [[nodiscard]] const ShapeTraits &getShapeTraits() const { return *this->shapeTraits; }
+
+public:
+    /**
+     * @brief Default number of Observable::calculate invocations after which the observable is recalculated from
+     * scratch.
+     */
+    static constexpr std::size_t DEFAULT_FULL_RECALCULATION_PERIOD = 100;
+
+    /**
+     * @brief Constructs the class, which will be recalculated from scratch every @a fullRecalculationPeriod
+     * invocations of Observable::calculate.
+     */
+    explicit IncrementalObservable(std::size_t fullRecalculationPeriod = DEFAULT_FULL_RECALCULATION_PERIOD);
+
+    void calculate(const Packing &packing, double temperature, double pressure,
+                   const ShapeTraits &shapeTraits) final;
+
+    void packingReset([[maybe_unused]] const Packing &packing) override { this->invalidate(); }
+
+    /**
+     * @brief Returns the number of Observable::calculate invocations after which the observable is recalculated from
+     * scratch.
+     */
+    [[nodiscard]] std::size_t getFullRecalculationPeriod() const { return this->fullRecalculationPeriod; }
+};
+
+
+#endif //RAMPACK_INCREMENTALOBSERVABLE_H
@@ -122,6 +122,16 @@ public:
      */
     [[nodiscard]] virtual std::vector<Vector<3>> getInteractionCentres() const { return {}; }
 
+    /**
+     * @brief Returns range radii of individual interaction centres (in the same order as
+     * Interaction::getInteractionCentres).
+     * @details Two interaction centres with range radii @a r1 and @a r2 cease to interact at the distance
+     * (@a r1 + @a r2)/2, so the radii cannot exceed Interaction::getRangeRadius. It is used by Packing to bucket
+     * interaction centres of very different sizes into separate neighbour grids. An empty list (the default) means
+     * that all centres have the range radius Interaction::getRangeRadius.
+     */
+    [[nodiscard]] virtual std::vector<double> getInteractionCentreRangeRadii() const { return {}; }
+
     /**
      * @brief Returns a distance at which two molecules cease to interact (opposed to Interaction::getRangeRadius which
      * applies to a single pair of interaction centers).
@@ -0,0 +1,42 @@
+#include <algorithm>
+
+#include "NamedPointCache.h"
+
+
+NamedPointCache &NamedPointCache::operator=([[maybe_unused]] const NamedPointCache &other) {
+    this->entries.clear();
+    this->invalidate();
+    return *this;
+}
+
+NamedPointCache &NamedPointCache::operator=([[maybe_unused]] NamedPointCache &&other) noexcept {
+    this->entries.clear();
+    this->invalidate();
+    return *this;
+}
+
+void NamedPointCache::clearIfInvalid() {
+    if (this->valid.load(std::memory_order_relaxed))
+        return;
+
+    this->entries.clear();
+    this->valid.store(true, std::memory_order_relaxed);
+}
+
+const std::vector<Vector<3>> *NamedPointCache::find(const Vector<3> &alignedNamedPoint) {
+    this->clearIfInvalid();
+    auto it = std::find_if(this->entries.begin(), this->entries.end(), [&alignedNamedPoint](const Entry &entry) {
+        return entry.alignedNamedPoint == alignedNamedPoint;
+    });
+    if (it == this->entries.end())
+        return nullptr;
+    return &it->namedPoints;
+}
+
+const std::vector<Vector<3>> &NamedPointCache::insert(const Vector<3> &alignedNamedPoint,
+                                                      std::vector<Vector<3>> namedPoints)
+{
+    this->clearIfInvalid();
+    this->entries.push_back({alignedNamedPoint, std::move(namedPoints)});
+    return this->entries.back().namedPoints;
+}
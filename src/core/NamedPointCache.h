@@ -0,0 +1,62 @@
+#ifndef RAMPACK_NAMEDPOINTCACHE_H
+#define RAMPACK_NAMEDPOINTCACHE_H
+
+#include <deque>
+#include <vector>
+#include <atomic>
+
+#include "geometry/Vector.h"
+
+
+/**
+ * @brief Cache of named points of all molecules in a Packing, used by Packing::dumpNamedPoints.
+ * @details Named points are keyed by the named point in the aligned molecule orientation (see
+ * ShapeGeometry::getNamedPoint), which together with positions and orientations of molecules fully determines them.
+ * Thus, different observables asking for the same point in the same snapshot share a single computation. The cache
+ * is invalidated by the packing on each modification. Invalidation is thread-safe, so it can be done concurrently from
+ * many move threads. Copying or moving the cache gives an empty one.
+ */
+class NamedPointCache {
+private:
+    struct Entry {
+        Vector<3> alignedNamedPoint;
+        std::vector<Vector<3>> namedPoints;
+    };
+
+    // std::deque does not invalidate references to elements when elements are added at the back
+    std::deque<Entry> entries;
+    std::atomic<bool> valid{};
+
+    void clearIfInvalid();
+
+public:
+    NamedPointCache() = default;
+    NamedPointCache([[maybe_unused]] const NamedPointCache &other) { }
+    NamedPointCache([[maybe_unused]] NamedPointCache &&other) noexcept { }
+    NamedPointCache &operator=(const NamedPointCache &other);
+    NamedPointCache &operator=(NamedPointCache &&other) noexcept;
+
+    /**
+     * @brief Returns cached named points for @a alignedNamedPoint or @a nullptr if they are not present.
+     */
+    [[nodiscard]] const std::vector<Vector<3>> *find(const Vector<3> &alignedNamedPoint);
+
+    /**
+     * @brief Stores @a namedPoints computed for @a alignedNamedPoint and returns a reference to the stored ones.
+     * @details The reference stays valid until the cache is invalidated.
+     */
+    const std::vector<Vector<3>> &insert(const Vector<3> &alignedNamedPoint, std::vector<Vector<3>> namedPoints);
+
+    /**
+     * @brief Marks all cached named points as outdated. They will be removed in the next find() or insert() call.
+     */
+    void invalidate() noexcept { this->valid.store(false, std::memory_order_relaxed); }
+
+    /**
+     * @brief Returns the number of cached named point lists (outdated ones included).
+     */
+    [[nodiscard]] std::size_t size() const { return this->entries.size(); }
+};
+
+
+#endif //RAMPACK_NAMEDPOINTCACHE_H
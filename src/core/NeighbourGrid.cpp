@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <numeric>
+#include <cmath>
 
 #include "NeighbourGrid.h"
 #include "utils/Utils.h"
@@ -26,8 +27,8 @@ std::size_t NeighbourGrid::positionToCellNo(const Vector<3> &position) const {
             relativePosI = 1 - EPSILON;
         }
 
-        // +1, since first row of cells on each edges is "reflected", not "real"
-        std::size_t coord = static_cast<int>(relativePosI / this->relativeCellSize[i]) + 1;
+        // + imageLayers, since first rows of cells on each edges are "reflected", not "real"
+        std::size_t coord = static_cast<int>(relativePosI / this->relativeCellSize[i]) + this->imageLayers[i];
         result = this->cellDivisions[i] * result + coord;
     }
     return result;
@@ -52,7 +53,7 @@ std::size_t NeighbourGrid::coordinatesToCellNo(const std::array<std::size_t, 3>
 std::size_t NeighbourGrid::realCoordinatesToCellNo(const std::array<std::size_t, 3> &coords) const {
     std::size_t result{};
     for (int i = 2; i >= 0; i--)
-        result = this->cellDivisions[i] * result + coords[i] + 1;
+        result = this->cellDivisions[i] * result + coords[i] + this->imageLayers[i];
     return result;
 }
 
@@ -61,8 +62,9 @@ std::size_t NeighbourGrid::cellNeighbourToCellNo(const std::array<std::size_t, 3
 {
     std::size_t result{};
     for (int i = 2; i >= 0; i--) {
-        // -1, because neighbour array goes from 0 to 2, and real offsets are from -1 to 1
-        std::size_t ix = coords[i] + neighbour[i] - 1;
+        // -imageLayers, because neighbour array goes from 0 to 2*imageLayers, and real offsets are from -imageLayers
+        // to imageLayers
+        std::size_t ix = coords[i] + neighbour[i] - this->imageLayers[i];
         Assert(ix < this->cellDivisions[i]);
         result = this->cellDivisions[i] * result + ix;
     }
@@ -72,50 +74,60 @@ std::size_t NeighbourGrid::cellNeighbourToCellNo(const std::array<std::size_t, 3
 bool NeighbourGrid::isCellReflected(std::size_t cellNo) const {
     std::array<std::size_t, 3> coords = this->cellNoToCoordinates(cellNo);
     for (std::size_t i{}; i < 3; i++)
-        if (coords[i] == 0 || coords[i] == this->cellDivisions[i] - 1)
+        if (coords[i] < this->imageLayers[i] || coords[i] >= this->cellDivisions[i] - this->imageLayers[i])
             return true;
     return false;
 }
 
 std::pair<std::size_t, std::size_t> NeighbourGrid::getReflectedCellData(std::size_t cellNo) const {
+    std::array<std::size_t, 3> noTranslation = this->imageLayers;
     if (!this->isCellReflected(cellNo))
-        return std::make_pair(cellNo, NeighbourGrid::flattenTranslationIndex(1, 1, 1));
+        return std::make_pair(cellNo, this->flattenTranslationIndex(noTranslation));
 
     std::array<std::size_t, 3> coords = this->cellNoToCoordinates(cellNo);
     std::array<std::size_t, 3> transCoord{};
-    transCoord.fill(1);
     for (std::size_t i{}; i < 3; i++) {
-        std::size_t &coord = coords[i];
-        if (coord == 0) {
-            coord = this->cellDivisions[i] - 2;
-            transCoord[i] = 0;
-        } else if (coord == this->cellDivisions[i] - 1) {
-            coord = 1;
-            transCoord[i] = 2;
-        }
+        // Image layers can span more than a single box height, so the number of box heights to wrap is computed using
+        // a floor division of the coordinate relative to the first real cell
+        auto numRealCells = static_cast<long>(this->cellDivisions[i] - 2*this->imageLayers[i]);
+        auto relativeCoord = static_cast<long>(coords[i]) - static_cast<long>(this->imageLayers[i]);
+        long numWraps = (relativeCoord >= 0) ? relativeCoord / numRealCells
+                                             : -((-relativeCoord + numRealCells - 1) / numRealCells);
+        coords[i] = static_cast<std::size_t>(relativeCoord - numWraps*numRealCells) + this->imageLayers[i];
+        transCoord[i] = static_cast<std::size_t>(numWraps + static_cast<long>(this->imageLayers[i]));
     }
 
-    std::size_t transIdx = NeighbourGrid::flattenTranslationIndex(transCoord[0], transCoord[1], transCoord[2]);
-    return std::make_pair(this->coordinatesToCellNo(coords), transIdx);
+    return std::make_pair(this->coordinatesToCellNo(coords), this->flattenTranslationIndex(transCoord));
+}
+
+std::size_t NeighbourGrid::flattenTranslationIndex(const std::array<std::size_t, 3> &transCoords) const {
+    std::size_t result{};
+    for (std::size_t i{}; i < 3; i++)
+        result = (2*this->imageLayers[i] + 1) * result + transCoords[i];
+    return result;
 }
 
-bool NeighbourGrid::increment(std::array<int, 3> &in) {
+bool NeighbourGrid::increment(std::array<int, 3> &in, const std::array<int, 3> &max) {
     for (std::size_t i{}; i < 3; i++) {
         in[i]++;
-        if (in[i] > 2 && i < 2)
+        if (in[i] > max[i] && i < 2)
             in[i] = 0;
         else
             break;
     }
-    return in[2] <= 2;
+    return in[2] <= max[2];
 }
 
 void NeighbourGrid::fillNeighbouringCellsOffsets() {
-    // 3 x 3 neighbours
+    // (2*imageLayers + 1)^3 neighbours - 3 x 3 x 3 unless some box height is smaller than the cell size
+    std::array<int, 3> maxNeighbour{};
+    for (std::size_t i{}; i < 3; i++)
+        maxNeighbour[i] = static_cast<int>(2*this->imageLayers[i]);
+    std::size_t numNeighbours = (maxNeighbour[0] + 1) * (maxNeighbour[1] + 1) * (maxNeighbour[2] + 1);
     this->neighbouringCellsOffsets.clear();
-    this->neighbouringCellsOffsets.reserve(27);
+    this->neighbouringCellsOffsets.reserve(numNeighbours);
     this->positiveNeighbouringCellsOffsets.clear();
-    this->positiveNeighbouringCellsOffsets.reserve(13);
+    this->positiveNeighbouringCellsOffsets.reserve(numNeighbours / 2);
 
     // We are taking the cell somewhere in the middle and computing offsets in cell list to all of its neighbours
     std::array<int, 3> neighbour{};
@@ -124,12 +136,26 @@ void NeighbourGrid::fillNeighbouringCellsOffsets() {
     for (std::size_t i{}; i < 3; i++)
         testCellCoords[i] = this->cellDivisions[i] / 2;
     std::size_t testCellNo = this->coordinatesToCellNo(testCellCoords);
+    // Neighbours "after" the central one in the lexicographic order of the stencil form the positive half
+    auto flattenNeighbour = [&maxNeighbour](const std::array<int, 3> &neighbour_) {
+        return ((neighbour_[0] * (maxNeighbour[1] + 1)) + neighbour_[1]) * (maxNeighbour[2] + 1) + neighbour_[2];
+    };
+    std::array<int, 3> centralNeighbour{maxNeighbour[0] / 2, maxNeighbour[1] / 2, maxNeighbour[2] / 2};
+    int centralNeighbourIdx = flattenNeighbour(centralNeighbour);
+    // (squared distance from the central cell in cell units, offset) pairs for the nearest-first order
+    std::vector<std::pair<int, std::size_t>> offsetsByDistance;
+    offsetsByDistance.reserve(numNeighbours);
     do {
         std::size_t neigbourNo = this->cellNeighbourToCellNo(testCellCoords, neighbour);
         this->neighbouringCellsOffsets.push_back(neigbourNo - testCellNo);
-        if (9*neighbour[0] + 3*neighbour[1] + neighbour[2] > 13)
+        if (flattenNeighbour(neighbour) > centralNeighbourIdx)
             this->positiveNeighbouringCellsOffsets.push_back(neigbourNo - testCellNo);
-    } while(increment(neighbour));
+
+        int distance2{};
+        for (std::size_t i{}; i < 3; i++)
+            distance2 += (neighbour[i] - centralNeighbour[i]) * (neighbour[i] - centralNeighbour[i]);
+        offsetsByDistance.emplace_back(distance2, neigbourNo - testCellNo);
+    } while(increment(neighbour, maxNeighbour));
 
     // sort and erase to avoid duplicates - important for small packings
     std::sort( this->neighbouringCellsOffsets.begin(), this->neighbouringCellsOffsets.end());
@@ -140,10 +166,38 @@ void NeighbourGrid::fillNeighbouringCellsOffsets() {
     this->positiveNeighbouringCellsOffsets.erase(std::unique(this->positiveNeighbouringCellsOffsets.begin(),
                                                      this->positiveNeighbouringCellsOffsets.end()),
                                          this->positiveNeighbouringCellsOffsets.end());
+
+    // Nearest-first order - offsets within the same distance are sorted to preserve memory locality. Duplicates are
+    // erased keeping the nearest occurrence
+    std::sort(offsetsByDistance.begin(), offsetsByDistance.end());
+    std::vector<bool> offsetUsed(this->neighbouringCellsOffsets.size(), false);
+    this->nearestFirstNeighbouringCellsOffsets.clear();
+    this->nearestFirstNeighbouringCellsOffsets.reserve(this->neighbouringCellsOffsets.size());
+    for (const auto &[distance2, offset] : offsetsByDistance) {
+        auto offsetIt = std::lower_bound(this->neighbouringCellsOffsets.begin(), this->neighbouringCellsOffsets.end(),
+                                         offset);
+        auto offsetIdx = static_cast<std::size_t>(offsetIt - this->neighbouringCellsOffsets.begin());
+        if (offsetUsed[offsetIdx])
+            continue;
+        offsetUsed[offsetIdx] = true;
+        this->nearestFirstNeighbouringCellsOffsets.push_back(offset);
+    }
 }
 
 NeighbourGrid::NeighbourGrid(const TriclinicBox& box, double cellSize, std::size_t numParticles) : box{box} {
     this->setupSizes(box, cellSize);
+    this->setupCells(numParticles);
+}
+
+NeighbourGrid::NeighbourGrid(const TriclinicBox &box, const std::array<std::size_t, 3> &realCellDivisions,
+                             const std::array<std::size_t, 3> &imageLayers, std::size_t numParticles)
+        : box{box}
+{
+    this->setupSizes(box, realCellDivisions, imageLayers);
+    this->setupCells(numParticles);
+}
+
+void NeighbourGrid::setupCells(std::size_t numParticles) {
     this->cellHeads.resize(this->numCells);
     std::fill(this->cellHeads.begin(), this->cellHeads.end(), LIST_END);
     this->translationIndices.resize(this->numCells);
@@ -156,6 +210,8 @@ NeighbourGrid::NeighbourGrid(const TriclinicBox& box, double cellSize, std::size
 
     this->successors.resize(numParticles);
     std::fill(this->successors.begin(), this->successors.end(), NeighbourGrid::LIST_END);
+    this->objectCells.resize(numParticles);
+    std::fill(this->objectCells.begin(), this->objectCells.end(), NeighbourGrid::LIST_END);
 
     // Aliasing "reflected" cell lists to real ones
     for (std::size_t i{}; i < this->numCells; i++)
@@ -175,25 +231,55 @@ NeighbourGrid::NeighbourGrid(const std::array<double, 3> &linearSizes, double ce
                         cellSize, numParticles)
 { }
 
-void NeighbourGrid::setupSizes(const TriclinicBox& newBox, double newCellSize) {
-    Expects(newBox.getVolume() > 0);
-    Expects(newCellSize > 0);
+std::pair<std::array<std::size_t, 3>, std::array<std::size_t, 3>>
+NeighbourGrid::calculateCellDivisions(const TriclinicBox &box, double cellSize) {
+    Expects(box.getVolume() > 0);
+    Expects(cellSize > 0);
 
-    auto newBoxSides = newBox.getSides();
-    auto newBoxHeights = newBox.getHeights();
+    auto boxHeights = box.getHeights();
+
+    // Additional cells on both edges - "reflected" cells - are used by periodic boundary conditions. Normally, a single
+    // layer is sufficient, but if the box is thinner than the cell size, a single real cell needs as many layers as
+    // needed to reach the cell size
+    std::array<std::size_t, 3> cellDivisions{};
+    std::array<std::size_t, 3> imageLayers{};
+    for (std::size_t i{}; i < 3; i++) {
+        auto numRealCells = static_cast<std::size_t>(std::floor(boxHeights[i] / cellSize));
+        if (numRealCells >= 1) {
+            imageLayers[i] = 1;
+        } else {
+            numRealCells = 1;
+            imageLayers[i] = static_cast<std::size_t>(std::ceil(cellSize / boxHeights[i]));
+        }
+        cellDivisions[i] = numRealCells + 2*imageLayers[i];
+    }
+    return {cellDivisions, imageLayers};
+}
 
-    // 2 additional cells on both edges - "reflected" cells - are used by periodic boundary conditions
+void NeighbourGrid::setupSizes(const TriclinicBox& newBox, double newCellSize) {
+    auto [cellDivisions_, imageLayers_] = NeighbourGrid::calculateCellDivisions(newBox, newCellSize);
+    for (std::size_t i{}; i < 3; i++)
+        cellDivisions_[i] -= 2*imageLayers_[i];
+    this->setupSizes(newBox, cellDivisions_, imageLayers_);
+}
+
+void NeighbourGrid::setupSizes(const TriclinicBox &newBox, const std::array<std::size_t, 3> &realCellDivisions,
+                               const std::array<std::size_t, 3> &imageLayers_)
+{
+    Expects(newBox.getVolume() > 0);
     std::array<std::size_t, 3> cellDivisions_{};
     for (std::size_t i{}; i < 3; i++) {
-        cellDivisions_[i] = static_cast<std::size_t>(floor(newBoxHeights[i] / newCellSize)) + 2;
-        ExpectsMsg(cellDivisions_[i] >= 3, "Neighbour grid cell too big");
+        Expects(realCellDivisions[i] > 0);
+        Expects(imageLayers_[i] > 0);
+        cellDivisions_[i] = realCellDivisions[i] + 2*imageLayers_[i];
     }
 
     this->box = newBox;
-    this->boxSides = newBoxSides;
+    this->boxSides = newBox.getSides();
     this->cellDivisions = cellDivisions_;
+    this->imageLayers = imageLayers_;
     for (std::size_t i{}; i < 3; i++)
-        this->relativeCellSize[i] = 1 / static_cast<double>(this->cellDivisions[i] - 2);
+        this->relativeCellSize[i] = 1 / static_cast<double>(this->cellDivisions[i] - 2*this->imageLayers[i]);
     this->calculateTranslations();
     this->numCells = static_cast<std::size_t>(
         std::accumulate(this->cellDivisions.begin(), this->cellDivisions.end(), 1., std::multiplies<>{})
@@ -201,15 +287,17 @@ void NeighbourGrid::setupSizes(const TriclinicBox& newBox, double newCellSize) {
 }
 
 void NeighbourGrid::calculateTranslations() {
-    for (std::size_t i{}; i < 3; i++) {
-        for (std::size_t j{}; j < 3; j++) {
-            for (std::size_t k{}; k < 3; k++) {
-                // indices 0, 1, 2 correspond to -1, 0, 1 (relative) translation respectively
-                Vector<3> relativeTranslation{static_cast<double>(i) - 1,
-                                              static_cast<double>(j) - 1.,
-                                              static_cast<double>(k) - 1.};
+    const auto &layers = this->imageLayers;
+    this->translations.resize((2*layers[0] + 1) * (2*layers[1] + 1) * (2*layers[2] + 1));
+    for (std::size_t i{}; i <= 2*layers[0]; i++) {
+        for (std::size_t j{}; j <= 2*layers[1]; j++) {
+            for (std::size_t k{}; k <= 2*layers[2]; k++) {
+                // indices 0, 1, ..., 2*layers correspond to -layers, ..., layers (relative) translation respectively
+                Vector<3> relativeTranslation{static_cast<double>(i) - static_cast<double>(layers[0]),
+                                              static_cast<double>(j) - static_cast<double>(layers[1]),
+                                              static_cast<double>(k) - static_cast<double>(layers[2])};
                 Vector<3> absoluteTranslation = this->box.relativeToAbsolute(relativeTranslation);
-                std::size_t idx = NeighbourGrid::flattenTranslationIndex(i, j, k);
+                std::size_t idx = this->flattenTranslationIndex({i, j, k});
                 this->translations[idx] = absoluteTranslation;
             }
         }
@@ -224,6 +312,7 @@ void NeighbourGrid::add(std::size_t idx, const Vector<3> &position) {
 
     this->successors[idx] = this->cellHeads[i];
     this->cellHeads[i] = idx;
+    this->objectCells[idx] = i;
 }
 
 void NeighbourGrid::add(std::size_t idx, std::size_t cellNo) {
@@ -233,6 +322,7 @@ void NeighbourGrid::add(std::size_t idx, std::size_t cellNo) {
 
     this->successors[idx] = this->cellHeads[cellNo];
     this->cellHeads[cellNo] = idx;
+    this->objectCells[idx] = cellNo;
 }
 
 void NeighbourGrid::remove(std::size_t idx, const Vector<3> &position) {
@@ -261,6 +351,20 @@ void NeighbourGrid::clear() {
     std::fill(this->cellHeads.begin(), this->cellHeads.end(), LIST_END);
     std::fill(this->cellOwningThreads.begin(), this->cellOwningThreads.end(), LIST_END);
     std::fill(this->successors.begin(), this->successors.end(), LIST_END);
+    std::fill(this->objectCells.begin(), this->objectCells.end(), LIST_END);
+}
+
+bool NeighbourGrid::canBeRescaled(const TriclinicBox &newBox, double newCellSize) const {
+    auto [newCellDivisions, newImageLayers] = NeighbourGrid::calculateCellDivisions(newBox, newCellSize);
+    return newCellDivisions == this->cellDivisions && newImageLayers == this->imageLayers;
+}
+
+void NeighbourGrid::rescale(const TriclinicBox &newBox) {
+    Expects(newBox.getVolume() > 0);
+
+    this->box = newBox;
+    this->boxSides = newBox.getSides();
+    this->calculateTranslations();
 }
 
 NeighbourGrid::CellView NeighbourGrid::getCell(const Vector<3> &position) const {
@@ -271,7 +375,7 @@ NeighbourGrid::CellView NeighbourGrid::getCell(const Vector<3> &position) const
 
 NeighbourGrid::CellView NeighbourGrid::getCell(const std::array<std::size_t, 3> &coord) const {
     for (std::size_t i = 0; i < 3; i++)
-        Expects(coord[i] < this->cellDivisions[i] - 2);
+        Expects(coord[i] < this->cellDivisions[i] - 2*this->imageLayers[i]);
 
     std::size_t i = this->realCoordinatesToCellNo(coord);
     std::size_t head = this->cellHeads[i];
@@ -310,13 +414,23 @@ std::vector<std::size_t> NeighbourGrid::getCellVector(std::size_t cellNo) const
 }
 
 bool NeighbourGrid::resize(TriclinicBox newBox, double newCellSize) {
+    auto [newCellDivisions, newImageLayers] = NeighbourGrid::calculateCellDivisions(newBox, newCellSize);
+    for (std::size_t i{}; i < 3; i++)
+        newCellDivisions[i] -= 2*newImageLayers[i];
+    return this->resize(newBox, newCellDivisions, newImageLayers);
+}
+
+bool NeighbourGrid::resize(const TriclinicBox &newBox, const std::array<std::size_t, 3> &newRealCellDivisions,
+                           const std::array<std::size_t, 3> &newImageLayers)
+{
     auto oldNumCellsInLine = this->cellDivisions;
+    auto oldImageLayers = this->imageLayers;
     std::size_t oldNumCells = this->numCells;
-    this->setupSizes(newBox, newCellSize);
+    this->setupSizes(newBox, newRealCellDivisions, newImageLayers);
 
     // Early exit - if number of cells in line did not change we do not need to rebuild the structure, only clear and
     // recreate translations
-    if (this->cellDivisions == oldNumCellsInLine) {
+    if (this->cellDivisions == oldNumCellsInLine && this->imageLayers == oldImageLayers) {
         this->clear();
         return false;
     }
@@ -361,7 +475,7 @@ NeighbourGrid::NeighboursView NeighbourGrid::getNeighbouringCells(const std::arr
                                                                   bool onlyPositive) const
 {
     for (std::size_t i = 0; i < 3; i++)
-        Expects(coord[i] < this->cellDivisions[i] - 2);
+        Expects(coord[i] < this->cellDivisions[i] - 2*this->imageLayers[i]);
 
     if (onlyPositive)
         return NeighboursView(*this, this->realCoordinatesToCellNo(coord), this->positiveNeighbouringCellsOffsets);
@@ -369,8 +483,14 @@ NeighbourGrid::NeighboursView NeighbourGrid::getNeighbouringCells(const std::arr
         return NeighboursView(*this, this->realCoordinatesToCellNo(coord), this->neighbouringCellsOffsets);
 }
 
+NeighbourGrid::NeighboursView NeighbourGrid::getNeighbouringCellsNearestFirst(const Vector<3> &position) const {
+    return NeighboursView(*this, this->positionToCellNo(position), this->nearestFirstNeighbouringCellsOffsets);
+}
+
 std::array<std::size_t, 3> NeighbourGrid::getCellDivisions() const {
-    return {this->cellDivisions[0] - 2, this->cellDivisions[1] - 2, this->cellDivisions[2] - 2};
+    return {this->cellDivisions[0] - 2*this->imageLayers[0],
+            this->cellDivisions[1] - 2*this->imageLayers[1],
+            this->cellDivisions[2] - 2*this->imageLayers[2]};
 }
 
 std::size_t NeighbourGrid::getMemoryUsage() const {
@@ -378,10 +498,13 @@ std::size_t NeighbourGrid::getMemoryUsage() const {
     bytes += get_vector_memory_usage(this->cellHeads);
     bytes += get_vector_memory_usage(this->cellOwningThreads);
     bytes += get_vector_memory_usage(this->translationIndices);
+    bytes += get_vector_memory_usage(this->translations);
     bytes += get_vector_memory_usage(this->successors);
+    bytes += get_vector_memory_usage(this->objectCells);
     bytes += get_vector_memory_usage(this->reflectedCells);
     bytes += get_vector_memory_usage(this->neighbouringCellsOffsets);
     bytes += get_vector_memory_usage(this->positiveNeighbouringCellsOffsets);
+    bytes += get_vector_memory_usage(this->nearestFirstNeighbouringCellsOffsets);
     return bytes;
 }
 
@@ -394,7 +517,8 @@ NeighbourGrid::cellCoordinatesToCellBounds(const std::array<std::size_t, 3> &coo
 {
     std::array<std::pair<double, double>, 3> bounds;
     for (std::size_t i{}; i < 3; i++) {
-        double beg = (static_cast<double>(coords[i]) - 1) / this->cellDivisions[i];
+        double beg = (static_cast<double>(coords[i]) - static_cast<double>(this->imageLayers[i]))
+                     * this->relativeCellSize[i];
         double end = beg + this->relativeCellSize[i];
         bounds[i] = {beg, end};
     }
@@ -420,8 +544,8 @@ void NeighbourGrid::sanitizeRaceCondition(std::size_t cellNo, const std::string
 
         auto coords = this->cellNoToCoordinates(cellNo);
         auto bounds = this->cellCoordinatesToCellBounds(coords);
-        for (auto &coord : coords)
-            coord--;
+        for (std::size_t i{}; i < 3; i++)
+            coords[i] -= this->imageLayers[i];
 
         msg << "Cell coordinates : {" << coords[0] << ", " << coords[1] << ", " << coords[2] << "}" << std::endl;
         msg << "Rel. cell bounds : {[" << bounds[0].first << ", " << bounds[0].second << "), ";
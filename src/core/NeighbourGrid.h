@@ -24,6 +24,11 @@
 
 /**
  * @brief An acceleration structure for a constant-time lookup of neighbours for a fixed number of particles.
+ * @details Real cells are surrounded by layers of "reflected" (image) cells, which alias real cells translated by
+ * box vectors due to periodic boundary conditions. Normally, there is a single image layer on each side. If a box
+ * height in some direction is smaller than the cell size (for example for a quasi-2D slab), there is a single real
+ * cell in that direction and as many image layers as needed to cover the cell size, so that all periodic images of
+ * neighbours within the cell size are enumerated.
  */
 class NeighbourGrid {
 private:
@@ -32,19 +37,23 @@ private:
     TriclinicBox box;
     std::array<Vector<3>, 3> boxSides;
     std::array<std::size_t, 3> cellDivisions{};
+    std::array<std::size_t, 3> imageLayers{};
     std::array<double, 3> relativeCellSize{};
     std::vector<std::size_t> cellHeads;
     std::vector<std::size_t> cellOwningThreads;
     std::vector<std::size_t> successors;
-    std::array<Vector<3>, 27> translations;
+    std::vector<std::size_t> objectCells;
+    std::vector<Vector<3>> translations;
     std::vector<std::size_t> translationIndices;
     std::vector<std::size_t> reflectedCells;
     std::size_t numCells{};
     std::vector<std::size_t> neighbouringCellsOffsets;
     std::vector<std::size_t> positiveNeighbouringCellsOffsets;
+    std::vector<std::size_t> nearestFirstNeighbouringCellsOffsets;
 
-    static bool increment(std::array<int, 3> &in);
-    static std::size_t flattenTranslationIndex(std::size_t i, std::size_t j, std::size_t k) { return i*3*3 + j*3 + k; }
+    static bool increment(std::array<int, 3> &in, const std::array<int, 3> &max);
+
+    [[nodiscard]] std::size_t flattenTranslationIndex(const std::array<std::size_t, 3> &transCoords) const;
 
     [[nodiscard]] std::array<std::size_t, 3> cellNoToCoordinates(std::size_t cellNo) const;
     [[nodiscard]] std::size_t coordinatesToCellNo(const std::array<std::size_t, 3> &coords) const;
@@ -68,7 +77,12 @@ private:
     void fillNeighbouringCellsOffsets();
 
     [[nodiscard]] std::vector<std::size_t> getCellVector(std::size_t cellNo) const;
+    [[nodiscard]] static std::pair<std::array<std::size_t, 3>, std::array<std::size_t, 3>>
+    calculateCellDivisions(const TriclinicBox &box, double cellSize);
     void setupSizes(const TriclinicBox& newBox, double newCellSize);
+    void setupSizes(const TriclinicBox &newBox, const std::array<std::size_t, 3> &realCellDivisions,
+                    const std::array<std::size_t, 3> &imageLayers_);
+    void setupCells(std::size_t numParticles);
     void calculateTranslations();
 
     void sanitizeRaceCondition(size_t cellNo, const std::string& methodSignature);
@@ -240,6 +254,15 @@ public:
      */
     NeighbourGrid(const TriclinicBox& box, double cellSize, std::size_t numParticles);
 
+    /**
+     * @brief Creates a neighbour grid for a general box with explicitly given numbers of real cells
+     * @a realCellDivisions and image layers @a imageLayers in each direction.
+     * @details The neighbouring cells then span @a imageLayers cells on each side of a given one. It is the caller's
+     * responsibility to ensure that the cells are large enough for the interaction range.
+     */
+    NeighbourGrid(const TriclinicBox &box, const std::array<std::size_t, 3> &realCellDivisions,
+                  const std::array<std::size_t, 3> &imageLayers, std::size_t numParticles);
+
     /**
      * @brief Adds an object with identifier @a idx at position @a position to the neighbour grid.
      */
@@ -283,6 +306,34 @@ public:
      */
     bool resize(TriclinicBox box_, double newCellSize);
 
+    /**
+     * @brief Resizes the neighbour grid with given new box, number of real cells @a newRealCellDivisions and image
+     * layers @a newImageLayers (see NeighbourGrid(const TriclinicBox &, const std::array<std::size_t, 3> &,
+     * const std::array<std::size_t, 3> &, std::size_t)). NG is also cleared.
+     */
+    bool resize(const TriclinicBox &newBox, const std::array<std::size_t, 3> &newRealCellDivisions,
+                const std::array<std::size_t, 3> &newImageLayers);
+
+    /**
+     * @brief Returns @a true if the grid for a box @a newBox and cell size @a newCellSize would have the same number
+     * of cells and image layers in each direction, so NeighbourGrid::rescale can be used instead of NeighbourGrid::resize.
+     */
+    [[nodiscard]] bool canBeRescaled(const TriclinicBox &newBox, double newCellSize) const;
+
+    /**
+     * @brief Changes the box to @a newBox without altering neither cell divisions nor the content of cells.
+     * @details Since cells are defined in relative coordinates, it is sufficient if objects are transformed together
+     * with the box (for example in an affine scaling of positions) and NeighbourGrid::canBeRescaled returned @a true.
+     * Cell membership of objects after rescaling can be verified using NeighbourGrid::getObjectCellNo.
+     */
+    void rescale(const TriclinicBox &newBox);
+
+    /**
+     * @brief Returns the internal cell number (see NeighbourGrid::positionToCellNo) of a cell, to which an object with
+     * identifier @a idx was added.
+     */
+    [[nodiscard]] std::size_t getObjectCellNo(std::size_t idx) const { return this->objectCells[idx]; }
+
     /**
      * @brief Returns all identifiers of objects places in NG cell containing @a position point.
      */
@@ -318,11 +369,27 @@ public:
     [[nodiscard]] NeighboursView getNeighbouringCells(const std::array<std::size_t, 3> &coord,
                                                       bool onlyPositive = false) const;
 
+    /**
+     * @brief Returns NeighboursView of the same cells as NeighbourGrid::getNeighbouringCells(const Vector<3> &, bool),
+     * however ordered from the nearest ones: the cell containing @a position, then cells sharing a face with it, then
+     * an edge and finally a corner.
+     * @details It is useful when searching for any overlap - the nearest cells are the most likely to contain an
+     * overlapping object, so the search terminates earlier. For full enumeration, the default order, which is
+     * sequential in memory, is preferable.
+     */
+    [[nodiscard]] NeighboursView getNeighbouringCellsNearestFirst(const Vector<3> &position) const;
+
     /**
      * @brief Returns a number of NG cells in each direction.
      */
     [[nodiscard]] std::array<std::size_t, 3> getCellDivisions() const;
 
+    /**
+     * @brief Returns a number of layers of image cells on each side of real cells in each direction.
+     * @details It is 1 for directions, in which the box is at least as high as the cell size, and more otherwise.
+     */
+    [[nodiscard]] const std::array<std::size_t, 3> &getImageLayers() const { return this->imageLayers; }
+
     /**
      * @brief Estimates the memory usage of the neighbour grid in bytes.
      */
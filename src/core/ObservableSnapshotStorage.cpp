@@ -0,0 +1,154 @@
+#include <istream>
+#include <ostream>
+#include <cstdint>
+
+#include "ObservableSnapshotStorage.h"
+#include "utils/Exceptions.h"
+#include "utils/Utils.h"
+
+
+namespace {
+    void write_size(std::ostream &out, std::size_t size) {
+        auto size64 = static_cast<std::uint64_t>(size);
+        out.write(reinterpret_cast<const char*>(&size64), sizeof(size64));
+    }
+
+    std::size_t read_size(std::istream &in) {
+        std::uint64_t size64{};
+        in.read(reinterpret_cast<char*>(&size64), sizeof(size64));
+        return static_cast<std::size_t>(size64);
+    }
+}
+
+void ObservableSnapshotStorage::add(Snapshot snapshot) {
+    this->inMemorySnapshots.push_back(std::move(snapshot));
+    if (this->inMemorySnapshots.size() <= this->maxInMemorySnapshots)
+        return;
+
+    if (this->spillStream != nullptr)
+        this->spill();
+    else if (this->dropOldSnapshots)
+        this->inMemorySnapshots.pop_front();
+}
+
+void ObservableSnapshotStorage::spill() {
+    Assert(this->spillStream != nullptr);
+
+    auto &out = *this->spillStream;
+    out.seekp(this->spillStreamEnd);
+    for (const auto &snapshot : this->inMemorySnapshots)
+        this->writeSnapshot(out, snapshot);
+    out.flush();
+    ValidateMsg(out.good(), "ObservableSnapshotStorage: Could not write to the spill stream");
+
+    this->spillStreamEnd = out.tellp();
+    this->numSpilledSnapshots += this->inMemorySnapshots.size();
+    this->inMemorySnapshots.clear();
+    this->inMemorySnapshots.shrink_to_fit();
+}
+
+void ObservableSnapshotStorage::writeSnapshot(std::ostream &out, const Snapshot &snapshot) {
+    write_size(out, snapshot.cycleNumber);
+
+    write_size(out, snapshot.intervalValues.size());
+    out.write(reinterpret_cast<const char*>(snapshot.intervalValues.data()),
+              static_cast<std::streamsize>(snapshot.intervalValues.size() * sizeof(double)));
+
+    write_size(out, snapshot.nominalValues.size());
+    for (const auto &nominalValue : snapshot.nominalValues) {
+        write_size(out, nominalValue.size());
+        out.write(nominalValue.data(), static_cast<std::streamsize>(nominalValue.size()));
+    }
+}
+
+ObservableSnapshotStorage::Snapshot ObservableSnapshotStorage::readSnapshot(std::istream &in) {
+    Snapshot snapshot;
+    snapshot.cycleNumber = read_size(in);
+
+    snapshot.intervalValues.resize(read_size(in));
+    in.read(reinterpret_cast<char*>(snapshot.intervalValues.data()),
+            static_cast<std::streamsize>(snapshot.intervalValues.size() * sizeof(double)));
+
+    snapshot.nominalValues.resize(read_size(in));
+    for (auto &nominalValue : snapshot.nominalValues) {
+        nominalValue.resize(read_size(in));
+        in.read(nominalValue.data(), static_cast<std::streamsize>(nominalValue.size()));
+    }
+
+    ValidateMsg(in.good(), "ObservableSnapshotStorage: Broken spill stream");
+    return snapshot;
+}
+
+void ObservableSnapshotStorage::visit(const std::function<void(const Snapshot &)> &visitor) const {
+    if (this->numSpilledSnapshots > 0) {
+        Assert(this->spillStream != nullptr);
+        auto &in = *this->spillStream;
+        in.seekg(0, std::ios::beg);
+        for (std::size_t i{}; i < this->numSpilledSnapshots; i++)
+            visitor(readSnapshot(in));
+    }
+
+    for (const auto &snapshot : this->inMemorySnapshots)
+        visitor(snapshot);
+}
+
+void ObservableSnapshotStorage::attachSpillStream(std::unique_ptr<std::iostream> spillStream_,
+                                                  std::size_t maxInMemorySnapshots_)
+{
+    Expects(spillStream_ != nullptr);
+
+    if (this->spillStream != nullptr)
+        this->detachSpillStream();
+
+    this->spillStream = std::move(spillStream_);
+    this->maxInMemorySnapshots = maxInMemorySnapshots_;
+    this->dropOldSnapshots = false;
+    this->numSpilledSnapshots = 0;
+    this->spillStreamEnd = 0;
+
+    if (this->inMemorySnapshots.size() > this->maxInMemorySnapshots)
+        this->spill();
+}
+
+std::unique_ptr<std::iostream> ObservableSnapshotStorage::detachSpillStream() {
+    if (this->numSpilledSnapshots > 0) {
+        std::deque<Snapshot> allSnapshots;
+        this->visit([&allSnapshots](const Snapshot &snapshot) { allSnapshots.push_back(snapshot); });
+        this->inMemorySnapshots = std::move(allSnapshots);
+    }
+
+    this->numSpilledSnapshots = 0;
+    this->spillStreamEnd = 0;
+    this->maxInMemorySnapshots = 0;
+    return std::move(this->spillStream);
+}
+
+void ObservableSnapshotStorage::limitToRecentSnapshots(std::size_t maxSnapshots) {
+    if (this->spillStream != nullptr)
+        this->detachSpillStream();
+
+    this->maxInMemorySnapshots = maxSnapshots;
+    this->dropOldSnapshots = true;
+
+    if (this->inMemorySnapshots.size() > this->maxInMemorySnapshots) {
+        auto numDropped = static_cast<std::ptrdiff_t>(this->inMemorySnapshots.size() - this->maxInMemorySnapshots);
+        this->inMemorySnapshots.erase(this->inMemorySnapshots.begin(), this->inMemorySnapshots.begin() + numDropped);
+    }
+}
+
+void ObservableSnapshotStorage::clear() {
+    this->inMemorySnapshots.clear();
+    this->numSpilledSnapshots = 0;
+    this->spillStreamEnd = 0;
+}
+
+std::size_t ObservableSnapshotStorage::getMemoryUsage() const {
+    std::size_t bytes = this->inMemorySnapshots.size() * sizeof(Snapshot);
+    for (const auto &snapshot : this->inMemorySnapshots) {
+        bytes += get_vector_memory_usage(snapshot.intervalValues);
+        bytes += get_vector_memory_usage(snapshot.nominalValues);
+        for (const auto &nominalValue : snapshot.nominalValues)
+            bytes += nominalValue.capacity();
+    }
+    return bytes;
+}
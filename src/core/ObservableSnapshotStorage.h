@@ -0,0 +1,108 @@
+#ifndef RAMPACK_OBSERVABLESNAPSHOTSTORAGE_H
+#define RAMPACK_OBSERVABLESNAPSHOTSTORAGE_H
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <memory>
+#include <iosfwd>
+#include <functional>
+
+
+/**
+ * @brief Storage of observable snapshots, which keeps the values in a binary form and can spill them to a stream (for
+ * example a file) to bound the memory usage.
+ * @details By default, all snapshots are kept in memory. If a spill stream is attached using
+ * ObservableSnapshotStorage::attachSpillStream, at most @a maxInMemorySnapshots snapshots are kept in memory - when the
+ * limit is exceeded, all of them are appended to the spill stream in a binary form and removed from the memory.
+ * Snapshots are then read back sequentially in ObservableSnapshotStorage::visit. Alternatively, if snapshots are
+ * stored elsewhere anyway, only the most recent ones can be kept (see
+ * ObservableSnapshotStorage::limitToRecentSnapshots).
+ */
+class ObservableSnapshotStorage {
+public:
+    /**
+     * @brief A single snapshot of observable values.
+     */
+    struct Snapshot {
+        std::size_t cycleNumber{};
+        std::vector<double> intervalValues;
+        std::vector<std::string> nominalValues;
+    };
+
+private:
+    // Deque, so that the oldest snapshot can be dropped in constant time (see limitToRecentSnapshots)
+    std::deque<Snapshot> inMemorySnapshots;
+    std::unique_ptr<std::iostream> spillStream;
+    std::size_t maxInMemorySnapshots{};
+    bool dropOldSnapshots{};
+    std::size_t numSpilledSnapshots{};
+    std::streamoff spillStreamEnd{};
+
+    void spill();
+    static void writeSnapshot(std::ostream &out, const Snapshot &snapshot);
+    static Snapshot readSnapshot(std::istream &in);
+
+public:
+    /**
+     * @brief Adds a new snapshot. If a spill stream is attached and the number of snapshots kept in memory exceeds
+     * the limit, they are moved to the spill stream. If the storage is limited to recent snapshots, the oldest one is
+     * dropped instead.
+     */
+    void add(Snapshot snapshot);
+
+    /**
+     * @brief Calls @a visitor for all stored snapshots in the order they were added. Spilled snapshots are read back
+     * from the spill stream.
+     */
+    void visit(const std::function<void(const Snapshot &)> &visitor) const;
+
+    /**
+     * @brief Returns the total number of stored snapshots (both in memory and spilled).
+     */
+    [[nodiscard]] std::size_t size() const { return this->numSpilledSnapshots + this->inMemorySnapshots.size(); }
+
+    /**
+     * @brief Returns the number of snapshots currently kept in memory.
+     */
+    [[nodiscard]] std::size_t getNumInMemorySnapshots() const { return this->inMemorySnapshots.size(); }
+
+    /**
+     * @brief Attaches a spill stream @a spillStream_, which has to support reading, writing and seeking, and limits
+     * the number of snapshots kept in memory to @a maxInMemorySnapshots_.
+     * @details The previous content of the stream is ignored and overwritten. Snapshots already present in the memory
+     * stay there until the limit is exceeded. If a spill stream was already attached, all snapshots are first moved
+     * back to memory, as in ObservableSnapshotStorage::detachSpillStream.
+     */
+    void attachSpillStream(std::unique_ptr<std::iostream> spillStream_, std::size_t maxInMemorySnapshots_);
+
+    /**
+     * @brief Detaches the spill stream and returns it. All spilled snapshots are read back to memory.
+     */
+    std::unique_ptr<std::iostream> detachSpillStream();
+
+    /**
+     * @brief Keeps only @a maxSnapshots most recent snapshots - older ones are dropped and will not be visited.
+     * @details It should be used only when snapshots are already stored elsewhere (for example on the fly to a file).
+     * If a spill stream was attached, it is detached first, as in ObservableSnapshotStorage::detachSpillStream.
+     */
+    void limitToRecentSnapshots(std::size_t maxSnapshots);
+
+    /**
+     * @brief Returns @a true if a spill stream is attached.
+     */
+    [[nodiscard]] bool hasSpillStream() const { return this->spillStream != nullptr; }
+
+    /**
+     * @brief Removes all snapshots. The content of the spill stream is not erased, but will be overwritten.
+     */
+    void clear();
+
+    /**
+     * @brief Returns an approximate number of bytes used by snapshots kept in memory.
+     */
+    [[nodiscard]] std::size_t getMemoryUsage() const;
+};
+
+
+#endif //RAMPACK_OBSERVABLESNAPSHOTSTORAGE_H
@@ -5,28 +5,36 @@
 #include <ostream>
 #include <iterator>
 #include <chrono>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
 
 #include "ObservablesCollector.h"
+#include "observables/correlation/CompoundPairConsumer.h"
 #include "utils/Utils.h"
 #include "utils/GetlineBackwards.h"
 
 
 void ObservablesCollector::addObservable(std::shared_ptr<Observable> observable, std::size_t observableType) {
-    if (!this->snapshotValues.empty())
-        ExpectsMsg(snapshotValues.front().empty(), "Cannot add a new observable if snapshots are already captured");
+    ExpectsMsg(this->snapshotStorage.size() == 0, "Cannot add a new observable if snapshots are already captured");
     if (!this->averagingValues.empty())
-        ExpectsMsg(averagingValues.front().empty(), "Cannot add a new observable if snapshots are already captured");
+        ExpectsMsg(averagingValues.front().getNumSamples() == 0, "Cannot add a new observable if snapshots are already captured");
 
     auto intervalHeader = observable->getIntervalHeader();
     auto nominalHeader = observable->getNominalHeader();
 
+    auto incrementalObservable = std::dynamic_pointer_cast<IncrementalObservable>(observable);
+    if (incrementalObservable != nullptr)
+        this->incrementalObservables.push_back(std::move(incrementalObservable));
+
     this->observables.push_back(std::move(observable));
     std::size_t observableIndex = this->observables.size() - 1;
 
     if (observableType & ObservableType::SNAPSHOT) {
         this->snapshotHeader.insert(this->snapshotHeader.end(), intervalHeader.begin(), intervalHeader.end());
         this->snapshotHeader.insert(this->snapshotHeader.end(), nominalHeader.begin(), nominalHeader.end());
-        this->snapshotValues.resize(this->snapshotHeader.size());
+        this->isSnapshotColumnNominal.insert(this->isSnapshotColumnNominal.end(), intervalHeader.size(), false);
+        this->isSnapshotColumnNominal.insert(this->isSnapshotColumnNominal.end(), nominalHeader.size(), true);
         this->snapshotObservablesIndices.push_back(observableIndex);
     }
 
@@ -34,77 +42,232 @@ void ObservablesCollector::addObservable(std::shared_ptr<Observable> observable,
         this->averagingHeader.insert(this->averagingHeader.end(), intervalHeader.begin(), intervalHeader.end());
         this->averagingValues.resize(this->averagingHeader.size());
         this->averagingObservablesIndices.push_back(observableIndex);
+        this->averagingMicroseconds.push_back(0);
     }
 
     if (observableType & ObservableType::INLINE)
         this->inlineObservablesIndices.push_back(observableIndex);
 }
 
+void ObservablesCollector::attachIncrementalObservables(Packing &packing) {
+    for (const auto &incrementalObservable : this->incrementalObservables)
+        packing.attachListener(*incrementalObservable);
+}
+
+void ObservablesCollector::detachIncrementalObservables(Packing &packing) {
+    for (const auto &incrementalObservable : this->incrementalObservables)
+        packing.detachListener(*incrementalObservable);
+}
+
 void ObservablesCollector::addBulkObservable(std::shared_ptr<BulkObservable> observable) {
-    this->bulkObservables.push_back(std::move(observable));
+    this->bulkObservables.push_back(observable);
+    this->bulkSamplingData.emplace_back();
+    if (observable->requiresEquallySpacedSnapshots()) {
+        this->equallySpacedBulkSnapshots = true;
+        this->bulkSamplingInterval = 1;
+    }
+
+    auto pairObservable = std::dynamic_pointer_cast<PairBulkObservable>(observable);
+    if (pairObservable == nullptr)
+        this->nonPairBulkObservables.push_back(std::move(observable));
+    else
+        this->addPairBulkObservable(std::move(pairObservable));
+}
+
+void ObservablesCollector::addPairBulkObservable(std::shared_ptr<PairBulkObservable> observable) {
+    const auto &enumerator = observable->getPairEnumerator();
+    for (auto &group : this->pairBulkObservableGroups) {
+        const auto &groupEnumerator = group.front()->getPairEnumerator();
+        if (groupEnumerator.getSignatureName() == enumerator.getSignatureName()
+            && groupEnumerator.isEquivalent(enumerator))
+        {
+            group.push_back(std::move(observable));
+            return;
+        }
+    }
+
+    this->pairBulkObservableGroups.push_back({std::move(observable)});
 }
 
 void ObservablesCollector::addSnapshot(const Packing &packing, std::size_t cycleNumber, const ShapeTraits &shapeTraits)
 {
     auto start = std::chrono::high_resolution_clock::now();
 
-    this->snapshotCycleNumbers.push_back(cycleNumber);
-    std::size_t valueIndex{};
+    ObservableSnapshotStorage::Snapshot snapshot;
+    snapshot.cycleNumber = cycleNumber;
     for (std::size_t observableIndex : this->snapshotObservablesIndices) {
         auto &observable = *this->observables[observableIndex];
         observable.calculate(packing, this->temperature, this->pressure, shapeTraits);
 
         auto intervalValues = observable.getIntervalValues();
-        for (double value : intervalValues) {
-            Assert(valueIndex < this->snapshotValues.size());
-            std::ostringstream ostr;
-            ostr.precision(std::numeric_limits<double>::max_digits10);
-            ostr << value;
-            this->snapshotValues[valueIndex].push_back(ostr.str());
-            valueIndex++;
-        }
-
+        snapshot.intervalValues.insert(snapshot.intervalValues.end(), intervalValues.begin(), intervalValues.end());
         auto nominalValues = observable.getNominalValues();
-        for (const auto &value : nominalValues) {
-            Assert(valueIndex < this->snapshotValues.size());
-            this->snapshotValues[valueIndex].push_back(value);
-            valueIndex++;
-        }
+        snapshot.nominalValues.insert(snapshot.nominalValues.end(), nominalValues.begin(), nominalValues.end());
     }
-    Assert(valueIndex == this->snapshotValues.size());
+    Assert(snapshot.intervalValues.size() + snapshot.nominalValues.size() == this->snapshotHeader.size());
 
     auto end = std::chrono::high_resolution_clock::now();
-    this->computationMicroseconds += std::chrono::duration<double, std::micro>(end - start).count();
+    this->snapshotMicroseconds += std::chrono::duration<double, std::micro>(end - start).count();
 
     if (this->onTheFlyOut != nullptr) {
-        this->doPrintSnapshotValues(*this->onTheFlyOut, this->snapshotCycleNumbers.size() - 1);
+        this->doPrintSnapshotValues(*this->onTheFlyOut, snapshot);
         this->onTheFlyLastCycleNumber = cycleNumber;
     }
 
+    this->snapshotStorage.add(std::move(snapshot));
 }
 
 void ObservablesCollector::addAveragingValues(const Packing &packing, const ShapeTraits &shapeTraits) {
-    auto start = std::chrono::high_resolution_clock::now();
+    using clock = std::chrono::high_resolution_clock;
+    auto start = clock::now();
 
     std::size_t valueIndex{};
-    for (std::size_t observableIndex : this->averagingObservablesIndices) {
-        auto &observable = *this->observables[observableIndex];
+    for (std::size_t i{}; i < this->averagingObservablesIndices.size(); i++) {
+        auto observableStart = clock::now();
+
+        auto &observable = *this->observables[this->averagingObservablesIndices[i]];
         observable.calculate(packing, this->temperature, this->pressure, shapeTraits);
 
         auto values = observable.getIntervalValues();
         for (double value : values) {
             Assert(valueIndex < this->averagingValues.size());
-            this->averagingValues[valueIndex].push_back(value);
+            this->averagingValues[valueIndex].add(value);
             valueIndex++;
         }
+
+        auto observableEnd = clock::now();
+        this->averagingMicroseconds[i]
+            += std::chrono::duration<double, std::micro>(observableEnd - observableStart).count();
     }
     Assert(valueIndex == this->averagingValues.size());
 
-    for (const auto &bulkObservable : this->bulkObservables)
+    this->averagingSnapshotsSinceBulkSampling++;
+    if (this->averagingSnapshotsSinceBulkSampling >= this->bulkSamplingInterval) {
+        this->addBulkObservablesSnapshot(packing, shapeTraits);
+        this->averagingSnapshotsSinceBulkSampling = 0;
+    }
+    this->updateBulkSamplingInterval();
+
+    auto end = clock::now();
+    this->averagingValuesMicroseconds += std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+void ObservablesCollector::addBulkObservablesSnapshot(const Packing &packing, const ShapeTraits &shapeTraits) {
+    using clock = std::chrono::high_resolution_clock;
+
+    for (const auto &bulkObservable : this->nonPairBulkObservables) {
+        auto start = clock::now();
         bulkObservable->addSnapshot(packing, this->temperature, this->pressure, shapeTraits);
+        auto end = clock::now();
 
-    auto end = std::chrono::high_resolution_clock::now();
-    this->computationMicroseconds += std::chrono::duration<double, std::micro>(end - start).count();
+        auto &samplingData = this->bulkSamplingData[this->getBulkObservableIndex(*bulkObservable)];
+        samplingData.microseconds += std::chrono::duration<double, std::micro>(end - start).count();
+        samplingData.numSamples++;
+    }
+
+    for (const auto &group : this->pairBulkObservableGroups) {
+        auto start = clock::now();
+        this->addPairBulkObservablesSnapshot(group, packing, shapeTraits);
+        auto end = clock::now();
+
+        // The time of the shared pair enumeration is split evenly between all observables from the group
+        double microseconds = std::chrono::duration<double, std::micro>(end - start).count();
+        for (const auto &bulkObservable : group) {
+            auto &samplingData = this->bulkSamplingData[this->getBulkObservableIndex(*bulkObservable)];
+            samplingData.microseconds += microseconds / static_cast<double>(group.size());
+            samplingData.numSamples++;
+        }
+    }
+}
+
+std::size_t ObservablesCollector::getBulkObservableIndex(const BulkObservable &bulkObservable) const {
+    auto it = std::find_if(this->bulkObservables.begin(), this->bulkObservables.end(),
+                           [&bulkObservable](const auto &observable) { return observable.get() == &bulkObservable; });
+    Assert(it != this->bulkObservables.end());
+    return it - this->bulkObservables.begin();
+}
+
+double ObservablesCollector::getMaxAutocorrelationTime() const {
+    double maxAutocorrelationTime = 0.5;
+    for (const auto &averager : this->averagingValues)
+        maxAutocorrelationTime = std::max(maxAutocorrelationTime, averager.getIntegratedAutocorrelationTime());
+    return maxAutocorrelationTime;
+}
+
+void ObservablesCollector::updateBulkSamplingInterval() {
+    if (this->bulkSamplingMaxInterval == 1 || this->equallySpacedBulkSnapshots)
+        return;
+
+    // Samples separated by 2 integrated autocorrelation times are roughly independent
+    double decorrelationInterval = std::ceil(2 * this->getMaxAutocorrelationTime());
+    auto maxInterval = static_cast<double>(this->bulkSamplingMaxInterval);
+    this->bulkSamplingInterval = static_cast<std::size_t>(std::clamp(decorrelationInterval, 1., maxInterval));
+}
+
+void ObservablesCollector::setBulkSamplingMaxInterval(std::size_t maxInterval) {
+    Expects(maxInterval > 0);
+    this->bulkSamplingMaxInterval = maxInterval;
+    this->bulkSamplingInterval = 1;
+    this->updateBulkSamplingInterval();
+}
+
+std::vector<ObservablesCollector::SamplingEfficiencyData> ObservablesCollector::getSamplingEfficiency() const {
+    auto calculateEfficiency = [](double effectiveSamples, double microseconds) {
+        return microseconds == 0 ? 0 : effectiveSamples / microseconds * 1e6;
+    };
+
+    std::vector<SamplingEfficiencyData> efficiencyData;
+    efficiencyData.reserve(this->averagingObservablesIndices.size() + this->bulkObservables.size());
+
+    std::size_t numAveragingSnapshots = this->averagingValues.empty() ? 0 : this->averagingValues.front().getNumSamples();
+    std::size_t valueIndex{};
+    for (std::size_t i{}; i < this->averagingObservablesIndices.size(); i++) {
+        const auto &observable = *this->observables[this->averagingObservablesIndices[i]];
+        std::size_t numValues = observable.getIntervalHeader().size();
+        double autocorrelationTime = 0.5;
+        for (std::size_t j{}; j < numValues; j++, valueIndex++) {
+            double valueAutocorrelationTime = this->averagingValues[valueIndex].getIntegratedAutocorrelationTime();
+            autocorrelationTime = std::max(autocorrelationTime, valueAutocorrelationTime);
+        }
+
+        double effectiveSamples = static_cast<double>(numAveragingSnapshots) / std::max(1., 2*autocorrelationTime);
+        efficiencyData.push_back({observable.getName(), numAveragingSnapshots, autocorrelationTime,
+                                  this->averagingMicroseconds[i],
+                                  calculateEfficiency(effectiveSamples, this->averagingMicroseconds[i])});
+    }
+
+    // For bulk observables, the largest autocorrelation time of ordinary observables is used
+    double maxAutocorrelationTime = this->getMaxAutocorrelationTime();
+    double maxEffectiveSamples = static_cast<double>(numAveragingSnapshots) / std::max(1., 2*maxAutocorrelationTime);
+    for (std::size_t i{}; i < this->bulkObservables.size(); i++) {
+        const auto &samplingData = this->bulkSamplingData[i];
+        double effectiveSamples = std::min(static_cast<double>(samplingData.numSamples), maxEffectiveSamples);
+        efficiencyData.push_back({this->bulkObservables[i]->getSignatureName(), samplingData.numSamples,
+                                  maxAutocorrelationTime, samplingData.microseconds,
+                                  calculateEfficiency(effectiveSamples, samplingData.microseconds)});
+    }
+
+    return efficiencyData;
+}
+
+void ObservablesCollector::addPairBulkObservablesSnapshot(
+        const std::vector<std::shared_ptr<PairBulkObservable>> &group, const Packing &packing,
+        const ShapeTraits &shapeTraits)
+{
+    Assert(!group.empty());
+    if (group.size() == 1) {
+        group.front()->addSnapshot(packing, this->temperature, this->pressure, shapeTraits);
+        return;
+    }
+
+    std::vector<PairConsumer *> consumers;
+    consumers.reserve(group.size());
+    for (const auto &observable : group)
+        consumers.push_back(observable.get());
+    CompoundPairConsumer compoundConsumer(std::move(consumers));
+    group.front()->getPairEnumerator().enumeratePairs(packing, shapeTraits, compoundConsumer);
+    for (const auto &observable : group)
+        observable->finishSnapshot(packing, this->temperature, this->pressure, shapeTraits);
 }
 
 std::string ObservablesCollector::generateInlineObservablesString(const Packing &packing,
@@ -158,40 +321,54 @@ void ObservablesCollector::printInlineObservable(unsigned long observableIdx, co
     Assert(valueNum == totalValues);
 
     auto end = std::chrono::high_resolution_clock::now();
-    this->computationMicroseconds += std::chrono::duration<double, std::micro>(end - start).count();
+    this->inlineMicroseconds += std::chrono::duration<double, std::micro>(end - start).count();
 }
 
 void ObservablesCollector::clear() {
-    this->snapshotCycleNumbers.clear();
-    for (auto &singleSet : this->snapshotValues)
-        singleSet.clear();
-    for (auto &singleSet : this->averagingValues)
-        singleSet.clear();
+    this->snapshotStorage.clear();
+    for (auto &averager : this->averagingValues)
+        averager.clear();
     for (const auto &bulkObservable : this->bulkObservables)
         bulkObservable->clear();
-    this->computationMicroseconds = 0;
+    this->snapshotMicroseconds = 0;
+    this->averagingValuesMicroseconds = 0;
+    this->inlineMicroseconds = 0;
+
+    std::fill(this->averagingMicroseconds.begin(), this->averagingMicroseconds.end(), 0);
+    std::fill(this->bulkSamplingData.begin(), this->bulkSamplingData.end(), BulkSamplingData{});
+    this->averagingSnapshotsSinceBulkSampling = 0;
+    this->bulkSamplingInterval = 1;
 }
 
 void ObservablesCollector::printSnapshots(std::ostream &out, bool printHeader) const {
-    Expects(!this->snapshotValues.empty());
-
-    // Consistency check - all observables should have the same number of entries as number of recorder cycles
-    std::size_t numSnapshots = this->snapshotCycleNumbers.size();
-    for (const auto &singleSet : this->snapshotValues)
-        Assert(singleSet.size() == numSnapshots);
+    Expects(!this->snapshotHeader.empty());
 
     if (printHeader)
         this->doPrintSnapshotHeader(out);
 
-    for (std::size_t i{}; i < numSnapshots; i++)
-        this->doPrintSnapshotValues(out, i);
+    this->snapshotStorage.visit([this, &out](const ObservableSnapshotStorage::Snapshot &snapshot) {
+        this->doPrintSnapshotValues(out, snapshot);
+    });
 }
 
-void ObservablesCollector::doPrintSnapshotValues(std::ostream &out, std::size_t snapshotIdx) const{
-    out << this->snapshotCycleNumbers[snapshotIdx] << " ";
-    for (const auto &observableValues : this->snapshotValues)
-        out << observableValues[snapshotIdx] << " ";
+void ObservablesCollector::doPrintSnapshotValues(std::ostream &out,
+                                                 const ObservableSnapshotStorage::Snapshot &snapshot) const
+{
+    // Consistency check - all snapshots should have values for all columns in the header
+    Assert(snapshot.intervalValues.size() + snapshot.nominalValues.size() == this->isSnapshotColumnNominal.size());
+
+    auto oldPrecision = out.precision(std::numeric_limits<double>::max_digits10);
+    out << snapshot.cycleNumber << " ";
+    auto intervalIt = snapshot.intervalValues.begin();
+    auto nominalIt = snapshot.nominalValues.begin();
+    for (bool isNominal : this->isSnapshotColumnNominal) {
+        if (isNominal)
+            out << *(nominalIt++) << " ";
+        else
+            out << *(intervalIt++) << " ";
+    }
     out << std::endl;
+    out.precision(oldPrecision);
     Expects(out.good());
 }
 
@@ -206,11 +383,50 @@ std::vector<ObservablesCollector::ObservableData> ObservablesCollector::getFlatt
     std::vector<ObservableData> flatValues(this->averagingHeader.size());
     for (std::size_t i{}; i < flatValues.size(); i++) {
         flatValues[i].name = this->averagingHeader[i];
-        flatValues[i].quantity.calculateFromSamples(this->averagingValues[i]);
+        flatValues[i].quantity = this->averagingValues[i].getQuantity();
     }
     return flatValues;
 }
 
+std::vector<ObservablesCollector::ObservableData> ObservablesCollector::getFlattenedBlockedAverageValues() const {
+    std::vector<ObservableData> flatValues(this->averagingHeader.size());
+    for (std::size_t i{}; i < flatValues.size(); i++) {
+        flatValues[i].name = this->averagingHeader[i];
+        flatValues[i].quantity = this->averagingValues[i].getBlockedQuantity();
+    }
+    return flatValues;
+}
+
+void ObservablesCollector::storeAveragingState(std::ostream &out) const {
+    out << this->averagingValues.size() << std::endl;
+    for (std::size_t i{}; i < this->averagingValues.size(); i++) {
+        out << std::quoted(this->averagingHeader[i]) << std::endl;
+        this->averagingValues[i].store(out);
+    }
+}
+
+void ObservablesCollector::restoreAveragingState(std::istream &in) {
+    std::size_t numValues{};
+    in >> numValues;
+    ValidateMsg(in, "Broken averaging state: number of values");
+    ValidateMsg(numValues == this->averagingValues.size(),
+                "Averaging state contains " + std::to_string(numValues) + " values, while "
+                + std::to_string(this->averagingValues.size()) + " were expected");
+
+    std::vector<BlockAverager> restoredValues(numValues);
+    for (std::size_t i{}; i < numValues; i++) {
+        std::string name;
+        in >> std::quoted(name);
+        ValidateMsg(in, "Broken averaging state: value " + std::to_string(i) + " name");
+        ValidateMsg(name == this->averagingHeader[i],
+                    "Averaging state value " + std::to_string(i) + " is named '" + name + "', while '"
+                    + this->averagingHeader[i] + "' was expected");
+        restoredValues[i].restore(in);
+    }
+
+    this->averagingValues = std::move(restoredValues);
+}
+
 std::vector<ObservablesCollector::ObservableGroupData> ObservablesCollector::getGroupedAverageValues() const {
     std::vector<ObservableGroupData> groupedValues;
     groupedValues.reserve(this->averagingObservablesIndices.size());
@@ -242,13 +458,16 @@ void ObservablesCollector::setThermodynamicParameters(double temperature_, doubl
 
 std::size_t ObservablesCollector::getMemoryUsage() const {
     std::size_t bytes{};
-    for (const auto &vec : this->snapshotValues)
-        bytes += get_vector_memory_usage(vec);
-    for (const auto &vec : this->averagingValues)
-        bytes += get_vector_memory_usage(vec);
+    bytes += this->snapshotStorage.getMemoryUsage();
+    for (const auto &averager : this->averagingValues)
+        bytes += averager.getMemoryUsage();
     return bytes;
 }
 
+std::size_t ObservablesCollector::estimateAveragingMemoryUsage(std::size_t numSamples) const {
+    return this->averagingValues.size() * BlockAverager::estimateMemoryUsage(numSamples);
+}
+
 void ObservablesCollector::visitBulkObservables(std::function<void(const BulkObservable &)> visitor) const {
     for (const auto &bulkObservable : this->bulkObservables)
         visitor(*bulkObservable);
@@ -272,6 +491,20 @@ void ObservablesCollector::attachOnTheFlyOutput(std::unique_ptr<std::iostream> o
     this->onTheFlyOut->seekp(0, std::ios::end);
 }
 
+void ObservablesCollector::attachSnapshotSpillStream(std::unique_ptr<std::iostream> spillStream,
+                                                     std::size_t maxInMemorySnapshots)
+{
+    this->snapshotStorage.attachSpillStream(std::move(spillStream), maxInMemorySnapshots);
+}
+
+std::unique_ptr<std::iostream> ObservablesCollector::detachSnapshotSpillStream() {
+    return this->snapshotStorage.detachSpillStream();
+}
+
+void ObservablesCollector::limitToRecentSnapshots(std::size_t maxSnapshots) {
+    this->snapshotStorage.limitToRecentSnapshots(maxSnapshots);
+}
+
 void ObservablesCollector::verifyOnTheFlyOutputHeader() {
     Assert(this->onTheFlyOut != nullptr);
 
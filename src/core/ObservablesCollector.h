@@ -13,7 +13,11 @@
 #include "ShapeTraits.h"
 #include "Observable.h"
 #include "BulkObservable.h"
+#include "IncrementalObservable.h"
+#include "ObservableSnapshotStorage.h"
+#include "observables/correlation/PairBulkObservable.h"
 #include "utils/Quantity.h"
+#include "utils/BlockAverager.h"
 
 
 /**
@@ -21,32 +25,61 @@
  * @details The class is responsible for three possible observable scopes: snapshots, inline printing on the standard
  * output and ensemble averaged values (see ObservableType). A single Observable can be used in an arbitrary combination
  * of all those scopes. BulkObservable -s are always calculated only in the averaging phase (where the system is already
- * thermalized).
+ * thermalized). Averaged values are not stored - they are accumulated online using BlockAverager. Snapshot values are
+ * kept in a binary form in ObservableSnapshotStorage and formatted only when printed - the memory usage can be bounded
+ * by attaching a spill stream (see ObservablesCollector::attachSnapshotSpillStream) or, if snapshots are stored on the
+ * fly, by keeping only the most recent ones (see ObservablesCollector::limitToRecentSnapshots). PairBulkObservable -s using
+ * equivalent PairEnumerator -s (see PairEnumerator::isEquivalent) are grouped and pairs are enumerated only once per
+ * snapshot for the whole group. IncrementalObservable -s can be attached to the packing using
+ * ObservablesCollector::attachIncrementalObservables, which makes their evaluation cheap.
  */
 class ObservablesCollector {
 private:
+    struct BulkSamplingData {
+        std::size_t numSamples{};
+        double microseconds{};
+    };
+
     double temperature{};
     double pressure{};
 
     std::vector<std::shared_ptr<Observable>> observables;
+    std::vector<std::shared_ptr<IncrementalObservable>> incrementalObservables;
     std::vector<std::shared_ptr<BulkObservable>> bulkObservables;
+    std::vector<std::shared_ptr<BulkObservable>> nonPairBulkObservables;
+    std::vector<std::vector<std::shared_ptr<PairBulkObservable>>> pairBulkObservableGroups;
+    std::vector<double> averagingMicroseconds;
+    std::vector<BulkSamplingData> bulkSamplingData;
+    std::size_t bulkSamplingMaxInterval = 1;
+    std::size_t bulkSamplingInterval = 1;
+    bool equallySpacedBulkSnapshots{};
+    std::size_t averagingSnapshotsSinceBulkSampling{};
     std::vector<std::string> snapshotHeader;
     std::vector<std::string> averagingHeader;
     std::vector<std::size_t> inlineObservablesIndices;
     std::vector<std::size_t> snapshotObservablesIndices;
     std::vector<std::size_t> averagingObservablesIndices;
-    std::vector<std::size_t> snapshotCycleNumbers;
-    std::vector<std::vector<std::string>> snapshotValues;
-    std::vector<std::vector<double>> averagingValues;
+    std::vector<bool> isSnapshotColumnNominal;
+    ObservableSnapshotStorage snapshotStorage;
+    std::vector<BlockAverager> averagingValues;
     std::size_t onTheFlyLastCycleNumber{};
     std::unique_ptr<std::iostream> onTheFlyOut;
 
-    mutable double computationMicroseconds{};
+    double snapshotMicroseconds{};
+    double averagingValuesMicroseconds{};
+    mutable double inlineMicroseconds{};
 
+    void addPairBulkObservable(std::shared_ptr<PairBulkObservable> observable);
+    void addBulkObservablesSnapshot(const Packing &packing, const ShapeTraits &shapeTraits);
+    [[nodiscard]] std::size_t getBulkObservableIndex(const BulkObservable &bulkObservable) const;
+    [[nodiscard]] double getMaxAutocorrelationTime() const;
+    void updateBulkSamplingInterval();
+    void addPairBulkObservablesSnapshot(const std::vector<std::shared_ptr<PairBulkObservable>> &group,
+                                        const Packing &packing, const ShapeTraits &shapeTraits);
     void printInlineObservable(unsigned long observableIdx, const Packing &packing, const ShapeTraits &shapeTraits,
                                std::ostringstream &out) const;
     void doPrintSnapshotHeader(std::ostream &out, bool printNewline = true) const;
-    void doPrintSnapshotValues(std::ostream &out, std::size_t snapshotIdx) const;
+    void doPrintSnapshotValues(std::ostream &out, const ObservableSnapshotStorage::Snapshot &snapshot) const;
     void verifyOnTheFlyOutputHeader();
     void findOnTheFlyLastCycleNumber();
 
@@ -69,6 +102,37 @@ public:
         std::vector<ObservableData> observableData;
     };
 
+    /**
+     * @brief Sampling statistics of a single Observable or BulkObservable in the averaging phase.
+     */
+    struct SamplingEfficiencyData {
+        /**
+         * @brief Observable::getName or BulkObservable::getSignatureName.
+         */
+        std::string name;
+
+        /**
+         * @brief The number of times the observable was calculated.
+         */
+        std::size_t numSamples{};
+
+        /**
+         * @brief Integrated autocorrelation time in units of averaging snapshots (for BulkObservable -s, the largest
+         * one among Observable -s is used).
+         */
+        double autocorrelationTime{};
+
+        /**
+         * @brief The total time consumed by calculations of the observable.
+         */
+        double computationMicroseconds{};
+
+        /**
+         * @brief The number of statistically independent samples gathered per one second of calculations.
+         */
+        double effectiveSamplesPerSecond{};
+    };
+
     /**
      * @brief Scopes of the observables, which can be bitwise-or combined
      */
@@ -92,9 +156,47 @@ public:
 
     /**
      * @brief Adds BulkObservable to be computed in the averaging phase.
+     * @details If @a observable is PairBulkObservable and its PairEnumerator is equivalent to the one of an already
+     * added PairBulkObservable, they will share a single pair enumeration.
      */
     void addBulkObservable(std::shared_ptr<BulkObservable> observable);
 
+    /**
+     * @brief Attaches all IncrementalObservable -s to @a packing (see Packing::attachListener), so that they are
+     * updated after each change of the packing instead of being recalculated from scratch.
+     * @details ObservablesCollector::detachIncrementalObservables should be called when the packing is no longer
+     * simulated.
+     */
+    void attachIncrementalObservables(Packing &packing);
+
+    /**
+     * @brief Detaches all IncrementalObservable -s previously attached to @a packing using
+     * ObservablesCollector::attachIncrementalObservables.
+     */
+    void detachIncrementalObservables(Packing &packing);
+
+    /**
+     * @brief Enables adaptive sampling of BulkObservable -s: they are calculated only on every n-th invocation of
+     * addAveragingValues(), where n is between 1 and @a maxInterval.
+     * @details The interval n is chosen to be roughly the decorrelation time (twice the integrated autocorrelation
+     * time) of ObservableType::AVERAGING Observable -s, estimated on the fly (see BlockAverager). For @a maxInterval
+     * equal 1 (the default), BulkObservable -s are calculated on each invocation. The same happens if any
+     * BulkObservable requires equally spaced snapshots (see BulkObservable::requiresEquallySpacedSnapshots()).
+     */
+    void setBulkSamplingMaxInterval(std::size_t maxInterval);
+
+    /**
+     * @brief Returns the current interval (in units of addAveragingValues() invocations) between calculations of
+     * BulkObservable -s (see setBulkSamplingMaxInterval()).
+     */
+    [[nodiscard]] std::size_t getBulkSamplingInterval() const { return this->bulkSamplingInterval; }
+
+    /**
+     * @brief Returns the sampling efficiency of all ObservableType::AVERAGING Observable -s followed by all
+     * BulkObservable -s.
+     */
+    [[nodiscard]] std::vector<SamplingEfficiencyData> getSamplingEfficiency() const;
+
     /**
      * @brief Sets the thermodynamic parameters: @a temperature_ and @a pressure_ to be used when calculating observable
      * values.
@@ -136,6 +238,33 @@ public:
      */
     std::unique_ptr<std::iostream> detachOnTheFlyOutput();
 
+    /**
+     * @brief Bounds the memory used by snapshots to @a maxInMemorySnapshots snapshots - older ones are moved in a
+     * binary form to @a spillStream and read back from it in printSnapshots().
+     * @details The stream has to support reading, writing and seeking (for example a temporary file) and its previous
+     * content is overwritten. See ObservableSnapshotStorage::attachSpillStream.
+     */
+    void attachSnapshotSpillStream(std::unique_ptr<std::iostream> spillStream, std::size_t maxInMemorySnapshots);
+
+    /**
+     * @brief Detaches and returns the snapshot spill stream (or @a nullptr if nothing is attached). All spilled
+     * snapshots are moved back to memory.
+     */
+    std::unique_ptr<std::iostream> detachSnapshotSpillStream();
+
+    /**
+     * @brief Keeps only @a maxSnapshots most recent snapshots in memory - older ones are dropped and are not printed
+     * in printSnapshots().
+     * @details It is meant for snapshots which are already stored on the fly (see attachOnTheFlyOutput()). See
+     * ObservableSnapshotStorage::limitToRecentSnapshots.
+     */
+    void limitToRecentSnapshots(std::size_t maxSnapshots);
+
+    /**
+     * @brief Returns the number of snapshots captured since the last clear().
+     */
+    [[nodiscard]] std::size_t getNumSnapshots() const { return this->snapshotStorage.size(); }
+
     /**
      * @brief Generate a short inline string with current interval and nominal values of all ObservableType::INLINE
      * observables.
@@ -176,6 +305,26 @@ public:
      */
     [[nodiscard]] std::vector<ObservableGroupData> getGroupedAverageValues() const;
 
+    /**
+     * @brief Calculate the average value of interval values of ObservableType::AVERAGING observables with errors
+     * estimated using the blocking method (see BlockAverager::getBlockedQuantity), which takes into account
+     * correlations between consecutive averaging samples, and return as a flat vector.
+     */
+    [[nodiscard]] std::vector<ObservableData> getFlattenedBlockedAverageValues() const;
+
+    /**
+     * @brief Stores the state of averaging of ObservableType::AVERAGING observables to @a out stream, so that it can be
+     * resumed later using ObservablesCollector::restoreAveragingState.
+     */
+    void storeAveragingState(std::ostream &out) const;
+
+    /**
+     * @brief Restores the state of averaging previously stored using ObservablesCollector::storeAveragingState from
+     * @a in stream.
+     * @details The observables added to the collector have to be the same as when the state was stored.
+     */
+    void restoreAveragingState(std::istream &in);
+
     /**
      * @brief The method iterates over all BulkObservables and calls @a visitor function passing them as the argument.
      */
@@ -185,12 +334,43 @@ public:
      * @brief Returns the total time used to calculate observable values in microseconds.
      * @details ObservablesCollector::clear resets the timer.
      */
-    [[nodiscard]] double getComputationMicroseconds() const { return this->computationMicroseconds; }
+    [[nodiscard]] double getComputationMicroseconds() const {
+        return this->snapshotMicroseconds + this->averagingValuesMicroseconds + this->inlineMicroseconds;
+    }
+
+    /**
+     * @brief Returns the part of getComputationMicroseconds() spent in ObservablesCollector::addSnapshot.
+     */
+    [[nodiscard]] double getSnapshotMicroseconds() const { return this->snapshotMicroseconds; }
+
+    /**
+     * @brief Returns the part of getComputationMicroseconds() spent in ObservablesCollector::addAveragingValues
+     * (including bulk observables).
+     */
+    [[nodiscard]] double getAveragingValuesMicroseconds() const { return this->averagingValuesMicroseconds; }
+
+    /**
+     * @brief Returns the part of getComputationMicroseconds() spent in
+     * ObservablesCollector::generateInlineObservablesString.
+     */
+    [[nodiscard]] double getInlineMicroseconds() const { return this->inlineMicroseconds; }
 
     /**
      * @brief Returns the estimated number of bytes used by observable data.
      */
     [[nodiscard]] std::size_t getMemoryUsage() const;
+
+    /**
+     * @brief Returns the estimated number of bytes used by observable snapshots kept in memory (the part of
+     * ObservablesCollector::getMemoryUsage growing linearly with the number of snapshots).
+     */
+    [[nodiscard]] std::size_t getSnapshotMemoryUsage() const { return this->snapshotStorage.getMemoryUsage(); }
+
+    /**
+     * @brief Returns the estimated number of bytes, which will be used by the state of averaging of
+     * ObservableType::AVERAGING observables after @a numSamples averaging samples.
+     */
+    [[nodiscard]] std::size_t estimateAveragingMemoryUsage(std::size_t numSamples) const;
 };
 
 
@@ -0,0 +1,76 @@
+#include <cmath>
+#include <numeric>
+#include <sstream>
+
+#include "OverlapSanitizer.h"
+#include "utils/Exceptions.h"
+
+
+OverlapSanitizer::OverlapSanitizer(std::size_t checkEvery, double particleFraction, unsigned long seed)
+        : checkEvery{checkEvery}, particleFraction{particleFraction}, mt(seed)
+{
+    Expects(checkEvery > 0);
+    Expects(particleFraction > 0 && particleFraction <= 1);
+}
+
+void OverlapSanitizer::check(const Packing &packing, const Interaction &interaction, std::size_t cycle) {
+    if (cycle % this->checkEvery != 0)
+        return;
+
+    if (packing.isOverlapCountingEnabled()) {
+        this->analysis.run(packing, [&interaction, cycle](const Packing &snapshot) {
+            OverlapSanitizer::checkOverlapCount(snapshot, interaction, cycle);
+        });
+    } else {
+        // Particles are sampled in the simulation thread, so the sample is reproducible for a given seed
+        this->analysis.run(packing, [&interaction, cycle, particleIndices = this->sampleParticles(packing.size())]
+                                    (const Packing &snapshot)
+        {
+            OverlapSanitizer::checkParticles(snapshot, interaction, particleIndices, cycle);
+        });
+    }
+    this->numChecks++;
+}
+
+std::vector<std::size_t> OverlapSanitizer::sampleParticles(std::size_t numParticles) {
+    std::vector<std::size_t> particleIndices;
+    if (this->particleFraction == 1) {
+        particleIndices.resize(numParticles);
+        std::iota(particleIndices.begin(), particleIndices.end(), 0);
+        return particleIndices;
+    }
+
+    // Particles are sampled with replacement - duplicates are harmless and it does not require O(N) memory
+    auto numSampled = static_cast<std::size_t>(std::ceil(this->particleFraction * static_cast<double>(numParticles)));
+    std::uniform_int_distribution<std::size_t> particleDistribution(0, numParticles - 1);
+    particleIndices.reserve(numSampled);
+    for (std::size_t i{}; i < numSampled; i++)
+        particleIndices.push_back(particleDistribution(this->mt));
+    return particleIndices;
+}
+
+void OverlapSanitizer::checkParticles(const Packing &snapshot, const Interaction &interaction,
+                                      const std::vector<std::size_t> &particleIndices, std::size_t cycle)
+{
+    for (auto particleIdx : particleIndices) {
+        if (snapshot.countParticleOverlaps(particleIdx, interaction) == 0)
+            continue;
+
+        std::ostringstream msg;
+        msg << "Overlap sanitizer: particle " << particleIdx << " overlaps with another particle or a wall in cycle ";
+        msg << cycle;
+        AssertThrow(msg.str());
+    }
+}
+
+void OverlapSanitizer::checkOverlapCount(const Packing &snapshot, const Interaction &interaction, std::size_t cycle) {
+    std::size_t cachedOverlaps = snapshot.getCachedNumberOfOverlaps();
+    std::size_t actualOverlaps = snapshot.countTotalOverlaps(interaction, false);
+    if (cachedOverlaps == actualOverlaps)
+        return;
+
+    std::ostringstream msg;
+    msg << "Overlap sanitizer: the cached number of overlaps " << cachedOverlaps << " differs from the actual one ";
+    msg << actualOverlaps << " in cycle " << cycle;
+    AssertThrow(msg.str());
+}
@@ -0,0 +1,68 @@
+#ifndef RAMPACK_OVERLAPSANITIZER_H
+#define RAMPACK_OVERLAPSANITIZER_H
+
+#include <random>
+#include <vector>
+
+#include "AsynchronousAnalysis.h"
+#include "Interaction.h"
+
+
+/**
+ * @brief Runtime validation of the packing integrity - it checks in the background if the packing does not contain
+ * overlaps which should have been rejected by the simulation.
+ * @details Every @a checkEvery cycles a snapshot of the packing is taken and checked in a separate thread (see
+ * AsynchronousAnalysis), so the simulation is slowed down only by taking the snapshot. If overlaps are not counted
+ * in the packing (see Packing::toggleOverlapCounting), only a random sample of particles (a given fraction of all of
+ * them) is checked against their neighbours, which allows continuous checking in production runs at low cost. If
+ * overlaps are counted (in overlap relaxation), the cached number of overlaps is compared with a full recount, so the
+ * fraction of particles is not used. If an inconsistency is found, AssertionException is thrown by one of the next
+ * invocations of OverlapSanitizer::check or by OverlapSanitizer::wait.
+ */
+class OverlapSanitizer {
+private:
+    std::size_t checkEvery{};
+    double particleFraction{};
+    std::mt19937 mt;
+    AsynchronousAnalysis analysis;
+    std::size_t numChecks{};
+
+    [[nodiscard]] std::vector<std::size_t> sampleParticles(std::size_t numParticles);
+
+    static void checkParticles(const Packing &snapshot, const Interaction &interaction,
+                               const std::vector<std::size_t> &particleIndices, std::size_t cycle);
+    static void checkOverlapCount(const Packing &snapshot, const Interaction &interaction, std::size_t cycle);
+
+public:
+    /**
+     * @brief Creates the sanitizer checking the packing every @a checkEvery cycles.
+     * @param checkEvery how often the packing should be checked
+     * @param particleFraction the fraction of particles (from (0, 1] range) sampled in a single check
+     * @param seed the seed of the RNG used to sample particles
+     */
+    OverlapSanitizer(std::size_t checkEvery, double particleFraction, unsigned long seed);
+
+    /**
+     * @brief If @a cycle is a multiple of @a checkEvery, it starts the check of @a packing for @a interaction in the
+     * background.
+     */
+    void check(const Packing &packing, const Interaction &interaction, std::size_t cycle);
+
+    /**
+     * @brief Waits for the pending check and throws AssertionException if it has found any inconsistency.
+     */
+    void wait() { this->analysis.wait(); }
+
+    /**
+     * @brief Returns the number of started checks.
+     */
+    [[nodiscard]] std::size_t getNumChecks() const { return this->numChecks; }
+
+    /**
+     * @brief Returns the time the simulation has spent taking snapshots and waiting for checks, in microseconds.
+     */
+    [[nodiscard]] double getWaitingMicroseconds() const { return this->analysis.getWaitingMicroseconds(); }
+};
+
+
+#endif //RAMPACK_OVERLAPSANITIZER_H
@@ -40,6 +40,10 @@ namespace {
         [[nodiscard]] double getDistance2(const Vector<3> &position1, const Vector<3> &position2) const override {
             return (position2 + this->translation - position1).norm2();
         }
+
+        [[nodiscard]] std::unique_ptr<BoundaryConditions> clone() const override {
+            return std::make_unique<HardcodedTranslation>(*this);
+        }
     };
 }
 
@@ -62,13 +66,15 @@ Packing::Packing(std::unique_ptr<BoundaryConditions> bc, std::size_t moveThreads
     this->shapes.resize(this->moveThreads);    // temp shapes at the back so that Packing::end() works
     this->lastAlteredParticleIdx.resize(this->moveThreads, 0);
     this->lastMoveOverlapDeltas.resize(this->moveThreads, 0);
+    this->lastMoveEnergyDeltas.resize(this->moveThreads, 0);
+    this->overlapRejectionStatistics.resize(this->moveThreads);
 }
 
 void Packing::reset(std::vector<Shape> newShapes, const TriclinicBox &newBox, const Interaction &newInteraction) {
     Expects(newBox.getVolume() != 0);
     Expects(newInteraction.getRangeRadius() > 0);
     Expects(!newShapes.empty());
-    Expects(Packing::areShapesWithinBox(newShapes, newBox));
+    Expects(Packing::areShapesWithinBox(newShapes, newBox, this->scalingThreads));
 
     this->shapes = std::move(newShapes);
     this->box = newBox;
@@ -77,10 +83,48 @@ void Packing::reset(std::vector<Shape> newShapes, const TriclinicBox &newBox, co
     this->shapes.resize(this->shapes.size() + this->moveThreads);    // temp shapes at the back
     this->lastAlteredParticleIdx.resize(this->moveThreads, 0);
     this->lastMoveOverlapDeltas.resize(this->moveThreads, 0);
+    this->lastMoveEnergyDeltas.resize(this->moveThreads, 0);
+    this->overlapRejectionStatistics.resize(this->moveThreads);
+    this->lastOverlapPartners.assign(this->size(), NO_OVERLAP_PARTNER);
     this->bc->setBox(this->box);
     this->setupForInteraction(newInteraction);
 }
 
+void Packing::takeSnapshot(Packing &snapshot) const {
+    Expects(&snapshot != this);
+
+    snapshot.shapes = this->shapes;
+    snapshot.interactionCentres = this->interactionCentres;
+    snapshot.absoluteInteractionCentres = this->absoluteInteractionCentres;
+    snapshot.box = this->box;
+    snapshot.bc = this->bc->clone();
+    snapshot.neighbourGrid = this->neighbourGrid;
+    snapshot.interactionRange = this->interactionRange;
+    snapshot.numInteractionCentres = this->numInteractionCentres;
+    snapshot.centreSizeClasses = this->centreSizeClasses;
+    snapshot.sizeClassRanges = this->sizeClassRanges;
+    snapshot.sizeClassGrids = this->sizeClassGrids;
+    snapshot.moveThreads = this->moveThreads;
+    snapshot.scalingThreads = this->scalingThreads;
+    snapshot.hasAnyWalls = this->hasAnyWalls;
+    snapshot.hasWall = this->hasWall;
+    snapshot.overlapCounting = this->overlapCounting;
+    snapshot.numOverlaps = this->numOverlaps;
+
+    snapshot.lastAlteredParticleIdx.resize(snapshot.moveThreads, 0);
+    snapshot.lastMoveOverlapDeltas.resize(snapshot.moveThreads, 0);
+    snapshot.lastMoveEnergyDeltas.resize(snapshot.moveThreads, 0);
+    snapshot.overlapRejectionStatistics.resize(snapshot.moveThreads);
+    snapshot.lastOverlapPartners.assign(snapshot.size(), NO_OVERLAP_PARTNER);
+    snapshot.notifyPackingReset();
+}
+
+std::unique_ptr<Packing> Packing::createSnapshot() const {
+    auto snapshot = std::make_unique<Packing>(this->bc->clone(), this->moveThreads, this->scalingThreads);
+    this->takeSnapshot(*snapshot);
+    return snapshot;
+}
+
 double Packing::tryTranslation(std::size_t particleIdx, Vector<3> translation, const Interaction &interaction,
                                std::optional<ActiveDomain> boundaries)
 {
@@ -100,13 +144,7 @@ double Packing::tryTranslation(std::size_t particleIdx, Vector<3> translation, c
         this->recalculateAbsoluteInteractionCentres(tempParticleIdx);
     }
 
-    double overlapEnergy = this->calculateMoveOverlapEnergy(particleIdx, tempParticleIdx, interaction);
-    if (overlapEnergy != 0)
-        return overlapEnergy;
-
-    double initialEnergy = this->calculateParticleEnergy(particleIdx, particleIdx, interaction);
-    double finalEnergy = this->calculateParticleEnergy(particleIdx, tempParticleIdx, interaction);
-    return finalEnergy - initialEnergy;
+    return this->calculateMoveEnergy(particleIdx, tempParticleIdx, interaction);
 }
 
 double Packing::tryRotation(std::size_t particleIdx, const Matrix<3, 3> &rotation, const Interaction &interaction) {
@@ -124,13 +162,7 @@ double Packing::tryRotation(std::size_t particleIdx, const Matrix<3, 3> &rotatio
         this->recalculateAbsoluteInteractionCentres(tempParticleIdx);
     }
 
-    double overlapEnergy = this->calculateMoveOverlapEnergy(particleIdx, tempParticleIdx, interaction);
-    if (overlapEnergy != 0)
-        return overlapEnergy;
-
-    double initialEnergy = this->calculateParticleEnergy(particleIdx, particleIdx, interaction);
-    double finalEnergy = this->calculateParticleEnergy(particleIdx, tempParticleIdx, interaction);
-    return finalEnergy - initialEnergy;
+    return this->calculateMoveEnergy(particleIdx, tempParticleIdx, interaction);
 }
 
 double Packing::tryMove(std::size_t particleIdx, const Vector<3> &translation, const Matrix<3, 3> &rotation,
@@ -154,13 +186,7 @@ double Packing::tryMove(std::size_t particleIdx, const Vector<3> &translation, c
         this->recalculateAbsoluteInteractionCentres(tempParticleIdx);
     }
 
-    double overlapEnergy = this->calculateMoveOverlapEnergy(particleIdx, tempParticleIdx, interaction);
-    if (overlapEnergy != 0)
-        return overlapEnergy;
-
-    double initialEnergy = this->calculateParticleEnergy(particleIdx, particleIdx, interaction);
-    double finalEnergy = this->calculateParticleEnergy(particleIdx, tempParticleIdx, interaction);
-    return finalEnergy - initialEnergy;
+    return this->calculateMoveEnergy(particleIdx, tempParticleIdx, interaction);
 }
 
 double Packing::tryScaling(const std::array<double, 3> &scaleFactor, const Interaction &interaction) {
@@ -182,10 +208,25 @@ double Packing::tryScaling(const TriclinicBox &newBox, const Interaction &intera
     this->bc->setBox(this->box);
     for (auto &shape : *this)
         shape.setPosition(this->box.relativeToAbsolute(this->lastBox.absoluteToRelative(shape.getPosition())));
-    std::swap(this->neighbourGrid, this->tempNeighbourGrid);
     if (this->numInteractionCentres != 0)
         this->recalculateAbsoluteInteractionCentres();
-    this->rebuildNeighbourGrid();
+
+    // The old neighbour grid is either rescaled in place or kept intact in tempNeighbourGrid for revertScaling()
+    this->lastScalingRescaledNeighbourGrid = this->tryRescalingNeighbourGrid();
+    if (!this->lastScalingRescaledNeighbourGrid) {
+        std::swap(this->neighbourGrid, this->tempNeighbourGrid);
+        std::swap(this->sizeClassGrids, this->tempSizeClassGrids);
+        this->rebuildNeighbourGrid();
+    }
+
+    double energy = this->calculateScalingEnergy(initialEnergy, interaction);
+    this->notifyBoxScaled(this->lastBox, this->lastScalingEnergyDelta);
+    return energy;
+}
+
+double Packing::calculateScalingEnergy(double initialEnergy, const Interaction &interaction) {
+    // Without a soft part, the energy is always zero, so the change is known even if the energy is not calculated
+    this->lastScalingEnergyDelta = interaction.hasSoftPart() ? std::numeric_limits<double>::quiet_NaN() : 0;
 
     static constexpr double INF = std::numeric_limits<double>::infinity();
     if (interaction.hasHardPart()) {
@@ -204,7 +245,8 @@ double Packing::tryScaling(const TriclinicBox &newBox, const Interaction &intera
     }
 
     double finalEnergy = this->getTotalEnergy(interaction);
-    return finalEnergy - initialEnergy;
+    this->lastScalingEnergyDelta = finalEnergy - initialEnergy;
+    return this->lastScalingEnergyDelta;
 }
 
 const Shape &Packing::operator[](std::size_t i) const {
@@ -233,6 +275,10 @@ double Packing::getNumberDensity() const {
 
 void Packing::acceptTranslation() {
     std::size_t lastAlteredIdx = this->lastAlteredParticleIdx[OMP_THREAD_ID];
+    // The old shape is needed only by listeners
+    std::optional<Shape> oldShape;
+    if (!this->listeners.empty())
+        oldShape = this->shapes[lastAlteredIdx];
     if (this->neighbourGrid.has_value()) {
         if (this->numInteractionCentres == 0)
             this->neighbourGrid->remove(lastAlteredIdx, this->shapes[lastAlteredIdx].getPosition());
@@ -255,10 +301,16 @@ void Packing::acceptTranslation() {
         #pragma omp critical
         this->numOverlaps += this->lastMoveOverlapDeltas[OMP_THREAD_ID];
     }
+
+    this->notifyParticleMoved(lastAlteredIdx, oldShape);
 }
 
 void Packing::acceptRotation() {
     std::size_t lastAlteredIdx = this->lastAlteredParticleIdx[OMP_THREAD_ID];
+    // The old shape is needed only by listeners
+    std::optional<Shape> oldShape;
+    if (!this->listeners.empty())
+        oldShape = this->shapes[lastAlteredIdx];
     if (this->neighbourGrid.has_value() && this->numInteractionCentres != 0)
         this->removeInteractionCentresFromNeighbourGrid(lastAlteredIdx);
 
@@ -273,10 +325,16 @@ void Packing::acceptRotation() {
         #pragma omp critical
         this->numOverlaps += this->lastMoveOverlapDeltas[OMP_THREAD_ID];
     }
+
+    this->notifyParticleMoved(lastAlteredIdx, oldShape);
 }
 
 void Packing::acceptMove() {
     std::size_t lastAlteredIdx = this->lastAlteredParticleIdx[OMP_THREAD_ID];
+    // The old shape is needed only by listeners
+    std::optional<Shape> oldShape;
+    if (!this->listeners.empty())
+        oldShape = this->shapes[lastAlteredIdx];
     if (this->neighbourGrid.has_value()) {
         if (this->numInteractionCentres == 0)
             this->neighbourGrid->remove(lastAlteredIdx, this->shapes[lastAlteredIdx].getPosition());
@@ -299,6 +357,8 @@ void Packing::acceptMove() {
         #pragma omp critical
         this->numOverlaps += this->lastMoveOverlapDeltas[OMP_THREAD_ID];
     }
+
+    this->notifyParticleMoved(lastAlteredIdx, oldShape);
 }
 
 double Packing::calculateMoveOverlapEnergy(size_t particleIdx, size_t tempParticleIdx, const Interaction &interaction) {
@@ -322,17 +382,40 @@ double Packing::calculateMoveOverlapEnergy(size_t particleIdx, size_t tempPartic
     return 0;
 }
 
+double Packing::calculateMoveEnergy(std::size_t particleIdx, std::size_t tempParticleIdx,
+                                    const Interaction &interaction)
+{
+    auto &lastMoveEnergyDelta = this->lastMoveEnergyDeltas[OMP_THREAD_ID];
+    // Without a soft part, the energy is always zero, so the change is known even if the energy is not calculated
+    lastMoveEnergyDelta = interaction.hasSoftPart() ? std::numeric_limits<double>::quiet_NaN() : 0;
+
+    double overlapEnergy = this->calculateMoveOverlapEnergy(particleIdx, tempParticleIdx, interaction);
+    if (overlapEnergy != 0)
+        return overlapEnergy;
+
+    double initialEnergy = this->calculateParticleEnergy(particleIdx, particleIdx, interaction);
+    double finalEnergy = this->calculateParticleEnergy(particleIdx, tempParticleIdx, interaction);
+    lastMoveEnergyDelta = finalEnergy - initialEnergy;
+    return lastMoveEnergyDelta;
+}
+
 void Packing::addInteractionCentresToNeighbourGrid(std::size_t particleIdx) {
     for (size_t i{}; i < this->numInteractionCentres; i++) {
         std::size_t centreIdx = particleIdx * this->numInteractionCentres + i;
-        this->neighbourGrid->add(centreIdx, this->absoluteInteractionCentres[centreIdx]);
+        const auto &pos = this->absoluteInteractionCentres[centreIdx];
+        this->neighbourGrid->add(centreIdx, pos);
+        if (!this->sizeClassGrids.empty())
+            this->sizeClassGrids[this->centreSizeClasses[i]].add(centreIdx, pos);
     }
 }
 
 void Packing::removeInteractionCentresFromNeighbourGrid(std::size_t particleIdx) {
     for (size_t i{}; i < this->numInteractionCentres; i++) {
         std::size_t centreIdx = particleIdx * this->numInteractionCentres + i;
-        this->neighbourGrid->remove(centreIdx, this->absoluteInteractionCentres[centreIdx]);
+        const auto &pos = this->absoluteInteractionCentres[centreIdx];
+        this->neighbourGrid->remove(centreIdx, pos);
+        if (!this->sizeClassGrids.empty())
+            this->sizeClassGrids[this->centreSizeClasses[i]].remove(centreIdx, pos);
     }
 }
 
@@ -361,29 +444,47 @@ void Packing::rotateTempInteractionCentres(const Matrix<3, 3> &rotation) {
 }
 
 void Packing::revertScaling() {
+    TriclinicBox revertedBox = this->box;
     this->shapes = this->lastShapes;
     this->box = this->lastBox;
     this->bc->setBox(this->box);
-    std::swap(this->neighbourGrid, this->tempNeighbourGrid);
+    if (this->lastScalingRescaledNeighbourGrid) {
+        this->neighbourGrid->rescale(this->box);
+        for (auto &grid : this->sizeClassGrids)
+            grid.rescale(this->box);
+    } else {
+        std::swap(this->neighbourGrid, this->tempNeighbourGrid);
+        std::swap(this->sizeClassGrids, this->tempSizeClassGrids);
+    }
     if (this->numInteractionCentres != 0)
         this->recalculateAbsoluteInteractionCentres();
     this->numOverlaps = this->lastScalingNumOverlaps;
+    this->notifyBoxScaled(revertedBox, -this->lastScalingEnergyDelta);
 }
 
 std::size_t Packing::countParticleOverlaps(std::size_t originalParticleIdx, std::size_t tempParticleIdx,
                                            const Interaction &interaction, bool earlyExit) const
 {
     std::size_t overlapsCounted{};
+    std::size_t pairChecks{};
+
+    // When looking for any overlap, the last overlap partner is the most likely one, so it is checked first. Then,
+    // the nearest NG cells are searched first
+    if (earlyExit && this->overlapsWithLastPartner(originalParticleIdx, tempParticleIdx, interaction, pairChecks))
+        return 1;
 
     if (this->neighbourGrid.has_value()) {
         if (this->numInteractionCentres == 0) {
             Vector<3> pos = this->shapes[tempParticleIdx].getPosition();
-            for (const auto &cell : this->neighbourGrid->getNeighbouringCells(pos)) {
+            auto neighbouringCells = earlyExit ? this->neighbourGrid->getNeighbouringCellsNearestFirst(pos)
+                                               : this->neighbourGrid->getNeighbouringCells(pos);
+            for (const auto &cell : neighbouringCells) {
                 HardcodedTranslation cellTranslation(cell.getTranslation());
                 for (auto j: cell.getNeighbours()) {
                     if (originalParticleIdx == j)
                         continue;
 
+                    pairChecks++;
                     if (interaction.overlapBetween(this->shapes[tempParticleIdx].getPosition(),
                                                    this->shapes[tempParticleIdx].getOrientation(),
                                                    0,
@@ -392,20 +493,22 @@ std::size_t Packing::countParticleOverlaps(std::size_t originalParticleIdx, std:
                                                    0,
                                                    cellTranslation))
                     {
-                        if (earlyExit) return 1;
+                        if (earlyExit) {
+                            this->recordOverlapRejection(originalParticleIdx, j, pairChecks, false);
+                            return 1;
+                        }
                         overlapsCounted++;
                     }
                 }
             }
         } else {
-            for (std::size_t centre1{}; centre1 < this->numInteractionCentres; centre1++) {
-                std::size_t centreOverlaps = this->countInteractionCentreOverlapsWithNG(originalParticleIdx,
-                                                                                        tempParticleIdx, centre1,
-                                                                                        interaction, earlyExit);
-                if (earlyExit && centreOverlaps > 0)
-                    return centreOverlaps;
-
-                overlapsCounted += centreOverlaps;
+            std::size_t overlapPartner = NO_OVERLAP_PARTNER;
+            overlapsCounted = this->countAllInteractionCentreOverlapsWithNG(originalParticleIdx, tempParticleIdx,
+                                                                            interaction, earlyExit, pairChecks,
+                                                                            overlapPartner);
+            if (earlyExit && overlapsCounted > 0) {
+                this->recordOverlapRejection(originalParticleIdx, overlapPartner, pairChecks, false);
+                return overlapsCounted;
             }
         }
     } else {
@@ -413,21 +516,57 @@ std::size_t Packing::countParticleOverlaps(std::size_t originalParticleIdx, std:
             if (originalParticleIdx == j)
                 continue;
             std::size_t particlesOverlaps = this->countOverlapsBetweenParticlesWithoutNG(tempParticleIdx, j,
-                                                                                         interaction, earlyExit);
-            if (earlyExit && particlesOverlaps)
+                                                                                         interaction, earlyExit,
+                                                                                         pairChecks);
+            if (earlyExit && particlesOverlaps) {
+                this->recordOverlapRejection(originalParticleIdx, j, pairChecks, false);
                 return particlesOverlaps;
+            }
 
             overlapsCounted += particlesOverlaps;
         }
     }
 
     std::size_t wallOverlaps{};
-    if (this->hasAnyWalls)
+    if (this->hasAnyWalls) {
         wallOverlaps = this->countParticleWallOverlaps(tempParticleIdx, interaction, earlyExit);
+        if (earlyExit && wallOverlaps > 0)
+            this->recordOverlapRejection(originalParticleIdx, NO_OVERLAP_PARTNER, pairChecks, false);
+    }
 
     return overlapsCounted + wallOverlaps;
 }
 
+bool Packing::overlapsWithLastPartner(std::size_t originalParticleIdx, std::size_t tempParticleIdx,
+                                      const Interaction &interaction, std::size_t &pairChecks) const
+{
+    std::size_t partnerIdx = this->lastOverlapPartners[originalParticleIdx];
+    if (partnerIdx == NO_OVERLAP_PARTNER)
+        return false;
+
+    // Partner is checked using the minimal image convention - in very small boxes, an overlap with another image may
+    // be missed, but it will be found later in the regular search
+    if (this->countOverlapsBetweenParticlesWithoutNG(tempParticleIdx, partnerIdx, interaction, true, pairChecks) == 0)
+        return false;
+
+    this->recordOverlapRejection(originalParticleIdx, partnerIdx, pairChecks, true);
+    return true;
+}
+
+void Packing::recordOverlapRejection(std::size_t originalParticleIdx, std::size_t partnerIdx, std::size_t pairChecks,
+                                     bool partnerHit) const
+{
+    // Wall overlaps do not overwrite the last partner - it may still be the culprit in the next move
+    if (partnerIdx != NO_OVERLAP_PARTNER)
+        this->lastOverlapPartners[originalParticleIdx] = partnerIdx;
+
+    auto &statistics = this->overlapRejectionStatistics[OMP_THREAD_ID];
+    statistics.rejectedMoves++;
+    statistics.pairChecks += pairChecks;
+    if (partnerHit)
+        statistics.partnerHits++;
+}
+
 std::size_t Packing::countTotalOverlapsNGCellHelper(const std::array<std::size_t, 3> &coord,
                                                     const Interaction &interaction, bool earlyExit) const
 {
@@ -456,6 +595,9 @@ std::size_t Packing::countTotalOverlapsNGCellHelper(const std::array<std::size_t
             for (const auto &cell : this->neighbourGrid->getNeighbouringCells(coord, true)) {
                 HardcodedTranslation cellTranslation(cell.getTranslation());
                 for (auto particleIdx2 : cell.getNeighbours()) { // NOLINT(readability-use-anyofallof)
+                    // Periodic images of the particle itself are not its neighbours (as in countParticleOverlaps)
+                    if (particleIdx1 == particleIdx2)
+                        continue;
                     const auto &pos2 = this->shapes[particleIdx2].getPosition();
                     const auto &orientation2 = this->shapes[particleIdx2].getOrientation();
                     if (interaction.overlapBetween(pos1, orientation1, 0, pos2, orientation2, 0, cellTranslation)) {
@@ -545,8 +687,9 @@ std::size_t Packing::countTotalOverlaps(const Interaction &interaction, bool ear
     } else {
         for (std::size_t i{}; i < this->size(); i++) {
             for (std::size_t j = i + 1; j < this->size(); j++) {
+                std::size_t pairChecks{};
                 std::size_t particleOverlaps = this->countOverlapsBetweenParticlesWithoutNG(i, j, interaction,
-                                                                                            earlyExit);
+                                                                                            earlyExit, pairChecks);
                 if (earlyExit && particleOverlaps > 0)
                     return particleOverlaps;
 
@@ -579,12 +722,28 @@ std::size_t Packing::countWallOverlaps(const Interaction &interaction, bool earl
     return wallOverlaps;
 }
 
+std::size_t Packing::countParticleOverlaps(std::size_t particleIdx, const Interaction &interaction,
+                                           bool earlyExit) const
+{
+    Expects(particleIdx < this->size());
+
+    std::size_t overlapsCounted = this->countParticleOverlaps(particleIdx, particleIdx, interaction, earlyExit);
+    if (earlyExit && overlapsCounted > 0)
+        return overlapsCounted;
+
+    if (this->hasAnyWalls)
+        overlapsCounted += this->countParticleWallOverlaps(particleIdx, interaction, earlyExit);
+    return overlapsCounted;
+}
+
 std::size_t Packing::countOverlapsBetweenParticlesWithoutNG(std::size_t tempParticleIdx, std::size_t anotherParticleIdx,
-                                                            const Interaction &interaction, bool earlyExit) const
+                                                            const Interaction &interaction, bool earlyExit,
+                                                            std::size_t &pairChecks) const
 {
     std::size_t overlapsCounted{};
 
     if (this->numInteractionCentres == 0) {
+        pairChecks++;
         if (interaction.overlapBetween(this->shapes[tempParticleIdx].getPosition(),
                                        this->shapes[tempParticleIdx].getOrientation(),
                                        0,
@@ -605,6 +764,7 @@ std::size_t Packing::countOverlapsBetweenParticlesWithoutNG(std::size_t tempPart
                 std::size_t centreIdx2 = anotherParticleIdx * this->numInteractionCentres + centre2;
                 const auto &pos2 = this->absoluteInteractionCentres[centreIdx2];
                 const auto &orientation2 = this->shapes[anotherParticleIdx].getOrientation();
+                pairChecks++;
                 if (interaction.overlapBetween(pos1, orientation1, centre1, pos2, orientation2, centre2, *this->bc)) {
                     if (earlyExit) return 1;
                     overlapsCounted++;
@@ -616,18 +776,100 @@ std::size_t Packing::countOverlapsBetweenParticlesWithoutNG(std::size_t tempPart
     return overlapsCounted;
 }
 
+bool Packing::isIntraMoveParallel() const {
+    // Nested teams would only oversubscribe the threads already performing moves in parallel
+    return this->intraMoveThreads > 1 && this->numInteractionCentres > 1 && !OMP_IN_PARALLEL;
+}
+
+std::size_t Packing::countAllInteractionCentreOverlapsWithNG(std::size_t originalParticleIdx,
+                                                             std::size_t tempParticleIdx,
+                                                             const Interaction &interaction, bool earlyExit,
+                                                             std::size_t &pairChecks,
+                                                             std::size_t &overlapPartner) const
+{
+    if (!this->isIntraMoveParallel()) {
+        std::size_t overlapsCounted{};
+        for (std::size_t centre{}; centre < this->numInteractionCentres; centre++) {
+            std::size_t centreOverlaps = this->countInteractionCentreOverlapsWithNG(originalParticleIdx,
+                                                                                    tempParticleIdx, centre,
+                                                                                    interaction, earlyExit,
+                                                                                    pairChecks, overlapPartner);
+            if (earlyExit && centreOverlaps > 0)
+                return centreOverlaps;
+
+            overlapsCounted += centreOverlaps;
+        }
+        return overlapsCounted;
+    }
+
+    // When looking for any overlap, the thread which has found one raises the flag and all threads skip the remaining
+    // centres. The result is the same as in the serial loop, only the reported partner may be a different one
+    std::size_t overlapsCounted{};
+    std::size_t teamPairChecks{};
+    std::atomic<bool> overlapFound{};
+    #pragma omp parallel for default(none) shared(originalParticleIdx, tempParticleIdx, interaction, earlyExit) \
+            shared(overlapFound, overlapPartner) reduction(+ : overlapsCounted, teamPairChecks) schedule(dynamic) \
+            num_threads(this->intraMoveThreads)
+    for (std::size_t centre = 0; centre < this->numInteractionCentres; centre++) {
+        if (earlyExit && overlapFound.load(std::memory_order_relaxed))
+            continue;
+
+        std::size_t centrePartner{};
+        std::size_t centreOverlaps = this->countInteractionCentreOverlapsWithNG(originalParticleIdx, tempParticleIdx,
+                                                                                centre, interaction, earlyExit,
+                                                                                teamPairChecks, centrePartner);
+        overlapsCounted += centreOverlaps;
+        if (earlyExit && centreOverlaps > 0 && !overlapFound.exchange(true))
+            overlapPartner = centrePartner;
+    }
+
+    pairChecks += teamPairChecks;
+    if (earlyExit)
+        return overlapFound ? 1 : 0;
+    return overlapsCounted;
+}
+
 std::size_t Packing::countInteractionCentreOverlapsWithNG(std::size_t originalParticleIdx, std::size_t tempParticleIdx,
                                                           std::size_t centre, const Interaction &interaction,
-                                                          bool earlyExit) const
+                                                          bool earlyExit, std::size_t &pairChecks,
+                                                          std::size_t &overlapPartner) const
 {
     Expects(this->neighbourGrid.has_value());
 
+    if (this->sizeClassGrids.empty()) {
+        return this->countInteractionCentreOverlapsInGrid(originalParticleIdx, tempParticleIdx, centre,
+                                                          *this->neighbourGrid, interaction, earlyExit, pairChecks,
+                                                          overlapPartner);
+    }
+
+    // Size classes are disjoint, so each pair of centres is still checked exactly once
+    std::size_t overlapsCounted{};
+    for (const auto &grid : this->sizeClassGrids) {
+        std::size_t gridOverlaps = this->countInteractionCentreOverlapsInGrid(originalParticleIdx, tempParticleIdx,
+                                                                              centre, grid, interaction, earlyExit,
+                                                                              pairChecks, overlapPartner);
+        if (earlyExit && gridOverlaps > 0)
+            return gridOverlaps;
+
+        overlapsCounted += gridOverlaps;
+    }
+    return overlapsCounted;
+}
+
+std::size_t Packing::countInteractionCentreOverlapsInGrid(std::size_t originalParticleIdx,
+                                                          std::size_t tempParticleIdx, std::size_t centre,
+                                                          const NeighbourGrid &grid, const Interaction &interaction,
+                                                          bool earlyExit, std::size_t &pairChecks,
+                                                          std::size_t &overlapPartner) const
+{
     std::size_t overlapsCounted{};
 
     std::size_t centreIdx1 = tempParticleIdx * this->numInteractionCentres + centre;
     auto pos1 = this->absoluteInteractionCentres[centreIdx1];
     const auto &orientation1 = this->shapes[tempParticleIdx].getOrientation();
-    for (const auto &cell : this->neighbourGrid->getNeighbouringCells(pos1)) {
+    auto neighbouringCells = earlyExit ? grid.getNeighbouringCellsNearestFirst(pos1)
+                                       : grid.getNeighbouringCells(pos1);
+    for (const auto &cell : neighbouringCells) {
         HardcodedTranslation cellTranslation(cell.getTranslation());
         for (auto centreIdx2 : cell.getNeighbours()) { // NOLINT(readability-use-anyofallof)
             std::size_t j = centreIdx2 / this->numInteractionCentres;
@@ -636,8 +878,12 @@ std::size_t Packing::countInteractionCentreOverlapsWithNG(std::size_t originalPa
             std::size_t centre2 = centreIdx2 % this->numInteractionCentres;
             const auto &pos2 = this->absoluteInteractionCentres[centreIdx2];
             const auto &orientation2 = this->shapes[j].getOrientation();
+            pairChecks++;
             if (interaction.overlapBetween(pos1, orientation1, centre, pos2, orientation2, centre2, cellTranslation)){
-                if (earlyExit) return 1;
+                if (earlyExit) {
+                    overlapPartner = j;
+                    return 1;
+                }
                 overlapsCounted++;
             }
         }
@@ -672,10 +918,8 @@ double Packing::calculateParticleEnergy(std::size_t originalParticleIdx, std::si
                 }
             }
         } else {
-            for (std::size_t centre1{}; centre1 < this->numInteractionCentres; centre1++) {
-                energy += calculateInteractionCentreEnergyWithNG(originalParticleIdx, tempParticleIdx, centre1,
-                                                                 interaction);
-            }
+            energy = this->calculateAllInteractionCentreEnergyWithNG(originalParticleIdx, tempParticleIdx,
+                                                                     interaction);
         }
     } else {
         for (std::size_t j{}; j < this->size(); j++) {
@@ -737,17 +981,58 @@ double Packing::calculateEnergyBetweenParticlesWithoutNG(std::size_t tempParticl
     return energy;
 }
 
+double Packing::calculateAllInteractionCentreEnergyWithNG(std::size_t originalParticleIdx,
+                                                         std::size_t tempParticleIdx,
+                                                         const Interaction &interaction) const
+{
+    double energy{};
+    if (!this->isIntraMoveParallel()) {
+        for (std::size_t centre{}; centre < this->numInteractionCentres; centre++)
+            energy += this->calculateInteractionCentreEnergyWithNG(originalParticleIdx, tempParticleIdx, centre,
+                                                                   interaction);
+        return energy;
+    }
+
+    // Energies of centres are summed in the same order as in the serial loop, so the result is exactly the same
+    std::vector<double> centreEnergies(this->numInteractionCentres);
+    #pragma omp parallel for default(none) shared(originalParticleIdx, tempParticleIdx, interaction, centreEnergies) \
+            schedule(dynamic) num_threads(this->intraMoveThreads)
+    for (std::size_t centre = 0; centre < this->numInteractionCentres; centre++) {
+        centreEnergies[centre] = this->calculateInteractionCentreEnergyWithNG(originalParticleIdx, tempParticleIdx,
+                                                                              centre, interaction);
+    }
+
+    for (double centreEnergy : centreEnergies)
+        energy += centreEnergy;
+    return energy;
+}
+
 double Packing::calculateInteractionCentreEnergyWithNG(size_t originalParticleIdx, std::size_t tempParticleIdx,
                                                        std::size_t centre, const Interaction &interaction) const
 {
     Expects(this->neighbourGrid.has_value());
 
+    if (this->sizeClassGrids.empty())
+        return this->calculateInteractionCentreEnergyInGrid(originalParticleIdx, tempParticleIdx, centre,
+                                                            *this->neighbourGrid, interaction);
+
+    double energy{};
+    for (const auto &grid : this->sizeClassGrids)
+        energy += this->calculateInteractionCentreEnergyInGrid(originalParticleIdx, tempParticleIdx, centre, grid,
+                                                               interaction);
+    return energy;
+}
+
+double Packing::calculateInteractionCentreEnergyInGrid(std::size_t originalParticleIdx, std::size_t tempParticleIdx,
+                                                       std::size_t centre, const NeighbourGrid &grid,
+                                                       const Interaction &interaction) const
+{
     double energy{};
 
     std::size_t centreIdx1 = tempParticleIdx * this->numInteractionCentres + centre;
     auto pos1 = this->absoluteInteractionCentres[centreIdx1];
     const auto &orientation1 = this->shapes[tempParticleIdx].getOrientation();
-    for (const auto &cell : this->neighbourGrid->getNeighbouringCells(pos1)) {
+    for (const auto &cell : grid.getNeighbouringCells(pos1)) {
         HardcodedTranslation cellTranslation(cell.getTranslation());
         for (auto centreIdx2 : cell.getNeighbours()) {
             size_t j = centreIdx2 / this->numInteractionCentres;
@@ -788,6 +1073,9 @@ double Packing::getTotalEnergyNGCellHelper(const std::array<std::size_t, 3> &coo
             for (const auto &cell : this->neighbourGrid->getNeighbouringCells(coord, true)) {
                 HardcodedTranslation cellTranslation(cell.getTranslation());
                 for (auto particleIdx2 : cell.getNeighbours()) { // NOLINT(readability-use-anyofallof)
+                    // Periodic images of the particle itself are not its neighbours (as in calculateParticleEnergy)
+                    if (particleIdx1 == particleIdx2)
+                        continue;
                     const auto &pos2 = this->shapes[particleIdx2].getPosition();
                     const auto &orientation2 = this->shapes[particleIdx2].getOrientation();
                     energy += interaction.calculateEnergyBetween(pos1, orientation1, 0, pos2, orientation2, 0,
@@ -855,30 +1143,114 @@ double Packing::getParticleEnergyFluctuations(const Interaction &interaction) co
     return doubleEnergy / 2;    // We divide by 2, because each interaction was counted twice
 }
 
-void Packing::rebuildNeighbourGrid() {
-    using namespace std::chrono;
-    auto start = high_resolution_clock::now();
-
+std::optional<double> Packing::calculateNeighbourGridCellSize() const {
     double cellSize = this->interactionRange;
     // linearSize/cbrt(size()) gives 1 cell per particle, factor 1/5 empirically gives best times
     double minCellSize = std::cbrt(this->getVolume() / this->size()) / 5;
     if (this->interactionRange < minCellSize)
         cellSize = minCellSize;
 
-    // Less than 4 cells in line is redundant, because everything always would be neighbour
+    // If the cell is larger than the box in some direction (for example for a quasi-2D slab or very few particles in a
+    // box very elongated in 2 directions and very narrow in the 3rd one), shrink it to the box height, but not below
+    // the interaction range. If the range is still larger, NG enumerates more periodic images in that direction
+    static constexpr double CELL_SIZE_EPSILON = 1 + 1e-12;
     auto boxHeights = this->box.getHeights();
-    if (cellSize * 4 > *std::max_element(boxHeights.begin(), boxHeights.end())) {
-        this->neighbourGrid = std::nullopt;
-        return;
+    double minHeight = *std::min_element(boxHeights.begin(), boxHeights.end());
+    if (cellSize * CELL_SIZE_EPSILON > minHeight)
+        cellSize = std::max(this->interactionRange, minHeight / CELL_SIZE_EPSILON);
+
+    // Without NG, only the nearest periodic image of each pair is checked, which is enough only if the range does not
+    // exceed half of the box height. Otherwise, NG has to be used even if it is not efficient
+    if (2 * this->interactionRange > minHeight)
+        return cellSize;
+
+    // Less than 4 cells in line is redundant, because everything always would be neighbour
+    if (cellSize * 4 > *std::max_element(boxHeights.begin(), boxHeights.end()))
+        return std::nullopt;
+
+    return cellSize;
+}
+
+bool Packing::tryRescalingNeighbourGrid() {
+    if (!this->neighbourGrid.has_value())
+        return false;
+
+    auto cellSize = this->calculateNeighbourGridCellSize();
+    if (!cellSize.has_value() || !this->neighbourGrid->canBeRescaled(this->box, *cellSize))
+        return false;
+
+    TriclinicBox oldBox = this->lastBox;
+    this->neighbourGrid->rescale(this->box);
+
+    // Relative positions of particles are not changed by the scaling, however due to numerical inaccuracies (or
+    // rotated interaction centres, which are not scaled) the cell may still change - then, NG has to be rebuilt
+    const auto &ng = *this->neighbourGrid;
+    bool cellsPreserved = true;
+    if (this->numInteractionCentres == 0) {
+        #pragma omp parallel for default(none) shared(ng) reduction(&&:cellsPreserved) \
+                num_threads(this->scalingThreads)
+        for (std::size_t particleIdx = 0; particleIdx < this->size(); particleIdx++) {
+            const auto &position = this->shapes[particleIdx].getPosition();
+            cellsPreserved = cellsPreserved && ng.positionToCellNo(position) == ng.getObjectCellNo(particleIdx);
+        }
+    } else {
+        std::size_t numCentres = this->size() * this->numInteractionCentres;
+        #pragma omp parallel for default(none) shared(ng, numCentres) reduction(&&:cellsPreserved) \
+                num_threads(this->scalingThreads)
+        for (std::size_t centreIdx = 0; centreIdx < numCentres; centreIdx++) {
+            const auto &position = this->absoluteInteractionCentres[centreIdx];
+            cellsPreserved = cellsPreserved && ng.positionToCellNo(position) == ng.getObjectCellNo(centreIdx);
+        }
     }
 
-    // If minCellSize makes the cell larger than the box (for example for very few particles in a box very elongated in
-    // 2 directions and very narrow in the 3rd one), abort creating NG
-    static constexpr double CELL_SIZE_EPSILON = 1 + 1e-12;
-    if (cellSize * CELL_SIZE_EPSILON > *std::min_element(boxHeights.begin(), boxHeights.end())) {
+    if (!cellsPreserved || !this->tryRescalingSizeClassGrids(oldBox)) {
+        this->neighbourGrid->rescale(oldBox);
+        return false;
+    }
+    return true;
+}
+
+bool Packing::tryRescalingSizeClassGrids(const TriclinicBox &oldBox) {
+    // Subdivisions of main grid cells depend on their size, so they may change even if the main grid can be rescaled
+    for (std::size_t sizeClass{}; sizeClass < this->sizeClassGrids.size(); sizeClass++) {
+        const auto &grid = this->sizeClassGrids[sizeClass];
+        auto [cellDivisions, imageLayers] = this->calculateSizeClassGridLayout(sizeClass);
+        if (grid.getCellDivisions() != cellDivisions || grid.getImageLayers() != imageLayers)
+            return false;
+    }
+
+    for (auto &grid : this->sizeClassGrids)
+        grid.rescale(this->box);
+
+    bool cellsPreserved = true;
+    std::size_t numCentres = this->sizeClassGrids.empty() ? 0 : this->size() * this->numInteractionCentres;
+    #pragma omp parallel for default(none) shared(numCentres) reduction(&&:cellsPreserved) \
+            num_threads(this->scalingThreads)
+    for (std::size_t centreIdx = 0; centreIdx < numCentres; centreIdx++) {
+        const auto &grid = this->sizeClassGrids[this->centreSizeClasses[centreIdx % this->numInteractionCentres]];
+        const auto &position = this->absoluteInteractionCentres[centreIdx];
+        cellsPreserved = cellsPreserved && grid.positionToCellNo(position) == grid.getObjectCellNo(centreIdx);
+    }
+
+    if (!cellsPreserved) {
+        for (auto &grid : this->sizeClassGrids)
+            grid.rescale(oldBox);
+        return false;
+    }
+    return true;
+}
+
+void Packing::rebuildNeighbourGrid() {
+    using namespace std::chrono;
+    auto start = high_resolution_clock::now();
+
+    auto optionalCellSize = this->calculateNeighbourGridCellSize();
+    if (!optionalCellSize.has_value()) {
         this->neighbourGrid = std::nullopt;
+        this->sizeClassGrids.clear();
         return;
     }
+    double cellSize = *optionalCellSize;
 
     std::size_t totalInteractionCentres{};
     if (this->numInteractionCentres == 0)
@@ -892,6 +1264,7 @@ void Packing::rebuildNeighbourGrid() {
         this->neighbourGridResizes += this->neighbourGrid->resize(this->box, cellSize);
 
     this->addInteractionCentresToNeighbourGrid();
+    this->rebuildSizeClassGrids();
 
     this->neighbourGridRebuilds++;
     auto end = high_resolution_clock::now();
@@ -928,25 +1301,127 @@ void Packing::addInteractionCentresToNeighbourGrid() {
     }
 }
 
+void Packing::rebuildSizeClassGrids() {
+    // In thin boxes, neighbouring cells of the main grid span multiple image layers and cannot be subdivided in a
+    // simple way - only the main grid is used then
+    std::array<std::size_t, 3> singleImageLayers{1, 1, 1};
+    if (this->sizeClassRanges.empty() || this->neighbourGrid->getImageLayers() != singleImageLayers) {
+        this->sizeClassGrids.clear();
+        return;
+    }
+
+    std::size_t totalInteractionCentres = this->size() * this->numInteractionCentres;
+    for (std::size_t sizeClass{}; sizeClass < this->sizeClassRanges.size(); sizeClass++) {
+        auto [cellDivisions, imageLayers] = this->calculateSizeClassGridLayout(sizeClass);
+        if (sizeClass < this->sizeClassGrids.size())
+            this->sizeClassGrids[sizeClass].resize(this->box, cellDivisions, imageLayers);
+        else
+            this->sizeClassGrids.emplace_back(this->box, cellDivisions, imageLayers, totalInteractionCentres);
+    }
+
+    std::vector<std::size_t> cellNos(totalInteractionCentres);
+    #pragma omp parallel for default(none) shared(cellNos, totalInteractionCentres) num_threads(this->scalingThreads)
+    for (std::size_t centreIdx = 0; centreIdx < totalInteractionCentres; centreIdx++) {
+        const auto &grid = this->sizeClassGrids[this->centreSizeClasses[centreIdx % this->numInteractionCentres]];
+        cellNos[centreIdx] = grid.positionToCellNo(this->absoluteInteractionCentres[centreIdx]);
+    }
+
+    for (std::size_t centreIdx{}; centreIdx < totalInteractionCentres; centreIdx++) {
+        auto &grid = this->sizeClassGrids[this->centreSizeClasses[centreIdx % this->numInteractionCentres]];
+        grid.add(centreIdx, cellNos[centreIdx]);
+    }
+}
+
+std::pair<std::array<std::size_t, 3>, std::array<std::size_t, 3>>
+Packing::calculateSizeClassGridLayout(std::size_t sizeClass) const {
+    // Each cell of the main grid is subdivided into cells not smaller than the range of the size class. Neighbouring
+    // cells span as many layers as needed to reach the range between the size class and the largest one - since it
+    // never exceeds the main cell size, they do not extend beyond the neighbouring main grid cells
+    auto mainCellDivisions = this->neighbourGrid->getCellDivisions();
+    auto boxHeights = this->box.getHeights();
+    double sizeClassRange = this->sizeClassRanges[sizeClass];
+    double crossClassRange = (sizeClassRange + this->interactionRange) / 2;
+
+    std::array<std::size_t, 3> cellDivisions{};
+    std::array<std::size_t, 3> imageLayers{};
+    for (std::size_t i{}; i < 3; i++) {
+        double mainCellSize = boxHeights[i] / static_cast<double>(mainCellDivisions[i]);
+        auto subdivisions = static_cast<std::size_t>(std::floor(mainCellSize / sizeClassRange));
+        subdivisions = std::max<std::size_t>(subdivisions, 1);
+        double cellSize = mainCellSize / static_cast<double>(subdivisions);
+        auto layers = static_cast<std::size_t>(std::ceil(crossClassRange / cellSize));
+        // Clamping only fixes numerical inaccuracies - crossClassRange <= mainCellSize
+        cellDivisions[i] = mainCellDivisions[i] * subdivisions;
+        imageLayers[i] = std::clamp<std::size_t>(layers, 1, subdivisions);
+    }
+    return {cellDivisions, imageLayers};
+}
+
+void Packing::setupSizeClasses(const Interaction &interaction) {
+    this->centreSizeClasses.clear();
+    this->sizeClassRanges.clear();
+    this->sizeClassGrids.clear();
+    this->tempSizeClassGrids.clear();
+
+    auto rangeRadii = interaction.getInteractionCentreRangeRadii();
+    if (rangeRadii.empty())
+        return;
+    Expects(rangeRadii.size() == this->numInteractionCentres);
+
+    // Centres are bucketed by the binary logarithm of the ratio of the maximal range and their range - within a single
+    // bucket, the ranges differ less than twice, so it is not worth splitting them further. The smallest centres are
+    // merged into the last bucket
+    static constexpr std::size_t MAX_SIZE_CLASSES = 4;
+    std::vector<std::size_t> buckets;
+    buckets.reserve(rangeRadii.size());
+    for (double rangeRadius : rangeRadii) {
+        Expects(rangeRadius > 0 && rangeRadius <= this->interactionRange);
+        auto bucket = static_cast<std::size_t>(std::floor(std::log2(this->interactionRange / rangeRadius)));
+        buckets.push_back(std::min(bucket, MAX_SIZE_CLASSES - 1));
+    }
+
+    std::vector<std::size_t> usedBuckets = buckets;
+    std::sort(usedBuckets.begin(), usedBuckets.end());
+    usedBuckets.erase(std::unique(usedBuckets.begin(), usedBuckets.end()), usedBuckets.end());
+    if (usedBuckets.size() < 2)
+        return;
+
+    this->centreSizeClasses.resize(buckets.size());
+    this->sizeClassRanges.resize(usedBuckets.size(), 0);
+    for (std::size_t centre{}; centre < buckets.size(); centre++) {
+        auto bucketIt = std::lower_bound(usedBuckets.begin(), usedBuckets.end(), buckets[centre]);
+        auto sizeClass = static_cast<std::size_t>(bucketIt - usedBuckets.begin());
+        this->centreSizeClasses[centre] = sizeClass;
+        this->sizeClassRanges[sizeClass] = std::max(this->sizeClassRanges[sizeClass], rangeRadii[centre]);
+    }
+}
+
 void Packing::setupForInteraction(const Interaction &interaction) {
     this->interactionRange = interaction.getRangeRadius();
     this->numInteractionCentres = interaction.getInteractionCentres().size();
+    this->setupSizeClasses(interaction);
     this->interactionCentres.clear();
     this->absoluteInteractionCentres.clear();
     if (this->numInteractionCentres > 0) {
         // Takes into account temp shapes at the back
-        this->interactionCentres.reserve(this->shapes.size() * this->numInteractionCentres);
+        this->interactionCentres.resize(this->shapes.size() * this->numInteractionCentres);
         this->absoluteInteractionCentres.resize(this->shapes.size() * this->numInteractionCentres);
         auto centres = interaction.getInteractionCentres();
-        for (const auto &shape : this->shapes)
-            for (const auto &centre : centres)
-                this->interactionCentres.emplace_back(shape.getOrientation() * centre);
+        #pragma omp parallel for default(none) shared(centres) num_threads(this->scalingThreads)
+        for (std::size_t shapeIdx = 0; shapeIdx < this->shapes.size(); shapeIdx++) {
+            const auto &orientation = this->shapes[shapeIdx].getOrientation();
+            std::size_t firstCentreIdx = shapeIdx * this->numInteractionCentres;
+            for (std::size_t centreIdx{}; centreIdx < this->numInteractionCentres; centreIdx++)
+                this->interactionCentres[firstCentreIdx + centreIdx] = orientation * centres[centreIdx];
+        }
         this->recalculateAbsoluteInteractionCentres();
     }
     this->rebuildNeighbourGrid();
 
     if (this->overlapCounting)
         this->numOverlaps = this->countTotalOverlaps(interaction, false);
+
+    this->notifyPackingReset();
 }
 
 double Packing::getVolume() const {
@@ -967,6 +1442,69 @@ void Packing::resetCounters() {
     this->neighbourGridRebuilds = 0;
     this->neighbourGridResizes = 0;
     this->neighbourGridRebuildMicroseconds = 0;
+    std::fill(this->overlapRejectionStatistics.begin(), this->overlapRejectionStatistics.end(),
+              OverlapRejectionStatistics{});
+}
+
+void Packing::resetOverlapPartners() {
+    std::fill(this->lastOverlapPartners.begin(), this->lastOverlapPartners.end(), NO_OVERLAP_PARTNER);
+}
+
+Packing::OverlapRejectionStatistics Packing::getOverlapRejectionStatistics() const {
+    OverlapRejectionStatistics total;
+    for (const auto &threadStatistics : this->overlapRejectionStatistics)
+        total += threadStatistics;
+    return total;
+}
+
+Packing::OverlapRejectionStatistics &
+Packing::OverlapRejectionStatistics::operator+=(const OverlapRejectionStatistics &other)
+{
+    this->rejectedMoves += other.rejectedMoves;
+    this->pairChecks += other.pairChecks;
+    this->partnerHits += other.partnerHits;
+    return *this;
+}
+
+void Packing::attachListener(PackingListener &listener) {
+    Expects(!this->isListenerAttached(listener));
+    this->listeners.push_back(&listener);
+    listener.packingReset(*this);
+}
+
+void Packing::detachListener(PackingListener &listener) {
+    auto it = std::find(this->listeners.begin(), this->listeners.end(), &listener);
+    Expects(it != this->listeners.end());
+    this->listeners.erase(it);
+    listener.packingReset(*this);
+}
+
+bool Packing::isListenerAttached(const PackingListener &listener) const {
+    return std::find(this->listeners.begin(), this->listeners.end(), &listener) != this->listeners.end();
+}
+
+void Packing::notifyParticleMoved(std::size_t particleIdx, const std::optional<Shape> &oldShape) const {
+    this->namedPointCache.invalidate();
+    if (this->listeners.empty())
+        return;
+
+    Assert(oldShape.has_value());
+    const auto &newShape = this->shapes[particleIdx];
+    double energyDelta = this->lastMoveEnergyDeltas[OMP_THREAD_ID];
+    for (auto listener : this->listeners)
+        listener->particleMoved(*this, particleIdx, *oldShape, newShape, energyDelta);
+}
+
+void Packing::notifyBoxScaled(const TriclinicBox &oldBox, double energyDelta) const {
+    this->namedPointCache.invalidate();
+    for (auto listener : this->listeners)
+        listener->boxScaled(*this, oldBox, energyDelta);
+}
+
+void Packing::notifyPackingReset() const {
+    this->namedPointCache.invalidate();
+    for (auto listener : this->listeners)
+        listener->packingReset(*this);
 }
 
 std::ostream &operator<<(std::ostream &out, const Packing &packing) {
@@ -994,6 +1532,10 @@ std::size_t Packing::getNeighbourGridMemoryUsage() const {
         bytes += this->neighbourGrid->getMemoryUsage();
     if (this->tempNeighbourGrid.has_value())
         bytes += this->tempNeighbourGrid->getMemoryUsage();
+    for (const auto &grid : this->sizeClassGrids)
+        bytes += grid.getMemoryUsage();
+    for (const auto &grid : this->tempSizeClassGrids)
+        bytes += grid.getMemoryUsage();
     return bytes;
 }
 
@@ -1016,15 +1558,24 @@ double Packing::getAverageNumberOfNeighbours() const {
         }
         return static_cast<double>(numNeighbours) / static_cast<double>(this->size());
     } else {
+        // Neighbours are enumerated in the grids used for single particle computations
+        std::vector<const NeighbourGrid *> grids;
+        if (this->sizeClassGrids.empty())
+            grids.push_back(&*this->neighbourGrid);
+        for (const auto &grid : this->sizeClassGrids)
+            grids.push_back(&grid);
+
         std::size_t numNeighbours{};
         for (std::size_t centreIdx1{}; centreIdx1 < this->size()*this->numInteractionCentres; centreIdx1++) {
             std::size_t particle1 = centreIdx1 / this->numInteractionCentres;
             auto pos1 = this->absoluteInteractionCentres[centreIdx1];
-            for (const auto &cell : this->neighbourGrid->getNeighbouringCells(pos1)) {
-                for (auto centreIdx2 : cell.getNeighbours()) { // NOLINT(readability-use-anyofallof)
-                    std::size_t particle2 = centreIdx2 / this->numInteractionCentres;
-                    if (particle2 != particle1)
-                        numNeighbours++;
+            for (const auto *grid : grids) {
+                for (const auto &cell : grid->getNeighbouringCells(pos1)) {
+                    for (auto centreIdx2 : cell.getNeighbours()) { // NOLINT(readability-use-anyofallof)
+                        std::size_t particle2 = centreIdx2 / this->numInteractionCentres;
+                        if (particle2 != particle1)
+                            numNeighbours++;
+                    }
                 }
             }
         }
@@ -1046,6 +1597,10 @@ void Packing::recalculateAbsoluteInteractionCentres(std::size_t particleIdx) {
     }
 }
 
+void Packing::setIntraMoveThreads(std::size_t intraMoveThreads_) {
+    this->intraMoveThreads = (intraMoveThreads_ == 0 ? OMP_MAXTHREADS : intraMoveThreads_);
+}
+
 void Packing::toggleOverlapCounting(bool countOverlaps, const Interaction &interaction) {
     this->overlapCounting = countOverlaps;
     if (this->overlapCounting)
@@ -1062,14 +1617,20 @@ std::size_t Packing::getCachedNumberOfOverlaps() const {
 void Packing::resetNGRaceConditionSanitizer() {
     if (this->neighbourGrid.has_value())
         this->neighbourGrid->resetRaceConditionSanitizer();
+    for (auto &grid : this->sizeClassGrids)
+        grid.resetRaceConditionSanitizer();
 }
 
-bool Packing::areShapesWithinBox(const std::vector<Shape> &shapes, const TriclinicBox &box) {
-    for (const auto &shape : shapes)
-        for (auto posCoord: box.absoluteToRelative(shape.getPosition()))
+bool Packing::areShapesWithinBox(const std::vector<Shape> &shapes, const TriclinicBox &box,
+                                 std::size_t numThreads)
+{
+    bool withinBox = true;
+    #pragma omp parallel for default(none) shared(shapes, box) reduction(&&:withinBox) num_threads(numThreads)
+    for (std::size_t i = 0; i < shapes.size(); i++)
+        for (auto posCoord: box.absoluteToRelative(shapes[i].getPosition()))
             if (posCoord < 0 || posCoord >= 1)
-                return false;
-    return true;
+                withinBox = false;
+    return withinBox;
 }
 
 void Packing::toggleWall(std::size_t wallAxis, bool trueOrFalse) {
@@ -1141,15 +1702,21 @@ std::size_t Packing::countParticleWallOverlaps(std::size_t particleIdx, const In
     return countedOverlaps;
 }
 
-std::vector<Vector<3>> Packing::dumpNamedPoints(const ShapeGeometry &geometry, const std::string &pointName) const {
-    std::vector<Vector<3>> namedPoints;
-    namedPoints.reserve(this->size());
+const std::vector<Vector<3>> &Packing::dumpNamedPoints(const ShapeGeometry &geometry,
+                                                       const std::string &pointName) const
+{
     Vector<3> alignedNamedPoint = geometry.getNamedPoint(pointName);
-    auto namedPointsCalculator = [alignedNamedPoint](const Shape &shape) {
-        return shape.getPosition() + shape.getOrientation() * alignedNamedPoint;
-    };
-    std::transform(this->begin(), this->end(), std::back_inserter(namedPoints), namedPointsCalculator);
-    return namedPoints;
+    const auto *cachedNamedPoints = this->namedPointCache.find(alignedNamedPoint);
+    if (cachedNamedPoints != nullptr)
+        return *cachedNamedPoints;
+
+    std::vector<Vector<3>> namedPoints(this->size());
+    #pragma omp parallel for shared(namedPoints, alignedNamedPoint) default(none) num_threads(this->scalingThreads)
+    for (std::size_t i = 0; i < this->size(); i++) {
+        const auto &shape = this->shapes[i];
+        namedPoints[i] = shape.getPosition() + shape.getOrientation() * alignedNamedPoint;
+    }
+    return this->namedPointCache.insert(alignedNamedPoint, std::move(namedPoints));
 }
 
 bool Packing::isBoxUpscaled(const TriclinicBox &oldBox, const TriclinicBox &newBox) {
@@ -1224,6 +1791,8 @@ void Packing::tryOrientationFix(std::size_t particleIdx, const std::vector<Vecto
     auto &shape = this->shapes[particleIdx];
     std::size_t tempParticleIdx = this->size() + threadId;
     this->lastAlteredParticleIdx[threadId] = particleIdx;
+    // Energy change is not calculated for orientation fixes
+    this->lastMoveEnergyDeltas[threadId] = std::numeric_limits<double>::quiet_NaN();
 
     auto &tempShape = this->shapes[tempParticleIdx];
     tempShape.setPosition(shape.getPosition());
@@ -10,6 +10,7 @@
 #include <memory>
 #include <optional>
 #include <map>
+#include <limits>
 
 #include "Shape.h"
 #include "BoundaryConditions.h"
@@ -18,7 +19,10 @@
 #include "ShapeGeometry.h"
 #include "NeighbourGrid.h"
 #include "ActiveDomain.h"
+#include "PackingListener.h"
+#include "NamedPointCache.h"
 #include "utils/OMPMacros.h"
+#include "utils/CompilerMacros.h"
 #include "TriclinicBox.h"
 
 /**
@@ -30,6 +34,24 @@
  * performed concurrently. Volume moves have a built-in parallelization.
  */
 class Packing {
+public:
+    /**
+     * @brief Statistics of overlap searches in molecule moves, which were rejected due to an overlap.
+     * @details Each particle remembers the last particle it was found to overlap with in a rejected move. In dense
+     * systems, it is very likely to be the culprit also in the next trial move of the particle, so it is checked
+     * first. Then, neighbouring cells are searched from the nearest ones.
+     */
+    struct OverlapRejectionStatistics {
+        /** @brief The number of molecule moves rejected due to an overlap */
+        std::size_t rejectedMoves{};
+        /** @brief The total number of pair overlap checks (Interaction::overlapBetween calls) in these moves */
+        std::size_t pairChecks{};
+        /** @brief The number of rejections found already by checking the remembered overlap partner */
+        std::size_t partnerHits{};
+
+        OverlapRejectionStatistics &operator+=(const OverlapRejectionStatistics &other);
+    };
+
 private:
     // shapes, interactionCentres and absoluteInteractionCentres contain additional slots at the end for temporary data
     // for all threads
@@ -46,9 +68,16 @@ private:
     std::optional<NeighbourGrid> neighbourGrid;
     double interactionRange{};
     std::size_t numInteractionCentres{};
+    // Interaction centres of very different sizes are bucketed into size classes, each one having a separate neighbour
+    // grid used for single particle computations (see Packing::setupSizeClasses); whole packing computations use the
+    // main neighbour grid
+    std::vector<std::size_t> centreSizeClasses;
+    std::vector<double> sizeClassRanges;
+    std::vector<NeighbourGrid> sizeClassGrids;
 
     std::size_t moveThreads{};
     std::size_t scalingThreads{};
+    std::size_t intraMoveThreads = 1;
 
     bool hasAnyWalls{};
     std::array<bool, 3> hasWall{};
@@ -58,23 +87,48 @@ private:
 
     std::vector<std::size_t> lastAlteredParticleIdx{};
     std::vector<int> lastMoveOverlapDeltas{};
+    std::vector<double> lastMoveEnergyDeltas{};
+    // The particle which a given particle was overlapping with in its last rejected move (or NO_OVERLAP_PARTNER)
+    mutable std::vector<std::size_t> lastOverlapPartners{};
+    mutable std::vector<OverlapRejectionStatistics> overlapRejectionStatistics{};
     std::size_t lastScalingNumOverlaps{};
+    double lastScalingEnergyDelta{};
+    bool lastScalingRescaledNeighbourGrid{};
     TriclinicBox lastBox;
     std::vector<Shape> lastShapes;
     std::optional<NeighbourGrid> tempNeighbourGrid;     // temp ng is used for swapping in volume moves
+    std::vector<NeighbourGrid> tempSizeClassGrids;
 
     std::size_t neighbourGridRebuilds{};
     std::size_t neighbourGridResizes{};
     double neighbourGridRebuildMicroseconds{};
 
+    std::vector<PackingListener *> listeners;
+    mutable NamedPointCache namedPointCache;
+
+    static constexpr std::size_t NO_OVERLAP_PARTNER = std::numeric_limits<std::size_t>::max();
 
-    static bool areShapesWithinBox(const std::vector<Shape> &shapes, const TriclinicBox &box);
+    static bool areShapesWithinBox(const std::vector<Shape> &shapes, const TriclinicBox &box,
+                                   std::size_t numThreads);
     static bool isBoxUpscaled(const TriclinicBox &oldBox, const TriclinicBox &newBox);
     static void fixRotationMatrix(Matrix<3, 3> &rotation);
 
     void rebuildNeighbourGrid();
+    [[nodiscard]] std::optional<double> calculateNeighbourGridCellSize() const;
+    bool tryRescalingNeighbourGrid();
+    void setupSizeClasses(const Interaction &interaction);
+    void rebuildSizeClassGrids();
+    [[nodiscard]] std::pair<std::array<std::size_t, 3>, std::array<std::size_t, 3>>
+    calculateSizeClassGridLayout(std::size_t sizeClass) const;
+    bool tryRescalingSizeClassGrids(const TriclinicBox &oldBox);
 
     double calculateMoveOverlapEnergy(size_t particleIdx, size_t tempParticleIdx, const Interaction &interaction);
+    double calculateMoveEnergy(std::size_t particleIdx, std::size_t tempParticleIdx, const Interaction &interaction);
+    double calculateScalingEnergy(double initialEnergy, const Interaction &interaction);
+
+    void notifyParticleMoved(std::size_t particleIdx, const std::optional<Shape> &oldShape) const;
+    void notifyBoxScaled(const TriclinicBox &oldBox, double energyDelta) const;
+    void notifyPackingReset() const;
 
     void removeInteractionCentresFromNeighbourGrid(std::size_t particleIdx);
     void addInteractionCentresToNeighbourGrid(std::size_t particleIdx);
@@ -97,20 +151,42 @@ private:
     // centres
     [[nodiscard]] std::size_t countParticleOverlaps(std::size_t originalParticleIdx, std::size_t tempParticleIdx,
                                                     const Interaction &interaction, bool earlyExit) const;
+    // Helper method for the early exit check of the last overlap partner of originalParticleIdx
+    [[nodiscard]] bool overlapsWithLastPartner(std::size_t originalParticleIdx, std::size_t tempParticleIdx,
+                                               const Interaction &interaction, std::size_t &pairChecks) const;
+    void recordOverlapRejection(std::size_t originalParticleIdx, std::size_t partnerIdx, std::size_t pairChecks,
+                                bool partnerHit) const;
     // Helper method for the overlap check without neighbour grid - exhaustive checks for all interaction centers
     [[nodiscard]] std::size_t countOverlapsBetweenParticlesWithoutNG(std::size_t tempParticleIdx,
                                                                      std::size_t anotherParticleIdx,
                                                                      const Interaction &interaction,
-                                                                     bool earlyExit) const;
+                                                                     bool earlyExit, std::size_t &pairChecks) const;
+    // Helper methods for all interaction centres of a particle with neighbour grid - the centres are split between
+    // Packing::intraMoveThreads threads if possible (see Packing::isIntraMoveParallel). On early exit, the particle
+    // which was found to overlap is stored in overlapPartner
+    [[nodiscard]] bool isIntraMoveParallel() const;
+    [[nodiscard]] std::size_t countAllInteractionCentreOverlapsWithNG(std::size_t originalParticleIdx,
+                                                                      std::size_t tempParticleIdx,
+                                                                      const Interaction &interaction, bool earlyExit,
+                                                                      std::size_t &pairChecks,
+                                                                      std::size_t &overlapPartner) const;
     // Helper method for a single interaction center with neighbour grid
     [[nodiscard]] std::size_t countInteractionCentreOverlapsWithNG(std::size_t originalParticleIdx,
                                                                    std::size_t tempParticleIdx,
                                                                    std::size_t centre,
                                                                    const Interaction &interaction,
-                                                                   bool earlyExit) const;
+                                                                   bool earlyExit, std::size_t &pairChecks,
+                                                                   std::size_t &overlapPartner) const;
+    // Innermost neighbour grid traversals are multiversioned for different instruction sets
+    [[nodiscard]] RAMPACK_MULTIVERSIONED
+    std::size_t countInteractionCentreOverlapsInGrid(std::size_t originalParticleIdx, std::size_t tempParticleIdx,
+                                                     std::size_t centre, const NeighbourGrid &grid,
+                                                     const Interaction &interaction, bool earlyExit,
+                                                     std::size_t &pairChecks, std::size_t &overlapPartner) const;
     // Helper method for a single NG cell when checking all particles
-    [[nodiscard]] std::size_t countTotalOverlapsNGCellHelper(const std::array<std::size_t, 3> &coord,
-                                                             const Interaction &interaction, bool earlyExit) const;
+    [[nodiscard]] RAMPACK_MULTIVERSIONED
+    std::size_t countTotalOverlapsNGCellHelper(const std::array<std::size_t, 3> &coord, const Interaction &interaction,
+                                               bool earlyExit) const;
     [[nodiscard]] std::size_t countParticleWallOverlaps(std::size_t particleIdx, const Interaction &interaction,
                                                         bool earlyExit) const;
 
@@ -120,11 +196,18 @@ private:
     [[nodiscard]] double calculateEnergyBetweenParticlesWithoutNG(std::size_t tempParticleIdx,
                                                                   std::size_t anotherParticleIdx,
                                                                   const Interaction &interaction) const;
+    [[nodiscard]] double calculateAllInteractionCentreEnergyWithNG(std::size_t originalParticleIdx,
+                                                                   std::size_t tempParticleIdx,
+                                                                   const Interaction &interaction) const;
     [[nodiscard]] double calculateInteractionCentreEnergyWithNG(std::size_t originalParticleIdx,
                                                                 std::size_t tempParticleIdx, size_t centre,
                                                                 const Interaction &interaction) const;
-    [[nodiscard]] double getTotalEnergyNGCellHelper(const std::array<std::size_t, 3> &coord,
-                                                    const Interaction &interaction) const;
+    [[nodiscard]] RAMPACK_MULTIVERSIONED
+    double calculateInteractionCentreEnergyInGrid(std::size_t originalParticleIdx, std::size_t tempParticleIdx,
+                                                  size_t centre, const NeighbourGrid &grid,
+                                                  const Interaction &interaction) const;
+    [[nodiscard]] RAMPACK_MULTIVERSIONED
+    double getTotalEnergyNGCellHelper(const std::array<std::size_t, 3> &coord, const Interaction &interaction) const;
 
     using iterator = decltype(shapes)::iterator;
 
@@ -171,6 +254,20 @@ public:
 
     void reset(std::vector<Shape> newShapes, const TriclinicBox &newBox, const Interaction &newInteraction);
 
+    /**
+     * @brief Copies the current state of the packing (shapes, box, boundary conditions, interaction centres and
+     * neighbour grid) to @a snapshot, which can be then analysed independently of this packing.
+     * @details The memory of @a snapshot is reused, so when it is a snapshot of the same packing taken earlier, no
+     * allocations are performed. Listeners and move statistics are not copied, while the listeners of @a snapshot are
+     * notified about the reset (PackingListener::packingReset).
+     */
+    void takeSnapshot(Packing &snapshot) const;
+
+    /**
+     * @brief Creates a new snapshot of the packing (see takeSnapshot()).
+     */
+    [[nodiscard]] std::unique_ptr<Packing> createSnapshot() const;
+
     /**
      * @brief Performs renormalization of rotation matrices.
      * @details If @a allowOverlaps is @a true, renormalization will be performed on all particles regardless if it
@@ -229,6 +326,20 @@ public:
      */
     [[nodiscard]] std::size_t getScalingThreads() const { return this->scalingThreads; }
 
+    /**
+     * @brief Sets the number of threads evaluating a single molecule move (0 means all OpenMP threads).
+     * @details Interaction centres of the moved molecule are then split between the threads when counting overlaps
+     * and calculating the energy. It is done only if the move is not already performed in a parallel region (for
+     * example in domain decomposition), so it is useful for molecules with many expensive interaction centres when
+     * moves are performed serially. The results are the same as for a single thread. The default is 1.
+     */
+    void setIntraMoveThreads(std::size_t intraMoveThreads_);
+
+    /**
+     * @brief Returns the number of threads evaluating a single molecule move (see Packing::setIntraMoveThreads).
+     */
+    [[nodiscard]] std::size_t getIntraMoveThreads() const { return this->intraMoveThreads; }
+
     /**
      * @brief Returns the number of neighbour grid cell in each direction.
      */
@@ -236,6 +347,31 @@ public:
         return this->neighbourGrid->getCellDivisions();
     }
 
+    /**
+     * @brief Returns @a true if neighbour grid is currently used. Otherwise, all pairs of particles are checked (for
+     * example for very small packings).
+     */
+    [[nodiscard]] bool isNeighbourGridUsed() const { return this->neighbourGrid.has_value(); }
+
+    /**
+     * @brief Returns the number of layers of neighbour grid image cells in each direction - more than 1 means that the
+     * box is thinner than the interaction range and many periodic images are checked (see
+     * NeighbourGrid::getImageLayers).
+     */
+    [[nodiscard]] std::array<std::size_t, 3> getNeighbourGridImageLayers() const {
+        return this->neighbourGrid->getImageLayers();
+    }
+
+    /**
+     * @brief Returns the number of separate neighbour grids for size classes of interaction centres, or 0 if only the
+     * main neighbour grid is used.
+     * @details Size classes are used when interaction centres have very different ranges (see
+     * Interaction::getInteractionCentreRangeRadii) - then, small centres are not checked against neighbourhoods sized
+     * for the largest ones. Cells of size class grids subdivide cells of the main grid, so that NG cells accessed in
+     * a move do not extend beyond the neighbourhood of the main grid cell, as assumed by DomainDecomposition.
+     */
+    [[nodiscard]] std::size_t getNumSizeClassGrids() const { return this->sizeClassGrids.size(); }
+
     /**
      * @brief Toggles if overlaps should be counted when performing moves. If toggled @a false, early exit will
      * performed in methods like Packing::tryMove and Packing::tryScaling when the first overlap is found.
@@ -243,6 +379,11 @@ public:
      */
     void toggleOverlapCounting(bool countOverlaps, const Interaction &interaction);
 
+    /**
+     * @brief Returns @a true if overlap counting is toggled on (see Packing::toggleOverlapCounting).
+     */
+    [[nodiscard]] bool isOverlapCountingEnabled() const { return this->overlapCounting; }
+
     /**
      * @brief Toggles @a true or @a false (@a trueOfFalse) hard walls intersected by axis @a wallAxis
      * @param wallAxis
@@ -294,6 +435,15 @@ public:
      */
     [[nodiscard]] std::size_t countWallOverlaps(const Interaction &interaction, bool earlyExit) const;
 
+    /**
+     * @brief Calculates the number of overlaps of a single particle @a particleIdx with other particles and walls (if
+     * toggled on) for @a interaction.
+     * @details The meaning of @a earlyExit is the same as in Packing::countTotalOverlaps. The particle is checked in
+     * O(1) time using the neighbour grid (if it is used).
+     */
+    [[nodiscard]] std::size_t countParticleOverlaps(std::size_t particleIdx, const Interaction &interaction,
+                                                    bool earlyExit = true) const;
+
     /**
      * @brief For overlap counting toggled @a true it returns cached number of overlaps, i.e. no overlap check are
      * actually performed and the method consumes only a couple of CPU cycles.
@@ -344,7 +494,9 @@ public:
      * @details Contrary to molecule moves, scaling is directly applied to the packing. If the move needs to be
      * reverted, Packing::revertScaling method can be used. The method calculates the energy using multiple threads.
      * If overlap counting is toggles @a true, changes in number of overlaps will we reported as 0, minus infinity and
-     * plus infinity for the same, smaller and larger number of overlaps, respectively.
+     * plus infinity for the same, smaller and larger number of overlaps, respectively. If the number of neighbour grid
+     * cells does not change and all molecules stay in the same cells (in relative coordinates), the neighbour grid is
+     * only rescaled instead of being rebuilt.
      * @param newBox new box to which molecule centres should be rescaled
      * @param interaction interaction to compute the energy
      * @return energy difference between the final and initial state
@@ -397,10 +549,35 @@ public:
     void setupForInteraction(const Interaction &interaction);
 
     /**
-     * @brief Resets all counters (neighbour grid rebuilds, etc.).
+     * @brief Resets all counters (neighbour grid rebuilds, overlap rejection statistics, etc.).
      */
     void resetCounters();
 
+    /**
+     * @brief Forgets last overlap partners of all particles (see Packing::OverlapRejectionStatistics).
+     * @details It has to be called before concurrent moves in a new domain decomposition, since a partner remembered
+     * earlier may lie in the domain of another thread.
+     */
+    void resetOverlapPartners();
+
+    /**
+     * @brief Attaches @a listener, which will be notified about all changes of the packing (see PackingListener).
+     * @details The packing does not own the listener, so it should be detached using Packing::detachListener before
+     * it is destroyed. Upon attaching, PackingListener::packingReset is called.
+     */
+    void attachListener(PackingListener &listener);
+
+    /**
+     * @brief Detaches @a listener previously attached using Packing::attachListener.
+     * @details Upon detaching, PackingListener::packingReset is called.
+     */
+    void detachListener(PackingListener &listener);
+
+    /**
+     * @brief Returns @a true if @a listener is attached to the packing.
+     */
+    [[nodiscard]] bool isListenerAttached(const PackingListener &listener) const;
+
     /**
      * @brief Stores a packing in an internal representation form.
      * @param out the output stream to store a packing
@@ -432,6 +609,12 @@ public:
      */
     [[nodiscard]] double getNeighbourGridRebuildMicroseconds() const { return this->neighbourGridRebuildMicroseconds; }
 
+    /**
+     * @brief Returns statistics of overlap searches in molecule moves rejected due to an overlap, summed over all
+     * threads, since the last reset.
+     */
+    [[nodiscard]] OverlapRejectionStatistics getOverlapRejectionStatistics() const;
+
     /**
      * @brief Returns an average number of neighbour per particles according to neighbour grid.
      */
@@ -459,11 +642,14 @@ public:
     void resetNGRaceConditionSanitizer();
 
     /**
-     * @brief Returns the list of named points with name @a pointName specified in ShapeGeometry  @a geometryof all
+     * @brief Returns the list of named points with name @a pointName specified in ShapeGeometry @a geometry of all
      * molecules in the packing.
+     * @details Named points are cached until the packing is modified, so subsequent calls for the same point (also
+     * from different observables) are cheap. The returned reference is valid until the next modification of the
+     * packing. The method is not thread-safe.
      */
-    [[nodiscard]] std::vector<Vector<3>> dumpNamedPoints(const ShapeGeometry &geometry,
-                                                         const std::string &pointName) const;
+    [[nodiscard]] const std::vector<Vector<3>> &dumpNamedPoints(const ShapeGeometry &geometry,
+                                                                const std::string &pointName) const;
 };
 
 
@@ -0,0 +1,54 @@
+#ifndef RAMPACK_PACKINGLISTENER_H
+#define RAMPACK_PACKINGLISTENER_H
+
+#include <cstddef>
+
+#include "Shape.h"
+#include "TriclinicBox.h"
+
+
+class Packing;
+
+/**
+ * @brief An interface of a class which is notified by Packing about all changes of its state.
+ * @details The listener is attached using Packing::attachListener. Notifications about accepted molecule moves can
+ * come concurrently from many move threads - Packing::getMoveThreads(), so they should either be thread-safe or
+ * accumulate changes in thread-local storage indexed by @a OMP_THREAD_ID. All other notifications come from a single
+ * thread, never concurrently with molecule moves.
+ */
+class PackingListener {
+public:
+    virtual ~PackingListener() = default;
+
+    /**
+     * @brief Called after a molecule move (translation, rotation or both) on a particle @a particleIdx has been
+     * accepted.
+     * @param packing the packing after the move
+     * @param particleIdx the index of the moved particle
+     * @param oldShape the state of the particle before the move
+     * @param newShape the state of the particle after the move
+     * @param energyDelta the soft energy change introduced by the move. It is NaN if the change is not known, for
+     * example when the move was accepted because it decreased the number of overlaps
+     */
+    virtual void particleMoved(const Packing &packing, std::size_t particleIdx, const Shape &oldShape,
+                               const Shape &newShape, double energyDelta) = 0;
+
+    /**
+     * @brief Called after the box of the packing has changed in Packing::tryScaling or Packing::revertScaling. Particle
+     * positions are rescaled together with the box, while their orientations remain unchanged.
+     * @param packing the packing after the change
+     * @param oldBox the box before the change
+     * @param energyDelta the soft energy change introduced by the change. It is NaN if the change is not known
+     */
+    virtual void boxScaled(const Packing &packing, const TriclinicBox &oldBox, double energyDelta) = 0;
+
+    /**
+     * @brief Called when the state of @a packing has changed in a way, which cannot be expressed incrementally (for
+     * example on Packing::reset or Packing::setupForInteraction), as well as when the listener is attached or
+     * detached.
+     */
+    virtual void packingReset(const Packing &packing) = 0;
+};
+
+
+#endif //RAMPACK_PACKINGLISTENER_H
@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+
+#include "ParticleSweep.h"
+#include "utils/Exceptions.h"
+
+
+ParticleSweep::ParticleSweep(Order order_, const Packing &packing, std::vector<std::size_t> particleIndices_,
+                             std::size_t blockSize_)
+        : order{order_}, particleIndices{std::move(particleIndices_)}, blockSize{blockSize_}
+{
+    Expects(!this->particleIndices.empty());
+    Expects(this->blockSize > 0);
+
+    if (this->order == Order::RANDOM)
+        return;
+
+    if (this->order == Order::SPATIAL || this->order == Order::SHUFFLED_BLOCKS)
+        this->sortSpatially(packing);
+
+    std::size_t maxParticleIdx = *std::max_element(this->particleIndices.begin(), this->particleIndices.end());
+    this->particleRanks.resize(maxParticleIdx + 1, NOT_IN_SWEEP);
+    for (std::size_t rank{}; rank < this->particleIndices.size(); rank++)
+        this->particleRanks[this->particleIndices[rank]] = rank;
+}
+
+std::size_t ParticleSweep::next(std::mt19937 &mt) {
+    if (this->order == Order::RANDOM) {
+        std::uniform_int_distribution<std::size_t> particleDistribution(0, this->particleIndices.size() - 1);
+        return this->particleIndices[particleDistribution(mt)];
+    }
+
+    if (this->sweepPosition == this->sweep.size())
+        this->prepareSweep(mt);
+    return this->sweep[this->sweepPosition++];
+}
+
+const std::vector<std::size_t> &ParticleSweep::arrangeSubset(const std::vector<std::size_t> &subsetIndices,
+                                                             std::mt19937 &mt, SubsetBuffers &buffers) const
+{
+    Expects(this->order != Order::RANDOM);
+    auto &subsetSweep = buffers.sweep;
+    subsetSweep.clear();
+    if (subsetIndices.empty())
+        return subsetSweep;
+
+    for (auto particleIdx : subsetIndices)
+        Expects(particleIdx < this->particleRanks.size() && this->particleRanks[particleIdx] != NOT_IN_SWEEP);
+
+    // Instead of sorting, ranks of the subset are marked in a bitmap, which is then scanned in order - it takes
+    // O(subset size + number of particles / 64). The bitmap is cleared while scanning, so it can be reused
+    auto &rankBitmap = buffers.rankBitmap;
+    rankBitmap.resize((this->particleIndices.size() + 63) / 64);
+    for (auto particleIdx : subsetIndices) {
+        std::size_t rank = this->particleRanks[particleIdx];
+        rankBitmap[rank / 64] |= std::uint64_t{1} << (rank % 64);
+    }
+    for (std::size_t wordIdx{}; wordIdx < rankBitmap.size(); wordIdx++) {
+        std::uint64_t word = rankBitmap[wordIdx];
+        if (word == 0)
+            continue;
+
+        rankBitmap[wordIdx] = 0;
+        for (std::size_t bit{}; word != 0; bit++, word >>= 1)
+            if (word & 1)
+                subsetSweep.push_back(this->particleIndices[64*wordIdx + bit]);
+    }
+
+    if (this->order == Order::SHUFFLED_BLOCKS) {
+        ParticleSweep::shuffleBlocks(subsetSweep, this->blockSize, mt, buffers.blockOrder,
+                                     buffers.shuffledParticles);
+    }
+
+    std::uniform_int_distribution<std::size_t> startDistribution(0, subsetSweep.size() - 1);
+    auto start = subsetSweep.begin() + static_cast<std::ptrdiff_t>(startDistribution(mt));
+    std::rotate(subsetSweep.begin(), start, subsetSweep.end());
+    return subsetSweep;
+}
+
+void ParticleSweep::prepareSweep(std::mt19937 &mt) {
+    this->sweep = this->particleIndices;
+    this->sweepPosition = 0;
+
+    switch (this->order) {
+        case Order::SEQUENTIAL:
+        case Order::SPATIAL:
+            break;
+        case Order::SHUFFLED_BLOCKS:
+            ParticleSweep::shuffleBlocks(this->sweep, this->blockSize, mt, this->blockOrder, this->shuffledSweep);
+            break;
+        default:
+            AssertThrow("unreachable");
+    }
+}
+
+void ParticleSweep::sortSpatially(const Packing &packing) {
+    const auto &box = packing.getBox();
+    std::vector<std::pair<std::uint64_t, std::size_t>> codes;
+    codes.reserve(this->particleIndices.size());
+    for (auto particleIdx : this->particleIndices) {
+        Vector<3> relativePosition = box.absoluteToRelative(packing[particleIdx].getPosition());
+        codes.emplace_back(ParticleSweep::calculateMortonCode(relativePosition), particleIdx);
+    }
+
+    std::sort(codes.begin(), codes.end());
+    std::transform(codes.begin(), codes.end(), this->particleIndices.begin(),
+                   [](const auto &code) { return code.second; });
+}
+
+void ParticleSweep::shuffleBlocks(std::vector<std::size_t> &particles, std::size_t blockSize, std::mt19937 &mt,
+                                  std::vector<std::size_t> &blockOrder, std::vector<std::size_t> &shuffledParticles)
+{
+    std::size_t numBlocks = (particles.size() + blockSize - 1) / blockSize;
+    blockOrder.resize(numBlocks);
+    std::iota(blockOrder.begin(), blockOrder.end(), 0);
+    std::shuffle(blockOrder.begin(), blockOrder.end(), mt);
+
+    shuffledParticles.clear();
+    for (auto blockIdx : blockOrder) {
+        auto blockBeg = particles.begin() + static_cast<std::ptrdiff_t>(blockIdx * blockSize);
+        auto blockEnd = particles.begin()
+                        + static_cast<std::ptrdiff_t>(std::min((blockIdx + 1) * blockSize, particles.size()));
+        shuffledParticles.insert(shuffledParticles.end(), blockBeg, blockEnd);
+    }
+    // Swapping keeps the capacity of both vectors for the next call
+    particles.swap(shuffledParticles);
+}
+
+std::uint64_t ParticleSweep::calculateMortonCode(const Vector<3> &relativePosition) {
+    // 21 bits per coordinate - the whole code fits in 63 bits
+    constexpr std::uint64_t MAX_COORD = (1ull << 21) - 1;
+
+    std::uint64_t code{};
+    std::array<std::uint64_t, 3> coords{};
+    for (std::size_t i{}; i < 3; i++) {
+        double relativeCoord = std::clamp(relativePosition[i], 0., 1.);
+        coords[i] = std::min(static_cast<std::uint64_t>(relativeCoord * static_cast<double>(MAX_COORD + 1)), MAX_COORD);
+    }
+
+    for (std::size_t bit{}; bit < 21; bit++)
+        for (std::size_t i{}; i < 3; i++)
+            code |= ((coords[i] >> bit) & 1ull) << (3*bit + i);
+    return code;
+}
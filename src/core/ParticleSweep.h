@@ -0,0 +1,115 @@
+#ifndef RAMPACK_PARTICLESWEEP_H
+#define RAMPACK_PARTICLESWEEP_H
+
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <limits>
+
+#include "Packing.h"
+
+
+/**
+ * @brief A class scheduling the order in which particles are perturbed by molecule moves.
+ * @details Apart from the default random choice of a particle for each move, particles can be visited in sweeps,
+ * where each particle is visited exactly once. When a sweep is completed, a new one is prepared. Sweeps do not satisfy
+ * the detailed balance, however each single move does, so the Boltzmann distribution remains stationary (global
+ * balance is preserved) - as long as the order of the sweep does not depend on the current configuration. Because of
+ * that, the spatial order is computed only once, in the constructor, and later it is only shuffled using a random
+ * number generator. Visiting particles in a spatial order makes consecutive moves operate on nearby particles and
+ * neighbour grid cells, which are then already in the CPU cache. As particles diffuse, the order gradually loses its
+ * locality, so a new object should be created for each simulation run.
+ */
+class ParticleSweep {
+public:
+    /**
+     * @brief The order in which particles are visited.
+     */
+    enum class Order {
+        /** @brief Each move chooses a particle at random, independently of the previous ones. */
+        RANDOM,
+        /** @brief Particles are visited in the order of their indices. */
+        SEQUENTIAL,
+        /**
+         * @brief Particles are visited along a Z-order (Morton) curve of their positions at the moment of the
+         * construction.
+         */
+        SPATIAL,
+        /**
+         * @brief Particles are grouped in spatially ordered blocks as for Order::SPATIAL, however the order of blocks
+         * is shuffled in each sweep.
+         */
+        SHUFFLED_BLOCKS
+    };
+
+    /**
+     * @brief Default number of particles in a block for Order::SHUFFLED_BLOCKS.
+     */
+    static constexpr std::size_t DEFAULT_BLOCK_SIZE = 64;
+
+    /**
+     * @brief Buffers reused between the calls of ParticleSweep::arrangeSubset, so that no memory is allocated once
+     * they have grown to the size of the largest subset.
+     */
+    struct SubsetBuffers {
+        /** @brief The arranged sweep over the subset. */
+        std::vector<std::size_t> sweep;
+        /** @brief Ranks of the subset particles in the whole sweep marked as bits (all zero between the calls). */
+        std::vector<std::uint64_t> rankBitmap;
+        /** @brief Scratch space for shuffling blocks in Order::SHUFFLED_BLOCKS. */
+        std::vector<std::size_t> blockOrder;
+        /** @brief Scratch space for shuffling blocks in Order::SHUFFLED_BLOCKS. */
+        std::vector<std::size_t> shuffledParticles;
+    };
+
+private:
+    static constexpr std::size_t NOT_IN_SWEEP = std::numeric_limits<std::size_t>::max();
+
+    Order order{};
+    // Particle indices in a fixed order (for example spatial) computed in the constructor
+    std::vector<std::size_t> particleIndices;
+    // particleRanks[particleIdx] is the position of particleIdx in particleIndices
+    std::vector<std::size_t> particleRanks;
+    std::size_t blockSize{};
+    std::vector<std::size_t> sweep;
+    std::size_t sweepPosition{};
+    std::vector<std::size_t> blockOrder;
+    std::vector<std::size_t> shuffledSweep;
+
+    [[nodiscard]] static std::uint64_t calculateMortonCode(const Vector<3> &relativePosition);
+    static void shuffleBlocks(std::vector<std::size_t> &particles, std::size_t blockSize, std::mt19937 &mt,
+                              std::vector<std::size_t> &blockOrder, std::vector<std::size_t> &shuffledParticles);
+    void sortSpatially(const Packing &packing);
+    void prepareSweep(std::mt19937 &mt);
+
+public:
+    /**
+     * @brief Creates a sweep over particles @a particleIndices_ from @a packing in a given @a order_.
+     * @details @a packing is used only in the constructor (to compute the spatial order) and @a blockSize_ is used
+     * only for Order::SHUFFLED_BLOCKS.
+     */
+    ParticleSweep(Order order_, const Packing &packing, std::vector<std::size_t> particleIndices_,
+                  std::size_t blockSize_ = DEFAULT_BLOCK_SIZE);
+
+    /**
+     * @brief Returns the index of the next particle to be perturbed, starting a new sweep if necessary.
+     * @details The position in the sweep is kept between the calls, so when a cycle performs fewer moves than there
+     * are particles, the next one continues where the previous one stopped.
+     */
+    std::size_t next(std::mt19937 &mt);
+
+    /**
+     * @brief Returns a single sweep over a subset @a subsetIndices of particles (for example the ones in a domain).
+     * @details Particles are arranged in the same order as in the whole sweep (with blocks shuffled for
+     * Order::SHUFFLED_BLOCKS), however the sweep starts from a randomly chosen particle, so that when not all of them
+     * are visited, it is not always the same ones which are skipped. All particles from @a subsetIndices have to be
+     * a part of the sweep. The sweep is placed in SubsetBuffers::sweep of @a buffers, which is also returned. The
+     * method does not alter the state of the object, so it can be called concurrently (with different @a mt and
+     * @a buffers instances). It cannot be used with Order::RANDOM.
+     */
+    const std::vector<std::size_t> &arrangeSubset(const std::vector<std::size_t> &subsetIndices, std::mt19937 &mt,
+                                                  SubsetBuffers &buffers) const;
+};
+
+
+#endif //RAMPACK_PARTICLESWEEP_H
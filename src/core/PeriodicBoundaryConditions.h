@@ -41,6 +41,10 @@ public:
     [[nodiscard]] Vector<3> getCorrection(const Vector<3> &position) const override;
     [[nodiscard]] Vector<3> getTranslation(const Vector<3> &position1, const Vector<3> &position2) const override;
     [[nodiscard]] double getDistance2(const Vector<3> &position1, const Vector<3> &position2) const override;
+
+    [[nodiscard]] std::unique_ptr<BoundaryConditions> clone() const override {
+        return std::make_unique<PeriodicBoundaryConditions>(*this);
+    }
 };
 
 
@@ -3,7 +3,9 @@
 //
 
 #include <cmath>
+#include <algorithm>
 #include <ostream>
+#include <sstream>
 #include <chrono>
 #include <atomic>
 #include <csignal>
@@ -39,6 +41,49 @@ namespace {
                 this->logger.setAdditionalText(this->previousAdditionalText + ", " + additionalText);
         }
     };
+
+    /* Waits for a pending background task (AsynchronousAnalysis or OverlapSanitizer) when leaving a simulation run
+     * (also due to SIGINT or an exception), so that it does not outlive objects it uses, and releases it */
+    template<typename BackgroundTask>
+    class BackgroundTaskFinisher {
+    private:
+        std::unique_ptr<BackgroundTask> &task;
+        double &waitingMicroseconds;
+
+    public:
+        BackgroundTaskFinisher(std::unique_ptr<BackgroundTask> &task, double &waitingMicroseconds)
+                : task{task}, waitingMicroseconds{waitingMicroseconds}
+        { }
+
+        ~BackgroundTaskFinisher() {
+            if (this->task == nullptr)
+                return;
+
+            try {
+                this->task->wait();
+            } catch (...) {
+                // Exceptions are rethrown by an explicit wait() on a regular path; here we may be already unwinding
+                // the stack
+            }
+            this->waitingMicroseconds = this->task->getWaitingMicroseconds();
+            this->task = nullptr;
+        }
+    };
+
+    class IncrementalObservablesAttacher {
+    private:
+        ObservablesCollector &observablesCollector;
+        Packing &packing;
+
+    public:
+        IncrementalObservablesAttacher(ObservablesCollector &observablesCollector, Packing &packing)
+                : observablesCollector{observablesCollector}, packing{packing}
+        {
+            this->observablesCollector.attachIncrementalObservables(this->packing);
+        }
+
+        ~IncrementalObservablesAttacher() { this->observablesCollector.detachIncrementalObservables(this->packing); }
+    };
 }
 
 
@@ -54,8 +99,8 @@ Simulation::Parameter::Parameter(double value) : parameter{std::make_shared<Cons
 Simulation::Simulation(std::unique_ptr<Packing> packing, unsigned long seed,
                        Simulation::Environment initialEnv, const std::array<std::size_t, 3> &domainDivisions,
                        bool handleSignals)
-        : environment{std::move(initialEnv)}, packing{std::move(packing)}, allParticleIndices(this->packing->size()),
-          domainDivisions{domainDivisions}
+        : environment{std::move(initialEnv)}, seed{seed}, packing{std::move(packing)},
+          allParticleIndices(this->packing->size()), domainDivisions{domainDivisions}
 {
     Expects(!this->packing->empty());
 
@@ -63,8 +108,9 @@ Simulation::Simulation(std::unique_ptr<Packing> packing, unsigned long seed,
     Expects(this->numDomains > 0);
     Expects(this->numDomains <= this->packing->getMoveThreads());
 
-    this->mts.reserve(this->numDomains);
-    for (std::size_t i{}; i < this->numDomains; i++)
+    // Domain divisions may be tuned during the simulation, so there are RNGs for all possible domains
+    this->mts.reserve(this->packing->getMoveThreads());
+    for (std::size_t i{}; i < this->packing->getMoveThreads(); i++)
         this->mts.emplace_back(seed + i);
 
     std::iota(this->allParticleIndices.begin(), this->allParticleIndices.end(), 0);
@@ -102,9 +148,20 @@ void Simulation::integrate(Environment env, const IntegrationParameters &params,
     Expects(params.thermalisationCycles > 0 || params.averagingCycles > 0);
     Expects(params.inlineInfoEvery > 0);
     Expects(params.rotationMatrixFixEvery > 0);
-    if (params.averagingCycles > 0)
-        Expects(params.averagingEvery > 0 && params.averagingEvery <= params.averagingCycles);
-    Expects(params.snapshotEvery <= (params.thermalisationCycles + params.averagingCycles));
+    if (params.averagingCycles > 0) {
+        Expects(params.averagingEvery > 0);
+        // Resumed averaging may have fewer cycles left than averagingEvery or snapshotEvery
+        if (params.averagingState.empty())
+            Expects(params.averagingEvery <= params.averagingCycles);
+    }
+    if (params.averagingCycles > 0 && params.bulkAveragingMaxEvery > 0) {
+        Expects(params.bulkAveragingMaxEvery >= params.averagingEvery);
+        Expects(params.bulkAveragingMaxEvery % params.averagingEvery == 0);
+    }
+    if (params.averagingState.empty())
+        Expects(params.snapshotEvery <= (params.thermalisationCycles + params.averagingCycles));
+    ExpectsMsg(!params.speculativeMoves || params.moveScheduling == ParticleSweep::Order::RANDOM,
+               "Speculative moves require random move scheduling");
 
     this->environment.combine(env);
     Expects(this->environment.isComplete());
@@ -113,7 +170,35 @@ void Simulation::integrate(Environment env, const IntegrationParameters &params,
         moveSampler->setupForShapeTraits(shapeTraits);
 
     this->observablesCollector = std::move(observablesCollector_);
+    this->stepSizeTuning = params.stepSizeTuning;
+    this->moveScheduling = params.moveScheduling;
+    this->speculativeMoves = params.speculativeMoves;
     this->reset();
+    if (!params.averagingState.empty()) {
+        std::istringstream averagingStateStream(params.averagingState);
+        this->observablesCollector->restoreAveragingState(averagingStateStream);
+    }
+    if (params.moveScheduling != ParticleSweep::Order::RANDOM) {
+        this->particleSweep = std::make_unique<ParticleSweep>(params.moveScheduling, *this->packing,
+                                                              this->allParticleIndices);
+        this->domainSweepBuffers.resize(this->mts.size());
+    }
+    this->isAnalysisAsynchronous_ = params.asynchronousAnalysis;
+    if (params.asynchronousAnalysis)
+        this->asynchronousAnalysis = std::make_unique<AsynchronousAnalysis>();
+    this->analysedInlineInfo = std::nullopt;
+    BackgroundTaskFinisher asynchronousAnalysisFinisher(this->asynchronousAnalysis,
+                                                        this->analysisWaitingMicroseconds);
+    if (params.overlapCheckEvery > 0) {
+        this->overlapSanitizer = std::make_unique<OverlapSanitizer>(params.overlapCheckEvery,
+                                                                    params.overlapCheckFraction,
+                                                                    this->getOverlapSanitizerSeed());
+    }
+    BackgroundTaskFinisher overlapSanitizerFinisher(this->overlapSanitizer, this->overlapCheckWaitingMicroseconds);
+    if (params.domainDivisionTuningEvery > 0 && params.thermalisationCycles > 0)
+        this->domainDivisionTuner = std::make_unique<DomainDivisionTuner>(params.domainDivisionTuningEvery);
+    if (params.averagingCycles > 0 && params.bulkAveragingMaxEvery > 0)
+        this->observablesCollector->setBulkSamplingMaxInterval(params.bulkAveragingMaxEvery / params.averagingEvery);
 
     this->totalCycles = params.cycleOffset;
     this->maxCycles = params.cycleOffset + params.thermalisationCycles + params.averagingCycles;
@@ -127,6 +212,11 @@ void Simulation::integrate(Environment env, const IntegrationParameters &params,
     this->packing->setupForInteraction(interaction);
     this->packing->toggleOverlapCounting(false, interaction);
     this->areOverlapsCounted = false;
+    // Incremental updates would race with the asynchronous analysis - observables are then computed from scratch on
+    // the snapshot
+    std::optional<IncrementalObservablesAttacher> incrementalObservablesAttacher;
+    if (!params.asynchronousAnalysis)
+        incrementalObservablesAttacher.emplace(*this->observablesCollector, *this->packing);
 
     ValidateMsg(this->packing->countTotalOverlaps(interaction) == 0,
                 "Overlaps are present at the start of integration. Perform overlap reduction beforehand.");
@@ -143,12 +233,8 @@ void Simulation::integrate(Environment env, const IntegrationParameters &params,
 
             if (this->totalCycles % params.rotationMatrixFixEvery == 0)
                 this->fixRotationMatrices(shapeTraits.getInteraction(), logger);
-            if (this->totalCycles % params.snapshotEvery == 0) {
-                this->observablesCollector->addSnapshot(*this->packing, this->totalCycles, shapeTraits);
-                if (!simulationRecorders.empty())
-                    for (const auto &recorder : simulationRecorders)
-                       recorder->recordSnapshot(*this->packing, this->totalCycles);
-            }
+            if (this->totalCycles % params.snapshotEvery == 0)
+                this->analysePacking(shapeTraits, simulationRecorders, true, false);
             if (this->totalCycles % params.inlineInfoEvery == 0)
                 this->printInlineInfo(this->totalCycles, shapeTraits, logger, false);
 
@@ -159,6 +245,10 @@ void Simulation::integrate(Environment env, const IntegrationParameters &params,
                 return;
             }
         }
+
+        if (this->stepSizeTuning == StepSizeTuning::EFFICIENCY)
+            this->printTunedStepSizes(logger);
+        this->stopDomainDivisionTuning(logger);
     }
 
     this->shouldAdjustStepSize = false;
@@ -172,14 +262,10 @@ void Simulation::integrate(Environment env, const IntegrationParameters &params,
 
             if (this->totalCycles % params.rotationMatrixFixEvery == 0)
                 this->fixRotationMatrices(shapeTraits.getInteraction(), logger);
-            if (this->totalCycles % params.snapshotEvery == 0) {
-                this->observablesCollector->addSnapshot(*this->packing, this->totalCycles, shapeTraits);
-                if (!simulationRecorders.empty())
-                    for (const auto &recorder : simulationRecorders)
-                        recorder->recordSnapshot(*this->packing, this->totalCycles);
-            }
-            if (this->totalCycles % params.averagingEvery == 0)
-                this->observablesCollector->addAveragingValues(*this->packing, shapeTraits);
+            bool addSnapshot = (this->totalCycles % params.snapshotEvery == 0);
+            bool addAveragingValues = (this->totalCycles % params.averagingEvery == 0);
+            if (addSnapshot || addAveragingValues)
+                this->analysePacking(shapeTraits, simulationRecorders, addSnapshot, addAveragingValues);
             if (this->totalCycles % params.inlineInfoEvery == 0)
                 this->printInlineInfo(this->totalCycles, shapeTraits, logger, false);
 
@@ -192,6 +278,10 @@ void Simulation::integrate(Environment env, const IntegrationParameters &params,
         }
     }
 
+    this->waitForAnalysis();
+    if (this->overlapSanitizer != nullptr)
+        this->overlapSanitizer->wait();
+
     auto end = std::chrono::high_resolution_clock::now();
     this->totalMicroseconds = std::chrono::duration<double, std::micro>(end - start).count();
 
@@ -227,6 +317,8 @@ void Simulation::relaxOverlaps(Environment env, const OverlapRelaxationParameter
     Expects(params.inlineInfoEvery > 0);
     Expects(params.rotationMatrixFixEvery > 0);
     Expects(params.snapshotEvery > 0);
+    ExpectsMsg(!params.speculativeMoves || params.moveScheduling == ParticleSweep::Order::RANDOM,
+               "Speculative moves require random move scheduling");
 
     this->environment.combine(env);
     Expects(this->environment.isComplete());
@@ -235,7 +327,22 @@ void Simulation::relaxOverlaps(Environment env, const OverlapRelaxationParameter
         moveSampler->setupForShapeTraits(shapeTraits);
 
     this->observablesCollector = std::move(observablesCollector_);
+    // Efficiency does not make much sense when overlaps are present, so the acceptance rate is always used
+    this->stepSizeTuning = StepSizeTuning::ACCEPTANCE_RATE;
+    this->moveScheduling = params.moveScheduling;
+    this->speculativeMoves = params.speculativeMoves;
     this->reset();
+    if (params.moveScheduling != ParticleSweep::Order::RANDOM) {
+        this->particleSweep = std::make_unique<ParticleSweep>(params.moveScheduling, *this->packing,
+                                                              this->allParticleIndices);
+        this->domainSweepBuffers.resize(this->mts.size());
+    }
+    if (params.overlapCheckEvery > 0)
+        this->overlapSanitizer = std::make_unique<OverlapSanitizer>(params.overlapCheckEvery, 1,
+                                                                    this->getOverlapSanitizerSeed());
+    BackgroundTaskFinisher overlapSanitizerFinisher(this->overlapSanitizer, this->overlapCheckWaitingMicroseconds);
+    if (params.domainDivisionTuningEvery > 0)
+        this->domainDivisionTuner = std::make_unique<DomainDivisionTuner>(params.domainDivisionTuningEvery);
 
     this->totalCycles = params.cycleOffset;
     this->maxCycles = std::numeric_limits<std::size_t>::max();
@@ -249,6 +356,7 @@ void Simulation::relaxOverlaps(Environment env, const OverlapRelaxationParameter
     this->packing->setupForInteraction(interaction);
     this->packing->toggleOverlapCounting(true, interaction);
     this->areOverlapsCounted = true;
+    IncrementalObservablesAttacher incrementalObservablesAttacher(*this->observablesCollector, *this->packing);
 
     this->shouldAdjustStepSize = true;
     loggerAdditionalTextAppender.setAdditionalText("ov");
@@ -276,6 +384,10 @@ void Simulation::relaxOverlaps(Environment env, const OverlapRelaxationParameter
         }
     }
 
+    this->stopDomainDivisionTuning(logger);
+    if (this->overlapSanitizer != nullptr)
+        this->overlapSanitizer->wait();
+
     auto end = std::chrono::high_resolution_clock::now();
     this->totalMicroseconds = std::chrono::duration<double, std::micro>(end - start).count();
 
@@ -310,11 +422,20 @@ void Simulation::reset() {
         moveCounter.reset();
     this->scalingCounter.reset();
     std::fill(this->adjustmentCancelReported.begin(), this->adjustmentCancelReported.end(), false);
+    this->moveEfficiencyTuners.resize(numMoveSamplers);
+    for (auto &moveEfficiencyTuner : this->moveEfficiencyTuners)
+        moveEfficiencyTuner.reset();
+    this->scalingEfficiencyTuner.reset();
     this->packing->resetCounters();
     this->moveMicroseconds = 0;
     this->scalingMicroseconds = 0;
     this->domainDecompositionMicroseconds = 0;
     this->totalMicroseconds = 0;
+    this->analysisWaitingMicroseconds = 0;
+    this->overlapCheckWaitingMicroseconds = 0;
+    this->domainDivisionTuner = nullptr;
+    this->particleSweep = nullptr;
+    this->isAnalysisAsynchronous_ = false;
     this->observablesCollector->clear();
     this->performedCycles = 0;
     this->totalCycles = 0;
@@ -325,34 +446,41 @@ void Simulation::reset() {
 void Simulation::performCycle(Logger &logger, const ShapeTraits &shapeTraits) {
     const auto &interaction = shapeTraits.getInteraction();
 
+    std::size_t numMovesBefore{};
+    if (this->domainDivisionTuner != nullptr) {
+        auto tunedDivisions = this->domainDivisionTuner->startCycle(*this->packing, interaction,
+                                                                    this->domainDivisions);
+        if (tunedDivisions.has_value())
+            this->setDomainDivisions(*tunedDivisions);
+        numMovesBefore = this->countAllMoves();
+    }
+
     using namespace std::chrono;
     auto start = high_resolution_clock::now();
     this->performMoves(shapeTraits, logger);
     auto end = high_resolution_clock::now();
-    this->moveMicroseconds += duration<double, std::micro>(end - start).count();
+    double moveMicroseconds_ = duration<double, std::micro>(end - start).count();
+    this->moveMicroseconds += moveMicroseconds_;
 
-    #ifdef SIMULATION_SANITIZE_OVERLAPS
-    if (this->areOverlapsCounted) {
-        Assert(this->packing->getCachedNumberOfOverlaps() == this->packing->countTotalOverlaps(interaction, false));
-    } else {
-        Assert(this->packing->countTotalOverlaps(interaction, true) == 0);
+    if (this->domainDivisionTuner != nullptr) {
+        std::size_t numMoves = this->countAllMoves() - numMovesBefore;
+        this->finishDomainDivisionTuningCycle(numMoves, moveMicroseconds_, logger);
     }
-    #endif
 
     if (this->environment.isBoxScalingEnabled()) {
+        TriclinicBox oldBox = this->packing->getBox();
         start = high_resolution_clock::now();
         bool wasScaled = this->tryScaling(interaction);
         this->scalingCounter.increment(wasScaled);
         end = high_resolution_clock::now();
-        this->scalingMicroseconds += duration<double, std::micro>(end - start).count();
-
-        #ifdef SIMULATION_SANITIZE_OVERLAPS
-        if (this->areOverlapsCounted) {
-            Assert(this->packing->getCachedNumberOfOverlaps() == this->packing->countTotalOverlaps(interaction, false));
-        } else {
-            Assert(this->packing->countTotalOverlaps(interaction, true) == 0);
+        double scalingMicroseconds_ = duration<double, std::micro>(end - start).count();
+        this->scalingMicroseconds += scalingMicroseconds_;
+        if (this->isEfficiencyMeasured()) {
+            if (wasScaled)
+                this->scalingCounter.addSquaredDisplacement(Simulation::calculateSquaredBoxChange(oldBox,
+                                                                                                  this->packing->getBox()));
+            this->scalingCounter.addMicroseconds(scalingMicroseconds_);
         }
-        #endif
     }
 
     if (this->shouldAdjustStepSize)
@@ -360,6 +488,9 @@ void Simulation::performCycle(Logger &logger, const ShapeTraits &shapeTraits) {
 
     this->performedCycles++;
     this->totalCycles++;
+
+    if (this->overlapSanitizer != nullptr)
+        this->overlapSanitizer->check(*this->packing, interaction, this->totalCycles);
 }
 
 void Simulation::performMoves(const ShapeTraits &shapeTraits, Logger &logger) {
@@ -367,15 +498,17 @@ void Simulation::performMoves(const ShapeTraits &shapeTraits, Logger &logger) {
 
     while (true) {
         try {
-            if (this->numDomains == 1)
+            if (this->numDomains == 1 && this->speculativeMoves && this->packing->getMoveThreads() > 1)
+                performSpeculativeMoves(shapeTraits);
+            else if (this->numDomains == 1)
                 performMovesWithoutDomainDivision(shapeTraits);
             else
                 performMovesWithDomainDivision(shapeTraits);
             break;
         } catch (const TooNarrowDomainException &ex) {
-            this->domainDivisions[ex.getCoord()]--;
-            this->numDomains = std::accumulate(this->domainDivisions.begin(), this->domainDivisions.end(), 1,
-                                               std::multiplies<>{});
+            auto reducedDivisions = this->domainDivisions;
+            reducedDivisions[ex.getCoord()]--;
+            this->setDomainDivisions(reducedDivisions);
         }
     }
 
@@ -386,11 +519,202 @@ void Simulation::performMoves(const ShapeTraits &shapeTraits, Logger &logger) {
     }
 }
 
+void Simulation::setDomainDivisions(const std::array<std::size_t, 3> &domainDivisions_) {
+    this->domainDivisions = domainDivisions_;
+    this->numDomains = std::accumulate(this->domainDivisions.begin(), this->domainDivisions.end(), 1,
+                                       std::multiplies<>{});
+    Expects(this->numDomains > 0);
+    Expects(this->numDomains <= this->mts.size());
+}
+
+std::size_t Simulation::countAllMoves() const {
+    return std::accumulate(this->moveCounters.begin(), this->moveCounters.end(), std::size_t{0},
+                           [](std::size_t sum, const Counter &counter) { return sum + counter.getMoves(); });
+}
+
+unsigned long Simulation::getOverlapSanitizerSeed() const {
+    Assert(this->mts.size() <= OVERLAP_SANITIZER_SEED_OFFSET);
+    return this->seed + OVERLAP_SANITIZER_SEED_OFFSET;
+}
+
+void Simulation::finishDomainDivisionTuningCycle(std::size_t numMoves, double microseconds, Logger &logger) {
+    if (this->domainDivisionTuner->finishCycle(numMoves, microseconds))
+        this->applyTunedDomainDivisions(logger);
+}
+
+void Simulation::stopDomainDivisionTuning(Logger &logger) {
+    if (this->domainDivisionTuner == nullptr)
+        return;
+
+    if (this->domainDivisionTuner->isBenchmarking()) {
+        this->domainDivisionTuner->abortBenchmark();
+        this->applyTunedDomainDivisions(logger);
+    }
+    this->domainDivisionTuner = nullptr;
+}
+
+void Simulation::applyTunedDomainDivisions(Logger &logger) {
+    const auto &previousDivisions = this->domainDivisionTuner->getDivisionsBeforeBenchmark();
+    auto bestDivisions = this->domainDivisionTuner->getBestDivisions();
+    this->setDomainDivisions(bestDivisions);
+    if (bestDivisions == previousDivisions)
+        return;
+
+    logger.info() << "Switching domain divisions from [";
+    logger << previousDivisions[0] << ", " << previousDivisions[1] << ", " << previousDivisions[2] << "] to [";
+    logger << bestDivisions[0] << ", " << bestDivisions[1] << ", " << bestDivisions[2] << "] (";
+    logger << this->domainDivisionTuner->getBestSpeedup() << "x faster)" << std::endl;
+}
+
 void Simulation::performMovesWithoutDomainDivision(const ShapeTraits &shapeTraits) {
     auto moveTypeAccumulations = this->calculateMoveTypeAccumulations(this->packing->size());
     std::size_t numMoves = moveTypeAccumulations.back();
-    for (std::size_t i{}; i < numMoves; i++)
-        this->tryMove(shapeTraits, this->allParticleIndices, this->moveCounters, moveTypeAccumulations);
+    if (this->moveScheduling == ParticleSweep::Order::RANDOM) {
+        for (std::size_t i{}; i < numMoves; i++)
+            this->tryMove(shapeTraits, this->allParticleIndices, this->moveCounters, moveTypeAccumulations);
+        return;
+    }
+
+    // A single-element list of particle indices makes MoveSampler perturb exactly the chosen particle. The sweep is
+    // kept between cycles, so particles are not skipped when there are fewer moves in a cycle than particles
+    auto &mt = this->mts[OMP_THREAD_ID];
+    std::vector<std::size_t> sweptParticle(1);
+    for (std::size_t i{}; i < numMoves; i++) {
+        sweptParticle.front() = this->particleSweep->next(mt);
+        this->tryMove(shapeTraits, sweptParticle, this->moveCounters, moveTypeAccumulations);
+    }
+}
+
+void Simulation::performSpeculativeMoves(const ShapeTraits &shapeTraits) {
+    // Moves are sampled in batches (one move per thread) in the same order and from the same RNG as in the serial
+    // Simulation::performMovesWithoutDomainDivision. Energy changes are evaluated in parallel for the state from the
+    // beginning of the batch and then the moves are committed in the sampling order. A move which could interact with
+    // a move accepted earlier in the batch is re-evaluated, so the Markov chain is the same as the serial one.
+    auto moveTypeAccumulations = this->calculateMoveTypeAccumulations(this->packing->size());
+    std::size_t numMoves = moveTypeAccumulations.back();
+    const auto &interaction = shapeTraits.getInteraction();
+    double conflictRadius = interaction.getTotalRangeRadius();
+    double conflictRadius2 = conflictRadius * conflictRadius;
+    bool measureEfficiency = this->isEfficiencyMeasured();
+    std::vector<SpeculativeMove> moves;
+    std::size_t sampledMoves{};
+
+    #pragma omp parallel default(none) shared(moves, sampledMoves, numMoves, moveTypeAccumulations, interaction) \
+            shared(conflictRadius2, measureEfficiency) num_threads(this->packing->getMoveThreads())
+    {
+        while (true) {
+            #pragma omp single
+            {
+                std::size_t maxMoves = std::min<std::size_t>(OMP_TEAM_SIZE, numMoves - sampledMoves);
+                this->sampleSpeculativeMoves(moves, maxMoves, moveTypeAccumulations);
+                sampledMoves += moves.size();
+            }
+
+            if (moves.empty())
+                break;
+
+            // Both loops have the same static schedule, so each move is evaluated and committed by the same thread,
+            // which owns the temporary shape in Packing
+            #pragma omp for schedule(static, 1)
+            for (std::size_t i = 0; i < moves.size(); i++)
+                this->evaluateSpeculativeMove(moves[i], interaction, measureEfficiency);
+
+            #pragma omp for ordered schedule(static, 1)
+            for (std::size_t i = 0; i < moves.size(); i++) {
+                #pragma omp ordered
+                this->commitSpeculativeMove(moves, i, interaction, conflictRadius2, measureEfficiency);
+            }
+        }
+    }
+
+    this->packing->resetNGRaceConditionSanitizer();
+}
+
+void Simulation::sampleSpeculativeMoves(std::vector<SpeculativeMove> &moves, std::size_t maxMoves,
+                                        const std::vector<std::size_t> &moveTypeAccumulations)
+{
+    const auto &moveSamplers = this->environment.getMoveSamplers();
+    auto &mt = this->mts.front();
+
+    moves.clear();
+    while (moves.size() < maxMoves) {
+        // A move of a particle already present in the batch would be sampled for its old state (see FlipSampler), so
+        // the batch is ended and the RNG is rewound - the move will be sampled again in the next batch
+        std::mt19937 previousMt = mt;
+        SpeculativeMove speculativeMove;
+        speculativeMove.moveType = Simulation::sampleMoveType(moveTypeAccumulations, mt);
+        auto &moveSampler = moveSamplers[speculativeMove.moveType];
+        speculativeMove.move = moveSampler->sampleMove(*this->packing, this->allParticleIndices, mt);
+
+        auto isSameParticle = [&speculativeMove](const SpeculativeMove &otherMove) {
+            return otherMove.move.particleIdx == speculativeMove.move.particleIdx;
+        };
+        if (std::any_of(moves.begin(), moves.end(), isSameParticle)) {
+            mt = previousMt;
+            break;
+        }
+
+        speculativeMove.acceptanceRandom = this->unitIntervalDistribution(mt);
+        moves.push_back(speculativeMove);
+    }
+}
+
+void Simulation::evaluateSpeculativeMove(SpeculativeMove &speculativeMove, const Interaction &interaction,
+                                         bool measureEfficiency)
+{
+    using namespace std::chrono;
+    high_resolution_clock::time_point start;
+    if (measureEfficiency)
+        start = high_resolution_clock::now();
+
+    speculativeMove.energyDelta = this->evaluateMove(speculativeMove.move, interaction);
+
+    if (measureEfficiency) {
+        auto end = high_resolution_clock::now();
+        speculativeMove.microseconds += duration<double, std::micro>(end - start).count();
+    }
+}
+
+void Simulation::commitSpeculativeMove(std::vector<SpeculativeMove> &moves, std::size_t moveIdx,
+                                       const Interaction &interaction, double conflictRadius2, bool measureEfficiency)
+{
+    auto &speculativeMove = moves[moveIdx];
+    const auto &move = speculativeMove.move;
+    const auto &bc = this->packing->getBoundaryConditions();
+    Shape newShape = (*this->packing)[move.particleIdx];
+    newShape.translate(move.translation, bc);
+    speculativeMove.oldPosition = (*this->packing)[move.particleIdx].getPosition();
+    speculativeMove.newPosition = newShape.getPosition();
+
+    // Particles may interact only if they are closer than the total range radius, so the move has to be re-evaluated
+    // only if its initial or final position is in range of the initial or final position of an accepted move
+    auto isConflicting = [&speculativeMove, &bc, conflictRadius2](const SpeculativeMove &previousMove) {
+        if (!previousMove.accepted)
+            return false;
+        for (const auto &previousPosition : {previousMove.oldPosition, previousMove.newPosition})
+            for (const auto &position : {speculativeMove.oldPosition, speculativeMove.newPosition})
+                if (bc.getDistance2(previousPosition, position) <= conflictRadius2)
+                    return true;
+        return false;
+    };
+    if (std::any_of(moves.begin(), moves.begin() + moveIdx, isConflicting))
+        this->evaluateSpeculativeMove(speculativeMove, interaction, measureEfficiency);
+
+    speculativeMove.accepted = speculativeMove.acceptanceRandom <= std::exp(-speculativeMove.energyDelta
+                                                                            / this->temperature);
+    if (speculativeMove.accepted) {
+        // Commits are serialized, but they are done by different threads
+        this->packing->resetNGRaceConditionSanitizer();
+        this->packing->acceptMove();
+    }
+
+    auto &moveCounter = this->moveCounters[speculativeMove.moveType];
+    moveCounter.increment(speculativeMove.accepted);
+    if (measureEfficiency) {
+        if (speculativeMove.accepted)
+            moveCounter.addSquaredDisplacement(Simulation::calculateSquaredDisplacement(move));
+        moveCounter.addMicroseconds(speculativeMove.microseconds);
+    }
 }
 
 void Simulation::performMovesWithDomainDivision(const ShapeTraits &shapeTraits) {
@@ -413,6 +737,7 @@ void Simulation::performMovesWithDomainDivision(const ShapeTraits &shapeTraits)
     this->domainDecompositionMicroseconds += duration<double, std::micro>(end - start).count();
 
     this->packing->resetNGRaceConditionSanitizer();
+    this->packing->resetOverlapPartners();
 
     #pragma omp declare reduction (+ : std::vector<Counter> : Simulation::accumulateCounters(omp_out, omp_in)) \
             initializer(omp_priv = omp_orig)
@@ -428,12 +753,29 @@ void Simulation::performMovesWithDomainDivision(const ShapeTraits &shapeTraits)
                 if (domainParticleIndices.empty())
                     continue;
 
-                std::size_t averageNumParticles = this->packing->size() / this->numDomains;
-                auto moveTypeAccumulations = this->calculateMoveTypeAccumulations(averageNumParticles);
-                std::size_t numMoves = moveTypeAccumulations.back();
-                for (std::size_t x{}; x < numMoves; x++) {
-                    this->tryMove(shapeTraits, domainParticleIndices, tempMoveCounters, moveTypeAccumulations,
-                                  activeDomain);
+                if (this->moveScheduling == ParticleSweep::Order::RANDOM) {
+                    std::size_t averageNumParticles = this->packing->size() / this->numDomains;
+                    auto moveTypeAccumulations = this->calculateMoveTypeAccumulations(averageNumParticles);
+                    std::size_t numMoves = moveTypeAccumulations.back();
+                    for (std::size_t x{}; x < numMoves; x++) {
+                        this->tryMove(shapeTraits, domainParticleIndices, tempMoveCounters, moveTypeAccumulations,
+                                      activeDomain);
+                    }
+                } else {
+                    // Domains change every cycle, so the sweep covers all particles of the domain and starts from
+                    // a random one
+                    auto &mt = this->mts[OMP_THREAD_ID];
+                    auto moveTypeAccumulations = this->calculateMoveTypeAccumulations(domainParticleIndices.size());
+                    std::size_t numMoves = moveTypeAccumulations.back();
+                    auto &buffers = this->domainSweepBuffers[OMP_THREAD_ID];
+                    const auto &domainSweep = this->particleSweep->arrangeSubset(domainParticleIndices, mt,
+                                                                                 buffers.subsetBuffers);
+                    auto &sweptParticle = buffers.sweptParticle;
+                    for (std::size_t x{}; x < numMoves; x++) {
+                        sweptParticle.front() = domainSweep[x % domainSweep.size()];
+                        this->tryMove(shapeTraits, sweptParticle, tempMoveCounters, moveTypeAccumulations,
+                                      activeDomain);
+                    }
                 }
             }
         }
@@ -452,9 +794,38 @@ bool Simulation::tryMove(const ShapeTraits &shapeTraits, const std::vector<std::
     Expects(moveCounters_.size() == moveSamplers.size());
     Expects(moveTypeAccumulations.size() == moveSamplers.size());
 
+    // Measuring time of each move is not free, so it is done only if needed
+    using namespace std::chrono;
+    bool measureEfficiency = this->isEfficiencyMeasured();
+    high_resolution_clock::time_point start;
+    if (measureEfficiency)
+        start = high_resolution_clock::now();
+
+    auto &mt = this->mts[OMP_THREAD_ID];
+    std::size_t moveType = Simulation::sampleMoveType(moveTypeAccumulations, mt);
+    auto &moveSampler = moveSamplers[moveType];
+    auto move = moveSampler->sampleMove(*this->packing, particleIndices, mt);
+    double dE = this->evaluateMove(move, shapeTraits.getInteraction(), boundaries);
+
+    auto &moveCounter = moveCounters_[moveType];
+    bool accepted = this->unitIntervalDistribution(mt) <= std::exp(-dE / this->temperature);
+    if (accepted)
+        this->packing->acceptMove();
+    moveCounter.increment(accepted);
+
+    if (measureEfficiency) {
+        if (accepted)
+            moveCounter.addSquaredDisplacement(Simulation::calculateSquaredDisplacement(move));
+        auto end = high_resolution_clock::now();
+        moveCounter.addMicroseconds(duration<double, std::micro>(end - start).count());
+    }
+
+    return accepted;
+}
+
+std::size_t Simulation::sampleMoveType(const std::vector<std::size_t> &moveTypeAccumulations, std::mt19937 &mt) {
     std::size_t numMoves = moveTypeAccumulations.back();
     std::uniform_int_distribution<std::size_t> moveDistribution(0, numMoves - 1);
-    auto &mt = this->mts[OMP_THREAD_ID];
     std::size_t sampledMoveType = moveDistribution(mt);
     std::size_t moveType{};
     for (auto moveTypeAccumulation : moveTypeAccumulations) {
@@ -462,32 +833,21 @@ bool Simulation::tryMove(const ShapeTraits &shapeTraits, const std::vector<std::
             break;
         moveType++;
     }
+    return moveType;
+}
 
-    auto &moveSampler = moveSamplers[moveType];
-    auto move = moveSampler->sampleMove(*this->packing, particleIndices, mt);
-    const auto &interaction = shapeTraits.getInteraction();
-    double dE{};
+double Simulation::evaluateMove(const MoveSampler::MoveData &move, const Interaction &interaction,
+                                std::optional<ActiveDomain> boundaries)
+{
     switch (move.moveType) {
         case MoveSampler::MoveType::TRANSLATION:
-            dE = this->packing->tryTranslation(move.particleIdx, move.translation, interaction, boundaries);
-            break;
+            return this->packing->tryTranslation(move.particleIdx, move.translation, interaction, boundaries);
         case MoveSampler::MoveType::ROTATION:
-            dE = this->packing->tryRotation(move.particleIdx, move.rotation, interaction);
-            break;
+            return this->packing->tryRotation(move.particleIdx, move.rotation, interaction);
         case MoveSampler::MoveType::ROTOTRANSLATION:
-            dE = this->packing->tryMove(move.particleIdx, move.translation, move.rotation, interaction, boundaries);
-            break;
-    }
-
-    auto &moveCounter = moveCounters_[moveType];
-    if (this->unitIntervalDistribution(mt) <= std::exp(-dE / this->temperature)) {
-        this->packing->acceptMove();
-        moveCounter.increment(true);
-        return true;
-    } else {
-        moveCounter.increment(false);
-        return false;
+            return this->packing->tryMove(move.particleIdx, move.translation, move.rotation, interaction, boundaries);
     }
+    AssertThrow("Simulation::evaluateMove: unknown move type");
 }
 
 bool Simulation::tryScaling(const Interaction &interaction) {
@@ -531,9 +891,140 @@ bool Simulation::tryScaling(const Interaction &interaction) {
 }
 
 void Simulation::evaluateCounters(Logger &logger) {
-    this->evaluateMoleculeMoveCounter(logger);
-    if (this->environment.isBoxScalingEnabled())
-        this->evaluateScalingMoveCounter(logger);
+    if (this->stepSizeTuning == StepSizeTuning::EFFICIENCY) {
+        this->evaluateMoleculeMoveEfficiency(logger);
+        if (this->environment.isBoxScalingEnabled())
+            this->evaluateScalingMoveEfficiency(logger);
+    } else {
+        this->evaluateMoleculeMoveCounter(logger);
+        if (this->environment.isBoxScalingEnabled())
+            this->evaluateScalingMoveCounter(logger);
+    }
+}
+
+bool Simulation::isEfficiencyMeasured() const {
+    return this->shouldAdjustStepSize && this->stepSizeTuning == StepSizeTuning::EFFICIENCY;
+}
+
+void Simulation::evaluateScalingMoveEfficiency(Logger &logger) {
+    if (this->scalingCounter.getMovesSinceEvaluation() < 100)
+        return;
+
+    auto &boxScaler = this->environment.getBoxScaler();
+    double rate = this->scalingCounter.getCurrentRate();
+    double efficiency = this->scalingCounter.getCurrentEfficiency();
+    this->scalingCounter.resetCurrent();
+
+    double prevStepSize = boxScaler.getStepSize();
+    auto direction = this->scalingEfficiencyTuner.evaluate(efficiency);
+    if (direction == StepSizeEfficiencyTuner::Direction::INCREASE) {
+        if (!boxScaler.increaseStepSize()) {
+            this->scalingEfficiencyTuner.notifyChangeAborted();
+            return;
+        }
+        logger.info() << "-- Scaling efficiency: " << efficiency << ", rate: " << rate << ", step size increased: ";
+    } else {
+        if (!boxScaler.decreaseStepSize()) {
+            this->scalingEfficiencyTuner.notifyChangeAborted();
+            return;
+        }
+        logger.info() << "-- Scaling efficiency: " << efficiency << ", rate: " << rate << ", step size decreased: ";
+    }
+    logger << prevStepSize << " -> " << boxScaler.getStepSize() << std::endl;
+}
+
+void Simulation::evaluateMoleculeMoveEfficiency(Logger &logger) {
+    const auto &moveSamplers = this->environment.getMoveSamplers();
+    for (std::size_t i{}; i < moveSamplers.size(); i++) {
+        auto &moveSampler = *moveSamplers[i];
+        auto &moveCounter = this->moveCounters[i];
+        auto &tuner = this->moveEfficiencyTuners[i];
+        std::vector<bool>::reference cancelReported = this->adjustmentCancelReported[i];
+        std::size_t requestedMoves = moveSampler.getNumOfRequestedMoves(this->packing->size());
+        auto moveName = moveSampler.getName();
+        moveName.front() = static_cast<char>(toupper(moveName.front()));
+
+        if (moveCounter.getMovesSinceEvaluation() < 100 * requestedMoves)
+            continue;
+
+        double rate = moveCounter.getCurrentRate();
+        double efficiency = moveCounter.getCurrentEfficiency();
+        moveCounter.resetCurrent();
+        auto oldStepSizes = moveSampler.getStepSizes();
+        auto direction = tuner.evaluate(efficiency);
+        bool increase = (direction == StepSizeEfficiencyTuner::Direction::INCREASE);
+        bool changed = increase ? moveSampler.increaseStepSize() : moveSampler.decreaseStepSize();
+        std::string changeName = increase ? "increase" : "decrease";
+        if (changed) {
+            logger.info() << "-- " << moveName << " efficiency: " << efficiency << ", rate: " << rate;
+            logger << "; step sizes " << changeName << "d: ";
+            auto newStepSizes = moveSampler.getStepSizes();
+            printStepSizesChange(logger, oldStepSizes, newStepSizes);
+            logger << std::endl;
+            cancelReported = false;
+        } else {
+            tuner.notifyChangeAborted();
+            if (!cancelReported) {
+                logger.info() << "-- " << moveName << " efficiency: " << efficiency << ", rate: " << rate << "; ";
+                logger << changeName << " of step sizes aborted (further notices not displayed)" << std::endl;
+            }
+            cancelReported = true;
+        }
+    }
+}
+
+void Simulation::printTunedStepSizes(Logger &logger) const {
+    logger.info() << "Step sizes tuned for efficiency (squared displacement per CPU second):" << std::endl;
+    const auto &moveSamplers = this->environment.getMoveSamplers();
+    for (std::size_t i{}; i < moveSamplers.size(); i++) {
+        const auto &moveSampler = *moveSamplers[i];
+        logger << "-- " << moveSampler.getName() << ": ";
+        auto stepSizes = moveSampler.getStepSizes();
+        for (std::size_t j{}; j < stepSizes.size(); j++) {
+            logger << stepSizes[j].first << ": " << stepSizes[j].second;
+            if (j < stepSizes.size() - 1)
+                logger << ", ";
+        }
+        auto efficiency = this->moveEfficiencyTuners[i].getLastEfficiency();
+        if (efficiency.has_value())
+            logger << "; efficiency: " << *efficiency;
+        logger << std::endl;
+    }
+
+    if (this->environment.isBoxScalingEnabled()) {
+        logger << "-- scaling: " << this->environment.getBoxScaler().getStepSize();
+        auto efficiency = this->scalingEfficiencyTuner.getLastEfficiency();
+        if (efficiency.has_value())
+            logger << "; efficiency: " << *efficiency;
+        logger << std::endl;
+    }
+}
+
+double Simulation::calculateSquaredDisplacement(const MoveSampler::MoveData &move) {
+    switch (move.moveType) {
+        case MoveSampler::MoveType::TRANSLATION:
+        // Rotation step of rototranslations is scaled together with the translation one, so only the translation is
+        // taken into account
+        case MoveSampler::MoveType::ROTOTRANSLATION:
+            return move.translation.norm2();
+        case MoveSampler::MoveType::ROTATION: {
+            double cosAngle = std::clamp((move.rotation.tr() - 1) / 2, -1., 1.);
+            double angle = std::acos(cosAngle);
+            return angle * angle;
+        }
+        default:
+            AssertThrow("unreachable");
+    }
+}
+
+double Simulation::calculateSquaredBoxChange(const TriclinicBox &oldBox, const TriclinicBox &newBox) {
+    // Sum of squared relative changes of box sides
+    auto oldSides = oldBox.getSides();
+    auto newSides = newBox.getSides();
+    double change{};
+    for (std::size_t i{}; i < 3; i++)
+        change += (newSides[i] - oldSides[i]).norm2() / oldSides[i].norm2();
+    return change;
 }
 
 void Simulation::evaluateScalingMoveCounter(Logger &logger) {
@@ -615,16 +1106,25 @@ void Simulation::Counter::increment(bool accepted) {
     }
 }
 
+void Simulation::Counter::addSquaredDisplacement(double squaredDisplacement) {
+    this->squaredDisplacementSinceEvaluation += squaredDisplacement;
+}
+
+void Simulation::Counter::addMicroseconds(double microseconds) {
+    this->microsecondsSinceEvaluation += microseconds;
+}
+
 void Simulation::Counter::reset() {
     this->acceptedMoves = 0;
     this->moves = 0;
-    this->acceptedMovesSinceEvaluation = 0;
-    this->movesSinceEvaluation = 0;
+    this->resetCurrent();
 }
 
 void Simulation::Counter::resetCurrent() {
     this->acceptedMovesSinceEvaluation = 0;
     this->movesSinceEvaluation = 0;
+    this->squaredDisplacementSinceEvaluation = 0;
+    this->microsecondsSinceEvaluation = 0;
 }
 
 double Simulation::Counter::getCurrentRate() const {
@@ -635,6 +1135,12 @@ double Simulation::Counter::getRate() const {
     return static_cast<double>(this->acceptedMoves) / static_cast<double>(this->moves);
 }
 
+double Simulation::Counter::getCurrentEfficiency() const {
+    if (this->microsecondsSinceEvaluation == 0)
+        return 0;
+    return this->squaredDisplacementSinceEvaluation / this->microsecondsSinceEvaluation * 1e6;
+}
+
 std::size_t Simulation::Counter::getMovesSinceEvaluation() const {
     return this->movesSinceEvaluation;
 }
@@ -644,6 +1150,8 @@ Simulation::Counter &Simulation::Counter::operator+=(const Simulation::Counter &
     this->moves += other.moves;
     this->acceptedMovesSinceEvaluation += other.acceptedMovesSinceEvaluation;
     this->movesSinceEvaluation += other.getMovesSinceEvaluation();
+    this->squaredDisplacementSinceEvaluation += other.squaredDisplacementSinceEvaluation;
+    this->microsecondsSinceEvaluation += other.microsecondsSinceEvaluation;
     return *this;
 }
 
@@ -662,11 +1170,29 @@ void Simulation::printInlineInfo(std::size_t cycleNumber, const ShapeTraits &tra
     if (displayOverlaps)
         logger << "overlaps: " << this->packing->getCachedNumberOfOverlaps() << "; ";
 
-    logger << this->observablesCollector->generateInlineObservablesString(*this->packing, traits);
+    // The collector is in use while the asynchronous analysis is running, so the values generated by the last
+    // completed one are printed instead of waiting for the pending one
+    std::optional<AnalysedInlineInfo> inlineInfo;
+    if (this->asynchronousAnalysis == nullptr) {
+        inlineInfo = AnalysedInlineInfo{cycleNumber,
+                                        this->observablesCollector->generateInlineObservablesString(*this->packing,
+                                                                                                    traits),
+                                        this->observablesCollector->getMemoryUsage()};
+    } else {
+        std::lock_guard<std::mutex> lock(this->analysedInlineInfoMutex);
+        inlineInfo = this->analysedInlineInfo;
+    }
+
+    if (inlineInfo.has_value() && inlineInfo->cycleNumber != cycleNumber && !inlineInfo->observables.empty())
+        logger << "analysed cycle " << inlineInfo->cycleNumber << ": ";
+    if (inlineInfo.has_value())
+        logger << inlineInfo->observables;
     logger << std::endl;
     logger.verbose() << "Memory usage (bytes): shape: " << this->packing->getShapesMemoryUsage() << ", ";
-    logger << "ng: " << this->packing->getNeighbourGridMemoryUsage() << ", ";
-    logger << "obs: " << this->observablesCollector->getMemoryUsage() << std::endl;
+    logger << "ng: " << this->packing->getNeighbourGridMemoryUsage();
+    if (inlineInfo.has_value())
+        logger << ", obs: " << inlineInfo->observablesMemoryUsage;
+    logger << std::endl;
 }
 
 bool Simulation::wasInterrupted() const {
@@ -796,6 +1322,59 @@ void Simulation::updateThermodynamicParameters() {
         this->pressure = this->environment.getPressure().getValueForCycle(this->totalCycles, this->maxCycles);
     else
         this->pressure = 0;
+
+    // For the asynchronous analysis, parameters are passed to the collector together with the snapshot
+    if (this->asynchronousAnalysis == nullptr)
+        this->observablesCollector->setThermodynamicParameters(this->temperature, this->pressure);
+}
+
+void Simulation::analysePacking(const ShapeTraits &shapeTraits,
+                                const std::vector<std::unique_ptr<SimulationRecorder>> &simulationRecorders,
+                                bool addSnapshot, bool addAveragingValues)
+{
+    if (this->asynchronousAnalysis == nullptr) {
+        this->collectObservables(*this->packing, this->temperature, this->pressure, this->totalCycles, shapeTraits,
+                                 simulationRecorders, addSnapshot, addAveragingValues);
+        return;
+    }
+
+    // Inline info is generated by each analysis, so printInlineInfo can use the last completed one without waiting
+    auto analysis = [this, &shapeTraits, &simulationRecorders, addSnapshot, addAveragingValues,
+                     temperature_ = this->temperature, pressure_ = this->pressure, cycleNumber = this->totalCycles]
+                    (const Packing &snapshot)
+    {
+        this->collectObservables(snapshot, temperature_, pressure_, cycleNumber, shapeTraits, simulationRecorders,
+                                 addSnapshot, addAveragingValues);
+        AnalysedInlineInfo inlineInfo{cycleNumber,
+                                      this->observablesCollector->generateInlineObservablesString(snapshot,
+                                                                                                  shapeTraits),
+                                      this->observablesCollector->getMemoryUsage()};
+        std::lock_guard<std::mutex> lock(this->analysedInlineInfoMutex);
+        this->analysedInlineInfo = std::move(inlineInfo);
+    };
+    this->asynchronousAnalysis->run(*this->packing, std::move(analysis));
+}
+
+void Simulation::collectObservables(const Packing &packing_, double temperature_, double pressure_,
+                                    std::size_t cycleNumber, const ShapeTraits &shapeTraits,
+                                    const std::vector<std::unique_ptr<SimulationRecorder>> &simulationRecorders,
+                                    bool addSnapshot, bool addAveragingValues) const
+{
+    this->observablesCollector->setThermodynamicParameters(temperature_, pressure_);
+    if (addSnapshot) {
+        this->observablesCollector->addSnapshot(packing_, cycleNumber, shapeTraits);
+        for (const auto &recorder : simulationRecorders)
+            recorder->recordSnapshot(packing_, cycleNumber);
+    }
+    if (addAveragingValues)
+        this->observablesCollector->addAveragingValues(packing_, shapeTraits);
+}
+
+void Simulation::waitForAnalysis() {
+    if (this->asynchronousAnalysis == nullptr)
+        return;
+
+    this->asynchronousAnalysis->wait();
     this->observablesCollector->setThermodynamicParameters(this->temperature, this->pressure);
 }
 
@@ -5,19 +5,12 @@
 #ifndef RAMPACK_SIMULATION_H
 #define RAMPACK_SIMULATION_H
 
-
-// Uncomment to sanitize overlaps.
-// For overlap reduction sanitize whether cached number of overlaps is consistent with a real one after both molecule
-// moves and scaling moves.
-// For normal integration, sanitize whether there are no overlaps after molecule moves and after scaling moves
-
-// #define SIMULATION_SANITIZE_OVERLAPS
-
 #include <random>
 #include <iosfwd>
 #include <optional>
 #include <utility>
 #include <variant>
+#include <mutex>
 
 #include "Packing.h"
 #include "utils/Logger.h"
@@ -29,6 +22,11 @@
 #include "SimulationRecorder.h"
 #include "DynamicParameter.h"
 #include "DomainDecomposition.h"
+#include "StepSizeEfficiencyTuner.h"
+#include "ParticleSweep.h"
+#include "AsynchronousAnalysis.h"
+#include "OverlapSanitizer.h"
+#include "DomainDivisionTuner.h"
 
 
 /**
@@ -164,14 +162,45 @@ public:
         void combine(Environment &other);
     };
 
+    /**
+     * @brief The way step sizes of molecule moves and box moves are adjusted during thermalisation.
+     */
+    enum class StepSizeTuning {
+        /** @brief Step sizes are adjusted to keep the acceptance rate between 0.1 and 0.2. */
+        ACCEPTANCE_RATE,
+        /**
+         * @brief Step sizes are adjusted to maximize squared displacements (rotation angles for rotations, relative
+         * box changes for box moves) of accepted moves per CPU second (see StepSizeEfficiencyTuner).
+         */
+        EFFICIENCY
+    };
+
     struct IntegrationParameters {
         std::size_t thermalisationCycles{};
         std::size_t averagingCycles{};
         std::size_t averagingEvery = 100;
+        // If non-zero, bulk observables are sampled adaptively, at most every bulkAveragingMaxEvery cycles
+        std::size_t bulkAveragingMaxEvery{};
         std::size_t snapshotEvery = 100;
         std::size_t inlineInfoEvery = 100;
         std::size_t rotationMatrixFixEvery = 10000;
         std::size_t cycleOffset{};
+        StepSizeTuning stepSizeTuning = StepSizeTuning::ACCEPTANCE_RATE;
+        // The order in which particles are perturbed by molecule moves
+        ParticleSweep::Order moveScheduling = ParticleSweep::Order::RANDOM;
+        // If true, observables and snapshots are computed on a copy of the packing in a separate thread
+        bool asynchronousAnalysis{};
+        // If non-zero, overlaps are checked in the background every overlapCheckEvery cycles (see OverlapSanitizer)
+        std::size_t overlapCheckEvery{};
+        // The fraction of particles sampled in a single overlap check
+        double overlapCheckFraction = 1;
+        // If true, molecule moves without domain decomposition are evaluated speculatively in parallel
+        bool speculativeMoves{};
+        // If non-zero, domain divisions are benchmarked and switched to the fastest ones every
+        // domainDivisionTuningEvery cycles of thermalisation (see DomainDivisionTuner)
+        std::size_t domainDivisionTuningEvery{};
+        // If not empty, the averaging is resumed from the state stored using ObservablesCollector::storeAveragingState
+        std::string averagingState;
     };
 
     struct OverlapRelaxationParameters {
@@ -179,18 +208,37 @@ public:
         std::size_t inlineInfoEvery = 100;
         std::size_t rotationMatrixFixEvery = 10000;
         std::size_t cycleOffset{};
+        // The order in which particles are perturbed by molecule moves
+        ParticleSweep::Order moveScheduling = ParticleSweep::Order::RANDOM;
+        // If non-zero, the cached number of overlaps is verified in the background every overlapCheckEvery cycles
+        std::size_t overlapCheckEvery{};
+        // If true, molecule moves without domain decomposition are evaluated speculatively in parallel
+        bool speculativeMoves{};
+        // If non-zero, domain divisions are benchmarked and switched to the fastest ones every
+        // domainDivisionTuningEvery cycles (see DomainDivisionTuner)
+        std::size_t domainDivisionTuningEvery{};
     };
 
 private:
+    struct DomainSweepBuffers {
+        ParticleSweep::SubsetBuffers subsetBuffers;
+        // A single-element list of particle indices makes MoveSampler perturb exactly the chosen particle
+        std::vector<std::size_t> sweptParticle = std::vector<std::size_t>(1);
+    };
+
     class Counter {
     private:
         std::size_t movesSinceEvaluation{};
         std::size_t acceptedMovesSinceEvaluation{};
         std::size_t moves{};
         std::size_t acceptedMoves{};
+        double squaredDisplacementSinceEvaluation{};
+        double microsecondsSinceEvaluation{};
 
     public:
         void increment(bool accepted);
+        void addSquaredDisplacement(double squaredDisplacement);
+        void addMicroseconds(double microseconds);
         void reset();
         void resetCurrent();
 
@@ -199,11 +247,24 @@ private:
         [[nodiscard]] std::size_t getAcceptedMoves() const;
         [[nodiscard]] double getCurrentRate() const;
         [[nodiscard]] double getRate() const;
+        [[nodiscard]] double getCurrentEfficiency() const;
 
         Counter &operator+=(const Counter &other);
         friend Counter operator+(Counter c1, const Counter &c2) { return c1 += c2; }
     };
 
+    struct SpeculativeMove {
+        std::size_t moveType{};
+        MoveSampler::MoveData move;
+        // The random number for the Metropolis criterion, drawn when the move is sampled
+        double acceptanceRandom{};
+        double energyDelta{};
+        double microseconds{};
+        bool accepted{};
+        Vector<3> oldPosition;
+        Vector<3> newPosition;
+    };
+
     double temperature{};
     double pressure{};
 
@@ -216,11 +277,21 @@ private:
     double domainDecompositionMicroseconds{};
     double totalMicroseconds{};
     bool shouldAdjustStepSize{};
+    StepSizeTuning stepSizeTuning = StepSizeTuning::ACCEPTANCE_RATE;
+    ParticleSweep::Order moveScheduling = ParticleSweep::Order::RANDOM;
+    // Created for each run with non-random move scheduling
+    std::unique_ptr<ParticleSweep> particleSweep;
+    // Per-thread buffers for sweeps over domains, reused between cycles
+    std::vector<DomainSweepBuffers> domainSweepBuffers;
+    bool speculativeMoves{};
+    std::vector<StepSizeEfficiencyTuner> moveEfficiencyTuners;
+    StepSizeEfficiencyTuner scalingEfficiencyTuner;
     bool areOverlapsCounted{};
     std::size_t performedCycles{};
     std::size_t totalCycles{};
     std::size_t maxCycles{};
 
+    unsigned long seed{};
     std::vector<std::mt19937> mts;
     std::uniform_real_distribution<double> unitIntervalDistribution;
 
@@ -228,8 +299,25 @@ private:
     std::vector<std::size_t> allParticleIndices;
     std::array<std::size_t, 3> domainDivisions;
     std::size_t numDomains{};
+    std::unique_ptr<DomainDivisionTuner> domainDivisionTuner;
 
     std::shared_ptr<ObservablesCollector> observablesCollector;
+    std::unique_ptr<AsynchronousAnalysis> asynchronousAnalysis;
+    bool isAnalysisAsynchronous_{};
+    double analysisWaitingMicroseconds{};
+    // Inline info generated by the last completed asynchronous analysis, printed without waiting for the pending one
+    struct AnalysedInlineInfo {
+        std::size_t cycleNumber{};
+        std::string observables;
+        std::size_t observablesMemoryUsage{};
+    };
+    std::optional<AnalysedInlineInfo> analysedInlineInfo;
+    std::mutex analysedInlineInfoMutex;
+    // The seed of OverlapSanitizer is seed + OVERLAP_SANITIZER_SEED_OFFSET, so that it does not depend on the number of
+    // threads (and is far beyond seeds of per-thread RNGs)
+    static constexpr unsigned long OVERLAP_SANITIZER_SEED_OFFSET = 1ul << 20;
+    std::unique_ptr<OverlapSanitizer> overlapSanitizer;
+    double overlapCheckWaitingMicroseconds{};
 
     static std::vector<std::unique_ptr<MoveSampler>> makeRototranslation(double translationStepSize,
                                                                          double rotationStepSize);
@@ -238,12 +326,38 @@ private:
     static void accumulateCounters(std::vector<Counter> &out, const std::vector<Counter> &in);
     static void printStepSizesChange(Logger &logger, const std::vector<std::pair<std::string, double>> &oldStepSizes,
                                      const std::vector<std::pair<std::string, double>> &newStepSizes);
+    static double calculateSquaredDisplacement(const MoveSampler::MoveData &move);
+    static double calculateSquaredBoxChange(const TriclinicBox &oldBox, const TriclinicBox &newBox);
+    static std::size_t sampleMoveType(const std::vector<std::size_t> &moveTypeAccumulations, std::mt19937 &mt);
 
     void updateThermodynamicParameters();
+    void analysePacking(const ShapeTraits &shapeTraits,
+                        const std::vector<std::unique_ptr<SimulationRecorder>> &simulationRecorders, bool addSnapshot,
+                        bool addAveragingValues);
+    void collectObservables(const Packing &packing_, double temperature_, double pressure_, std::size_t cycleNumber,
+                            const ShapeTraits &shapeTraits,
+                            const std::vector<std::unique_ptr<SimulationRecorder>> &simulationRecorders,
+                            bool addSnapshot, bool addAveragingValues) const;
+    void waitForAnalysis();
     void performCycle(Logger &logger, const ShapeTraits &shapeTraits);
     void performMoves(const ShapeTraits &shapeTraits, Logger &logger);
     void performMovesWithDomainDivision(const ShapeTraits &shapeTraits);
     void performMovesWithoutDomainDivision(const ShapeTraits &shapeTraits);
+    void setDomainDivisions(const std::array<std::size_t, 3> &domainDivisions_);
+    void finishDomainDivisionTuningCycle(std::size_t numMoves, double microseconds, Logger &logger);
+    void stopDomainDivisionTuning(Logger &logger);
+    void applyTunedDomainDivisions(Logger &logger);
+    [[nodiscard]] std::size_t countAllMoves() const;
+    [[nodiscard]] unsigned long getOverlapSanitizerSeed() const;
+    void performSpeculativeMoves(const ShapeTraits &shapeTraits);
+    void sampleSpeculativeMoves(std::vector<SpeculativeMove> &moves, std::size_t maxMoves,
+                                const std::vector<std::size_t> &moveTypeAccumulations);
+    void evaluateSpeculativeMove(SpeculativeMove &speculativeMove, const Interaction &interaction,
+                                 bool measureEfficiency);
+    void commitSpeculativeMove(std::vector<SpeculativeMove> &moves, std::size_t moveIdx,
+                               const Interaction &interaction, double conflictRadius2, bool measureEfficiency);
+    double evaluateMove(const MoveSampler::MoveData &move, const Interaction &interaction,
+                        std::optional<ActiveDomain> boundaries = std::nullopt);
     bool tryMove(const ShapeTraits &shapeTraits, const std::vector<std::size_t> &particleIndices,
                  std::vector<Counter> &moveCounters_, const std::vector<std::size_t> &moveTypeAccumulations,
                  std::optional<ActiveDomain> boundaries = std::nullopt);
@@ -251,6 +365,10 @@ private:
     void evaluateCounters(Logger &logger);
     void evaluateMoleculeMoveCounter(Logger &logger);
     void evaluateScalingMoveCounter(Logger &logger);
+    void evaluateMoleculeMoveEfficiency(Logger &logger);
+    void evaluateScalingMoveEfficiency(Logger &logger);
+    [[nodiscard]] bool isEfficiencyMeasured() const;
+    void printTunedStepSizes(Logger &logger) const;
     void reset();
     void printInlineInfo(std::size_t cycleNumber, const ShapeTraits &traits, Logger &logger, bool displayOverlaps);
     [[nodiscard]] std::vector<std::size_t> calculateMoveTypeAccumulations(std::size_t numParticles) const;
@@ -368,7 +486,7 @@ public:
                        std::shared_ptr<ObservablesCollector> observablesCollector_,
                        std::vector<std::unique_ptr<SimulationRecorder>> simulationRecorders, Logger &logger);
 
-    [[nodiscard]] const ObservablesCollector &getObservablesCollector() { return *this->observablesCollector; }
+    [[nodiscard]] const ObservablesCollector &getObservablesCollector() const { return *this->observablesCollector; }
 
     /**
      * @brief Returns move statistics for all MoveSamplers.
@@ -397,6 +515,24 @@ public:
         return this->observablesCollector->getComputationMicroseconds();
     }
 
+    /**
+     * @brief Returns @a true if observables in the last integration were computed asynchronously (see
+     * Simulation::IntegrationParameters::asynchronousAnalysis). In such a case, getObservablesMicroseconds() is the
+     * time spent in the background thread.
+     */
+    [[nodiscard]] bool isAnalysisAsynchronous() const { return this->isAnalysisAsynchronous_; }
+
+    /**
+     * @brief Returns the total time the simulation has waited for asynchronous analyses to finish and for snapshots of
+     * the packing to be taken.
+     */
+    [[nodiscard]] double getAnalysisWaitingMicroseconds() const { return this->analysisWaitingMicroseconds; }
+
+    /**
+     * @brief Returns the total time the simulation has spent taking snapshots for overlap checks and waiting for them.
+     */
+    [[nodiscard]] double getOverlapCheckWaitingMicroseconds() const { return this->overlapCheckWaitingMicroseconds; }
+
     /**
      * @brief Returns the total time consumed by the simulation.
      */
@@ -407,6 +543,12 @@ public:
 
     [[nodiscard]] std::size_t getTotalCycles() const { return this->totalCycles; }
 
+    /**
+     * @brief Returns domain divisions currently used. They can differ from the ones passed to the constructor if the
+     * domains became too narrow or if they were tuned (see IntegrationParameters::domainDivisionTuningEvery).
+     */
+    [[nodiscard]] const std::array<std::size_t, 3> &getDomainDivisions() const { return this->domainDivisions; }
+
     /**
      * @brief Returns number of cycles actually performed by the class (not counging the cycle offset)
      */
@@ -0,0 +1,27 @@
+#include "StepSizeEfficiencyTuner.h"
+#include "utils/Exceptions.h"
+
+
+StepSizeEfficiencyTuner::Direction StepSizeEfficiencyTuner::evaluate(double efficiency) {
+    Expects(efficiency >= 0);
+
+    if (efficiency == 0)
+        this->direction = Direction::DECREASE;
+    else if (this->lastEfficiency.has_value() && efficiency < *this->lastEfficiency)
+        this->reverse();
+
+    this->lastEfficiency = efficiency;
+    return this->direction;
+}
+
+void StepSizeEfficiencyTuner::reverse() {
+    if (this->direction == Direction::INCREASE)
+        this->direction = Direction::DECREASE;
+    else
+        this->direction = Direction::INCREASE;
+}
+
+void StepSizeEfficiencyTuner::reset() {
+    this->direction = Direction::INCREASE;
+    this->lastEfficiency = std::nullopt;
+}
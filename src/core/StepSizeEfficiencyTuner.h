@@ -0,0 +1,59 @@
+#ifndef RAMPACK_STEPSIZEEFFICIENCYTUNER_H
+#define RAMPACK_STEPSIZEEFFICIENCYTUNER_H
+
+#include <optional>
+
+
+/**
+ * @brief A hill-climbing optimizer of a step size (of a MoveSampler or a TriclinicBoxScaler), which maximizes the
+ * sampling efficiency instead of keeping the acceptance rate in a fixed window.
+ * @details The efficiency is the sum of squared displacements (or rotation angles, volume changes, etc.) of accepted
+ * moves per CPU time spent on the moves. After each evaluation period, the step size is changed in the current
+ * direction as long as the efficiency grows - when it drops, the direction is reversed. Thus, the step size eventually
+ * oscillates around the optimal value. If no move was accepted, the step size is always decreased.
+ */
+class StepSizeEfficiencyTuner {
+public:
+    /**
+     * @brief The direction in which the step size should be changed.
+     */
+    enum class Direction {
+        /** @brief The step size should be increased. */
+        INCREASE,
+        /** @brief The step size should be decreased. */
+        DECREASE
+    };
+
+private:
+    Direction direction = Direction::INCREASE;
+    std::optional<double> lastEfficiency;
+
+    void reverse();
+
+public:
+    /**
+     * @brief Registers the @a efficiency measured with the current step size and returns the direction in which the
+     * step size should be changed.
+     */
+    Direction evaluate(double efficiency);
+
+    /**
+     * @brief Informs the tuner that the step size could not be changed in the last returned direction (because it
+     * reached its limit), so it should be reversed.
+     */
+    void notifyChangeAborted() { this->reverse(); }
+
+    /**
+     * @brief Returns the efficiency passed to the last StepSizeEfficiencyTuner::evaluate call or @a std::nullopt if
+     * there was no such call.
+     */
+    [[nodiscard]] std::optional<double> getLastEfficiency() const { return this->lastEfficiency; }
+
+    /**
+     * @brief Forgets all efficiency measurements.
+     */
+    void reset();
+};
+
+
+#endif //RAMPACK_STEPSIZEEFFICIENCYTUNER_H
@@ -0,0 +1,41 @@
+#include <cmath>
+
+#include "CentralInteraction.h"
+#include "utils/Exceptions.h"
+
+
+CentralInteraction::TabulationAccuracy CentralInteraction::tabulate(double minDistance, std::size_t numNodes,
+                                                                    PotentialTable::Interpolation interpolation)
+{
+    double maxDistance = this->getRangeRadius();
+    ExpectsMsg(std::isfinite(maxDistance), "Only potentials with a finite range can be tabulated");
+    Expects(minDistance > 0);
+    ExpectsMsg(minDistance < maxDistance, "Minimal distance of the table should be smaller than interaction range");
+    Expects(numNodes >= 2);
+
+    double minDistance2 = minDistance * minDistance;
+    double maxDistance2 = maxDistance * maxDistance;
+    double step = (maxDistance2 - minDistance2) / static_cast<double>(numNodes - 1);
+    std::vector<double> energies(numNodes);
+    for (std::size_t i{}; i < numNodes; i++)
+        energies[i] = this->calculateEnergyForDistance2(minDistance2 + step * static_cast<double>(i));
+    // Table is set only after all exact values are calculated
+    this->potentialTable = std::make_shared<PotentialTable>(minDistance2, maxDistance2, energies, interpolation);
+
+    std::vector<double> midpoints(numNodes - 1);
+    for (std::size_t i{}; i < numNodes - 1; i++)
+        midpoints[i] = minDistance2 + step * (static_cast<double>(i) + 0.5);
+    std::vector<double> tabulatedEnergies(midpoints.size());
+    this->potentialTable->evaluate(midpoints.data(), tabulatedEnergies.data(), midpoints.size());
+
+    TabulationAccuracy accuracy;
+    for (std::size_t i{}; i < midpoints.size(); i++) {
+        double error = std::abs(tabulatedEnergies[i] - this->calculateEnergyForDistance2(midpoints[i]));
+        if (error > accuracy.maxAbsoluteError) {
+            accuracy.maxAbsoluteError = error;
+            accuracy.maxErrorDistance = std::sqrt(midpoints[i]);
+        }
+    }
+    this->tabulationAccuracy = accuracy;
+    return accuracy;
+}
@@ -7,17 +7,35 @@
 
 #include <utility>
 #include <vector>
+#include <memory>
+#include <optional>
 
 #include "core/Interaction.h"
+#include "PotentialTable.h"
 
 /**
  * @brief A class representing the central interaction, where the energy depends only on the distance between
  * interaction centres.
  * @details Concrete potentials are programmed by implementing CentralInteraction::calculateEnergyForDistance2 method.
+ * The potential can be also tabulated using CentralInteraction::tabulate - then, within the table range,
+ * interpolated values are used instead.
  */
 class CentralInteraction : public Interaction {
+public:
+    /**
+     * @brief The accuracy of the tabulated potential compared to CentralInteraction::calculateEnergyForDistance2.
+     */
+    struct TabulationAccuracy {
+        /** @brief The maximal absolute difference between the tabulated and the original energy */
+        double maxAbsoluteError{};
+        /** @brief The distance at which the maximal difference occurs */
+        double maxErrorDistance{};
+    };
+
 private:
     std::vector<Vector<3>> potentialCentres;
+    std::shared_ptr<const PotentialTable> potentialTable;
+    std::optional<TabulationAccuracy> tabulationAccuracy;
 
 protected:
     /**
@@ -26,6 +44,13 @@ protected:
      */
     [[nodiscard]] virtual double calculateEnergyForDistance2(double distance2) const = 0;
 
+    /**
+     * @brief Sets the table @a potentialTable_ used for distances within it.
+     */
+    void setPotentialTable(std::shared_ptr<const PotentialTable> potentialTable_) {
+        this->potentialTable = std::move(potentialTable_);
+    }
+
 public:
     /**
      * @brief Constructs the interaction with a single interaction centre in the origin (an empty interaction centres
@@ -63,7 +88,34 @@ public:
                                                 [[maybe_unused]] std::size_t idx2,
                                                 const BoundaryConditions &bc) const final
     {
-        return this->calculateEnergyForDistance2(bc.getDistance2(pos1, pos2));
+        double distance2 = bc.getDistance2(pos1, pos2);
+        if (this->potentialTable != nullptr && this->potentialTable->contains(distance2))
+            return this->potentialTable->evaluate(distance2);
+        return this->calculateEnergyForDistance2(distance2);
+    }
+
+    /**
+     * @brief Tabulates the potential on @a numNodes nodes uniformly distributed in a squared distance between
+     * @a minDistance and the range of the interaction (CentralInteraction::getRangeRadius).
+     * @details For distances outside the table, CentralInteraction::calculateEnergyForDistance2 is still used, so
+     * @a minDistance affects only the performance, not the correctness. The accuracy of the table is estimated by
+     * comparing interpolated and exact values in the middle of all intervals between the nodes. It is also stored and
+     * can be later retrieved using CentralInteraction::getTabulationAccuracy.
+     */
+    TabulationAccuracy tabulate(double minDistance, std::size_t numNodes,
+                                PotentialTable::Interpolation interpolation);
+
+    /**
+     * @brief Returns the potential table if the potential is tabulated or @a nullptr otherwise.
+     */
+    [[nodiscard]] const PotentialTable *getPotentialTable() const { return this->potentialTable.get(); }
+
+    /**
+     * @brief Returns the accuracy of the table created by CentralInteraction::tabulate or @a std::nullopt if the
+     * potential was not tabulated this way.
+     */
+    [[nodiscard]] const std::optional<TabulationAccuracy> &getTabulationAccuracy() const {
+        return this->tabulationAccuracy;
     }
 
     [[nodiscard]] std::vector<Vector<3>> getInteractionCentres() const final { return this->potentialCentres; }
@@ -0,0 +1,96 @@
+#include <algorithm>
+
+#include "PotentialTable.h"
+#include "utils/Exceptions.h"
+
+
+PotentialTable::PotentialTable(double minDistance2_, double maxDistance2_, const std::vector<double> &energies,
+                               Interpolation interpolation_)
+        : minDistance2{minDistance2_}, maxDistance2{maxDistance2_}, interpolation{interpolation_},
+          numNodes{energies.size()}
+{
+    Expects(minDistance2_ >= 0);
+    Expects(maxDistance2_ > minDistance2_);
+    ExpectsMsg(energies.size() >= 2, "Potential table should have at least 2 nodes");
+
+    double step = (this->maxDistance2 - this->minDistance2) / static_cast<double>(this->numNodes - 1);
+    this->inverseStep = 1 / step;
+
+    switch (this->interpolation) {
+        case Interpolation::LINEAR:
+            this->calculateLinearCoefficients(energies);
+            break;
+        case Interpolation::CUBIC_SPLINE:
+            this->calculateSplineCoefficients(energies);
+            break;
+        default:
+            AssertThrow("unreachable");
+    }
+}
+
+void PotentialTable::calculateLinearCoefficients(const std::vector<double> &energies) {
+    this->coefficients.resize(this->numNodes - 1);
+    for (std::size_t i{}; i < this->coefficients.size(); i++)
+        this->coefficients[i] = {energies[i], energies[i + 1] - energies[i], 0, 0};
+}
+
+void PotentialTable::calculateSplineCoefficients(const std::vector<double> &energies) {
+    // Second derivatives (with respect to t, so the step is 1) in nodes: m[i-1] + 4m[i] + m[i+1] = 6(E[i+1] - 2E[i] +
+    // E[i-1]). Not-a-knot end conditions (continuous third derivative in the second and the last but one node) are
+    // used, since natural ones (m[0] = m[n-1] = 0) spoil the accuracy near a steep repulsive core. Substituting
+    // m[0] = 2m[1] - m[2] gives 6m[1] in the first equation (and analogously in the last one). The tridiagonal system is
+    // solved using the Thomas algorithm. For less than 4 nodes natural conditions are used
+    std::size_t n = this->numNodes;
+    std::vector<double> secondDerivatives(n, 0);
+    if (n > 2) {
+        bool notAKnot = (n >= 4);
+        std::vector<double> diagonal(n - 2, 4);
+        std::vector<double> lower(n - 2, 1);
+        std::vector<double> upper(n - 2, 1);
+        if (notAKnot) {
+            diagonal.front() = 6;
+            upper.front() = 0;
+            diagonal.back() = 6;
+            lower.back() = 0;
+        }
+        std::vector<double> rhs(n - 2);
+        for (std::size_t i = 1; i < n - 1; i++)
+            rhs[i - 1] = 6 * (energies[i + 1] - 2*energies[i] + energies[i - 1]);
+
+        for (std::size_t i = 1; i < n - 2; i++) {
+            double factor = lower[i] / diagonal[i - 1];
+            diagonal[i] -= factor * upper[i - 1];
+            rhs[i] -= factor * rhs[i - 1];
+        }
+        secondDerivatives[n - 2] = rhs[n - 3] / diagonal[n - 3];
+        for (std::size_t i = n - 3; i >= 1; i--)
+            secondDerivatives[i] = (rhs[i - 1] - upper[i - 1] * secondDerivatives[i + 1]) / diagonal[i - 1];
+
+        if (notAKnot) {
+            secondDerivatives[0] = 2*secondDerivatives[1] - secondDerivatives[2];
+            secondDerivatives[n - 1] = 2*secondDerivatives[n - 2] - secondDerivatives[n - 3];
+        }
+    }
+
+    this->coefficients.resize(n - 1);
+    for (std::size_t i{}; i < n - 1; i++) {
+        double m0 = secondDerivatives[i];
+        double m1 = secondDerivatives[i + 1];
+        this->coefficients[i] = {energies[i], energies[i + 1] - energies[i] - (2*m0 + m1) / 6, m0 / 2, (m1 - m0) / 6};
+    }
+}
+
+void PotentialTable::evaluate(const double *distances2, double *energies, std::size_t numDistances) const {
+    const auto *coeffs = this->coefficients.data();
+    auto maxIntervalIdx = static_cast<double>(this->coefficients.size() - 1);
+
+    #pragma omp simd
+    for (std::size_t i = 0; i < numDistances; i++) {
+        double x = (distances2[i] - this->minDistance2) * this->inverseStep;
+        double intervalIdxDouble = std::min(static_cast<double>(static_cast<std::size_t>(x)), maxIntervalIdx);
+        auto intervalIdx = static_cast<std::size_t>(intervalIdxDouble);
+        double t = x - intervalIdxDouble;
+        const auto &c = coeffs[intervalIdx];
+        energies[i] = c[0] + t*(c[1] + t*(c[2] + t*c[3]));
+    }
+}
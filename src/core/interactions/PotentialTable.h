@@ -0,0 +1,84 @@
+#ifndef RAMPACK_POTENTIALTABLE_H
+#define RAMPACK_POTENTIALTABLE_H
+
+#include <vector>
+#include <array>
+#include <cstddef>
+
+
+/**
+ * @brief A central potential tabulated on a uniform grid in the squared distance and interpolated between the nodes.
+ * @details Using the squared distance as a variable avoids a square root in the evaluation. Regardless of the
+ * interpolation type, on each interval between nodes the potential is represented by a polynomial of the third degree
+ * in a normalized variable <tt>t</tt> = (<tt>r<sup>2</sup></tt> - <tt>r<sub>i</sub><sup>2</sup></tt>) / @a h (where @a h
+ * is the grid step), so the evaluation is branchless and can be vectorized in PotentialTable::evaluate(const double *,
+ * double *, std::size_t) const.
+ */
+class PotentialTable {
+public:
+    /**
+     * @brief Interpolation between table nodes.
+     */
+    enum class Interpolation {
+        /** @brief Piecewise linear interpolation - continuous, but with discontinuous derivative */
+        LINEAR,
+        /** @brief Cubic spline (with not-a-knot end conditions) - with continuous first and second derivatives */
+        CUBIC_SPLINE
+    };
+
+private:
+    double minDistance2{};
+    double maxDistance2{};
+    double inverseStep{};
+    Interpolation interpolation{};
+    std::size_t numNodes{};
+    // Polynomial coefficients of each interval: c[0] + t*(c[1] + t*(c[2] + t*c[3])) for t in [0, 1]
+    std::vector<std::array<double, 4>> coefficients;
+
+    void calculateLinearCoefficients(const std::vector<double> &energies);
+    void calculateSplineCoefficients(const std::vector<double> &energies);
+
+public:
+    /**
+     * @brief Creates the table of @a energies given on nodes uniformly distributed in a squared distance from
+     * @a minDistance2_ to @a maxDistance2_ (inclusive), using a given @a interpolation_.
+     */
+    PotentialTable(double minDistance2_, double maxDistance2_, const std::vector<double> &energies,
+                   Interpolation interpolation_);
+
+    /**
+     * @brief Returns @a true if @a distance2 lies within the table.
+     */
+    [[nodiscard]] bool contains(double distance2) const {
+        return distance2 >= this->minDistance2 && distance2 <= this->maxDistance2;
+    }
+
+    /**
+     * @brief Returns the interpolated energy for a squared distance @a distance2, which has to lie within the table
+     * (see PotentialTable::contains).
+     */
+    [[nodiscard]] double evaluate(double distance2) const {
+        double x = (distance2 - this->minDistance2) * this->inverseStep;
+        auto intervalIdx = static_cast<std::size_t>(x);
+        // For distance2 == maxDistance2 the last interval is used (with t = 1)
+        if (intervalIdx >= this->coefficients.size())
+            intervalIdx = this->coefficients.size() - 1;
+        double t = x - static_cast<double>(intervalIdx);
+        const auto &c = this->coefficients[intervalIdx];
+        return c[0] + t*(c[1] + t*(c[2] + t*c[3]));
+    }
+
+    /**
+     * @brief Evaluates the energies for @a numDistances squared distances @a distances2 (which all have to lie within
+     * the table) and stores them in @a energies.
+     */
+    void evaluate(const double *distances2, double *energies, std::size_t numDistances) const;
+
+    [[nodiscard]] double getMinDistance2() const { return this->minDistance2; }
+    [[nodiscard]] double getMaxDistance2() const { return this->maxDistance2; }
+    [[nodiscard]] std::size_t getNumNodes() const { return this->numNodes; }
+    [[nodiscard]] Interpolation getInterpolation() const { return this->interpolation; }
+};
+
+
+#endif //RAMPACK_POTENTIALTABLE_H
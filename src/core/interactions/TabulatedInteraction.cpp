@@ -0,0 +1,52 @@
+#include <istream>
+#include <sstream>
+#include <string>
+
+#include "TabulatedInteraction.h"
+#include "utils/Exceptions.h"
+
+
+TabulatedInteraction::TabulatedInteraction(double minDistance, double maxDistance, const std::vector<double> &energies,
+                                           PotentialTable::Interpolation interpolation)
+        : minDistance2{minDistance * minDistance}, maxDistance2{maxDistance * maxDistance}
+{
+    Expects(minDistance > 0);
+    Expects(maxDistance > minDistance);
+    ExpectsMsg(energies.size() >= 2, "Tabulated interaction should have at least 2 nodes");
+    ExpectsMsg(energies.back() == 0, "The last energy of tabulated interaction should be zero");
+    ExpectsMsg(energies[0] > energies[1], "Tabulated interaction should be repulsive at the first node");
+
+    this->firstEnergy = energies.front();
+    double step = (this->maxDistance2 - this->minDistance2) / static_cast<double>(energies.size() - 1);
+    this->coreSlope = (energies[0] - energies[1]) / step;
+    this->setPotentialTable(std::make_shared<PotentialTable>(this->minDistance2, this->maxDistance2, energies,
+                                                             interpolation));
+}
+
+double TabulatedInteraction::calculateEnergyForDistance2(double distance2) const {
+    if (distance2 < this->minDistance2)
+        return this->firstEnergy + this->coreSlope * (this->minDistance2 - distance2);
+    else if (distance2 > this->maxDistance2)
+        return 0;
+    else
+        return this->getPotentialTable()->evaluate(distance2);
+}
+
+std::vector<double> TabulatedInteraction::readEnergies(std::istream &in) {
+    std::vector<double> energies;
+    std::string line;
+    std::size_t lineNo{};
+    while (std::getline(in, line)) {
+        lineNo++;
+        std::size_t firstNonSpace = line.find_first_not_of(" \t\r");
+        if (firstNonSpace == std::string::npos || line[firstNonSpace] == '#')
+            continue;
+
+        std::istringstream lineStream(line);
+        double energy{};
+        while (lineStream >> energy)
+            energies.push_back(energy);
+        ValidateMsg(lineStream.eof(), "Malformed energy in line " + std::to_string(lineNo) + " of the potential table");
+    }
+    return energies;
+}
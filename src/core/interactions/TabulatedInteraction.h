@@ -0,0 +1,48 @@
+#ifndef RAMPACK_TABULATEDINTERACTION_H
+#define RAMPACK_TABULATEDINTERACTION_H
+
+#include <vector>
+#include <iosfwd>
+#include <cmath>
+
+#include "CentralInteraction.h"
+
+
+/**
+ * @brief CentralInteraction class with energies given by the user on a uniform grid in the squared distance.
+ * @details The energies are interpolated between the nodes (see PotentialTable). Beyond the last node, which determines
+ * the interaction range, the energy is zero, so the last energy has to be zero as well - otherwise, there would be a
+ * step at the cutoff. Below the first node, the repulsive branch is extrapolated linearly in the squared distance with
+ * the slope of the first interval of the table, so the table has to be repulsive there (the first energy larger than
+ * the second one). This way particles closer than the first node are still pushed apart.
+ */
+class TabulatedInteraction : public CentralInteraction {
+private:
+    double firstEnergy{};
+    // Energy increase per unit decrease of the squared distance below minDistance2
+    double coreSlope{};
+    double minDistance2{};
+    double maxDistance2{};
+
+protected:
+    [[nodiscard]] double calculateEnergyForDistance2(double distance2) const override;
+
+public:
+    /**
+     * @brief Creates the interaction from @a energies given on nodes uniformly distributed in a squared distance
+     * between @a minDistance and @a maxDistance (inclusive). The first energy has to be larger than the second one
+     * and the last energy has to be zero.
+     */
+    TabulatedInteraction(double minDistance, double maxDistance, const std::vector<double> &energies,
+                         PotentialTable::Interpolation interpolation);
+
+    /**
+     * @brief Reads whitespace-separated energies from @a in. Lines starting with @a # are treated as comments.
+     */
+    [[nodiscard]] static std::vector<double> readEnergies(std::istream &in);
+
+    [[nodiscard]] double getRangeRadius() const override { return std::sqrt(this->maxDistance2); }
+};
+
+
+#endif //RAMPACK_TABULATEDINTERACTION_H
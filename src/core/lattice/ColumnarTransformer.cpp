@@ -24,27 +24,38 @@ void ColumnarTransformer::transform(Lattice &lattice, [[maybe_unused]] const Sha
     std::size_t idx1 = (axisIdx + 1) % 3;
     std::size_t idx2 = (axisIdx + 2) % 3;
 
-    std::array<std::size_t, 3> i{};
-    i.fill(0);
-    for (i[idx1] = 0; i[idx1] < dim[idx1]; i[idx1]++) {
-        for (i[idx2] = 0; i[idx2] < dim[idx2]; i[idx2]++) {
-            for (const auto &column : columnAssociation) {
-                std::uniform_real_distribution<double> zeroToOne;
-                double shift = zeroToOne(this->rng);
+    // Shifts are drawn serially in the same order as columns are looped through and then columns are translated in
+    // parallel, so the result does not depend on the number of threads
+    std::vector<double> shifts(dim[idx1] * dim[idx2] * columnAssociation.size());
+    std::uniform_real_distribution<double> zeroToOne;
+    std::generate(shifts.begin(), shifts.end(), [this, &zeroToOne]() { return zeroToOne(this->rng); });
+
+    lattice.makeIrregular();
+    #pragma omp parallel for collapse(2) default(none) \
+            shared(lattice, columnAssociation, dim, shifts) firstprivate(axisIdx, idx1, idx2)
+    for (std::size_t i1 = 0; i1 < dim[idx1]; i1++) {
+        for (std::size_t i2 = 0; i2 < dim[idx2]; i2++) {
+            std::array<std::size_t, 3> i{};
+            i[idx1] = i1;
+            i[idx2] = i2;
+            for (std::size_t columnIdx{}; columnIdx < columnAssociation.size(); columnIdx++) {
+                double shift = shifts[(i1 * dim[idx2] + i2) * columnAssociation.size() + columnIdx];
                 for (i[axisIdx] = 0; i[axisIdx] < dim[axisIdx]; i[axisIdx]++) {
                     auto &cell = lattice.modifySpecificCellMolecules(i[0], i[1], i[2]);
-                    for (auto cellIdx : column.second) {
-                        auto &shape = cell[cellIdx];
-                        auto pos = shape.getPosition();
-                        pos[axisIdx] = pos[axisIdx] + shift;
-                        while (pos[axisIdx] >= 1.0)
-                            pos[axisIdx] -= 1.0;
-                        while (pos[axisIdx] < 0.0)
-                            pos[axisIdx] += 1.0;
-                        shape.setPosition(pos);
-                    }
+                    for (auto cellIdx : columnAssociation[columnIdx].second)
+                        ColumnarTransformer::shiftShape(cell[cellIdx], axisIdx, shift);
                 }
             }
         }
     }
 }
+
+void ColumnarTransformer::shiftShape(Shape &shape, std::size_t axisIdx, double shift) {
+    auto pos = shape.getPosition();
+    pos[axisIdx] = pos[axisIdx] + shift;
+    while (pos[axisIdx] >= 1.0)
+        pos[axisIdx] -= 1.0;
+    while (pos[axisIdx] < 0.0)
+        pos[axisIdx] += 1.0;
+    shape.setPosition(pos);
+}
@@ -23,6 +23,8 @@ private:
     LatticeTraits::Axis columnAxis{};
     mutable std::mt19937 rng;
 
+    static void shiftShape(Shape &shape, std::size_t axisIdx, double shift);
+
 public:
     /**
      * @brief Constructs the object.
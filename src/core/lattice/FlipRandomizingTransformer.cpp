@@ -2,6 +2,8 @@
 // Created by pkua on 20.05.22.
 //
 
+#include <algorithm>
+
 #include "FlipRandomizingTransformer.h"
 #include "core/FreeBoundaryConditions.h"
 
@@ -12,25 +14,25 @@ void FlipRandomizingTransformer::transform(Lattice &lattice, const ShapeTraits &
 
     Vector<3> flipAxis = geometry.findFlipAxis({});
 
-    const auto &dim = lattice.getDimensions();
+    // Flips are drawn serially in the order of Lattice::generateMolecules() and then performed in parallel, so the
+    // result does not depend on the number of threads
+    std::vector<char> isFlipped(lattice.size());
+    std::uniform_int_distribution flipOrNot(0, 1);
+    std::generate(isFlipped.begin(), isFlipped.end(), [this, &flipOrNot]() { return flipOrNot(this->rng) == 1; });
+
     FreeBoundaryConditions fbc;
-    for (std::size_t i{}; i < dim[0]; i++) {
-        for (std::size_t j{}; j < dim[1]; j++) {
-            for (std::size_t k{}; k < dim[2]; k++) {
-                for (auto &shape : lattice.modifySpecificCellMolecules(i, j, k)) {
-                    std::uniform_int_distribution flipOrNot(0, 1);
-                    if (flipOrNot(this->rng) == 1) {
-                        Vector<3> axis = shape.getOrientation() * flipAxis;
-                        Matrix<3, 3> rotation = Matrix<3, 3>::rotation(axis.normalized(), M_PI);
-                        Vector<3> geometricOrigin = geometry.getGeometricOrigin(shape);
-                        Vector<3> translation = -rotation * geometricOrigin + geometricOrigin;
-                        shape.rotate(rotation);
-                        shape.translate(lattice.getCellBox().absoluteToRelative(translation), fbc);
-                    }
-                }
-            }
-        }
-    }
+    const auto &cellBox = lattice.getCellBox();
+    lattice.forEachMolecule([&](Shape &shape, std::size_t moleculeIdx) {
+        if (!isFlipped[moleculeIdx])
+            return;
+
+        Vector<3> axis = shape.getOrientation() * flipAxis;
+        Matrix<3, 3> rotation = Matrix<3, 3>::rotation(axis.normalized(), M_PI);
+        Vector<3> geometricOrigin = geometry.getGeometricOrigin(shape);
+        Vector<3> translation = -rotation * geometricOrigin + geometricOrigin;
+        shape.rotate(rotation);
+        shape.translate(cellBox.absoluteToRelative(translation), fbc);
+    });
 
     if (wasNormalized)
         lattice.normalize();
@@ -24,14 +24,41 @@ const UnitCell &Lattice::getSpecificCell(std::size_t i, std::size_t j, std::size
 }
 
 std::vector<Shape> &Lattice::modifySpecificCellMolecules(std::size_t i, std::size_t j, std::size_t k) {
-    if (this->isRegular_) {
-        this->isRegular_ = false;
-        this->cells.resize(this->numCells, this->cells.front());
-    }
-
+    this->makeIrregular();
     return this->cells[this->getCellIndex(i, j, k)].getMolecules();
 }
 
+void Lattice::makeIrregular() {
+    if (!this->isRegular_)
+        return;
+
+    // Empty cells (sharing the box) are replicated first, and molecules are copied into them in parallel
+    auto unitCellMolecules = std::move(this->cells.front().getMolecules());
+    this->cells.front().getMolecules().clear();
+    this->cells.resize(this->numCells, this->cells.front());
+
+    #pragma omp parallel for default(none) shared(unitCellMolecules)
+    for (std::size_t cellIdx = 0; cellIdx < this->numCells; cellIdx++)
+        this->cells[cellIdx].getMolecules() = unitCellMolecules;
+
+    this->isRegular_ = false;
+}
+
+void Lattice::forEachMolecule(const std::function<void(Shape &, std::size_t)> &function) {
+    this->makeIrregular();
+
+    std::array<std::size_t, 3> axisOrder{0, 1, 2};
+    auto cellOffsets = this->calculateCellOffsets(axisOrder);
+
+    #pragma omp parallel for default(none) shared(function, axisOrder, cellOffsets)
+    for (std::size_t loopIdx = 0; loopIdx < this->numCells; loopIdx++) {
+        auto cellIndices = this->getLoopCellIndices(loopIdx, axisOrder);
+        auto &molecules = this->cells[this->getCellIndex(cellIndices[0], cellIndices[1], cellIndices[2])].getMolecules();
+        for (std::size_t i{}; i < molecules.size(); i++)
+            function(molecules[i], cellOffsets[loopIdx] + i);
+    }
+}
+
 std::size_t Lattice::getCellIndex(std::size_t i, std::size_t j, std::size_t k) const {
     Expects(i < this->dimensions[0]);
     Expects(j < this->dimensions[1]);
@@ -58,22 +85,60 @@ std::size_t Lattice::size() const {
     }
 }
 
+std::array<std::size_t, 3> Lattice::getLoopCellIndices(std::size_t loopIdx,
+                                                       const std::array<std::size_t, 3> &axisOrder) const
+{
+    std::array<std::size_t, 3> cellIndices{};
+    for (auto axisIt = axisOrder.rbegin(); axisIt != axisOrder.rend(); axisIt++) {
+        cellIndices[*axisIt] = loopIdx % this->dimensions[*axisIt];
+        loopIdx /= this->dimensions[*axisIt];
+    }
+    return cellIndices;
+}
+
+std::vector<std::size_t> Lattice::calculateCellOffsets(const std::array<std::size_t, 3> &axisOrder) const {
+    // cellOffsets[loopIdx] is the index of the first molecule of loopIdx-th cell in the loop order
+    std::vector<std::size_t> cellOffsets(this->numCells + 1);
+    for (std::size_t loopIdx{}; loopIdx < this->numCells; loopIdx++) {
+        if (this->isRegular_) {
+            cellOffsets[loopIdx + 1] = cellOffsets[loopIdx] + this->cells.front().size();
+        } else {
+            auto cellIndices = this->getLoopCellIndices(loopIdx, axisOrder);
+            const auto &cell = this->getSpecificCell(cellIndices[0], cellIndices[1], cellIndices[2]);
+            cellOffsets[loopIdx + 1] = cellOffsets[loopIdx] + cell.size();
+        }
+    }
+    return cellOffsets;
+}
+
 std::vector<Shape> Lattice::generateMolecules() const {
-    std::size_t size_ = this->size();
-
-    std::vector<Shape> shapes;
-    shapes.reserve(size_);
-
-    for (std::size_t i{}; i < this->dimensions[0]; i++) {
-        for (std::size_t j{}; j < this->dimensions[1]; j++) {
-            for (std::size_t k{}; k < this->dimensions[2]; k++) {
-                const auto &cell = this->getSpecificCell(i, j, k);
-                for (const auto &shape : cell) {
-                    Vector<3> pos = Vector<3>{static_cast<double>(i), static_cast<double>(j), static_cast<double>(k)};
-                    pos += shape.getPosition();
-                    shapes.emplace_back(cell.getBox().relativeToAbsolute(pos), shape.getOrientation());
-                }
-            }
+    return this->generateMolecules({0, 1, 2}, this->size());
+}
+
+std::vector<Shape> Lattice::generateMolecules(const std::array<std::size_t, 3> &axisOrder,
+                                              std::size_t numMolecules) const
+{
+    Expects(numMolecules <= this->size());
+
+    auto cellOffsets = this->calculateCellOffsets(axisOrder);
+    std::vector<Shape> shapes(numMolecules);
+    const auto &cellBox = this->getCellBox();
+
+    #pragma omp parallel for default(none) shared(axisOrder, cellOffsets, shapes, cellBox) firstprivate(numMolecules)
+    for (std::size_t loopIdx = 0; loopIdx < this->numCells; loopIdx++) {
+        std::size_t moleculeIdx = cellOffsets[loopIdx];
+        if (moleculeIdx >= numMolecules)
+            continue;
+
+        auto cellIndices = this->getLoopCellIndices(loopIdx, axisOrder);
+        const auto &cell = this->getSpecificCell(cellIndices[0], cellIndices[1], cellIndices[2]);
+        Vector<3> cellPos{static_cast<double>(cellIndices[0]), static_cast<double>(cellIndices[1]),
+                          static_cast<double>(cellIndices[2])};
+        for (const auto &shape : cell) {
+            if (moleculeIdx == numMolecules)
+                break;
+            shapes[moleculeIdx++] = Shape(cellBox.relativeToAbsolute(cellPos + shape.getPosition()),
+                                          shape.getOrientation());
         }
     }
 
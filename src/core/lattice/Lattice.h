@@ -7,6 +7,7 @@
 
 #include <vector>
 #include <array>
+#include <functional>
 
 #include "UnitCell.h"
 
@@ -33,6 +34,9 @@ private:
     bool isRegular_{};
 
     [[nodiscard]] std::size_t getCellIndex(std::size_t i, std::size_t j, std::size_t k) const;
+    [[nodiscard]] std::array<std::size_t, 3> getLoopCellIndices(std::size_t loopIdx,
+                                                                const std::array<std::size_t, 3> &axisOrder) const;
+    [[nodiscard]] std::vector<std::size_t> calculateCellOffsets(const std::array<std::size_t, 3> &axisOrder) const;
     void normalizeRegular();
     void normalizeIrregular();
 
@@ -77,6 +81,21 @@ public:
      */
     [[nodiscard]] std::vector<Shape> &modifySpecificCellMolecules(std::size_t i, std::size_t j, std::size_t k);
 
+    /**
+     * @brief Turns the lattice into an irregular one (if it was regular) without modifying any cell.
+     * @details Afterwards, modifySpecificCellMolecules() can be called concurrently for different cells.
+     */
+    void makeIrregular();
+
+    /**
+     * @brief Invokes @a function(molecule, moleculeIdx) for all molecules in parallel, turning the lattice into an
+     * irregular one.
+     * @details @a molecule is a modifiable molecule with relative cell coordinates, while @a moleculeIdx is its index
+     * in the list returned by generateMolecules(). @a function has to be safe to call concurrently for different
+     * molecules.
+     */
+    void forEachMolecule(const std::function<void(Shape &, std::size_t)> &function);
+
     /**
      * @brief Returns a modifiable list of molecules in the unit cell of the regular lattice. Irregular lattice throws.
      * @details In contrary to modifySpecificCellMolecules(), this method does not turn the lattice into an irregular
@@ -128,6 +147,15 @@ public:
      * @details The order of molecules is an implementation detail, however not random.
      */
     [[nodiscard]] std::vector<Shape> generateMolecules() const;
+
+    /**
+     * @brief Generates first @a numMolecules molecules with absolute coordinates looping through the cells in the axis
+     * order @a axisOrder.
+     * @details @a axisOrder[0] is the outermost loop and @a axisOrder[2] is the innermost one. Order of molecules within
+     * the cell is preserved. Cells are processed in parallel.
+     */
+    [[nodiscard]] std::vector<Shape> generateMolecules(const std::array<std::size_t, 3> &axisOrder,
+                                                       std::size_t numMolecules) const;
 };
 
 
@@ -13,17 +13,21 @@ std::vector<Shape> RandomPopulator::populateLattice(const Lattice &lattice, std:
     std::size_t latticeSize = lattice.size();
     Expects(latticeSize >= numOfShapes);
 
-    auto allShapes = lattice.generateMolecules();
     std::vector<std::size_t> moleculeIdxs(latticeSize, 0);
     std::iota(moleculeIdxs.begin(), moleculeIdxs.end(), 0);
     std::shuffle(moleculeIdxs.begin(), moleculeIdxs.end(), this->rng);
-    moleculeIdxs.erase(moleculeIdxs.begin() + static_cast<std::ptrdiff_t>(numOfShapes), moleculeIdxs.end());
-    std::sort(moleculeIdxs.begin(), moleculeIdxs.end());
+    std::vector<char> isSelected(latticeSize, false);
+    for (std::size_t i{}; i < numOfShapes; i++)
+        isSelected[moleculeIdxs[i]] = true;
+    moleculeIdxs = std::vector<std::size_t>{};
 
-    std::vector<Shape> shapes;
-    shapes.reserve(numOfShapes);
-    for (auto i : moleculeIdxs)
-        shapes.push_back(allShapes[i]);
+    // Not selected molecules are removed in place to avoid keeping two copies of the whole lattice
+    auto shapes = lattice.generateMolecules();
+    std::size_t numSelected{};
+    for (std::size_t i{}; i < latticeSize; i++)
+        if (isSelected[i])
+            shapes[numSelected++] = shapes[i];
+    shapes.resize(numOfShapes);
 
     return shapes;
 }
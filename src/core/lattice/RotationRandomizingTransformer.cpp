@@ -2,6 +2,8 @@
 // Created by Piotr Kubala on 20/06/2023.
 //
 
+#include <algorithm>
+
 #include "RotationRandomizingTransformer.h"
 #include "utils/Utils.h"
 
@@ -19,30 +21,45 @@ RotationRandomizingTransformer::RotationRandomizingTransformer(const Axis &axis,
 }
 
 void RotationRandomizingTransformer::transform(Lattice &lattice, const ShapeTraits &shapeTraits) const {
-    auto dim = lattice.getDimensions();
-    for (std::size_t i{}; i < dim[0]; i++)
-        for (std::size_t j{}; j < dim[1]; j++)
-            for (std::size_t k{}; k < dim[2]; k++)
-                for (auto &shape : lattice.modifySpecificCellMolecules(i, j, k))
-                    this->rotateRandomly(shape, shapeTraits.getGeometry());
+    std::vector<RandomNumbers> randomNumbers(lattice.size());
+    std::generate(randomNumbers.begin(), randomNumbers.end(), [this]() { return this->drawRandomNumbers(); });
+
+    const auto &geometry = shapeTraits.getGeometry();
+    lattice.forEachMolecule([this, &geometry, &randomNumbers](Shape &shape, std::size_t moleculeIdx) {
+        this->rotateRandomly(shape, geometry, randomNumbers[moleculeIdx]);
+    });
 }
 
-void RotationRandomizingTransformer::rotateRandomly(Shape &shape, const ShapeGeometry &geometry) const {
-    auto getRotation = [this, &geometry, &shape](auto &&axisVariant) -> Matrix<3, 3> {
-        std::uniform_real_distribution<double> plusMinusOne(-1, 1);
-        std::uniform_real_distribution<double> zero2pi(0, 2*M_PI);
+RotationRandomizingTransformer::RandomNumbers RotationRandomizingTransformer::drawRandomNumbers() const {
+    std::uniform_real_distribution<double> plusMinusOne(-1, 1);
+    std::uniform_real_distribution<double> zero2pi(0, 2*M_PI);
+
+    RandomNumbers randomNumbers{};
+    if (std::holds_alternative<RandomAxisType>(this->axis)) {
+        randomNumbers[0] = zero2pi(this->mt);
+        randomNumbers[1] = plusMinusOne(this->mt);
+        randomNumbers[2] = zero2pi(this->mt);
+    } else {
+        randomNumbers[0] = zero2pi(this->mt);
+    }
+    return randomNumbers;
+}
 
+void RotationRandomizingTransformer::rotateRandomly(Shape &shape, const ShapeGeometry &geometry,
+                                                    const RandomNumbers &randomNumbers) const
+{
+    auto getRotation = [&geometry, &shape, &randomNumbers](auto &&axisVariant) -> Matrix<3, 3> {
         using T = std::decay_t<decltype(axisVariant)>;
         if constexpr (std::is_same_v<T, Vector<3>>) {
-            return Matrix<3, 3>::rotation(axisVariant, zero2pi(this->mt));
+            return Matrix<3, 3>::rotation(axisVariant, randomNumbers[0]);
         } else if constexpr (std::is_same_v<T, ShapeGeometry::Axis>) {
             auto theAxis = geometry.getAxis(shape, axisVariant).normalized();
-            return Matrix<3, 3>::rotation(theAxis, zero2pi(this->mt));
+            return Matrix<3, 3>::rotation(theAxis, randomNumbers[0]);
         } else if constexpr (std::is_same_v<T, RandomAxisType>) {
             // For Tait-Bryan angles, this gives a uniform probability of rotations
-            double angleX = zero2pi(this->mt);
-            double angleY = std::asin(plusMinusOne(this->mt));
-            double angleZ = zero2pi(this->mt);
+            double angleX = randomNumbers[0];
+            double angleY = std::asin(randomNumbers[1]);
+            double angleZ = randomNumbers[2];
             return Matrix<3, 3>::rotation(angleX, angleY, angleZ);
         } else {
             static_assert(always_false<T>);
@@ -8,6 +8,7 @@
 
 #include <random>
 #include <variant>
+#include <array>
 
 #include "LatticeTransformer.h"
 
@@ -37,7 +38,10 @@ private:
     mutable std::mt19937 mt;
     Axis axis;
 
-    void rotateRandomly(Shape &shape, const ShapeGeometry &geometry) const;
+    using RandomNumbers = std::array<double, 3>;
+
+    [[nodiscard]] RandomNumbers drawRandomNumbers() const;
+    void rotateRandomly(Shape &shape, const ShapeGeometry &geometry, const RandomNumbers &randomNumbers) const;
 
 public:
     /**
@@ -45,6 +49,11 @@ public:
      */
     RotationRandomizingTransformer(const Axis &axis, unsigned long seed);
 
+    /**
+     * @brief Rotates all molecules in the @a lattice.
+     * @details Random numbers are drawn serially in the order of Lattice::generateMolecules(), while rotations are
+     * performed in parallel, so the result does not depend on the number of threads.
+     */
     void transform(Lattice &lattice, const ShapeTraits &shapeTraits) const override;
 };
 
@@ -19,20 +19,28 @@ void BinAveragedFunction::addSnapshot(const Packing &packing, [[maybe_unused]] d
         this->firstOrigin = trackedOrigin;
     Vector<3> originDelta = trackedOrigin - *this->firstOrigin;
 
+    this->shapeFunction->calculateBatchConcurrently(packing.begin(), packing.end(), shapeTraits, this->functionValues,
+                                                    this->numThreads);
+
     const auto &box = packing.getBox();
     const auto &bc = packing.getBoundaryConditions();
-    #pragma omp parallel for shared(packing, bc, box, histogramBuilder, originDelta, shapeTraits) \
+    std::size_t numShapes = packing.size();
+    std::size_t numValues = this->shapeFunction->getNumValues();
+    #pragma omp parallel shared(packing, bc, box, histogramBuilder, originDelta, functionValues, numShapes, numValues) \
             default(none) num_threads(this->numThreads)
-    for (std::size_t i = 0; i < packing.size(); i++) {
-        const auto &shape = packing[i];
-        Vector<3> pos = shape.getPosition();
-        pos -= originDelta;
-        pos += bc.getCorrection(pos);
-        this->shapeFunction->calculate(shape, shapeTraits);
-        auto valuesVector = this->shapeFunction->getValues();
-        std::valarray<double> values(valuesVector.data(), valuesVector.size());
+    {
+        std::valarray<double> values(numValues);
+
+        #pragma omp for
+        for (std::size_t i = 0; i < numShapes; i++) {
+            Vector<3> pos = packing[i].getPosition();
+            pos -= originDelta;
+            pos += bc.getCorrection(pos);
+            for (std::size_t j{}; j < numValues; j++)
+                values[j] = this->functionValues[j*numShapes + i];
 
-        this->histogramBuilder.add(box.absoluteToRelative(pos), values);
+            this->histogramBuilder.add(box.absoluteToRelative(pos), values);
+        }
     }
     this->histogramBuilder.nextSnapshot();
 }
@@ -60,7 +68,7 @@ BinAveragedFunction::BinAveragedFunction(const std::array<std::size_t, 3> &numBi
                                          std::size_t numThreads)
         : numBins{normalizeNumBins(numBins)}, tracker{std::move(tracker)},
           histogramBuilder({0, 0, 0}, {1, 1, 1}, this->numBins, numThreads,
-                           BinAveragedFunction::makeInitialValarray(*shapeFunction)),
+                           BinAveragedFunction::makeInitialValarray(*shapeFunction), HistogramStorage::AUTO),
           numThreads{numThreads == 0 ? OMP_MAXTHREADS : numThreads},
           shapeFunction{std::move(shapeFunction)}, printCount{printCount}
 {
@@ -81,6 +89,6 @@ std::vector<Histogram<3, std::valarray<double>>::BinValue> BinAveragedFunction::
 }
 
 std::valarray<double> BinAveragedFunction::makeInitialValarray(const ShapeFunction &shapeFunction) {
-    std::size_t numValues = shapeFunction.getValues().size();
+    std::size_t numValues = shapeFunction.getNumValues();
     return std::valarray<double>(0.0, numValues);
 }
@@ -18,7 +18,9 @@
 /**
  * @brief Divides the system into bins and averages some observable over those bins and over the system snapshots.
  * @details The class may use GoldstoneTracker to accommodate for the movement of the system. The initial captured
- * snapshot fixes system origin position and its movement in subsequent snapshots is cancelled.
+ * snapshot fixes system origin position and its movement in subsequent snapshots is cancelled. Bins store
+ * non-arithmetic values, so for high resolutions per-thread histograms are tiled and otherwise dense (see
+ * HistogramStorage::AUTO).
  */
 class BinAveragedFunction : public BulkObservable {
 private:
@@ -28,6 +30,7 @@ private:
     std::optional<Vector<3>> firstOrigin;
     OMP_MAYBE_UNUSED std::size_t numThreads{};  // maybe_unused for builds without OpenMP support
     std::shared_ptr<ShapeFunction> shapeFunction;
+    std::vector<double> functionValues;
     bool printCount;
 
     static std::array<std::size_t, 3> normalizeNumBins(std::array<std::size_t, 3> array);
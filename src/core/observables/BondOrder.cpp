@@ -49,8 +49,8 @@ void BondOrder::calculateLayerGeometry(const Packing &packing, const std::vector
 void BondOrder::calculate(const Packing &packing, [[maybe_unused]] double temperature, [[maybe_unused]] double pressure,
                           [[maybe_unused]] const ShapeTraits &shapeTraits)
 {
-    auto layeringPoints = packing.dumpNamedPoints(shapeTraits.getGeometry(), this->layeringPointName);
-    auto bondOrderPoints = packing.dumpNamedPoints(shapeTraits.getGeometry(), this->bondOrderPointName);
+    const auto &layeringPoints = packing.dumpNamedPoints(shapeTraits.getGeometry(), this->layeringPointName);
+    const auto &bondOrderPoints = packing.dumpNamedPoints(shapeTraits.getGeometry(), this->bondOrderPointName);
 
     this->calculateLayerGeometry(packing, layeringPoints);
     const auto &bc = packing.getBoundaryConditions();
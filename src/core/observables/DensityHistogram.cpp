@@ -64,7 +64,7 @@ void DensityHistogram::clear() {
 DensityHistogram::DensityHistogram(const std::array<std::size_t, 3> &numBins, std::shared_ptr<GoldstoneTracker> tracker,
                                    Normalization normalization, bool printCount, std::size_t numThreads)
         : numBins{normalizeNumBins(numBins)}, tracker{std::move(tracker)},
-          histogramBuilder({0, 0, 0}, {1, 1, 1}, this->numBins, numThreads),
+          histogramBuilder({0, 0, 0}, {1, 1, 1}, this->numBins, numThreads, 0, HistogramStorage::AUTO),
           numThreads{numThreads == 0 ? OMP_MAXTHREADS : numThreads}, normalization{normalization},
           printCount{printCount}
 {
@@ -17,7 +17,9 @@
  * @brief BulkObservable creating the density histogram.
  * @details The histogram is normalized by multiplying by the number of bins and dividing by the number of molecules.
  * The class may use GoldstoneTracker to accommodate for the movement of the system. The initial captured snapshot
- * fixes system origin position and its movement in subsequent snapshots is cancelled.
+ * fixes system origin position and its movement in subsequent snapshots is cancelled. For high resolutions, per-thread
+ * histograms are tiled, while for moderate ones a single histogram is shared atomically by all threads (see
+ * HistogramStorage::AUTO).
  */
 class DensityHistogram : public BulkObservable {
 public:
@@ -5,20 +5,76 @@
 #ifndef RAMPACK_ENERGYPERPARTICLE_H
 #define RAMPACK_ENERGYPERPARTICLE_H
 
-#include "core/Observable.h"
+#include <vector>
+#include <cmath>
+
+#include "core/IncrementalObservable.h"
+#include "utils/Exceptions.h"
+#include "utils/OMPMacros.h"
 
 /**
  * @brief Energy per particle interval observable.
+ * @details The observable is incremental (see IncrementalObservable) - when attached to the packing, energy changes of
+ * accepted moves are accumulated instead of recalculating the total energy.
  */
-class EnergyPerParticle : public Observable {
+class EnergyPerParticle : public IncrementalObservable {
 private:
     double energyPerParticle{};
+    double totalEnergy{};
+    std::vector<double> totalEnergyDeltas;
+
+protected:
+    void recalculate(const Packing &packing, [[maybe_unused]] double temperature, [[maybe_unused]] double pressure,
+                     const ShapeTraits &shapeTraits) override
+    {
+        this->totalEnergy = packing.getTotalEnergy(shapeTraits.getInteraction());
+        this->totalEnergyDeltas.assign(packing.getMoveThreads(), 0);
+        this->energyPerParticle = this->totalEnergy / packing.size();
+    }
+
+    void calculateIncrementally(const Packing &packing, [[maybe_unused]] double temperature,
+                                [[maybe_unused]] double pressure,
+                                [[maybe_unused]] const ShapeTraits &shapeTraits) override
+    {
+        for (auto &delta : this->totalEnergyDeltas) {
+            this->totalEnergy += delta;
+            delta = 0;
+        }
+        this->energyPerParticle = this->totalEnergy / packing.size();
+    }
 
 public:
-    void calculate(const Packing &packing, [[maybe_unused]] double temperature, [[maybe_unused]] double pressure,
-                   const ShapeTraits &shapeTraits) override
+    /**
+     * @brief Creates the class. @a fullRecalculationPeriod is passed to IncrementalObservable.
+     */
+    explicit EnergyPerParticle(std::size_t fullRecalculationPeriod = DEFAULT_FULL_RECALCULATION_PERIOD)
+            : IncrementalObservable(fullRecalculationPeriod)
+    { }
+
+    void particleMoved([[maybe_unused]] const Packing &packing, [[maybe_unused]] std::size_t particleIdx,
+                       [[maybe_unused]] const Shape &oldShape, [[maybe_unused]] const Shape &newShape,
+                       double energyDelta) override
+    {
+        if (!this->isUpToDate())
+            return;
+
+        if (std::isnan(energyDelta)) {
+            this->invalidate();
+            return;
+        }
+
+        std::size_t threadId = OMP_THREAD_ID;
+        Assert(threadId < this->totalEnergyDeltas.size());
+        this->totalEnergyDeltas[threadId] += energyDelta;
+    }
+
+    void boxScaled([[maybe_unused]] const Packing &packing, [[maybe_unused]] const TriclinicBox &oldBox,
+                   double energyDelta) override
     {
-        this->energyPerParticle = packing.getTotalEnergy(shapeTraits.getInteraction()) / packing.size();
+        if (std::isnan(energyDelta))
+            this->invalidate();
+        else
+            this->totalEnergy += energyDelta;
     }
 
     [[nodiscard]] std::vector<std::string> getIntervalHeader() const override { return {"E"}; }
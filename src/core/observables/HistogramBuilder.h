@@ -11,6 +11,7 @@
 #include <tuple>
 
 #include "geometry/Vector.h"
+#include "utils/CompilerMacros.h"
 #include "Histogram.h"
 
 
@@ -32,6 +33,45 @@ enum class ReductionMethod {
 };
 
 
+/**
+ * @brief The way HistogramBuilder stores per-thread histograms for the current snapshot.
+ */
+enum class HistogramStorage {
+    /**
+     * @brief Each thread has a full, dense histogram.
+     * @details It is the fastest option for small histograms.
+     */
+    DENSE,
+    /**
+     * @brief Per-thread histograms are divided into tiles of HistogramBuilder::TILE_SIZE bins, which are allocated
+     * when a value is first added to them and then kept for later snapshots. Tiles touched in a snapshot are merged
+     * into the main histogram in parallel.
+     * @details It is suitable for high-resolution histograms, where dense per-thread histograms would use too much
+     * memory and merging them would dominate the computation time.
+     */
+    TILED,
+    /**
+     * @brief All threads share a single histogram and add values to it atomically. It is available only for arithmetic
+     * types of bin values.
+     * @details It is suitable for histograms with many bins per thread, where threads rarely contend for the same bin,
+     * while folding per-thread histograms would be comparable to the accumulation itself.
+     */
+    ATOMIC,
+    /**
+     * @brief The storage is picked based on the number of bins and threads:
+     * <ol>
+     *     <li>HistogramStorage::TILED if the total number of bins in dense per-thread histograms would be at least
+     *     HistogramBuilder::AUTO_TILED_STORAGE_THRESHOLD,</li>
+     *     <li>otherwise HistogramStorage::ATOMIC if bin values are arithmetic, more than one thread is used and the
+     *     total number of bins in dense per-thread histograms would be at least
+     *     HistogramBuilder::AUTO_ATOMIC_STORAGE_THRESHOLD,</li>
+     *     <li>otherwise HistogramStorage::DENSE.</li>
+     * </ol>
+     */
+    AUTO
+};
+
+
 /**
  * @brief Class facilitating multithreaded building a histogram, where each bin accumulates arbitrary values inserted
  * in it (it is not restricted only to counting points), which are then averaged over many snapshots.
@@ -40,6 +80,8 @@ enum class ReductionMethod {
  * Then nextSnapshot() method adds the data accumulated by add() to the main histogram and increases the snapshot
  * counter. Before adding the snapshot one can renormalize bin values using renormalizeBins() method. After gathering
  * all snapshots dumpHistogram() (or dumoValues()) method can be used to obtain a final, snapshot-averaged histogram.
+ * Per-thread storage can be dense, tiled or shared and atomic (see HistogramStorage). Per-thread histograms are folded
+ * into the main one in parallel, for disjoint ranges of bins.
  */
 template<std::size_t DIM = 1, typename T = double>
 class HistogramBuilder {
@@ -51,24 +93,73 @@ private:
     std::array<double, DIM> step{};
     std::array<std::size_t, DIM> numBins{};
     std::size_t flatNumBins{};
+    std::size_t numThreads{};
     std::size_t numSnapshots{};
     Histogram<DIM, T> histogram;
     std::vector<Histogram<DIM, T>> currentHistograms;
     T initialValue{};
 
+    using ValueCount = typename Histogram<DIM, T>::ValueCount;
+    using Tile = std::vector<ValueCount>;
+
+    // The number of consecutive bins folded at once when merging per-thread histograms
+    static constexpr std::size_t MERGE_BLOCK_SIZE = 256;
+
+    bool tiled{};
+    bool atomic{};
+    std::size_t numTiles{};
+    std::vector<std::vector<Tile>> currentTiles;
+    // Tiles are kept allocated between snapshots - only those touched in the current snapshot are merged
+    std::vector<std::vector<char>> touchedTiles;
+
+    [[nodiscard]] std::size_t calculateFlatBinIndex(const Vector<DIM> &pos) const;
+    [[nodiscard]] std::size_t getTileSize(std::size_t tileIdx) const;
+    void addToTile(std::size_t threadId, std::size_t flatIdx, const T &value);
+    void mergeTiles();
+    void mergeHistograms();
+    // Innermost loop of merging, multiversioned for different instruction sets
+    RAMPACK_MULTIVERSIONED
+    static void accumulateBins(ValueCount *bins, const ValueCount *binsToAdd, std::size_t numBinsToAdd);
+    void addAtomically(const Vector<DIM> &pos, const T &value);
+
     template<typename T1>
     static std::array<std::decay_t<T1>, DIM> filledArray(T1 &&value);
 
 public:
+    /**
+     * @brief The number of consecutive bins (in the flattened order) in a single tile for HistogramStorage::TILED.
+     */
+    static constexpr std::size_t TILE_SIZE = 4096;
+
+    /**
+     * @brief The total number of bins in all per-thread histograms, from which HistogramStorage::AUTO uses
+     * HistogramStorage::TILED.
+     */
+    static constexpr std::size_t AUTO_TILED_STORAGE_THRESHOLD = 1ul << 22;
+
+    /**
+     * @brief The total number of bins in all per-thread histograms, from which HistogramStorage::AUTO uses
+     * HistogramStorage::ATOMIC (below AUTO_TILED_STORAGE_THRESHOLD).
+     * @details Around this size merging dense per-thread histograms becomes as costly as atomic accumulation.
+     */
+    static constexpr std::size_t AUTO_ATOMIC_STORAGE_THRESHOLD = 1ul << 19;
+
+    /**
+     * @brief The minimal number of bins in all per-thread histograms, from which they are folded into the main
+     * histogram in parallel.
+     */
+    static constexpr std::size_t PARALLEL_MERGE_THRESHOLD = 1ul << 14;
+
     /**
      * @brief Construct a class where for axis @a i = 0, 1, ... values are gathered in the range `[min[i], max[i]]`
      * (inclusive) divided into `numBins[i]` bins with initial value @a initialValue; it setups concurrent accumulation
      * for at most @a numThreads OpenMP threads.
-     * @details If @a numThreads is equal to 0, @a omp_get_max_threads() threads will be used.
+     * @details If @a numThreads is equal to 0, @a omp_get_max_threads() threads will be used. @a storage specifies
+     * how per-thread histograms are stored (see HistogramStorage).
      */
     explicit HistogramBuilder(const std::array<double, DIM> &min, const std::array<double, DIM> &max,
                               const std::array<std::size_t, DIM> &numBins, std::size_t numThreads = 1,
-                              const T &initialValue = T{});
+                              const T &initialValue = T{}, HistogramStorage storage = HistogramStorage::DENSE);
 
     /**
      * @brief Simplified version of
@@ -76,9 +167,9 @@ public:
      * where all dimensions have the same range and are divided into the same number of bins.
      */
     explicit HistogramBuilder(double min, double max, std::size_t numBins, std::size_t numThreads = 1,
-                              const T &initialValue = T{})
+                              const T &initialValue = T{}, HistogramStorage storage = HistogramStorage::DENSE)
             : HistogramBuilder(filledArray(min), filledArray(max), filledArray(numBins), numThreads,
-                               initialValue)
+                               initialValue, storage)
     { }
 
     /**
@@ -123,6 +214,16 @@ public:
      */
     void clear();
 
+    /**
+     * @brief Returns @a true if per-thread histograms are tiled (see HistogramStorage::TILED).
+     */
+    [[nodiscard]] bool isTiled() const { return this->tiled; }
+
+    /**
+     * @brief Returns @a true if all threads share a single histogram (see HistogramStorage::ATOMIC).
+     */
+    [[nodiscard]] bool isAtomic() const { return this->atomic; }
+
     /**
      * @brief See Histogram::getNumBins(std::size_t) const.
      */
@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <numeric>
 #include <cmath>
+#include <type_traits>
 #include <ZipIterator.hpp>
 
 #include "utils/Exceptions.h"
@@ -15,7 +16,18 @@
 template<std::size_t DIM, typename T>
 void HistogramBuilder<DIM, T>::add(const Vector<DIM> &pos, const T &value) {
     std::size_t threadId = OMP_THREAD_ID;
-    Expects(threadId < this->currentHistograms.size());
+    Expects(threadId < this->numThreads);
+
+    if (this->tiled) {
+        this->addToTile(threadId, this->calculateFlatBinIndex(pos), value);
+        return;
+    }
+
+    if (this->atomic) {
+        this->addAtomically(pos, value);
+        return;
+    }
+
     auto &currentHistogram = this->currentHistograms[threadId];
     auto &bin = currentHistogram.atPos(pos);
     bin.value += value;
@@ -23,19 +35,125 @@ void HistogramBuilder<DIM, T>::add(const Vector<DIM> &pos, const T &value) {
 }
 
 template<std::size_t DIM, typename T>
-void HistogramBuilder<DIM, T>::nextSnapshot() {
-    for (auto &currentHistogram : this->currentHistograms) {
-        this->histogram += currentHistogram;
-        currentHistogram.clear();
+void HistogramBuilder<DIM, T>::addAtomically(const Vector<DIM> &pos, const T &value) {
+    if constexpr (std::is_arithmetic_v<T>) {
+        auto &bin = this->currentHistograms.front().atPos(pos);
+        #pragma omp atomic
+        bin.value += value;
+        #pragma omp atomic
+        bin.count++;
+    } else {
+        AssertThrow("atomic accumulation of non-arithmetic values");
+    }
+}
+
+template<std::size_t DIM, typename T>
+std::size_t HistogramBuilder<DIM, T>::calculateFlatBinIndex(const Vector<DIM> &pos) const {
+    for (auto[posItem, minItem, maxItem] : Zip(pos, this->min, this->max)) {
+        Expects(posItem >= minItem);
+        Expects(posItem <= maxItem);
+    }
+
+    // The same binning as in Histogram, but branchless. Positions are within range, so the cast is equivalent to floor
+    std::size_t flatIdx{};
+    for (std::size_t i{}; i < DIM; i++) {
+        auto binIdx = static_cast<std::size_t>((pos[i] - this->min[i]) / this->step[i]);
+        binIdx = std::min(binIdx, this->numBins[i] - 1);
+        flatIdx = this->numBins[i]*flatIdx + binIdx;
     }
+    return flatIdx;
+}
+
+template<std::size_t DIM, typename T>
+std::size_t HistogramBuilder<DIM, T>::getTileSize(std::size_t tileIdx) const {
+    return std::min(TILE_SIZE, this->flatNumBins - tileIdx*TILE_SIZE);
+}
+
+template<std::size_t DIM, typename T>
+void HistogramBuilder<DIM, T>::addToTile(std::size_t threadId, std::size_t flatIdx, const T &value) {
+    std::size_t tileIdx = flatIdx / TILE_SIZE;
+    auto &tile = this->currentTiles[threadId][tileIdx];
+    if (tile.empty())
+        tile.resize(this->getTileSize(tileIdx), ValueCount{this->initialValue, 0});
+    this->touchedTiles[threadId][tileIdx] = true;
+
+    auto &bin = tile[flatIdx % TILE_SIZE];
+    bin.value += value;
+    bin.count++;
+}
+
+template<std::size_t DIM, typename T>
+void HistogramBuilder<DIM, T>::nextSnapshot() {
+    if (this->tiled)
+        this->mergeTiles();
+    else
+        this->mergeHistograms();
     this->numSnapshots++;
 }
 
+template<std::size_t DIM, typename T>
+void HistogramBuilder<DIM, T>::mergeHistograms() {
+    // Each thread folds a disjoint range of bins from all per-thread histograms and clears them. Per-thread histograms
+    // are added one by one, so each bin is summed in the same order as in the serial loop
+    auto bins = this->histogram.begin();
+    auto numThreads = static_cast<int>(this->numThreads);
+    bool isMergeParallel = this->currentHistograms.size() * this->flatNumBins >= PARALLEL_MERGE_THRESHOLD;
+    std::size_t numBlocks = (this->flatNumBins + MERGE_BLOCK_SIZE - 1) / MERGE_BLOCK_SIZE;
+    const ValueCount emptyBin{this->initialValue, 0};
+    #pragma omp parallel for schedule(static) shared(bins, emptyBin) num_threads(numThreads) if(isMergeParallel)
+    for (std::size_t blockIdx = 0; blockIdx < numBlocks; blockIdx++) {
+        std::size_t blockBegin = blockIdx*MERGE_BLOCK_SIZE;
+        std::size_t blockSize = std::min(MERGE_BLOCK_SIZE, this->flatNumBins - blockBegin);
+        auto blockBins = bins + static_cast<std::ptrdiff_t>(blockBegin);
+        for (auto &currentHistogram : this->currentHistograms) {
+            auto currentBins = currentHistogram.begin() + static_cast<std::ptrdiff_t>(blockBegin);
+            HistogramBuilder::accumulateBins(&*blockBins, &*currentBins, blockSize);
+            std::fill(currentBins, currentBins + static_cast<std::ptrdiff_t>(blockSize), emptyBin);
+        }
+    }
+}
+
+template<std::size_t DIM, typename T>
+void HistogramBuilder<DIM, T>::accumulateBins(ValueCount *bins, const ValueCount *binsToAdd,
+                                              std::size_t numBinsToAdd)
+{
+    for (std::size_t i{}; i < numBinsToAdd; i++)
+        bins[i] += binsToAdd[i];
+}
+
+template<std::size_t DIM, typename T>
+void HistogramBuilder<DIM, T>::mergeTiles() {
+    // Tiles cover disjoint ranges of bins, so they can be merged independently by many threads. Merged tiles are
+    // cleared, but not deallocated - reallocating (and page-faulting) them in each snapshot would dominate the time
+    auto bins = this->histogram.begin();
+    auto numThreads = static_cast<int>(this->numThreads);
+    const ValueCount emptyBin{this->initialValue, 0};
+    #pragma omp parallel for schedule(dynamic) shared(bins, emptyBin) num_threads(numThreads)
+    for (std::size_t tileIdx = 0; tileIdx < this->numTiles; tileIdx++) {
+        auto tileBins = bins + static_cast<std::ptrdiff_t>(tileIdx*TILE_SIZE);
+        for (std::size_t threadIdx{}; threadIdx < this->currentTiles.size(); threadIdx++) {
+            auto &touched = this->touchedTiles[threadIdx][tileIdx];
+            if (!touched)
+                continue;
+
+            auto &tile = this->currentTiles[threadIdx][tileIdx];
+            HistogramBuilder::accumulateBins(&*tileBins, tile.data(), tile.size());
+            std::fill(tile.begin(), tile.end(), emptyBin);
+            touched = false;
+        }
+    }
+}
+
 template<std::size_t DIM, typename T>
 void HistogramBuilder<DIM, T>::clear() {
     this->histogram.clear();
     for (auto &currentHistogram : this->currentHistograms)
         currentHistogram.clear();
+    for (auto &threadTiles : this->currentTiles)
+        for (auto &tile : threadTiles)
+            tile = Tile{};
+    for (auto &threadTouchedTiles : this->touchedTiles)
+        std::fill(threadTouchedTiles.begin(), threadTouchedTiles.end(), false);
     this->numSnapshots = 0;
 }
 
@@ -77,7 +195,7 @@ Histogram<DIM, T> HistogramBuilder<DIM, T>::dumpHistogram(ReductionMethod reduct
 template<std::size_t DIM, typename T>
 HistogramBuilder<DIM, T>::HistogramBuilder(const std::array<double, DIM> &min, const std::array<double, DIM> &max,
                                            const std::array<std::size_t, DIM> &numBins,
-                                           std::size_t numThreads, const T &initialValue)
+                                           std::size_t numThreads, const T &initialValue, HistogramStorage storage)
         : min{min}, max{max}, numBins{numBins},
           flatNumBins{std::accumulate(numBins.begin(), numBins.end(), 1ul, std::multiplies<>{})},
           histogram(min, max, numBins, initialValue),
@@ -92,7 +210,39 @@ HistogramBuilder<DIM, T>::HistogramBuilder(const std::array<double, DIM> &min, c
 
     if (numThreads == 0)
         numThreads = OMP_MAXTHREADS;
-    this->currentHistograms.resize(numThreads, Histogram<DIM, T>(this->min, this->max, this->numBins, initialValue));
+
+    this->numThreads = numThreads;
+
+    if (storage == HistogramStorage::AUTO) {
+        std::size_t totalNumBins = numThreads * this->flatNumBins;
+        if (totalNumBins >= AUTO_TILED_STORAGE_THRESHOLD) {
+            storage = HistogramStorage::TILED;
+        } else if (std::is_arithmetic_v<T> && numThreads > 1 && totalNumBins >= AUTO_ATOMIC_STORAGE_THRESHOLD) {
+            storage = HistogramStorage::ATOMIC;
+        } else {
+            storage = HistogramStorage::DENSE;
+        }
+    }
+
+    switch (storage) {
+        case HistogramStorage::DENSE:
+            this->currentHistograms.resize(numThreads,
+                                           Histogram<DIM, T>(this->min, this->max, this->numBins, initialValue));
+            break;
+        case HistogramStorage::TILED:
+            this->tiled = true;
+            this->numTiles = (this->flatNumBins + TILE_SIZE - 1) / TILE_SIZE;
+            this->currentTiles.resize(numThreads, std::vector<Tile>(this->numTiles));
+            this->touchedTiles.resize(numThreads, std::vector<char>(this->numTiles, false));
+            break;
+        case HistogramStorage::ATOMIC:
+            ExpectsMsg(std::is_arithmetic_v<T>, "Atomic histogram storage requires arithmetic bin values");
+            this->atomic = true;
+            this->currentHistograms.emplace_back(this->min, this->max, this->numBins, initialValue);
+            break;
+        default:
+            AssertThrow("unreachable");
+    }
 }
 
 template<std::size_t DIM, typename T>
@@ -100,6 +250,18 @@ template<std::size_t DIM_>
 std::enable_if_t<DIM_ == 1, void> HistogramBuilder<DIM, T>::renormalizeBins(const std::vector<double> &factors) {
     for (auto &currentHistogram : this->currentHistograms)
         currentHistogram.renormalizeBins(factors);
+
+    if (!this->tiled)
+        return;
+
+    Expects(factors.size() == this->flatNumBins);
+    for (auto &threadTiles : this->currentTiles) {
+        for (std::size_t tileIdx{}; tileIdx < this->numTiles; tileIdx++) {
+            auto &tile = threadTiles[tileIdx];
+            for (std::size_t i{}; i < tile.size(); i++)
+                tile[i] *= factors[tileIdx*TILE_SIZE + i];
+        }
+    }
 }
 
 template<std::size_t DIM, typename T>
@@ -5,18 +5,57 @@
 #include <algorithm>
 
 #include "NematicOrder.h"
+#include "utils/Exceptions.h"
+#include "utils/OMPMacros.h"
 
-void NematicOrder::calculate(const Packing &packing, [[maybe_unused]] double temperature,
-                             [[maybe_unused]] double pressure, const ShapeTraits &shapeTraits)
+void NematicOrder::recalculate(const Packing &packing, [[maybe_unused]] double temperature,
+                               [[maybe_unused]] double pressure, const ShapeTraits &shapeTraits)
 {
-    this->QTensor = Matrix<3, 3>{};
-    for (const auto &shape : packing) {
-        Vector<3> axis = shapeTraits.getGeometry().getPrimaryAxis(shape);
-        for (std::size_t i{}; i < 3; i++)
-            for (std::size_t j{}; j < 3; j++)
-                this->QTensor(i, j) += axis[i] * axis[j];
+    this->axisTensorSum = Matrix<3, 3>{};
+    for (const auto &shape : packing)
+        this->axisTensorSum += NematicOrder::calculateAxisTensor(shapeTraits.getGeometry().getPrimaryAxis(shape));
+    this->axisTensorSumDeltas.assign(packing.getMoveThreads(), Matrix<3, 3>{});
+
+    this->calculateQTensorAndP2(packing.size());
+}
+
+void NematicOrder::calculateIncrementally(const Packing &packing, [[maybe_unused]] double temperature,
+                                          [[maybe_unused]] double pressure,
+                                          [[maybe_unused]] const ShapeTraits &shapeTraits)
+{
+    for (auto &delta : this->axisTensorSumDeltas) {
+        this->axisTensorSum += delta;
+        delta = Matrix<3, 3>{};
     }
-    this->QTensor /= static_cast<double>(packing.size());
+
+    this->calculateQTensorAndP2(packing.size());
+}
+
+void NematicOrder::particleMoved([[maybe_unused]] const Packing &packing, [[maybe_unused]] std::size_t particleIdx,
+                                 const Shape &oldShape, const Shape &newShape,
+                                 [[maybe_unused]] double energyDelta)
+{
+    if (!this->isUpToDate() || oldShape.getOrientation() == newShape.getOrientation())
+        return;
+
+    std::size_t threadId = OMP_THREAD_ID;
+    Assert(threadId < this->axisTensorSumDeltas.size());
+    const auto &geometry = this->getShapeTraits().getGeometry();
+    auto &delta = this->axisTensorSumDeltas[threadId];
+    delta += NematicOrder::calculateAxisTensor(geometry.getPrimaryAxis(newShape));
+    delta -= NematicOrder::calculateAxisTensor(geometry.getPrimaryAxis(oldShape));
+}
+
+Matrix<3, 3> NematicOrder::calculateAxisTensor(const Vector<3> &axis) {
+    Matrix<3, 3> axisTensor;
+    for (std::size_t i{}; i < 3; i++)
+        for (std::size_t j{}; j < 3; j++)
+            axisTensor(i, j) = axis[i] * axis[j];
+    return axisTensor;
+}
+
+void NematicOrder::calculateQTensorAndP2(std::size_t numParticles) {
+    this->QTensor = this->axisTensorSum / static_cast<double>(numParticles);
     // Take into account the normalisation of the order parameter
     this->QTensor = 0.5*(3.*this->QTensor - Matrix<3, 3>::identity());
     auto eigenvalues = calculateEigenvalues(this->QTensor);
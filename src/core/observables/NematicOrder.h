@@ -6,18 +6,35 @@
 #define RAMPACK_NEMATICORDER_H
 
 #include <array>
+#include <vector>
 
-#include "core/Observable.h"
+#include "core/IncrementalObservable.h"
 
 /**
  * @brief P2 nematic order interval observable. P2 is given by highest-magnitude eigenvalue of the Q tensor.
+ * @details The observable is incremental (see IncrementalObservable) - when attached to the packing, only rotated
+ * particles contribute to the update of the Q tensor.
  */
-class NematicOrder : public Observable {
+class NematicOrder : public IncrementalObservable {
 private:
     bool dumpQTensor{};
     Matrix<3, 3> QTensor;
     double P2{};
 
+    // Sum of outer products of primary axes of all particles and its per move thread changes
+    Matrix<3, 3> axisTensorSum;
+    std::vector<Matrix<3, 3>> axisTensorSumDeltas;
+
+    static Matrix<3, 3> calculateAxisTensor(const Vector<3> &axis);
+
+    void calculateQTensorAndP2(std::size_t numParticles);
+
+protected:
+    void recalculate(const Packing &packing, double temperature, double pressure,
+                     const ShapeTraits &shapeTraits) override;
+    void calculateIncrementally(const Packing &packing, double temperature, double pressure,
+                                const ShapeTraits &shapeTraits) override;
+
 public:
     /**
      * @brief Returns eigenvalues of a given @a matrix.
@@ -26,12 +43,18 @@ public:
 
     /**
      * @brief Creates the class. If @a dumpQTensor_ is @a true, whole Q tensor (upper-triangle part) will be also
-     * dumped.
+     * dumped. @a fullRecalculationPeriod is passed to IncrementalObservable.
      */
-    explicit NematicOrder(bool dumpQTensor_ = false) : dumpQTensor{dumpQTensor_} { }
+    explicit NematicOrder(bool dumpQTensor_ = false,
+                          std::size_t fullRecalculationPeriod = DEFAULT_FULL_RECALCULATION_PERIOD)
+            : IncrementalObservable(fullRecalculationPeriod), dumpQTensor{dumpQTensor_}
+    { }
 
-    void calculate(const Packing &packing, double temperature, double pressure,
-                   const ShapeTraits &shapeTraits) override;
+    void particleMoved(const Packing &packing, std::size_t particleIdx, const Shape &oldShape,
+                       const Shape &newShape, double energyDelta) override;
+    void boxScaled([[maybe_unused]] const Packing &packing, [[maybe_unused]] const TriclinicBox &oldBox,
+                   [[maybe_unused]] double energyDelta) override
+    { }
     [[nodiscard]] std::vector<std::string> getIntervalHeader() const override;
     [[nodiscard]] std::vector<double> getIntervalValues() const override;
     [[nodiscard]] std::vector<std::string> getNominalHeader() const override { return {}; }
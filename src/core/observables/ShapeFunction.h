@@ -6,9 +6,14 @@
 #define RAMPACK_SHAPEFUNCTION_H
 
 #include <string>
+#include <vector>
+#include <iterator>
+#include <algorithm>
 
 #include "core/Shape.h"
 #include "core/ShapeTraits.h"
+#include "utils/OMPMacros.h"
+#include "utils/Exceptions.h"
 
 
 /**
@@ -18,9 +23,19 @@
  * particular components (getNames()). For example, the primary name can be `axis` and component names can by `x`, `y`
  * and `z`, referring to subsequent coordinates. If the function is single-valued, the name of the only component should
  * be the same as the primary name.
+ *
+ * <p> Apart from the stateful, per-shape calculate() + getValues() interface, the function can be evaluated for a whole
+ * range of shapes using calculateBatch(), which writes the values to a caller-provided buffer without allocating any
+ * memory. If isStateless() is @a true, calculateBatch() does not use the state of the object and can be invoked
+ * concurrently for disjoint ranges (see calculateBatchConcurrently()).
  */
 class ShapeFunction {
 public:
+    /**
+     * @brief Iterator over shapes accepted by calculateBatch(). It is the same as Packing::const_iterator.
+     */
+    using ShapeIterator = std::vector<Shape>::const_iterator;
+
     virtual ~ShapeFunction() = default;
 
     /**
@@ -43,6 +58,70 @@ public:
      * @brief Returns the vector of function values calculates in the last calculate() invocation.
      */
     [[nodiscard]] virtual std::vector<double> getValues() const = 0;
+
+    /**
+     * @brief Returns the number of values (components) of the function.
+     * @details The default implementation returns the size of getNames().
+     */
+    [[nodiscard]] virtual std::size_t getNumValues() const { return this->getNames().size(); }
+
+    /**
+     * @brief Returns @a true, if calculateBatch() does not depend on nor modify the state of the object, so it can be
+     * invoked concurrently for disjoint ranges of shapes.
+     */
+    [[nodiscard]] virtual bool isStateless() const { return false; }
+
+    /**
+     * @brief Calculates the function values for shapes in the range [@a first, @a last) based on @a traits and stores
+     * them in the @a values buffer, column by column.
+     * @details Value (component) @a j of @a i-th shape in the range is stored in `values[j*stride + i]`, so the buffer
+     * has to have at least `getNumValues()*stride` elements and @a stride cannot be smaller than the length of the
+     * range. The default implementation is an adapter of calculate() and getValues(), thus it is not thread-safe.
+     */
+    virtual void calculateBatch(ShapeIterator first, ShapeIterator last, const ShapeTraits &traits, double *values,
+                                std::size_t stride)
+    {
+        Expects(static_cast<std::size_t>(std::distance(first, last)) <= stride);
+        for (std::size_t i{}; first != last; first++, i++) {
+            this->calculate(*first, traits);
+            auto shapeValues = this->getValues();
+            for (std::size_t j{}; j < shapeValues.size(); j++)
+                values[j*stride + i] = shapeValues[j];
+        }
+    }
+
+    /**
+     * @brief Calculates function values for all shapes in the range [@a first, @a last) and returns them in a
+     * column-wise buffer, where value @a j of @a i-th shape is at `j*numShapes + i` index.
+     * @details If the function isStateless(), the range is divided between at most @a numThreads OpenMP threads (0
+     * means all available threads). Otherwise, the function is calculated serially. @a values buffer is reused (resized
+     * if needed) to avoid reallocations between snapshots.
+     */
+    void calculateBatchConcurrently(ShapeIterator first, ShapeIterator last, const ShapeTraits &traits,
+                                    std::vector<double> &values, std::size_t numThreads = 1)
+    {
+        auto numShapes = static_cast<std::size_t>(std::distance(first, last));
+        values.resize(this->getNumValues() * numShapes);
+        if (numShapes == 0)
+            return;
+
+        if (!this->isStateless() || numThreads == 1) {
+            this->calculateBatch(first, last, traits, values.data(), numShapes);
+            return;
+        }
+
+        if (numThreads == 0)
+            numThreads = OMP_MAXTHREADS;
+        std::size_t chunkSize = (numShapes + numThreads - 1) / numThreads;
+        std::size_t numChunks = (numShapes + chunkSize - 1) / chunkSize;
+        #pragma omp parallel for shared(first, traits, values, numShapes, chunkSize, numChunks) default(none) \
+                num_threads(numThreads)
+        for (std::size_t chunk = 0; chunk < numChunks; chunk++) {
+            std::size_t chunkBeg = chunk * chunkSize;
+            std::size_t chunkEnd = std::min(chunkBeg + chunkSize, numShapes);
+            this->calculateBatch(first + chunkBeg, first + chunkEnd, traits, values.data() + chunkBeg, numShapes);
+        }
+    }
 };
 
 
@@ -35,7 +35,7 @@ auto SmecticOrder::calculateTau(const std::array<int, 3> &nTau_, const Packing &
 void SmecticOrder::calculate(const Packing &packing, [[maybe_unused]] double temperature,
                              [[maybe_unused]] double pressure, [[maybe_unused]] const ShapeTraits &shapeTraits)
 {
-    auto focalPoints = packing.dumpNamedPoints(shapeTraits.getGeometry(), this->focalPoint);
+    const auto &focalPoints = packing.dumpNamedPoints(shapeTraits.getGeometry(), this->focalPoint);
     auto functionValues = this->calculateFunctionValues(packing, shapeTraits);
 
     this->tau = 0;
@@ -101,11 +101,7 @@ std::vector<double> SmecticOrder::getIntervalValues() const {
 
 std::vector<double> SmecticOrder::calculateFunctionValues(const Packing &packing, const ShapeTraits &traits) const {
     std::vector<double> values;
-    values.reserve(packing.size());
-    for (const auto &shape : packing) {
-        this->shapeFunction->calculate(shape, traits);
-        values.push_back(this->shapeFunction->getValues().front());
-    }
+    this->shapeFunction->calculateBatchConcurrently(packing.begin(), packing.end(), traits, values);
     return values;
 }
 
@@ -0,0 +1,45 @@
+#ifndef RAMPACK_COMPOUNDPAIRCONSUMER_H
+#define RAMPACK_COMPOUNDPAIRCONSUMER_H
+
+#include <vector>
+#include <algorithm>
+
+#include "PairConsumer.h"
+#include "utils/Exceptions.h"
+
+
+/**
+ * @brief PairConsumer which passes each consumed pair to all of the underlying PairConsumer -s.
+ * @details It allows to enumerate pairs only once for many consumers. The maximal number of threads is the smallest
+ * of maximal numbers of threads of the underlying consumers. The class does not own the consumers.
+ */
+class CompoundPairConsumer : public PairConsumer {
+private:
+    std::vector<PairConsumer *> consumers;
+
+    static std::size_t getCommonMaxThreads(const std::vector<PairConsumer *> &consumers) {
+        Expects(!consumers.empty());
+        auto threadsComparator = [](const PairConsumer *c1, const PairConsumer *c2) {
+            return c1->getMaxThreads() < c2->getMaxThreads();
+        };
+        return (*std::min_element(consumers.begin(), consumers.end(), threadsComparator))->getMaxThreads();
+    }
+
+public:
+    /**
+     * @brief Constructs the class for (non-empty) list of @a consumers.
+     */
+    explicit CompoundPairConsumer(std::vector<PairConsumer *> consumers)
+            : PairConsumer(getCommonMaxThreads(consumers)), consumers{std::move(consumers)}
+    { }
+
+    void consumePair(const Packing &packing, const std::pair<std::size_t, std::size_t> &idxPair,
+                     const Vector<3> &distanceVector, const ShapeTraits &shapeTraits) override
+    {
+        for (auto consumer : this->consumers)
+            consumer->consumePair(packing, idxPair, distanceVector, shapeTraits);
+    }
+};
+
+
+#endif //RAMPACK_COMPOUNDPAIRCONSUMER_H
@@ -23,7 +23,7 @@ void LayerwiseRadialEnumerator::enumeratePairs(const Packing &packing, const Sha
 {
     Vector<3> kVector = this->calculateK(packing);
     Vector<3> kVectorNorm = kVector.normalized();
-    auto focalPoints = packing.dumpNamedPoints(traits.getGeometry(), this->focalPointName);
+    const auto &focalPoints = packing.dumpNamedPoints(traits.getGeometry(), this->focalPointName);
     double tauAngle = LayerwiseRadialEnumerator::calculateTauAngle(kVector, focalPoints);
     const auto &bc = packing.getBoundaryConditions();
     [[maybe_unused]] std::size_t maxThreads = pairConsumer.getMaxThreads(); // maybe_unused is OpenMP not avaliable
@@ -67,6 +67,14 @@ LayerwiseRadialEnumerator::LayerwiseRadialEnumerator(const std::array<int, 3> &m
     std::copy(millerIndices.begin(), millerIndices.end(), this->millerIndices.begin());
 }
 
+bool LayerwiseRadialEnumerator::isEquivalent(const PairEnumerator &other) const {
+    const auto *otherLayerwise = dynamic_cast<const LayerwiseRadialEnumerator *>(&other);
+    if (otherLayerwise == nullptr)
+        return false;
+    return this->millerIndices == otherLayerwise->millerIndices
+           && this->focalPointName == otherLayerwise->focalPointName;
+}
+
 std::vector<double>
 LayerwiseRadialEnumerator::getExpectedNumOfMoleculesInShells(const Packing &packing,
                                                              const std::vector<double> &radiiBounds) const
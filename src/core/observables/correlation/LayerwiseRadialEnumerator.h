@@ -47,6 +47,12 @@ public:
      * @brief Returns signature name "lr" (from "layerwise radial")
      */
     [[nodiscard]] std::string getSignatureName() const override { return "lr"; }
+
+    /**
+     * @brief Returns @a true if @a other is also LayerwiseRadialEnumerator using the same Miller indices and focal
+     * point.
+     */
+    [[nodiscard]] bool isEquivalent(const PairEnumerator &other) const override;
 };
 
 
@@ -17,6 +17,13 @@ std::string LinearEnumerator::getSignatureName() const {
     AssertThrow("unreachable");
 }
 
+bool LinearEnumerator::isEquivalent(const PairEnumerator &other) const {
+    const auto *otherLinear = dynamic_cast<const LinearEnumerator *>(&other);
+    if (otherLinear == nullptr)
+        return false;
+    return this->axis == otherLinear->axis && this->focalPointName == otherLinear->focalPointName;
+}
+
 std::vector<double> LinearEnumerator::getExpectedNumOfMoleculesInShells(const Packing &packing,
                                                                         const std::vector<double> &radiiBounds) const
 {
@@ -41,7 +48,7 @@ void LinearEnumerator::enumeratePairs(const Packing &packing, const ShapeTraits
                                       PairConsumer &pairConsumer) const
 {
     const auto &bc = packing.getBoundaryConditions();
-    auto focalPoints = packing.dumpNamedPoints(shapeTraits.getGeometry(), this->focalPointName);
+    const auto &focalPoints = packing.dumpNamedPoints(shapeTraits.getGeometry(), this->focalPointName);
     [[maybe_unused]] std::size_t maxThreads = pairConsumer.getMaxThreads();     // maybe-unused if OpenMP not available
 
     const auto &sides = packing.getBox().getSides();
@@ -60,6 +60,11 @@ public:
      * @brief Returns signature name "x", "y" or "z" depending on chosen axis (see constructor).
      */
     [[nodiscard]] std::string getSignatureName() const override;
+
+    /**
+     * @brief Returns @a true if @a other is also LinearEnumerator using the same axis and focal point.
+     */
+    [[nodiscard]] bool isEquivalent(const PairEnumerator &other) const override;
 };
 
 
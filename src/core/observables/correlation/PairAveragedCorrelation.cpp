@@ -5,10 +5,10 @@
 #include "PairAveragedCorrelation.h"
 
 
-void PairAveragedCorrelation::addSnapshot(const Packing &packing, [[maybe_unused]] double temperature,
-                                          [[maybe_unused]] double pressure, const ShapeTraits &shapeTraits)
+void PairAveragedCorrelation::finishSnapshot([[maybe_unused]] const Packing &packing,
+                                             [[maybe_unused]] double temperature, [[maybe_unused]] double pressure,
+                                             [[maybe_unused]] const ShapeTraits &shapeTraits)
 {
-    this->pairEnumerator->enumeratePairs(packing, shapeTraits, *this);
     this->histogram.nextSnapshot();
 }
 
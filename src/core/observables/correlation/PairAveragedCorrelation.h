@@ -7,8 +7,7 @@
 
 #include <memory>
 
-#include "core/BulkObservable.h"
-#include "PairConsumer.h"
+#include "PairBulkObservable.h"
 #include "PairEnumerator.h"
 #include "core/observables/HistogramBuilder.h"
 #include "core/observables/CorrelationFunction.h"
@@ -18,7 +17,7 @@
  * @brief Bulk observable which computes an average of the given CorrelationFunction versus the distance between
  * molecules as per given PairEnumerator.
  */
-class PairAveragedCorrelation : public BulkObservable, public PairConsumer {
+class PairAveragedCorrelation : public PairBulkObservable {
 private:
     std::shared_ptr<PairEnumerator> pairEnumerator;
     std::shared_ptr<CorrelationFunction> correlationFunction;
@@ -43,13 +42,15 @@ public:
     PairAveragedCorrelation(std::shared_ptr<PairEnumerator> pairEnumerator,
                             std::shared_ptr<CorrelationFunction> correlationFunction, double maxR, std::size_t numBins,
                             bool printCount = false, std::size_t numThreads = 1)
-            : PairConsumer(numThreads), pairEnumerator{std::move(pairEnumerator)},
+            : PairBulkObservable(numThreads), pairEnumerator{std::move(pairEnumerator)},
               correlationFunction{std::move(correlationFunction)}, histogram(0, maxR, numBins, numThreads),
               printCount{printCount}
     { }
 
-    void addSnapshot(const Packing &packing, double temperature, double pressure,
-                     const ShapeTraits &shapeTraits) override;
+    [[nodiscard]] const PairEnumerator &getPairEnumerator() const override { return *this->pairEnumerator; }
+
+    void finishSnapshot(const Packing &packing, double temperature, double pressure,
+                        const ShapeTraits &shapeTraits) override;
 
     /**
      * @brief Prints correlation function vs distance onto @a out stream as space separated columns (distance, value,
@@ -0,0 +1,46 @@
+#ifndef RAMPACK_PAIRBULKOBSERVABLE_H
+#define RAMPACK_PAIRBULKOBSERVABLE_H
+
+#include "core/BulkObservable.h"
+#include "PairConsumer.h"
+#include "PairEnumerator.h"
+
+
+/**
+ * @brief BulkObservable which gathers its data from pairs of molecules enumerated by a PairEnumerator.
+ * @details The snapshot is processed in two stages: enumeration of pairs, which are passed to consumePair(), and
+ * finishSnapshot(), which closes the snapshot. Splitting them allows ObservablesCollector to perform a single
+ * enumeration for many observables using equivalent enumerators (see PairEnumerator::isEquivalent) and then close
+ * snapshots for all of them. addSnapshot() simply performs both stages for a single observable.
+ */
+class PairBulkObservable : public BulkObservable, public PairConsumer {
+public:
+    /**
+     * @brief Constructs the class declaring the support of at most @a numThreads threads (see PairConsumer).
+     */
+    explicit PairBulkObservable(std::size_t numThreads = 1) : PairConsumer(numThreads) { }
+
+    /**
+     * @brief Returns PairEnumerator, whose pairs are consumed by this observable.
+     */
+    [[nodiscard]] virtual const PairEnumerator &getPairEnumerator() const = 0;
+
+    /**
+     * @brief Closes the snapshot after all pairs have been consumed. Parameters are the same as in addSnapshot().
+     */
+    virtual void finishSnapshot(const Packing &packing, double temperature, double pressure,
+                                const ShapeTraits &shapeTraits) = 0;
+
+    /**
+     * @brief Enumerates pairs using getPairEnumerator() and then calls finishSnapshot().
+     */
+    void addSnapshot(const Packing &packing, double temperature, double pressure,
+                     const ShapeTraits &shapeTraits) override
+    {
+        this->getPairEnumerator().enumeratePairs(packing, shapeTraits, *this);
+        this->finishSnapshot(packing, temperature, pressure, shapeTraits);
+    }
+};
+
+
+#endif //RAMPACK_PAIRBULKOBSERVABLE_H
@@ -5,10 +5,10 @@
 #include "PairDensityCorrelation.h"
 
 
-void PairDensityCorrelation::addSnapshot(const Packing &packing, [[maybe_unused]] double temperature,
-                                         [[maybe_unused]] double pressure, const ShapeTraits &shapeTraits)
+void PairDensityCorrelation::finishSnapshot(const Packing &packing, [[maybe_unused]] double temperature,
+                                            [[maybe_unused]] double pressure,
+                                            [[maybe_unused]] const ShapeTraits &shapeTraits)
 {
-    this->pairEnumerator->enumeratePairs(packing, shapeTraits, *this);
     auto binDividers = this->histogram.getBinDividers();
     auto factors = this->pairEnumerator->getExpectedNumOfMoleculesInShells(packing, binDividers);
     for (auto &factor : factors)
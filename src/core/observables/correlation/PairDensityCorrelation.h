@@ -7,8 +7,7 @@
 
 #include <memory>
 
-#include "core/BulkObservable.h"
-#include "PairConsumer.h"
+#include "PairBulkObservable.h"
 #include "PairEnumerator.h"
 #include "core/observables/HistogramBuilder.h"
 
@@ -19,7 +18,7 @@
  * @details If no correlations are present, it is equal 1. Values smaller than 1 mean negative correlations while
  * greater than 1 - positive correlations. Distances are computed as per PairEnumerator implementation.
  */
-class PairDensityCorrelation : public BulkObservable, protected PairConsumer {
+class PairDensityCorrelation : public PairBulkObservable {
 private:
     std::shared_ptr<PairEnumerator> pairEnumerator;
     HistogramBuilder<1> histogram;
@@ -36,12 +35,14 @@ public:
      */
     explicit PairDensityCorrelation(std::shared_ptr<PairEnumerator> pairEnumerator, double maxR, std::size_t numBins,
                                     bool printCount = false, std::size_t numThreads = 1)
-            : PairConsumer(numThreads), pairEnumerator{std::move(pairEnumerator)},
+            : PairBulkObservable(numThreads), pairEnumerator{std::move(pairEnumerator)},
               histogram(0, maxR, numBins, numThreads), printCount{printCount}
     { }
 
-    void addSnapshot(const Packing &packing, double temperature, double pressure,
-                     const ShapeTraits &shapeTraits) override;
+    [[nodiscard]] const PairEnumerator &getPairEnumerator() const override { return *this->pairEnumerator; }
+
+    void finishSnapshot(const Packing &packing, double temperature, double pressure,
+                        const ShapeTraits &shapeTraits) override;
 
     /**
      * @brief Prints pair density correlation function vs distance onto @a out stream as space separated columns
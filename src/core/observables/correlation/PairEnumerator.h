@@ -37,6 +37,15 @@ public:
      * @brief Returns a (short) name of this PairEnumerator used in filenames and reporting.
      */
     [[nodiscard]] virtual std::string getSignatureName() const = 0;
+
+    /**
+     * @brief Returns @a true if @a other enumerates exactly the same pairs with the same distance vectors as this
+     * enumerator, so that a single enumeration can be shared between many PairConsumer -s.
+     * @details The default implementation only recognizes the identical object. Enumerators with the same
+     * getSignatureName() may still differ in parameters (for example a focal point), so implementations should compare
+     * them as well.
+     */
+    [[nodiscard]] virtual bool isEquivalent(const PairEnumerator &other) const { return this == &other; }
 };
 
 
@@ -10,7 +10,7 @@ ProbabilityEvolution::ProbabilityEvolution(double maxDistance, std::size_t numDi
                                            std::pair<double, double> functionRange,
                                            std::size_t numFunctionBins, std::shared_ptr<CorrelationFunction> function,
                                            Normalization normalization, bool printCount, std::size_t numThreads)
-        : PairConsumer(numThreads), maxDistance{maxDistance}, functionRange{functionRange},
+        : PairBulkObservable(numThreads), maxDistance{maxDistance}, functionRange{functionRange},
           histogramBuilder({0, functionRange.first}, {maxDistance, functionRange.second},
                            {numDistanceBins, numFunctionBins}, numThreads),
           pairEnumerator{std::move(pairEnumerator)}, function{std::move(function)}, normalization{normalization},
@@ -19,10 +19,10 @@ ProbabilityEvolution::ProbabilityEvolution(double maxDistance, std::size_t numDi
     Expects(maxDistance > 0);
 }
 
-void ProbabilityEvolution::addSnapshot(const Packing &packing, [[maybe_unused]] double temperature,
-                                       [[maybe_unused]] double pressure, const ShapeTraits &shapeTraits)
+void ProbabilityEvolution::finishSnapshot([[maybe_unused]] const Packing &packing,
+                                          [[maybe_unused]] double temperature, [[maybe_unused]] double pressure,
+                                          [[maybe_unused]] const ShapeTraits &shapeTraits)
 {
-    this->pairEnumerator->enumeratePairs(packing, shapeTraits, *this);
     this->histogramBuilder.nextSnapshot();
 }
 
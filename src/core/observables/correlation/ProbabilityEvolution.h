@@ -6,8 +6,7 @@
 #define RAMPACK_PROBABILITYEVOLUTION_H
 
 #include "core/observables/HistogramBuilder.h"
-#include "core/BulkObservable.h"
-#include "PairConsumer.h"
+#include "PairBulkObservable.h"
 #include "PairEnumerator.h"
 #include "core/observables/CorrelationFunction.h"
 
@@ -18,7 +17,7 @@
  * @details It can be seen as a generalization of PairAveragedCorrelation which shows the whole probability distribution
  * function instead only the average value.
  */
-class ProbabilityEvolution : public BulkObservable, public PairConsumer {
+class ProbabilityEvolution : public PairBulkObservable {
 public:
     /**
      * @brief How probability distribution for a given distance should be normalized.
@@ -74,8 +73,10 @@ public:
                          Normalization normalization = Normalization::PDF, bool printCount = false,
                          std::size_t numThreads = 1);
 
-    void addSnapshot(const Packing &packing, double temperature, double pressure,
-                     const ShapeTraits &shapeTraits) override;
+    [[nodiscard]] const PairEnumerator &getPairEnumerator() const override { return *this->pairEnumerator; }
+
+    void finishSnapshot(const Packing &packing, double temperature, double pressure,
+                        const ShapeTraits &shapeTraits) override;
 
     /**
      * @brief Outputs the histogram.
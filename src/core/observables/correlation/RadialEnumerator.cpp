@@ -13,7 +13,7 @@ void RadialEnumerator::enumeratePairs(const Packing &packing, const ShapeTraits
                                       PairConsumer &pairConsumer) const
 {
     const auto &bc = packing.getBoundaryConditions();
-    auto focalPoints = packing.dumpNamedPoints(shapeTraits.getGeometry(), this->focalPointName);
+    const auto &focalPoints = packing.dumpNamedPoints(shapeTraits.getGeometry(), this->focalPointName);
     [[maybe_unused]] std::size_t maxThreads = pairConsumer.getMaxThreads();     // maybe-unused if OpenMP not available
 
     #pragma omp parallel for shared(packing, focalPoints, bc, pairConsumer, shapeTraits) default(none) \
@@ -30,6 +30,13 @@ void RadialEnumerator::enumeratePairs(const Packing &packing, const ShapeTraits
     }
 }
 
+bool RadialEnumerator::isEquivalent(const PairEnumerator &other) const {
+    const auto *otherRadial = dynamic_cast<const RadialEnumerator *>(&other);
+    if (otherRadial == nullptr)
+        return false;
+    return this->focalPointName == otherRadial->focalPointName;
+}
+
 std::vector<double> RadialEnumerator::getExpectedNumOfMoleculesInShells(const Packing &packing,
                                                                         const std::vector<double> &radiiBounds) const
 {
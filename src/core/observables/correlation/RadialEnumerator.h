@@ -37,6 +37,11 @@ public:
      * Returns "r" (from "radial") as the signature name.
      */
     [[nodiscard]] std::string getSignatureName() const override { return "r"; }
+
+    /**
+     * @brief Returns @a true if @a other is also RadialEnumerator using the same focal point.
+     */
+    [[nodiscard]] bool isEquivalent(const PairEnumerator &other) const override;
 };
 
 
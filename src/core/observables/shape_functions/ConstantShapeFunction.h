@@ -23,6 +23,14 @@ public:
     [[nodiscard]] std::string getPrimaryName() const override { return "const"; }
     [[nodiscard]] std::vector<std::string> getNames() const override { return {"const"}; }
     [[nodiscard]] std::vector<double> getValues() const override { return {this->value}; }
+    [[nodiscard]] std::size_t getNumValues() const override { return 1; }
+    [[nodiscard]] bool isStateless() const override { return true; }
+
+    void calculateBatch(ShapeIterator first, ShapeIterator last, [[maybe_unused]] const ShapeTraits &traits,
+                        double *values, [[maybe_unused]] std::size_t stride) override
+    {
+        std::fill(values, values + std::distance(first, last), this->value);
+    }
 };
 
 
@@ -12,6 +12,24 @@ void ShapeAxis::calculate(const Shape &shape, const ShapeTraits &traits) {
     std::copy(shapeAxis.begin(), shapeAxis.end(), this->values.begin());
 }
 
+void ShapeAxis::calculateBatch(ShapeIterator first, ShapeIterator last, const ShapeTraits &traits, double *values_,
+                               std::size_t stride)
+{
+    const auto &geometry = traits.getGeometry();
+    auto numShapes = static_cast<std::size_t>(std::distance(first, last));
+    Expects(numShapes <= stride);
+
+    double *xs = values_;
+    double *ys = values_ + stride;
+    double *zs = values_ + 2*stride;
+    for (std::size_t i{}; i < numShapes; i++) {
+        Vector<3> shapeAxis = geometry.getAxis(first[i], this->axis);
+        xs[i] = shapeAxis[0];
+        ys[i] = shapeAxis[1];
+        zs[i] = shapeAxis[2];
+    }
+}
+
 std::string ShapeAxis::getPrimaryName() const {
     switch (this->axis) {
         case ShapeGeometry::Axis::PRIMARY:
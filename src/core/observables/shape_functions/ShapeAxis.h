@@ -38,6 +38,11 @@ public:
      * @brief Returns subsequents x, y and z components of the shape axis.
      */
     [[nodiscard]] std::vector<double> getValues() const override { return this->values; };
+
+    [[nodiscard]] std::size_t getNumValues() const override { return 3; }
+    [[nodiscard]] bool isStateless() const override { return true; }
+    void calculateBatch(ShapeIterator first, ShapeIterator last, const ShapeTraits &traits, double *values_,
+                        std::size_t stride) override;
 };
 
 
@@ -27,6 +27,17 @@ void ShapeAxisCoordinate::calculate(const Shape &shape, const ShapeTraits &trait
     }
 }
 
+void ShapeAxisCoordinate::calculateBatch(ShapeIterator first, ShapeIterator last, const ShapeTraits &traits,
+                                         double *values, std::size_t stride)
+{
+    const auto &geometry = traits.getGeometry();
+    auto numShapes = static_cast<std::size_t>(std::distance(first, last));
+    Expects(numShapes <= stride);
+
+    for (std::size_t i{}; i < numShapes; i++)
+        values[i] = geometry.getAxis(first[i], this->axis)[this->coord];
+}
+
 std::string ShapeAxisCoordinate::constructName() const {
     std::string name_;
     using Axis = ShapeGeometry::Axis;
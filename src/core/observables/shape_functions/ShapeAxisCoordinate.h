@@ -34,6 +34,11 @@ public:
     [[nodiscard]] std::string getPrimaryName() const override { return this->name; }
     [[nodiscard]] std::vector<std::string> getNames() const override { return {this->name}; }
     [[nodiscard]] std::vector<double> getValues() const override { return {this->value}; }
+    [[nodiscard]] std::size_t getNumValues() const override { return 1; }
+    [[nodiscard]] bool isStateless() const override { return true; }
+
+    void calculateBatch(ShapeIterator first, ShapeIterator last, const ShapeTraits &traits, double *values,
+                        std::size_t stride) override;
 };
 
 
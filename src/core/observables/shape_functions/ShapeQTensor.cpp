@@ -20,6 +20,41 @@ void ShapeQTensor::calculate(const Shape &shape, const ShapeTraits &traits) {
     };
 }
 
+void ShapeQTensor::calculateBatch(ShapeIterator first, ShapeIterator last, const ShapeTraits &traits,
+                                  double *values_, std::size_t stride)
+{
+    const auto &geometry = traits.getGeometry();
+    auto numShapes = static_cast<std::size_t>(std::distance(first, last));
+    Expects(numShapes <= stride);
+
+    // First gather axes in the first three columns (xx, xy, xz), then compute all components in a separate,
+    // vectorizable loop
+    double *xx = values_;
+    double *xy = values_ + stride;
+    double *xz = values_ + 2*stride;
+    double *yy = values_ + 3*stride;
+    double *yz = values_ + 4*stride;
+    double *zz = values_ + 5*stride;
+    for (std::size_t i{}; i < numShapes; i++) {
+        Vector<3> shapeAxis = geometry.getAxis(first[i], this->axis);
+        xx[i] = shapeAxis[0];
+        xy[i] = shapeAxis[1];
+        xz[i] = shapeAxis[2];
+    }
+
+    for (std::size_t i{}; i < numShapes; i++) {
+        double ax = xx[i];
+        double ay = xy[i];
+        double az = xz[i];
+        xx[i] = 1.5*ax*ax - 0.5;
+        xy[i] = 1.5*ax*ay;
+        xz[i] = 1.5*ax*az;
+        yy[i] = 1.5*ay*ay - 0.5;
+        yz[i] = 1.5*ay*az;
+        zz[i] = 1.5*az*az - 0.5;
+    }
+}
+
 std::string ShapeQTensor::getPrimaryName() const {
     switch (this->axis) {
         case ShapeGeometry::Axis::PRIMARY:
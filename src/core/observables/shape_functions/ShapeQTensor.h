@@ -47,6 +47,11 @@ public:
      * \f$\mathbf{Q}_{33}\f$, in the given order.
      */
     [[nodiscard]] std::vector<double> getValues() const override { return this->values; };
+
+    [[nodiscard]] std::size_t getNumValues() const override { return 6; }
+    [[nodiscard]] bool isStateless() const override { return true; }
+    void calculateBatch(ShapeIterator first, ShapeIterator last, const ShapeTraits &traits, double *values_,
+                        std::size_t stride) override;
 };
 
 
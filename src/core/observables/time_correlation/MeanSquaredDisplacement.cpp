@@ -0,0 +1,13 @@
+#include "MeanSquaredDisplacement.h"
+
+
+void MeanSquaredDisplacement::calculateSignals(const Packing &packing,
+                                               [[maybe_unused]] const ShapeTraits &shapeTraits,
+                                               std::vector<double> &signals)
+{
+    this->positions.update(packing);
+    const auto &unwrappedPositions = this->positions.getPositions();
+    for (std::size_t i{}; i < unwrappedPositions.size(); i++)
+        for (std::size_t j{}; j < 3; j++)
+            signals[3*i + j] = unwrappedPositions[i][j];
+}
@@ -0,0 +1,34 @@
+#ifndef RAMPACK_MEANSQUAREDDISPLACEMENT_H
+#define RAMPACK_MEANSQUAREDDISPLACEMENT_H
+
+#include "TimeCorrelation.h"
+#include "UnwrappedPositions.h"
+
+
+/**
+ * @brief TimeCorrelation computing the mean squared displacement <tt>&lt;|r(t + lag) - r(t)|<sup>2</sup>&gt;</tt>
+ * of particles' positions unwrapped from periodic boundary conditions (see UnwrappedPositions).
+ */
+class MeanSquaredDisplacement : public TimeCorrelation {
+private:
+    UnwrappedPositions positions;
+
+protected:
+    void calculateSignals(const Packing &packing, const ShapeTraits &shapeTraits,
+                          std::vector<double> &signals) override;
+    [[nodiscard]] double transformCorrelation(double correlation) const override { return 3 * correlation; }
+    void resetState() override { this->positions.clear(); }
+
+public:
+    explicit MeanSquaredDisplacement(std::size_t pointsPerLevel = MultiTauCorrelator::DEFAULT_POINTS_PER_LEVEL)
+            : TimeCorrelation(MultiTauCorrelator::Mode::SQUARED_DIFFERENCE, 3, pointsPerLevel)
+    { }
+
+    /**
+     * @brief Returns "msd" as the signature name.
+     */
+    [[nodiscard]] std::string getSignatureName() const override { return "msd"; }
+};
+
+
+#endif //RAMPACK_MEANSQUAREDDISPLACEMENT_H
@@ -0,0 +1,107 @@
+#include <algorithm>
+
+#include "MultiTauCorrelator.h"
+#include "utils/Exceptions.h"
+
+
+MultiTauCorrelator::MultiTauCorrelator(std::size_t numChannels, Mode mode, std::size_t pointsPerLevel,
+                                       std::size_t averagingFactor)
+        : numChannels{numChannels}, mode{mode}, pointsPerLevel{pointsPerLevel}, averagingFactor{averagingFactor}
+{
+    Expects(numChannels > 0);
+    Expects(averagingFactor >= 2);
+    Expects(pointsPerLevel >= averagingFactor);
+    ExpectsMsg(pointsPerLevel % averagingFactor == 0, "Points per level should be divisible by averaging factor");
+}
+
+void MultiTauCorrelator::addSample(const std::vector<double> &values) {
+    Expects(values.size() == this->numChannels);
+    this->addToLevel(0, values);
+    this->numSamples++;
+}
+
+void MultiTauCorrelator::addToLevel(std::size_t levelIdx, const std::vector<double> &values) {
+    if (levelIdx == this->levels.size()) {
+        Level newLevel;
+        newLevel.buffer.resize(this->pointsPerLevel * this->numChannels);
+        newLevel.accumulator.resize(this->numChannels);
+        newLevel.head = this->pointsPerLevel - 1;
+        newLevel.correlationSums.resize(this->pointsPerLevel);
+        newLevel.counts.resize(this->pointsPerLevel);
+        this->levels.push_back(std::move(newLevel));
+    }
+
+    auto &level = this->levels[levelIdx];
+    level.head = (level.head + 1) % this->pointsPerLevel;
+    const double *newest = level.buffer.data() + level.head * this->numChannels;
+    std::copy(values.begin(), values.end(), level.buffer.begin() + level.head * this->numChannels);
+    level.numInserted++;
+
+    // Lags below pointsPerLevel / averagingFactor on higher levels are already covered by the previous level
+    std::size_t minLagIdx = (levelIdx == 0) ? 0 : this->pointsPerLevel / this->averagingFactor;
+    std::size_t maxLagIdx = std::min(level.numInserted, this->pointsPerLevel);
+    for (std::size_t lagIdx = minLagIdx; lagIdx < maxLagIdx; lagIdx++) {
+        std::size_t slot = (level.head + this->pointsPerLevel - lagIdx) % this->pointsPerLevel;
+        const double *older = level.buffer.data() + slot * this->numChannels;
+        level.correlationSums[lagIdx] += this->correlate(newest, older);
+        level.counts[lagIdx]++;
+    }
+
+    std::transform(level.accumulator.begin(), level.accumulator.end(), values.begin(), level.accumulator.begin(),
+                   std::plus<>{});
+    level.numAccumulated++;
+    if (level.numAccumulated < this->averagingFactor)
+        return;
+
+    std::vector<double> averagedValues(this->numChannels);
+    auto factor = static_cast<double>(this->averagingFactor);
+    std::transform(level.accumulator.begin(), level.accumulator.end(), averagedValues.begin(),
+                   [factor](double sum) { return sum / factor; });
+    std::fill(level.accumulator.begin(), level.accumulator.end(), 0);
+    level.numAccumulated = 0;
+    // level reference may be invalidated by adding a new level, so it is not used below
+    this->addToLevel(levelIdx + 1, averagedValues);
+}
+
+double MultiTauCorrelator::correlate(const double *newest, const double *older) const {
+    double sum{};
+    switch (this->mode) {
+        case Mode::PRODUCT:
+            for (std::size_t i{}; i < this->numChannels; i++)
+                sum += newest[i] * older[i];
+            break;
+        case Mode::SQUARED_DIFFERENCE:
+            for (std::size_t i{}; i < this->numChannels; i++) {
+                double diff = newest[i] - older[i];
+                sum += diff * diff;
+            }
+            break;
+        default:
+            AssertThrow("unreachable");
+    }
+    return sum;
+}
+
+std::vector<MultiTauCorrelator::Point> MultiTauCorrelator::getCorrelation() const {
+    std::vector<Point> correlation;
+    std::size_t lagUnit = 1;
+    for (std::size_t levelIdx{}; levelIdx < this->levels.size(); levelIdx++) {
+        const auto &level = this->levels[levelIdx];
+        std::size_t minLagIdx = (levelIdx == 0) ? 0 : this->pointsPerLevel / this->averagingFactor;
+        for (std::size_t lagIdx = minLagIdx; lagIdx < this->pointsPerLevel; lagIdx++) {
+            std::size_t count = level.counts[lagIdx];
+            if (count == 0)
+                continue;
+
+            double normalization = static_cast<double>(count) * static_cast<double>(this->numChannels);
+            correlation.push_back({lagIdx * lagUnit, level.correlationSums[lagIdx] / normalization, count});
+        }
+        lagUnit *= this->averagingFactor;
+    }
+    return correlation;
+}
+
+void MultiTauCorrelator::clear() {
+    this->levels.clear();
+    this->numSamples = 0;
+}
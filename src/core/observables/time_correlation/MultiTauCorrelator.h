@@ -0,0 +1,106 @@
+#ifndef RAMPACK_MULTITAUCORRELATOR_H
+#define RAMPACK_MULTITAUCORRELATOR_H
+
+#include <vector>
+#include <cstddef>
+
+
+/**
+ * @brief Multiple-tau correlator, which calculates time correlation functions of many signals (channels) on the fly,
+ * averaged over time origins and channels.
+ * @details The correlator is organized into levels. On level @a l, values averaged over blocks of
+ * <tt>m<sup>l</sup></tt> consecutive samples (where @a m is the averaging factor) are stored in a circular buffer of
+ * @a p (points per level) entries and correlated with the newest entry. Thus, level 0 gives lags 0, 1, ..., @a p - 1,
+ * while level @a l > 0 gives lags <tt>j m<sup>l</sup></tt> for @a j = @a p / @a m, ..., @a p - 1. For @a T samples, the
+ * cost is O(@a p @a T) and memory is O(@a p log @a T) per channel, contrary to O(@a T<sup>2</sup>) and O(@a T) for a
+ * direct calculation. Correlations for large lags are calculated using block-averaged values, which is an
+ * approximation, but a very good one for signals varying slowly on the scale of the lag.
+ */
+class MultiTauCorrelator {
+public:
+    /**
+     * @brief How two values of a channel separated by a lag are combined.
+     */
+    enum class Mode {
+        /** @brief <tt>x(t) x(t + lag)</tt> - a standard correlation function */
+        PRODUCT,
+        /** @brief <tt>(x(t + lag) - x(t))<sup>2</sup></tt> - for example for a mean squared displacement */
+        SQUARED_DIFFERENCE
+    };
+
+    /**
+     * @brief A single point of the correlation function.
+     */
+    struct Point {
+        /** @brief The lag in units of the sampling interval */
+        std::size_t lag{};
+        /** @brief The value averaged over time origins and channels */
+        double value{};
+        /** @brief The number of time origins the value was averaged over */
+        std::size_t count{};
+    };
+
+private:
+    struct Level {
+        // Values are stored slot-major: buffer[slot * numChannels + channel]
+        std::vector<double> buffer;
+        std::vector<double> accumulator;
+        std::size_t numAccumulated{};
+        std::size_t numInserted{};
+        std::size_t head{};
+        std::vector<double> correlationSums;
+        std::vector<std::size_t> counts;
+    };
+
+    std::size_t numChannels{};
+    Mode mode{};
+    std::size_t pointsPerLevel{};
+    std::size_t averagingFactor{};
+    std::size_t numSamples{};
+    std::vector<Level> levels;
+
+    void addToLevel(std::size_t levelIdx, const std::vector<double> &values);
+    [[nodiscard]] double correlate(const double *newest, const double *older) const;
+
+public:
+    /**
+     * @brief The default number of points per level.
+     */
+    static constexpr std::size_t DEFAULT_POINTS_PER_LEVEL = 16;
+
+    /**
+     * @brief Creates the correlator for @a numChannels channels, combining the values as specified by @a mode.
+     * @details Each level contains @a pointsPerLevel points and values are averaged in blocks of @a averagingFactor
+     * entries, when passed to the next level. @a pointsPerLevel has to be divisible by @a averagingFactor.
+     */
+    MultiTauCorrelator(std::size_t numChannels, Mode mode, std::size_t pointsPerLevel = DEFAULT_POINTS_PER_LEVEL,
+                       std::size_t averagingFactor = 2);
+
+    /**
+     * @brief Adds the next sample consisting of values of all channels.
+     */
+    void addSample(const std::vector<double> &values);
+
+    /**
+     * @brief Returns the correlation function for all lags having at least one time origin, sorted by lag.
+     */
+    [[nodiscard]] std::vector<Point> getCorrelation() const;
+
+    /**
+     * @brief Returns the number of samples added so far.
+     */
+    [[nodiscard]] std::size_t getNumSamples() const { return this->numSamples; }
+
+    /**
+     * @brief Returns the number of channels.
+     */
+    [[nodiscard]] std::size_t getNumChannels() const { return this->numChannels; }
+
+    /**
+     * @brief Removes all samples.
+     */
+    void clear();
+};
+
+
+#endif //RAMPACK_MULTITAUCORRELATOR_H
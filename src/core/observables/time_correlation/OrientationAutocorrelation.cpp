@@ -0,0 +1,22 @@
+#include <cmath>
+
+#include "OrientationAutocorrelation.h"
+
+
+void OrientationAutocorrelation::calculateSignals(const Packing &packing, const ShapeTraits &shapeTraits,
+                                                  std::vector<double> &signals)
+{
+    static const double SQRT_2 = std::sqrt(2.);
+
+    const auto &geometry = shapeTraits.getGeometry();
+    for (std::size_t i{}; i < packing.size(); i++) {
+        Vector<3> u = geometry.getAxis(packing[i], this->axis);
+        // Off-diagonal elements appear twice in the tensor contraction, hence sqrt(2)
+        signals[6*i] = u[0] * u[0];
+        signals[6*i + 1] = u[1] * u[1];
+        signals[6*i + 2] = u[2] * u[2];
+        signals[6*i + 3] = SQRT_2 * u[0] * u[1];
+        signals[6*i + 4] = SQRT_2 * u[0] * u[2];
+        signals[6*i + 5] = SQRT_2 * u[1] * u[2];
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef RAMPACK_ORIENTATIONAUTOCORRELATION_H
+#define RAMPACK_ORIENTATIONAUTOCORRELATION_H
+
+#include "TimeCorrelation.h"
+#include "core/ShapeGeometry.h"
+
+
+/**
+ * @brief TimeCorrelation computing the second Legendre polynomial autocorrelation of a given molecular axis
+ * <tt>&lt;P<sub>2</sub>(u(t) · u(t + lag))&gt;</tt>.
+ * @details Using <tt>(u · v)<sup>2</sup> = (u ⊗ u) : (v ⊗ v)</tt>, the function is a standard correlation function of
+ * 6 independent components of the <tt>u ⊗ u</tt> tensor.
+ */
+class OrientationAutocorrelation : public TimeCorrelation {
+private:
+    ShapeGeometry::Axis axis{};
+
+protected:
+    void calculateSignals(const Packing &packing, const ShapeTraits &shapeTraits,
+                          std::vector<double> &signals) override;
+    [[nodiscard]] double transformCorrelation(double correlation) const override { return 9 * correlation - 0.5; }
+
+public:
+    /**
+     * @brief Creates the class for a given molecular @a axis.
+     */
+    explicit OrientationAutocorrelation(ShapeGeometry::Axis axis = ShapeGeometry::Axis::PRIMARY,
+                                        std::size_t pointsPerLevel = MultiTauCorrelator::DEFAULT_POINTS_PER_LEVEL)
+            : TimeCorrelation(MultiTauCorrelator::Mode::PRODUCT, 6, pointsPerLevel), axis{axis}
+    { }
+
+    /**
+     * @brief Returns "p2_autocorr" as the signature name.
+     */
+    [[nodiscard]] std::string getSignatureName() const override { return "p2_autocorr"; }
+};
+
+
+#endif //RAMPACK_ORIENTATIONAUTOCORRELATION_H
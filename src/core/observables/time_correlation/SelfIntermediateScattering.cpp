@@ -0,0 +1,26 @@
+#include <cmath>
+
+#include "SelfIntermediateScattering.h"
+#include "utils/Exceptions.h"
+
+
+SelfIntermediateScattering::SelfIntermediateScattering(double k, std::size_t pointsPerLevel)
+        : TimeCorrelation(MultiTauCorrelator::Mode::PRODUCT, 6, pointsPerLevel), k{k}
+{
+    Expects(k > 0);
+}
+
+void SelfIntermediateScattering::calculateSignals(const Packing &packing,
+                                                  [[maybe_unused]] const ShapeTraits &shapeTraits,
+                                                  std::vector<double> &signals)
+{
+    this->positions.update(packing);
+    const auto &unwrappedPositions = this->positions.getPositions();
+    for (std::size_t i{}; i < unwrappedPositions.size(); i++) {
+        for (std::size_t j{}; j < 3; j++) {
+            double phase = this->k * unwrappedPositions[i][j];
+            signals[6*i + 2*j] = std::cos(phase);
+            signals[6*i + 2*j + 1] = std::sin(phase);
+        }
+    }
+}
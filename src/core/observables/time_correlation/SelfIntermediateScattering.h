@@ -0,0 +1,40 @@
+#ifndef RAMPACK_SELFINTERMEDIATESCATTERING_H
+#define RAMPACK_SELFINTERMEDIATESCATTERING_H
+
+#include "TimeCorrelation.h"
+#include "UnwrappedPositions.h"
+
+
+/**
+ * @brief TimeCorrelation computing the self part of the intermediate scattering function
+ * <tt>F<sub>s</sub>(k, lag) = &lt;cos(k (x<sub>a</sub>(t + lag) - x<sub>a</sub>(t)))&gt;</tt>, averaged over particles
+ * and three Cartesian axes @a a.
+ * @details Unwrapped positions are used (see UnwrappedPositions). The cosine of a difference is decomposed into the
+ * sum of products of cosines and sines, so the function is a standard correlation function of those.
+ */
+class SelfIntermediateScattering : public TimeCorrelation {
+private:
+    double k{};
+    UnwrappedPositions positions;
+
+protected:
+    void calculateSignals(const Packing &packing, const ShapeTraits &shapeTraits,
+                          std::vector<double> &signals) override;
+    [[nodiscard]] double transformCorrelation(double correlation) const override { return 2 * correlation; }
+    void resetState() override { this->positions.clear(); }
+
+public:
+    /**
+     * @brief Creates the class for a wave number @a k.
+     */
+    explicit SelfIntermediateScattering(double k,
+                                        std::size_t pointsPerLevel = MultiTauCorrelator::DEFAULT_POINTS_PER_LEVEL);
+
+    /**
+     * @brief Returns "fs_k" as the signature name.
+     */
+    [[nodiscard]] std::string getSignatureName() const override { return "fs_k"; }
+};
+
+
+#endif //RAMPACK_SELFINTERMEDIATESCATTERING_H
@@ -0,0 +1,55 @@
+#include <ostream>
+
+#include "TimeCorrelation.h"
+#include "utils/Exceptions.h"
+
+
+TimeCorrelation::TimeCorrelation(MultiTauCorrelator::Mode mode, std::size_t signalsPerParticle,
+                                 std::size_t pointsPerLevel)
+        : mode{mode}, signalsPerParticle{signalsPerParticle}, pointsPerLevel{pointsPerLevel}
+{
+    Expects(signalsPerParticle > 0);
+    Expects(pointsPerLevel >= 2);
+    ExpectsMsg(pointsPerLevel % 2 == 0, "Points per level should be even");
+}
+
+void TimeCorrelation::addSnapshot(const Packing &packing, [[maybe_unused]] double temperature,
+                                  [[maybe_unused]] double pressure, const ShapeTraits &shapeTraits)
+{
+    Expects(!packing.empty());
+
+    if (!this->correlator.has_value()) {
+        this->numParticles = packing.size();
+        this->correlator.emplace(this->numParticles * this->signalsPerParticle, this->mode, this->pointsPerLevel);
+        this->signals.resize(this->numParticles * this->signalsPerParticle);
+    }
+    ExpectsMsg(packing.size() == this->numParticles,
+               this->getSignatureName() + ": number of particles has to be constant");
+
+    this->calculateSignals(packing, shapeTraits, this->signals);
+    this->correlator->addSample(this->signals);
+}
+
+void TimeCorrelation::print(std::ostream &out) const {
+    for (const auto &[lag, value] : this->getValues())
+        out << lag << " " << value << std::endl;
+}
+
+void TimeCorrelation::clear() {
+    this->correlator.reset();
+    this->numParticles = 0;
+    this->signals.clear();
+    this->resetState();
+}
+
+std::vector<std::pair<std::size_t, double>> TimeCorrelation::getValues() const {
+    if (!this->correlator.has_value())
+        return {};
+
+    auto correlation = this->correlator->getCorrelation();
+    std::vector<std::pair<std::size_t, double>> values;
+    values.reserve(correlation.size());
+    for (const auto &point : correlation)
+        values.emplace_back(point.lag, this->transformCorrelation(point.value));
+    return values;
+}
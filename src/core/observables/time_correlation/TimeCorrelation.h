@@ -0,0 +1,74 @@
+#ifndef RAMPACK_TIMECORRELATION_H
+#define RAMPACK_TIMECORRELATION_H
+
+#include <optional>
+#include <vector>
+
+#include "core/BulkObservable.h"
+#include "MultiTauCorrelator.h"
+
+
+/**
+ * @brief Base class for BulkObservable -s computing a time correlation function of per-particle signals over
+ * consecutive snapshots.
+ * @details Derived classes calculate a fixed number of signals for each particle in each snapshot (see
+ * TimeCorrelation::calculateSignals) and the correlation function, averaged over time origins, particles and signals,
+ * is calculated on the fly using MultiTauCorrelator. Thus, memory does not grow with the length of the trajectory.
+ * Snapshots are assumed to be equally spaced, so adaptive bulk sampling is disabled (see
+ * BulkObservable::requiresEquallySpacedSnapshots). The number of particles has to be constant. The output consists of
+ * two columns: lag in units of snapshots and the (transformed, see TimeCorrelation::transformCorrelation) value.
+ */
+class TimeCorrelation : public BulkObservable {
+private:
+    MultiTauCorrelator::Mode mode{};
+    std::size_t signalsPerParticle{};
+    std::size_t pointsPerLevel{};
+    std::optional<MultiTauCorrelator> correlator;
+    std::size_t numParticles{};
+    std::vector<double> signals;
+
+protected:
+    /**
+     * @brief Fills @a signals (already of size <tt>signalsPerParticle * packing.size()</tt>) with signals of all
+     * particles in @a packing, in a particle-major order.
+     */
+    virtual void calculateSignals(const Packing &packing, const ShapeTraits &shapeTraits,
+                                  std::vector<double> &signals) = 0;
+
+    /**
+     * @brief Transforms the correlation averaged over time origins, particles and signals into the final value.
+     */
+    [[nodiscard]] virtual double transformCorrelation(double correlation) const = 0;
+
+    /**
+     * @brief Resets the derived class state (for example stored positions) when the observable is cleared.
+     */
+    virtual void resetState() { }
+
+public:
+    /**
+     * @brief Creates the class with @a signalsPerParticle signals combined according to @a mode.
+     * @details @a pointsPerLevel is passed to MultiTauCorrelator - lags up to @a pointsPerLevel - 1 are calculated
+     * exactly, while the larger ones are based on block-averaged signals.
+     */
+    TimeCorrelation(MultiTauCorrelator::Mode mode, std::size_t signalsPerParticle,
+                    std::size_t pointsPerLevel = MultiTauCorrelator::DEFAULT_POINTS_PER_LEVEL);
+
+    void addSnapshot(const Packing &packing, double temperature, double pressure,
+                     const ShapeTraits &shapeTraits) final;
+    void print(std::ostream &out) const final;
+    void clear() final;
+
+    /**
+     * @brief Returns @a true, since lags are expressed in units of snapshots.
+     */
+    [[nodiscard]] bool requiresEquallySpacedSnapshots() const final { return true; }
+
+    /**
+     * @brief Returns the correlation function as a list of (lag, value) pairs.
+     */
+    [[nodiscard]] std::vector<std::pair<std::size_t, double>> getValues() const;
+};
+
+
+#endif //RAMPACK_TIMECORRELATION_H
@@ -0,0 +1,28 @@
+#include "UnwrappedPositions.h"
+#include "utils/Exceptions.h"
+
+
+void UnwrappedPositions::update(const Packing &packing) {
+    if (this->lastPositions.empty()) {
+        this->lastPositions.reserve(packing.size());
+        for (const auto &shape : packing)
+            this->lastPositions.push_back(shape.getPosition());
+        this->unwrappedPositions = this->lastPositions;
+        return;
+    }
+
+    Expects(packing.size() == this->lastPositions.size());
+    const auto &bc = packing.getBoundaryConditions();
+    for (std::size_t i{}; i < packing.size(); i++) {
+        const auto &position = packing[i].getPosition();
+        auto &lastPosition = this->lastPositions[i];
+        Vector<3> nearestLastPosition = lastPosition + bc.getTranslation(position, lastPosition);
+        this->unwrappedPositions[i] += position - nearestLastPosition;
+        lastPosition = position;
+    }
+}
+
+void UnwrappedPositions::clear() {
+    this->lastPositions.clear();
+    this->unwrappedPositions.clear();
+}
@@ -0,0 +1,38 @@
+#ifndef RAMPACK_UNWRAPPEDPOSITIONS_H
+#define RAMPACK_UNWRAPPEDPOSITIONS_H
+
+#include <vector>
+
+#include "core/Packing.h"
+
+
+/**
+ * @brief Tracks positions of particles unwrapped from periodic boundary conditions across consecutive snapshots.
+ * @details The displacement between snapshots is calculated using the nearest image, so particles should not move by
+ * more than half of the box size between snapshots.
+ */
+class UnwrappedPositions {
+private:
+    std::vector<Vector<3>> lastPositions;
+    std::vector<Vector<3>> unwrappedPositions;
+
+public:
+    /**
+     * @brief Updates unwrapped positions based on @a packing. The first call initializes them to the current
+     * positions.
+     */
+    void update(const Packing &packing);
+
+    /**
+     * @brief Returns unwrapped positions after the last update.
+     */
+    [[nodiscard]] const std::vector<Vector<3>> &getPositions() const { return this->unwrappedPositions; }
+
+    /**
+     * @brief Forgets all positions.
+     */
+    void clear();
+};
+
+
+#endif //RAMPACK_UNWRAPPEDPOSITIONS_H
@@ -113,6 +113,14 @@ FourierTracker::FourierCoefficients FourierTracker::calculateFourierCoefficients
 {
     FourierCoefficients coefficients{};
 
+    std::vector<double> functionValues;
+    this->function->calculateBatchConcurrently(packing.begin(), packing.end(), shapeTraits, functionValues);
+    std::vector<Vector<3>> relativePositions;
+    relativePositions.reserve(packing.size());
+    const auto &box = packing.getBox();
+    for (const auto &shape : packing)
+        relativePositions.push_back(box.absoluteToRelative(shape.getPosition()));
+
     for (std::size_t i{}; i < this->fourierFunctions[0].size(); i++) {
         for (std::size_t j{}; j < this->fourierFunctions[1].size(); j++) {
             for (std::size_t k{}; k < this->fourierFunctions[2].size(); k++) {
@@ -126,13 +134,8 @@ FourierTracker::FourierCoefficients FourierTracker::calculateFourierCoefficients
                 };
 
                 coefficient = 0;
-                for (std::size_t shapeI{}; shapeI < packing.size(); shapeI++) {
-                    const auto &shape = packing[shapeI];
-                    this->function->calculate(shape, shapeTraits);
-                    double functionMapping = this->function->getValues().front();
-                    Vector<3> relativePos = packing.getBox().absoluteToRelative(shape.getPosition());
-                    coefficient += fProduct(relativePos) * functionMapping;
-                }
+                for (std::size_t shapeI{}; shapeI < packing.size(); shapeI++)
+                    coefficient += fProduct(relativePositions[shapeI]) * functionValues[shapeI];
             }
         }
     }
@@ -113,6 +113,14 @@ std::vector<Vector<3>> PolysphereTraits::HardInteraction::getInteractionCentres(
     return centres;
 }
 
+std::vector<double> PolysphereTraits::HardInteraction::getInteractionCentreRangeRadii() const {
+    std::vector<double> rangeRadii;
+    rangeRadii.reserve(this->sphereData.size());
+    for (const auto &data : this->sphereData)
+        rangeRadii.push_back(2 * data.radius);
+    return rangeRadii;
+}
+
 double PolysphereTraits::HardInteraction::getRangeRadius() const {
     auto comparator = [](const SphereData &sd1, const SphereData &sd2) {
         return sd1.radius < sd2.radius;
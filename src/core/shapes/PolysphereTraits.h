@@ -138,6 +138,7 @@ private:
                                            const Vector<3> &wallOrigin, const Vector<3> &wallVector) const override;
 
         [[nodiscard]] std::vector<Vector<3>> getInteractionCentres() const override;
+        [[nodiscard]] std::vector<double> getInteractionCentreRangeRadii() const override;
 
         [[nodiscard]] double getRangeRadius() const override;
     };
@@ -5,6 +5,9 @@
 #include <fstream>
 #include <regex>
 #include <filesystem>
+#include <cstdlib>
+
+#include <unistd.h>
 
 #include "IO.h"
 #include "utils/Utils.h"
@@ -29,6 +32,31 @@ void IO::storeSnapshots(const ObservablesCollector &observablesCollector, bool i
     this->logger.info() << "Observable snapshots stored to '" + observableSnapshotFilename << "'" << std::endl;
 }
 
+void IO::attachSnapshotSpillFile(ObservablesCollector &observablesCollector, std::size_t maxInMemorySnapshots) const {
+    // mkstemp creates the file exclusively, so an already existing file (for example a symlink planted by another user)
+    // is never opened. In a sticky temporary directory, other users cannot replace it afterwards
+    std::string pathTemplate = (std::filesystem::temp_directory_path() / "rampack_snapshots_XXXXXX").string();
+    int fileDescriptor = mkstemp(pathTemplate.data());
+    ValidateMsg(fileDescriptor != -1,
+                "Could not create a temporary file '" + pathTemplate + "' to store observable snapshots");
+    close(fileDescriptor);
+    std::filesystem::path path = pathTemplate;
+
+    auto spillFile = std::make_unique<std::fstream>(
+        path, std::ios_base::in | std::ios_base::out | std::ios_base::trunc | std::ios_base::binary
+    );
+    ValidateOpenedDesc(*spillFile, path.string(), "to temporarily store observable snapshots");
+
+    // The file is removed right away - it stays accessible until the stream is closed. If it fails, the file is simply
+    // left in the temporary directory
+    std::error_code errorCode;
+    std::filesystem::remove(path, errorCode);
+
+    observablesCollector.attachSnapshotSpillStream(std::move(spillFile), maxInMemorySnapshots);
+    this->logger.verbose() << "Observable snapshots exceeding " << maxInMemorySnapshots << " are moved to ";
+    this->logger << "a temporary file '" << path.string() << "'" << std::endl;
+}
+
 std::unique_ptr<RamtrjPlayer> IO::loadRamtrjPlayer(std::string &trajectoryFilename, std::size_t numMolecules,
                                                    bool autoFix_)
 {
@@ -125,3 +153,14 @@ void IO::storeAverageValues(const std::string &filename, const ObservablesCollec
 
     this->logger.info() << "Average values stored to '" << filename << "'" << std::endl;
 }
+
+void IO::storeAveragingState(const std::string &filename, const ObservablesCollector &collector, std::size_t cycles,
+                             std::size_t averagedCycles) const
+{
+    std::ofstream out(filename);
+    ValidateOpenedDesc(out, filename, "to store the averaging state");
+    out << cycles << " " << averagedCycles << std::endl;
+    collector.storeAveragingState(out);
+
+    this->logger.info() << "Averaging state stored to '" << filename << "'" << std::endl;
+}
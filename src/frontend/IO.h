@@ -15,16 +15,22 @@ private:
     Logger &logger;
 
 public:
+    static constexpr std::size_t DEFAULT_IN_MEMORY_SNAPSHOTS = 1000;
+
     explicit IO(Logger &logger) : logger{logger} { }
 
     RampackParameters dispatchParams(const std::string &filename);
     std::unique_ptr<RamtrjPlayer> loadRamtrjPlayer(std::string &trajectoryFilename, size_t numMolecules, bool autoFix_);
     void storeSnapshots(const ObservablesCollector &observablesCollector, bool isContinuation,
                         const std::string &observableSnapshotFilename) const;
+    void attachSnapshotSpillFile(ObservablesCollector &observablesCollector,
+                                 std::size_t maxInMemorySnapshots = DEFAULT_IN_MEMORY_SNAPSHOTS) const;
     void storeBulkObservables(const ObservablesCollector &observablesCollector,
                               std::string bulkObservableFilenamePattern) const;
     void storeAverageValues(const std::string &filename, const ObservablesCollector &collector, double temperature,
                             double pressure) const;
+    void storeAveragingState(const std::string &filename, const ObservablesCollector &collector, std::size_t cycles,
+                             std::size_t averagedCycles) const;
 };
 
 
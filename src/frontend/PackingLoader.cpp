@@ -4,6 +4,7 @@
 
 #include <fstream>
 #include <iomanip>
+#include <sstream>
 
 #include "PackingLoader.h"
 #include "core/io/RamsnapReader.h"
@@ -72,6 +73,7 @@ void PackingLoader::reset() {
     this->isRestored_ = false;
     this->startRunIndex = 0;
     this->isAllFinished_ = false;
+    this->averagingState = std::nullopt;
 }
 
 void PackingLoader::autoFindStartRunIndex() {
@@ -238,8 +240,10 @@ void PackingLoader::loadPackingContinuation(std::unique_ptr<BoundaryConditions>
         this->logger << "' will be skipped, since " << *this->continuationCycles << " or more cycles were ";
         this->logger << "already performed." << std::endl;
 
-        if (integrationStartRun.averagingCycles > 0)
+        if (integrationStartRun.averagingCycles > 0) {
+            this->restoreAveragingState(integrationStartRun);
             return;
+        }
 
         this->logger << "Averaging phase is turned off, moving to the next run." << std::endl;
 
@@ -258,6 +262,33 @@ void PackingLoader::loadPackingContinuation(std::unique_ptr<BoundaryConditions>
 
 }
 
+void PackingLoader::restoreAveragingState(IntegrationRun &integrationRun) {
+    std::string filename = PackingLoader::getAveragingStateFilename(*integrationRun.ramsnapOut);
+    std::ifstream in(filename);
+    if (!in)
+        return;
+
+    std::size_t cycles{};
+    std::size_t averagedCycles{};
+    in >> cycles >> averagedCycles;
+    if (!in || cycles != this->cycleOffset || averagedCycles >= *integrationRun.averagingCycles) {
+        this->logger.warn() << "Averaging state '" << filename << "' does not match the RAMSNAP file. Averaging ";
+        this->logger << "will be started from scratch." << std::endl;
+        return;
+    }
+
+    std::ostringstream state;
+    state << in.rdbuf();
+    this->averagingState = AveragingState{averagedCycles, state.str()};
+    integrationRun.averagingCycles = *integrationRun.averagingCycles - averagedCycles;
+    this->logger.info() << "Averaging of the interrupted run '" << integrationRun.runName << "' will be resumed ";
+    this->logger << "from '" << filename << "' (" << *integrationRun.averagingCycles << " cycles to go)" << std::endl;
+}
+
+std::string PackingLoader::getAveragingStateFilename(const std::string &ramsnapFilename) {
+    return ramsnapFilename + ".avgstate";
+}
+
 void PackingLoader::loadPackingNoContinuation(std::unique_ptr<BoundaryConditions> bc, const Interaction &interaction,
                                               std::size_t moveThreads, std::size_t scalingThreads)
 {
@@ -14,6 +14,15 @@
 
 
 class PackingLoader {
+public:
+    // The state of the averaging phase of an interrupted integration run, which is resumed
+    struct AveragingState {
+        // The number of cycles of the averaging phase performed before the interruption
+        std::size_t averagedCycles{};
+        // The state stored using ObservablesCollector::storeAveragingState
+        std::string state;
+    };
+
 private:
     struct PerformedRunData {
         std::string runName;
@@ -39,6 +48,7 @@ private:
     bool isRestored_{};
     std::unique_ptr<Packing> packing{};
     bool isAllFinished_{};
+    std::optional<AveragingState> averagingState{};
 
     void findStartRunIndex();
     void autoFindStartRunIndex();
@@ -53,10 +63,14 @@ private:
     void loadPackingNoContinuation(std::unique_ptr<BoundaryConditions> bc, const Interaction &interaction,
                                    std::size_t moveThreads, std::size_t scalingThreads);
     [[nodiscard]] bool isStartingFromScratch() const;
+    void restoreAveragingState(IntegrationRun &integrationRun);
 
 public:
     static std::size_t findStartRunIndex(const std::string &runName, const std::vector<Run> &runsParameters);
 
+    // The state of the averaging of an interrupted integration run is stored next to its RAMSNAP file
+    static std::string getAveragingStateFilename(const std::string &ramsnapFilename);
+
     // TODO: runsParameters should not be modified. Instead, there should be getter for new number of thermalization
     // cycles
     PackingLoader(Logger &logger, std::optional<std::string> startFrom, std::optional<std::size_t> continuationCycles,
@@ -76,6 +90,10 @@ public:
     [[nodiscard]] std::unique_ptr<Packing> releasePacking() { return std::move(this->packing); }
     [[nodiscard]] bool isAllFinished() const { return this->isAllFinished_; }
 
+    // If the averaging phase of the continued run was interrupted, it is resumed from this state. The number of
+    // averaging cycles of the run is then reduced by the cycles already performed
+    [[nodiscard]] const std::optional<AveragingState> &getAveragingState() const { return this->averagingState; }
+
     void reset();
 };
 
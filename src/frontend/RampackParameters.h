@@ -29,7 +29,9 @@ struct BaseParameters {
     std::shared_ptr<ShapeTraits> shapeTraits;
     std::array<bool, 3> walls{};
     std::size_t scalingThreads{};
+    std::size_t intraMoveThreads{};
     std::array<std::size_t, 3> domainDivisions{};
+    bool autoDomainDivisions{};
     bool saveOnSignal{};
 };
 
@@ -40,6 +42,13 @@ struct IntegrationRun {
     std::optional<std::size_t> averagingCycles{};
     std::size_t snapshotEvery{};
     std::size_t averagingEvery{};
+    std::size_t bulkAveragingMaxEvery{};
+    Simulation::StepSizeTuning stepSizeTuning{};
+    ParticleSweep::Order moveScheduling{};
+    bool speculativeMoves{};
+    bool asynchronousAnalysis{};
+    std::size_t overlapCheckEvery{};
+    double overlapCheckFraction{};
     std::size_t inlineInfoEvery{};
     std::size_t orientationFixEvery{};
     std::vector<FileSnapshotWriter> lastSnapshotWriters;
@@ -56,6 +65,9 @@ struct OverlapRelaxationRun  {
     std::string runName;
     Simulation::Environment environment;
     std::size_t snapshotEvery{};
+    ParticleSweep::Order moveScheduling{};
+    bool speculativeMoves{};
+    std::size_t overlapCheckEvery{};
     std::size_t inlineInfoEvery{};
     std::size_t orientationFixEvery{};
     std::shared_ptr<ShapeTraits> helperShapeTraits;
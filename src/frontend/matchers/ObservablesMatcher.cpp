@@ -32,6 +32,9 @@
 #include "core/observables/DensityHistogram.h"
 #include "core/observables/correlation/ProbabilityEvolution.h"
 #include "core/observables/BinAveragedFunction.h"
+#include "core/observables/time_correlation/OrientationAutocorrelation.h"
+#include "core/observables/time_correlation/MeanSquaredDisplacement.h"
+#include "core/observables/time_correlation/SelfIntermediateScattering.h"
 
 #include "core/observables/correlation_functions/S110Correlation.h"
 #include "core/observables/correlation_functions/S220Correlation.h"
@@ -82,6 +85,9 @@ namespace {
     MatcherDataclass create_density_histogram(std::size_t maxThreads);
     MatcherDataclass create_probability_evolution(std::size_t maxThreads);
     MatcherDataclass create_bin_averaged_function(std::size_t maxThreads);
+    MatcherDataclass create_orientation_autocorrelation();
+    MatcherDataclass create_mean_squared_displacement();
+    MatcherDataclass create_self_intermediate_scattering();
 
     MatcherDataclass create_radial();
     MatcherDataclass create_layerwise_radial();
@@ -125,6 +131,12 @@ namespace {
     });
     auto shapeAxis = primaryAxis | secondaryAxis | auxiliaryAxis;
 
+    auto pointsPerLevel = MatcherInt{}
+        .greaterEquals(2)
+        .filter([](long i) { return i % 2 == 0; })
+        .describe("even")
+        .mapTo<std::size_t>();
+
     auto binning = create_radial() | create_layerwise_radial() | create_linear();
 
     auto shapeFunction = create_shape_function();
@@ -347,7 +359,10 @@ namespace {
             | create_pair_averaged_correlation(maxThreads)
             | create_density_histogram(maxThreads)
             | create_probability_evolution(maxThreads)
-            | create_bin_averaged_function(maxThreads);
+            | create_bin_averaged_function(maxThreads)
+            | create_orientation_autocorrelation()
+            | create_mean_squared_displacement()
+            | create_self_intermediate_scattering();
     }
 
     MatcherDataclass create_pair_density_correlation(std::size_t maxThreads) {
@@ -502,6 +517,37 @@ namespace {
             });
     }
 
+    MatcherDataclass create_orientation_autocorrelation() {
+        return MatcherDataclass("orientation_autocorrelation")
+            .arguments({{"axis", shapeAxis, R"("primary")"},
+                        {"points_per_level", pointsPerLevel, "16"}})
+            .mapTo([](const DataclassData &autocorrelation) -> std::shared_ptr<BulkObservable> {
+                auto axis = autocorrelation["axis"].as<ShapeGeometry::Axis>();
+                auto points = autocorrelation["points_per_level"].as<std::size_t>();
+                return std::make_shared<OrientationAutocorrelation>(axis, points);
+            });
+    }
+
+    MatcherDataclass create_mean_squared_displacement() {
+        return MatcherDataclass("mean_squared_displacement")
+            .arguments({{"points_per_level", pointsPerLevel, "16"}})
+            .mapTo([](const DataclassData &msd) -> std::shared_ptr<BulkObservable> {
+                auto points = msd["points_per_level"].as<std::size_t>();
+                return std::make_shared<MeanSquaredDisplacement>(points);
+            });
+    }
+
+    MatcherDataclass create_self_intermediate_scattering() {
+        return MatcherDataclass("self_intermediate_scattering")
+            .arguments({{"k", MatcherFloat{}.positive()},
+                        {"points_per_level", pointsPerLevel, "16"}})
+            .mapTo([](const DataclassData &scattering) -> std::shared_ptr<BulkObservable> {
+                auto k = scattering["k"].as<double>();
+                auto points = scattering["points_per_level"].as<std::size_t>();
+                return std::make_shared<SelfIntermediateScattering>(k, points);
+            });
+    }
+
     MatcherDataclass create_radial() {
         return MatcherDataclass("radial")
             .arguments({{"focal_point", MatcherString{}.nonEmpty(), R"("o")"}})
@@ -24,6 +24,7 @@ using namespace pyon::matcher;
 
 namespace {
     struct BoxScalingDisabled { };
+    struct DomainDivisionsAuto { };
 
     using ObservableData = ObservablesMatcher::ObservableData;
 
@@ -49,7 +50,7 @@ namespace {
     MatcherAlternative create_move_types();
     MatcherAlternative create_box_scaler();
     MatcherAlternative create_box_move_threads();
-    MatcherArray create_domain_divisions();
+    MatcherAlternative create_domain_divisions();
     Simulation::Environment create_environment(const DataclassData &environment);
     BaseParameters create_base_parameters(const DataclassData &rampack);
 
@@ -78,6 +79,27 @@ namespace {
     auto outNone = MatcherNone{}.mapTo<std::optional<std::string>>();
     auto out_ = outString | outNone;
 
+    auto moveScheduling = MatcherString{}
+        .anyOf({"random", "sequential", "spatial", "shuffled_blocks"})
+        .mapTo([](const std::string &scheduling) {
+            if (scheduling == "random")
+                return ParticleSweep::Order::RANDOM;
+            else if (scheduling == "sequential")
+                return ParticleSweep::Order::SEQUENTIAL;
+            else if (scheduling == "spatial")
+                return ParticleSweep::Order::SPATIAL;
+            else if (scheduling == "shuffled_blocks")
+                return ParticleSweep::Order::SHUFFLED_BLOCKS;
+            else
+                AssertThrow(scheduling);
+        });
+
+    auto speculative_moves_filter = [](const DataclassData &run) {
+        if (!run["speculative_moves"].as<bool>())
+            return true;
+        return run["move_scheduling"].as<ParticleSweep::Order>() == ParticleSweep::Order::RANDOM;
+    };
+
 
     MatcherString create_version() {
         return MatcherString{}
@@ -167,6 +189,14 @@ namespace {
                         {"move_types", create_move_types(), "None"},
                         {"box_move_type", create_box_scaler(), "None"},
                         {"averaging_every", nullableEvery, "0"},
+                        {"bulk_averaging_max_every", nullableEvery, "0"},
+                        {"step_size_tuning", MatcherString{}.anyOf({"acceptance_rate", "efficiency"}),
+                         R"("acceptance_rate")"},
+                        {"move_scheduling", moveScheduling, R"("random")"},
+                        {"speculative_moves", MatcherBoolean{}, "False"},
+                        {"async_analysis", MatcherBoolean{}, "False"},
+                        {"overlap_check_every", nullableEvery, "0"},
+                        {"overlap_check_fraction", MatcherFloat{}.positive().lessEquals(1), "1.0"},
                         {"inline_info_every", notNullEvery, "100"},
                         {"orientation_fix_every", notNullEvery, "10000"},
                         {"output_last_snapshot", create_output_last_snapshot(), "[]"},
@@ -190,6 +220,14 @@ namespace {
                 return averagingEvery > 0;
             })
             .describe("if averaging_cycles is specified, averaging_every > 0 should also be specified")
+            .filter([](const DataclassData &integration) {
+                auto averagingEvery = integration["averaging_every"].as<std::size_t>();
+                auto bulkAveragingMaxEvery = integration["bulk_averaging_max_every"].as<std::size_t>();
+                if (bulkAveragingMaxEvery == 0)
+                    return true;
+                return averagingEvery > 0 && bulkAveragingMaxEvery % averagingEvery == 0;
+            })
+            .describe("if bulk_averaging_max_every > 0 is specified, it should be a multiple of averaging_every")
             .filter([](const DataclassData &integration) {
                 auto averagingCycles = integration["averaging_cycles"].as<std::optional<std::size_t>>();
                 auto averagesOut = integration["averages_out"].as<std::optional<std::string>>();
@@ -209,6 +247,8 @@ namespace {
                 return bulkObservablesOutPattern.has_value();
             })
             .describe("if bulk_observables are specified, bulk_observables_out_pattern should also be")
+            .filter(speculative_moves_filter)
+            .describe("if speculative_moves is True, move_scheduling should be \"random\"")
             .mapTo([](const DataclassData &integration) -> Run {
                 IntegrationRun run;
 
@@ -218,6 +258,16 @@ namespace {
                 run.averagingCycles = integration["averaging_cycles"].as<std::optional<std::size_t>>();
                 run.snapshotEvery = integration["snapshot_every"].as<std::size_t>();
                 run.averagingEvery = integration["averaging_every"].as<std::size_t>();
+                run.bulkAveragingMaxEvery = integration["bulk_averaging_max_every"].as<std::size_t>();
+                if (integration["step_size_tuning"].as<std::string>() == "efficiency")
+                    run.stepSizeTuning = Simulation::StepSizeTuning::EFFICIENCY;
+                else
+                    run.stepSizeTuning = Simulation::StepSizeTuning::ACCEPTANCE_RATE;
+                run.moveScheduling = integration["move_scheduling"].as<ParticleSweep::Order>();
+                run.speculativeMoves = integration["speculative_moves"].as<bool>();
+                run.asynchronousAnalysis = integration["async_analysis"].as<bool>();
+                run.overlapCheckEvery = integration["overlap_check_every"].as<std::size_t>();
+                run.overlapCheckFraction = integration["overlap_check_fraction"].as<double>();
                 run.inlineInfoEvery = integration["inline_info_every"].as<std::size_t>();
                 run.orientationFixEvery = integration["orientation_fix_every"].as<std::size_t>();
                 run.lastSnapshotWriters = integration["output_last_snapshot"].as<std::vector<FileSnapshotWriter>>();
@@ -254,6 +304,9 @@ namespace {
                         {"pressure", dynamicParameter, "None"},
                         {"move_types", create_move_types(), "None"},
                         {"box_move_type", create_box_scaler(), "None"},
+                        {"move_scheduling", moveScheduling, R"("random")"},
+                        {"speculative_moves", MatcherBoolean{}, "False"},
+                        {"overlap_check_every", nullableEvery, "0"},
                         {"inline_info_every", notNullEvery, "100"},
                         {"orientation_fix_every", notNullEvery, "10000"},
                         {"helper_shape", helperShape, "None"},
@@ -261,12 +314,17 @@ namespace {
                         {"record_trajectory", create_record_trajectory(), "[]"},
                         {"observables", create_observables_matcher(), "[]"},
                         {"observables_out", out_, "None"}})
+            .filter(speculative_moves_filter)
+            .describe("if speculative_moves is True, move_scheduling should be \"random\"")
             .mapTo([](const DataclassData &overlaps) -> Run {
                 OverlapRelaxationRun run;
 
                 run.runName = overlaps["run_name"].as<std::string>();
                 run.environment = create_environment(overlaps);
                 run.snapshotEvery = overlaps["snapshot_every"].as<std::size_t>();
+                run.moveScheduling = overlaps["move_scheduling"].as<ParticleSweep::Order>();
+                run.speculativeMoves = overlaps["speculative_moves"].as<bool>();
+                run.overlapCheckEvery = overlaps["overlap_check_every"].as<std::size_t>();
                 run.inlineInfoEvery = overlaps["inline_info_every"].as<std::size_t>();
                 run.orientationFixEvery = overlaps["orientation_fix_every"].as<std::size_t>();
                 run.helperShapeTraits = overlaps["helper_shape"].as<std::shared_ptr<ShapeTraits>>();
@@ -327,9 +385,12 @@ namespace {
         return moveThreadsMax | moveThreadsInt;
     }
 
-    MatcherArray create_domain_divisions() {
-        return MatcherArray(MatcherInt{}.positive().mapTo<std::size_t>(), 3)
+    MatcherAlternative create_domain_divisions() {
+        auto domainDivisionsAuto = MatcherString("auto")
+            .mapTo([](const std::string&) { return DomainDivisionsAuto{}; });
+        auto domainDivisionsArray = MatcherArray(MatcherInt{}.positive().mapTo<std::size_t>(), 3)
             .mapToStdArray<std::size_t, 3>();
+        return domainDivisionsAuto | domainDivisionsArray;
     }
 
     Simulation::Environment create_environment(const DataclassData &environment) {
@@ -368,7 +429,14 @@ namespace {
         baseParams.baseEnvironment = create_environment(rampack);
         baseParams.walls = rampack["walls"].as<std::array<bool, 3>>();
         baseParams.scalingThreads = rampack["box_move_threads"].as<std::size_t>();
-        baseParams.domainDivisions = rampack["domain_divisions"].as<std::array<std::size_t, 3>>();
+        baseParams.intraMoveThreads = rampack["intra_move_threads"].as<std::size_t>();
+        auto domainDivisions = rampack["domain_divisions"];
+        if (domainDivisions.is<DomainDivisionsAuto>()) {
+            baseParams.domainDivisions = {1, 1, 1};
+            baseParams.autoDomainDivisions = true;
+        } else {
+            baseParams.domainDivisions = domainDivisions.as<std::array<std::size_t, 3>>();
+        }
         baseParams.saveOnSignal = rampack["handle_signals"].as<bool>();
 
         return baseParams;
@@ -392,6 +460,7 @@ pyon::matcher::MatcherDataclass RampackMatcher::create() {
                     {"box_move_type", create_box_scaler(), "None"},
                     {"walls", walls, "[False, False, False]"},
                     {"box_move_threads", create_box_move_threads(), "1"},
+                    {"intra_move_threads", create_box_move_threads(), "1"},
                     {"domain_divisions", create_domain_divisions(), "[1, 1, 1]"},
                     {"handle_signals", MatcherBoolean{}, "True"}})
         .filter([](const DataclassData &rampack) {
@@ -2,6 +2,10 @@
 // Created by Piotr Kubala on 16/12/2022.
 //
 
+#include <fstream>
+#include <optional>
+#include <sstream>
+
 #include "ShapeMatcher.h"
 
 #include "core/shapes/SphereTraits.h"
@@ -18,19 +22,29 @@
 #include "core/interactions/LennardJonesInteraction.h"
 #include "core/interactions/RepulsiveLennardJonesInteraction.h"
 #include "core/interactions/SquareInverseCoreInteraction.h"
+#include "core/interactions/TabulatedInteraction.h"
 
 #include "geometry/xenocollide/XCBodyBuilder.h"
 #include "core/shapes/PolyhedralWedgeTraits.h"
 
 #include "GenericConvexGeometryMatcher.h"
+#include "utils/Exceptions.h"
 
 
 using namespace pyon::matcher;
 
 namespace {
+    struct TabulationParameters {
+        double minR{};
+        std::size_t numNodes{};
+        PotentialTable::Interpolation interpolation{};
+        std::optional<double> maxError;
+    };
+
     MatcherDataclass create_lj_matcher();
     MatcherDataclass create_wca_matcher();
     MatcherDataclass create_square_inverse_core_matcher();
+    MatcherDataclass create_tabulated_matcher();
 
     MatcherDataclass create_sphere_matcher();
     MatcherDataclass create_kmer_matcher();
@@ -46,11 +60,36 @@ namespace {
     MatcherDataclass create_polyhedral_wedge_matcher();
 
     bool validate_axes(const DataclassData &dataclass);
+    void tabulate_if_requested(CentralInteraction &interaction, const DataclassData &dataclass);
+
+
+    // Both have to be defined before softInteraction - the interaction matchers creating it copy them
+    auto interpolation = MatcherString{}
+        .anyOf({"linear", "spline"})
+        .mapTo([](const std::string &interpolation) {
+            if (interpolation == "linear")
+                return PotentialTable::Interpolation::LINEAR;
+            else
+                return PotentialTable::Interpolation::CUBIC_SPLINE;
+        });
 
+    auto tabulation = MatcherDataclass("table")
+        .arguments({{"min_r", MatcherFloat{}.positive()},
+                    {"points", MatcherInt{}.greaterEquals(2).mapTo<std::size_t>(), "1000"},
+                    {"interpolation", interpolation, R"("spline")"},
+                    {"max_error", MatcherFloat{}.positive() | MatcherNone{}, "None"}})
+        .mapTo([](const DataclassData &table) {
+            TabulationParameters params{table["min_r"].as<double>(), table["points"].as<std::size_t>(),
+                                        table["interpolation"].as<PotentialTable::Interpolation>(), std::nullopt};
+            if (!table["max_error"].isEmpty())
+                params.maxError = table["max_error"].as<double>();
+            return params;
+        });
 
     auto hardInteraction = MatcherDataclass("hard")
         .mapTo([](const auto &) -> std::shared_ptr<CentralInteraction> { return nullptr; });
-    auto softInteraction = create_lj_matcher() | create_wca_matcher() | create_square_inverse_core_matcher();
+    auto softInteraction = create_lj_matcher() | create_wca_matcher() | create_square_inverse_core_matcher()
+        | create_tabulated_matcher();
     auto sphereInteraction = hardInteraction | softInteraction;
 
     auto vector = MatcherArray(MatcherFloat{}.mapTo<double>(), 3).mapToVector<3>();
@@ -77,36 +116,105 @@ namespace {
     MatcherDataclass create_lj_matcher() {
         return MatcherDataclass("lj")
             .arguments({{"epsilon", MatcherFloat{}.positive()},
-                        {"sigma", MatcherFloat{}.positive()}})
+                        {"sigma", MatcherFloat{}.positive()},
+                        {"tabulation", tabulation | MatcherNone{}, "None"}})
             .mapTo([](const DataclassData &lj) -> std::shared_ptr<CentralInteraction> {
-                return std::make_shared<LennardJonesInteraction>(
+                auto interaction = std::make_shared<LennardJonesInteraction>(
                     lj["epsilon"].as<double>(), lj["sigma"].as<double>()
                 );
+                tabulate_if_requested(*interaction, lj);
+                return interaction;
             });
     }
 
     MatcherDataclass create_wca_matcher() {
         return MatcherDataclass("wca")
             .arguments({{"epsilon", MatcherFloat{}.positive()},
-                        {"sigma", MatcherFloat{}.positive()}})
+                        {"sigma", MatcherFloat{}.positive()},
+                        {"tabulation", tabulation | MatcherNone{}, "None"}})
             .mapTo([](const DataclassData &wca) -> std::shared_ptr<CentralInteraction> {
-                return std::make_shared<RepulsiveLennardJonesInteraction>(
+                auto interaction = std::make_shared<RepulsiveLennardJonesInteraction>(
                     wca["epsilon"].as<double>(), wca["sigma"].as<double>()
                 );
+                tabulate_if_requested(*interaction, wca);
+                return interaction;
             });
     }
 
     MatcherDataclass create_square_inverse_core_matcher() {
         return MatcherDataclass("square_inverse_core")
             .arguments({{"epsilon", MatcherFloat{}.positive()},
-                        {"sigma", MatcherFloat{}.positive()}})
+                        {"sigma", MatcherFloat{}.positive()},
+                        {"tabulation", tabulation | MatcherNone{}, "None"}})
             .mapTo([](const DataclassData &square_inverse_core) -> std::shared_ptr<CentralInteraction> {
-                return std::make_shared<SquareInverseCoreInteraction>(
+                auto interaction = std::make_shared<SquareInverseCoreInteraction>(
                     square_inverse_core["epsilon"].as<double>(), square_inverse_core["sigma"].as<double>()
                 );
+                tabulate_if_requested(*interaction, square_inverse_core);
+                return interaction;
+            });
+    }
+
+    MatcherDataclass create_tabulated_matcher() {
+        auto energyArray = MatcherArray{}
+            .elementsMatch(MatcherFloat{}.mapTo<double>())
+            .sizeAtLeast(2)
+            .mapToStdVector<double>();
+        auto energyFile = MatcherString{}
+            .nonEmpty()
+            .mapTo([](const std::string &filename) {
+                std::ifstream energyFile(filename);
+                ValidateOpenedDesc(energyFile, filename, "to load tabulated potential");
+                auto energies = TabulatedInteraction::readEnergies(energyFile);
+                ValidateMsg(energies.size() >= 2, "Tabulated potential in " + filename + " has less than 2 nodes");
+                return energies;
+            });
+
+        return MatcherDataclass("tabulated")
+            .arguments({{"min_r", MatcherFloat{}.positive()},
+                        {"max_r", MatcherFloat{}.positive()},
+                        {"energies", energyArray | energyFile},
+                        {"interpolation", interpolation, R"("spline")"}})
+            .filter([](const DataclassData &tabulated) {
+                return tabulated["min_r"].as<double>() < tabulated["max_r"].as<double>();
+            })
+            .describe("with min_r < max_r")
+            .filter([](const DataclassData &tabulated) {
+                return tabulated["energies"].as<std::vector<double>>().back() == 0;
+            })
+            .describe("with the last energy equal to 0")
+            .filter([](const DataclassData &tabulated) {
+                const auto &energies = tabulated["energies"].as<std::vector<double>>();
+                return energies[0] > energies[1];
+            })
+            .describe("with the first energy larger than the second one")
+            .mapTo([](const DataclassData &tabulated) -> std::shared_ptr<CentralInteraction> {
+                return std::make_shared<TabulatedInteraction>(
+                    tabulated["min_r"].as<double>(), tabulated["max_r"].as<double>(),
+                    tabulated["energies"].as<std::vector<double>>(),
+                    tabulated["interpolation"].as<PotentialTable::Interpolation>()
+                );
             });
     }
 
+    void tabulate_if_requested(CentralInteraction &interaction, const DataclassData &dataclass) {
+        if (dataclass["tabulation"].isEmpty())
+            return;
+
+        auto table = dataclass["tabulation"].as<TabulationParameters>();
+        ValidateMsg(table.minR < interaction.getRangeRadius(),
+                    "Tabulation min_r should be smaller than the interaction range "
+                    + std::to_string(interaction.getRangeRadius()));
+        auto accuracy = interaction.tabulate(table.minR, table.numNodes, table.interpolation);
+        if (table.maxError.has_value() && accuracy.maxAbsoluteError > *table.maxError) {
+            std::ostringstream message;
+            message << "Maximal error of the tabulated potential " << accuracy.maxAbsoluteError << " at r = ";
+            message << accuracy.maxErrorDistance << " exceeds max_error = " << *table.maxError;
+            message << ". Increase the number of points or min_r";
+            throw ValidationException(message.str());
+        }
+    }
+
     MatcherDataclass create_sphere_matcher() {
         return MatcherDataclass("sphere")
             .arguments({{"r", MatcherFloat{}.positive()},
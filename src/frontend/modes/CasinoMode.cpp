@@ -5,14 +5,17 @@
 #include <iomanip>
 #include <fstream>
 #include <set>
+#include <algorithm>
 
 #include <cxxopts.hpp>
 
 #include "CasinoMode.h"
 #include "utils/Utils.h"
 #include "core/shapes/CompoundShapeTraits.h"
+#include "core/interactions/CentralInteraction.h"
 #include "core/PeriodicBoundaryConditions.h"
 #include "utils/Fold.h"
+#include "utils/CpuDispatch.h"
 
 
 int CasinoMode::main(int argc, char **argv) {
@@ -51,9 +54,9 @@ int CasinoMode::main(int argc, char **argv) {
             ("c,continue", "when specified, the thermalization of previously finished or aborted run will be continued "
                            "for as many more cycles as specified. It can be used together with `--start-from` to "
                            "specify which run should be continued. If the thermalization phase is already over, "
-                           "the averaging phase will be immediately started. If 0 is specified (or left blank, since "
-                           "0 is the implicit value), total number of thermalization cycles from the input file will "
-                           "not be changed",
+                           "the averaging phase will be immediately started (or resumed, if it was interrupted). If 0 "
+                           "is specified (or left blank, since 0 is the implicit value), total number of "
+                           "thermalization cycles from the input file will not be changed",
              cxxopts::value<std::size_t>(continuationCycles)->implicit_value("0"))
             ("l,log-file", "if specified, messages will be logged both on the standard output and to this file. "
                            "Verbosity defaults then to: `warn` for standard output and to: `info` for log file, unless "
@@ -94,6 +97,7 @@ int CasinoMode::main(int argc, char **argv) {
     this->logger << "--------------------------------------------------------------------" << std::endl;
     this->logger << "Random And Maximal PACKing PACKage v" << CURRENT_VERSION << std::endl;
     this->logger << "(C) 2023 Piotr Kubala and Collaborators" << std::endl;
+    this->logger << "Instruction set of hot kernels: " << describe_kernel_instruction_set() << std::endl;
     this->logger << "--------------------------------------------------------------------" << std::endl;
 
     RampackParameters rampackParams = this->io.dispatchParams(inputFilename);
@@ -103,6 +107,12 @@ int CasinoMode::main(int argc, char **argv) {
     this->logger << "--------------------------------------------------------------------" << std::endl;
     this->logger << "Interaction centre range : " << shapeTraits->getInteraction().getRangeRadius() << std::endl;
     this->logger << "Total interaction range  : " << shapeTraits->getInteraction().getTotalRangeRadius() << std::endl;
+    const auto *centralInteraction = dynamic_cast<const CentralInteraction *>(&shapeTraits->getInteraction());
+    if (centralInteraction != nullptr && centralInteraction->getTabulationAccuracy().has_value()) {
+        const auto &accuracy = *centralInteraction->getTabulationAccuracy();
+        this->logger << "Tabulation max error     : " << accuracy.maxAbsoluteError << " at r = ";
+        this->logger << accuracy.maxErrorDistance << std::endl;
+    }
     this->logger << "--------------------------------------------------------------------" << std::endl;
 
 #ifdef _OPENMP
@@ -117,22 +127,37 @@ int CasinoMode::main(int argc, char **argv) {
     ValidateMsg(numDomains <= baseParams.scalingThreads,
                 "Number of domains (" + std::to_string(numDomains) + ") should not be larger than the number of "
                 "scaling threads (" + std::to_string(baseParams.scalingThreads) + ")");
+    ValidateMsg(baseParams.intraMoveThreads <= baseParams.scalingThreads,
+                "Number of intra-move threads (" + std::to_string(baseParams.intraMoveThreads) + ") should not be "
+                "larger than the number of scaling threads (" + std::to_string(baseParams.scalingThreads) + ")");
 
     // Info about threads
     this->logger << OMP_MAXTHREADS << " OpenMP threads are available" << std::endl;
     this->logger << "Using " << baseParams.scalingThreads << " threads for scaling moves" << std::endl;
-    if (numDomains == 1) {
+    if (baseParams.autoDomainDivisions) {
+        this->logger << "Using up to " << baseParams.scalingThreads << " domains for particle moves, tuned ";
+        this->logger << "automatically" << std::endl;
+        this->domainDivisionTuningEvery = DomainDivisionTuner::DEFAULT_TUNING_EVERY;
+    } else if (numDomains == 1) {
         this->logger << "Using 1 thread without domain decomposition for particle moves" << std::endl;
     } else {
         this->logger << "Using " << baseParams.domainDivisions[0] << " x " << baseParams.domainDivisions[1] << " x ";
         this->logger << baseParams.domainDivisions[2] << " = " << numDomains << " domains for particle moves";
         this->logger << std::endl;
     }
+    if (baseParams.intraMoveThreads > 1) {
+        this->logger << "Using " << baseParams.intraMoveThreads << " threads within a single particle move when ";
+        this->logger << "moves are not parallelized" << std::endl;
+    }
     this->logger << "--------------------------------------------------------------------" << std::endl;
 #else
-    if (baseParams.domainDivisions != std::array<std::size_t, 3>{1, 1, 1} || baseParams.scalingThreads != 1) {
+    if (baseParams.domainDivisions != std::array<std::size_t, 3>{1, 1, 1} || baseParams.autoDomainDivisions
+        || baseParams.scalingThreads != 1 || baseParams.intraMoveThreads != 1)
+    {
         baseParams.domainDivisions = {1, 1, 1};
+        baseParams.autoDomainDivisions = false;
         baseParams.scalingThreads = 1;
+        baseParams.intraMoveThreads = 1;
 
         this->logger.warn() << "OpenMP is disabled in the build - domain division and parallel scaling are ";
         this->logger << "unavailable." << std::endl;
@@ -164,6 +189,7 @@ int CasinoMode::main(int argc, char **argv) {
     std::size_t startRunIndex = packingLoader.getStartRunIndex();
     std::size_t cycleOffset = packingLoader.getCycleOffset();
     bool isContinuation = packingLoader.isContinuation();
+    std::optional<PackingLoader::AveragingState> averagingState = packingLoader.getAveragingState();
 
     auto env = this->recreateEnvironment(rampackParams, packingLoader);
 
@@ -181,7 +207,8 @@ int CasinoMode::main(int argc, char **argv) {
             this->verifyDynamicParameter(env.getTemperature(), "temperature", integrationRun, cycleOffset);
             if (env.isBoxScalingEnabled())
                 this->verifyDynamicParameter(env.getPressure(), "pressure", integrationRun, cycleOffset);
-            this->performIntegration(simulation, env, integrationRun, *shapeTraits, cycleOffset, isContinuation);
+            this->performIntegration(simulation, env, integrationRun, *shapeTraits, cycleOffset, isContinuation,
+                                     averagingState);
         } else if (std::holds_alternative<OverlapRelaxationRun>(run)) {
             const auto &overlapRelaxationRun = std::get<OverlapRelaxationRun>(run);
             this->performOverlapRelaxation(simulation, env, overlapRelaxationRun, shapeTraits, cycleOffset,
@@ -192,6 +219,7 @@ int CasinoMode::main(int argc, char **argv) {
 
         isContinuation = false;
         cycleOffset = 0;
+        averagingState = std::nullopt;
 
         if (simulation.wasInterrupted())
             break;
@@ -201,7 +229,8 @@ int CasinoMode::main(int argc, char **argv) {
 }
 
 void CasinoMode::performIntegration(Simulation &simulation, Simulation::Environment &env, const IntegrationRun &run,
-                                    const ShapeTraits &shapeTraits, std::size_t cycleOffset, bool isContinuation)
+                                    const ShapeTraits &shapeTraits, std::size_t cycleOffset, bool isContinuation,
+                                    const std::optional<PackingLoader::AveragingState> &averagingState)
 {
     this->logger.setAdditionalText(run.runName);
     this->logger.info() << std::endl;
@@ -215,10 +244,20 @@ void CasinoMode::performIntegration(Simulation &simulation, Simulation::Environm
     integrationParams.thermalisationCycles = run.thermalizationCycles.value_or(0);
     integrationParams.averagingCycles = run.averagingCycles.value_or(0);
     integrationParams.averagingEvery = run.averagingEvery;
+    integrationParams.bulkAveragingMaxEvery = run.bulkAveragingMaxEvery;
+    integrationParams.stepSizeTuning = run.stepSizeTuning;
+    integrationParams.moveScheduling = run.moveScheduling;
+    integrationParams.speculativeMoves = run.speculativeMoves;
+    integrationParams.asynchronousAnalysis = run.asynchronousAnalysis;
+    integrationParams.overlapCheckEvery = run.overlapCheckEvery;
+    integrationParams.overlapCheckFraction = run.overlapCheckFraction;
+    integrationParams.domainDivisionTuningEvery = this->domainDivisionTuningEvery;
     integrationParams.snapshotEvery = run.snapshotEvery;
     integrationParams.inlineInfoEvery = run.inlineInfoEvery;
     integrationParams.rotationMatrixFixEvery = run.orientationFixEvery;
     integrationParams.cycleOffset = cycleOffset;
+    if (averagingState.has_value())
+        integrationParams.averagingState = averagingState->state;
 
     simulation.integrate(env, integrationParams, shapeTraits, std::move(onTheFlyOutput.collector),
                          std::move(onTheFlyOutput.recorders), this->logger);
@@ -227,6 +266,7 @@ void CasinoMode::performIntegration(Simulation &simulation, Simulation::Environm
     this->logger.info() << "--------------------------------------------------------------------" << std::endl;
     if (integrationParams.averagingCycles != 0 && !simulation.wasInterrupted()) {
         this->printAverageValues(observablesCollector);
+        this->printSamplingEfficiency(observablesCollector);
     } else {
         this->logger.warn() << "Printing averages skipped due to incomplete averaging phase." << std::endl;
         this->logger.info() << "--------------------------------------------------------------------" << std::endl;
@@ -239,6 +279,21 @@ void CasinoMode::performIntegration(Simulation &simulation, Simulation::Environm
     for (const auto &writer : run.lastSnapshotWriters)
         jobs.emplace_back([&]() { writer.storeSnapshot(simulation, shapeTraits, this->logger); });
 
+    jobs.emplace_back([&]() {
+        // Only interrupted averaging is stored - it is resumed on continuation (see PackingLoader)
+        std::size_t averagingStart = cycleOffset + integrationParams.thermalisationCycles;
+        if (!run.ramsnapOut.has_value() || !simulation.wasInterrupted())
+            return;
+        if (simulation.getTotalCycles() <= averagingStart)
+            return;
+
+        std::size_t averagedCycles = simulation.getTotalCycles() - averagingStart;
+        if (averagingState.has_value())
+            averagedCycles += averagingState->averagedCycles;
+        this->io.storeAveragingState(PackingLoader::getAveragingStateFilename(*run.ramsnapOut), observablesCollector,
+                                     simulation.getTotalCycles(), averagedCycles);
+    });
+
     jobs.emplace_back([&]() {
         if (!run.averagesOut.has_value())
             return;
@@ -290,6 +345,10 @@ void CasinoMode::performOverlapRelaxation(Simulation &simulation, Simulation::En
 
     Simulation::OverlapRelaxationParameters relaxParams;
     relaxParams.snapshotEvery = run.snapshotEvery;
+    relaxParams.moveScheduling = run.moveScheduling;
+    relaxParams.speculativeMoves = run.speculativeMoves;
+    relaxParams.overlapCheckEvery = run.overlapCheckEvery;
+    relaxParams.domainDivisionTuningEvery = this->domainDivisionTuningEvery;
     relaxParams.inlineInfoEvery = run.inlineInfoEvery;
     relaxParams.rotationMatrixFixEvery = run.orientationFixEvery;
     relaxParams.cycleOffset = cycleOffset;
@@ -360,6 +419,7 @@ std::unique_ptr<Packing> CasinoMode::recreatePacking(PackingLoader &loader, cons
     }
 
     packing->toggleWalls(params.walls);
+    packing->setIntraMoveThreads(params.intraMoveThreads);
 
     return packing;
 }
@@ -408,7 +468,14 @@ void CasinoMode::printPerformanceInfo(const Simulation &simulation) {
     double scalingSeconds = simulation.getScalingMicroseconds() / 1e6;
     double domainDecompositionSeconds = simulation.getDomainDecompositionMicroseconds() / 1e6;
     double observablesSeconds = simulation.getObservablesMicroseconds() / 1e6;
-    double otherSeconds = totalSeconds - moveSeconds - scalingSeconds - observablesSeconds;
+    double analysisWaitingSeconds = simulation.getAnalysisWaitingMicroseconds() / 1e6;
+    double overlapCheckSeconds = simulation.getOverlapCheckWaitingMicroseconds() / 1e6;
+    // Asynchronous observables are computed in the background - only waiting for them is a part of the total time
+    double otherSeconds = totalSeconds - moveSeconds - scalingSeconds - overlapCheckSeconds;
+    if (simulation.isAnalysisAsynchronous())
+        otherSeconds -= analysisWaitingSeconds;
+    else
+        otherSeconds -= observablesSeconds;
     double cyclesPerSecond = static_cast<double>(simulation.getPerformedCycles()) / totalSeconds;
 
     double ngRebuildTotalPercent = ngRebuildSeconds / totalSeconds * 100;
@@ -418,13 +485,42 @@ void CasinoMode::printPerformanceInfo(const Simulation &simulation) {
     double movePercent = moveSeconds / totalSeconds * 100;
     double scalingPercent = scalingSeconds / totalSeconds * 100;
     double observablesPercent = observablesSeconds / totalSeconds * 100;
+    double analysisWaitingPercent = analysisWaitingSeconds / totalSeconds * 100;
+    double overlapCheckPercent = overlapCheckSeconds / totalSeconds * 100;
     double otherPercent = otherSeconds / totalSeconds * 100;
 
     this->printMoveStatistics(simulation);
     this->logger.info() << "--------------------------------------------------------------------" << std::endl;
+    this->logger << "Neighbour grid cells            : ";
+    if (simulatedPacking.isNeighbourGridUsed()) {
+        auto ngDivisions = simulatedPacking.getNeighbourGridCellDivisions();
+        auto ngImageLayers = simulatedPacking.getNeighbourGridImageLayers();
+        this->logger << ngDivisions[0] << " x " << ngDivisions[1] << " x " << ngDivisions[2];
+        if (std::any_of(ngImageLayers.begin(), ngImageLayers.end(), [](std::size_t layers) { return layers > 1; })) {
+            this->logger << " (periodic image layers: " << ngImageLayers[0] << " x " << ngImageLayers[1] << " x ";
+            this->logger << ngImageLayers[2] << ")";
+        }
+        std::size_t numSizeClassGrids = simulatedPacking.getNumSizeClassGrids();
+        if (numSizeClassGrids > 0)
+            this->logger << " (subdivided for " << numSizeClassGrids << " interaction centre size classes)";
+    } else {
+        this->logger << "none (all pairs checked)";
+    }
+    this->logger << std::endl;
     this->logger << "Neighbour grid resizes/rebuilds : " << ngResizes << "/" << ngRebuilds << std::endl;
+    const auto &domainDivisions = simulation.getDomainDivisions();
+    this->logger << "Domain divisions                : " << domainDivisions[0] << " x " << domainDivisions[1] << " x ";
+    this->logger << domainDivisions[2] << std::endl;
     this->logger << "Average neighbours per centre   : " << simulatedPacking.getAverageNumberOfNeighbours();
     this->logger << std::endl;
+    auto rejectionStatistics = simulatedPacking.getOverlapRejectionStatistics();
+    if (rejectionStatistics.rejectedMoves > 0) {
+        auto rejectedMoves = static_cast<double>(rejectionStatistics.rejectedMoves);
+        double pairChecksPerRejection = static_cast<double>(rejectionStatistics.pairChecks) / rejectedMoves;
+        double partnerHitPercent = static_cast<double>(rejectionStatistics.partnerHits) / rejectedMoves * 100;
+        this->logger << "Pair checks per overlap reject. : " << pairChecksPerRejection << " (last partner hits: ";
+        this->logger << partnerHitPercent << "%)" << std::endl;
+    }
     this->logger << "--------------------------------------------------------------------" << std::endl;
     this->logger << "Cycles per second   : " << cyclesPerSecond << std::endl;
     this->logger << "--------------------------------------------------------------------" << std::endl;
@@ -436,7 +532,17 @@ void CasinoMode::printPerformanceInfo(const Simulation &simulation) {
     this->logger << "NG rebuild time     : " << std::right << std::setw(11) << ngRebuildSeconds << " s (";
     this->logger << ngRebuildScalingPercent << "% scaling, " << ngRebuildTotalPercent << "% total)" << std::endl;
     this->logger << "Observables time    : " << std::right << std::setw(11) << observablesSeconds << " s (";
-    this->logger << observablesPercent << "% total)" << std::endl;
+    if (simulation.isAnalysisAsynchronous()) {
+        this->logger << "in background)" << std::endl;
+        this->logger << "Analysis wait time  : " << std::right << std::setw(11) << analysisWaitingSeconds << " s (";
+        this->logger << analysisWaitingPercent << "% total)" << std::endl;
+    } else {
+        this->logger << observablesPercent << "% total)" << std::endl;
+    }
+    if (overlapCheckSeconds > 0) {
+        this->logger << "Overlap check time  : " << std::right << std::setw(11) << overlapCheckSeconds << " s (";
+        this->logger << overlapCheckPercent << "% total)" << std::endl;
+    }
     this->logger << "Other time          : " << std::right << std::setw(11) << otherSeconds << " s (" << otherPercent << "% total)" << std::endl;
     this->logger << "--------------------------------------------------------------------" << std::endl;
 }
@@ -467,6 +573,28 @@ void CasinoMode::printAverageValues(const ObservablesCollector &collector) {
     this->logger << "--------------------------------------------------------------------" << std::endl;
 }
 
+void CasinoMode::printSamplingEfficiency(const ObservablesCollector &collector) {
+    auto samplingEfficiency = collector.getSamplingEfficiency();
+    if (samplingEfficiency.empty())
+        return;
+
+    auto lengthComparator = [](const auto &data1, const auto &data2) {
+        return data1.name.length() < data2.name.length();
+    };
+    std::size_t maxLength = std::max_element(samplingEfficiency.begin(), samplingEfficiency.end(),
+                                             lengthComparator)->name.length();
+
+    this->logger.info() << "Sampling efficiency (autocorrelation time in averaging snapshots):" << std::endl;
+    for (const auto &data : samplingEfficiency) {
+        this->logger << std::left << std::setw(maxLength) << data.name << " : ";
+        this->logger << "samples = " << data.numSamples << ", ";
+        this->logger << "tau = " << data.autocorrelationTime << ", ";
+        this->logger << "time = " << (data.computationMicroseconds / 1e6) << " s, ";
+        this->logger << "independent samples per second = " << data.effectiveSamplesPerSecond << std::endl;
+    }
+    this->logger << "--------------------------------------------------------------------" << std::endl;
+}
+
 void CasinoMode::overwriteMoveStepSizes(Simulation::Environment &env,
                                         const std::map<std::string, std::string> &packingAuxInfo) const
 {
@@ -521,6 +649,9 @@ void CasinoMode::OnTheFlyOutput::attachSnapshotOut(const std::string &filename)
     ValidateOpenedDesc(*out, filename, "to store observables");
     this->logger.info() << "Observable snapshots are stored on the fly to '" << filename << "'" << std::endl;
     this->collector->attachOnTheFlyOutput(std::move(out));
+
+    // Snapshots are already written on the fly and are never printed from memory, so older ones can be dropped
+    this->collector->limitToRecentSnapshots(IO::DEFAULT_IN_MEMORY_SNAPSHOTS);
 }
 
 void CasinoMode::printMoveStatistics(const Simulation &simulation) const {
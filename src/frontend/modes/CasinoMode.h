@@ -37,12 +37,15 @@ private:
                        Logger &logger);
     };
 
+    // If non-zero, domain divisions are tuned during thermalisation and overlap relaxation every that many cycles
+    std::size_t domainDivisionTuningEvery{};
 
     [[nodiscard]] Simulation::Environment recreateEnvironment(const RampackParameters &params, const PackingLoader &loader) const;
     void verifyDynamicParameter(const DynamicParameter &dynamicParameter, const std::string &parameterName,
                                 const IntegrationRun &run, std::size_t cycleOffset) const;
     void performIntegration(Simulation &simulation, Simulation::Environment &env, const IntegrationRun &run,
-                            const ShapeTraits &shapeTraits, std::size_t cycleOffset, bool isContinuation);
+                            const ShapeTraits &shapeTraits, std::size_t cycleOffset, bool isContinuation,
+                            const std::optional<PackingLoader::AveragingState> &averagingState);
     void performOverlapRelaxation(Simulation &simulation, Simulation::Environment &env, const OverlapRelaxationRun &run,
                                   std::shared_ptr<ShapeTraits> shapeTraits, std::size_t cycleOffset,
                                   bool isContinuation);
@@ -50,6 +53,7 @@ private:
                                 const std::map<std::string, std::string> &packingAuxInfo) const;
     void printPerformanceInfo(const Simulation &simulation);
     void printAverageValues(const ObservablesCollector &collector);
+    void printSamplingEfficiency(const ObservablesCollector &collector);
     void printMoveStatistics(const Simulation &simulation) const;
     static std::unique_ptr<Packing> recreatePacking(PackingLoader &loader, const BaseParameters &params,
                                                     const ShapeTraits &traits, std::size_t maxThreads);
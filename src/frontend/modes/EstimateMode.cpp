@@ -0,0 +1,426 @@
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+
+#include <cxxopts.hpp>
+
+#include "EstimateMode.h"
+#include "core/PeriodicBoundaryConditions.h"
+#include "core/DomainDivisionTuner.h"
+#include "core/shapes/CompoundShapeTraits.h"
+#include "utils/OMPMacros.h"
+
+
+int EstimateMode::main(int argc, char **argv) {
+    // Prepare and parse options
+    cxxopts::Options options(argv[0], "Dry run projecting the wall time and memory usage of the simulation.");
+
+    std::string inputFilename;
+    std::string verbosity;
+    std::size_t burstCycles{};
+
+    options
+        .set_width(120)
+        .add_options()
+            ("h,help", "prints help for this mode")
+            ("i,input", "a PYON file with parameters. See "
+                        "https://github.com/PKua007/rampack/blob/main/docs/input-file.md for the documentation of the "
+                        "input file",
+             cxxopts::value<std::string>(inputFilename))
+            ("V,verbosity", "how verbose the output should be. Allowed values, with increasing verbosity: "
+                            "`fatal`, `error`, `warn`, `info`, `verbose`, `debug`. Defaults to: `info`",
+             cxxopts::value<std::string>(verbosity))
+            ("c,cycles", "the number of cycles performed for each phase of each run (and for each benchmarked number "
+                         "of threads and domain division) to measure the performance",
+             cxxopts::value<std::size_t>(burstCycles)->default_value("100"));
+
+    auto parsedOptions = ModeBase::parseOptions(options, argc, argv);
+    if (parsedOptions.count("help")) {
+        std::ostream &rawOut = this->logger;
+        rawOut << options.help() << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    std::optional<std::string> verbosityOptional;
+    if (parsedOptions.count("verbosity"))
+        verbosityOptional = verbosity;
+    this->setVerbosityLevel(verbosityOptional, std::nullopt, std::nullopt);
+
+    // Validate parsed options
+    std::string cmd(argv[0]);
+    if (!parsedOptions.unmatched().empty())
+        throw ValidationException("Unexpected positional arguments. See " + cmd + " --help");
+    if (!parsedOptions.count("input"))
+        throw ValidationException("Input file must be specified with option -i [input file name]");
+    if (burstCycles == 0)
+        throw ValidationException("Number of cycles (-c, --cycles) must be positive");
+
+    RampackParameters rampackParams = this->io.dispatchParams(inputFilename);
+    auto &baseParams = rampackParams.baseParameters;
+    const auto &shapeTraits = baseParams.shapeTraits;
+
+#ifdef _OPENMP
+    std::size_t numDomains = std::accumulate(baseParams.domainDivisions.begin(), baseParams.domainDivisions.end(), 1ul,
+                                             std::multiplies<>{});
+    ValidateMsg(numDomains <= baseParams.scalingThreads,
+                "Number of domains (" + std::to_string(numDomains) + ") should not be larger than the number of "
+                "scaling threads (" + std::to_string(baseParams.scalingThreads) + ")");
+    ValidateMsg(baseParams.intraMoveThreads <= baseParams.scalingThreads,
+                "Number of intra-move threads (" + std::to_string(baseParams.intraMoveThreads) + ") should not be "
+                "larger than the number of scaling threads (" + std::to_string(baseParams.scalingThreads) + ")");
+    if (baseParams.autoDomainDivisions)
+        this->domainDivisionTuningEvery = DomainDivisionTuner::DEFAULT_TUNING_EVERY;
+#else
+    baseParams.domainDivisions = {1, 1, 1};
+    baseParams.autoDomainDivisions = false;
+    baseParams.scalingThreads = 1;
+    baseParams.intraMoveThreads = 1;
+#endif
+
+    // Same number of scaling and domain threads - see CasinoMode
+    auto pbc = std::make_unique<PeriodicBoundaryConditions>();
+    auto packing = baseParams.packingFactory->createPacking(std::move(pbc), *shapeTraits, baseParams.scalingThreads,
+                                                            baseParams.scalingThreads);
+    packing->toggleWalls(baseParams.walls);
+    packing->setIntraMoveThreads(baseParams.intraMoveThreads);
+
+    Simulation simulation(std::move(packing), baseParams.seed, baseParams.domainDivisions);
+    auto env = baseParams.baseEnvironment;
+    double totalSeconds{};
+    std::optional<Simulation::Environment> lastIntegrationEnv;
+
+    for (const auto &run : rampackParams.runs) {
+        combine_environment(env, run);
+        ValidateMsg(env.isComplete(), "Some of parameters: pressure, temperature, moveTypes, scalingType are missing");
+
+        if (std::holds_alternative<IntegrationRun>(run)) {
+            const auto &integrationRun = std::get<IntegrationRun>(run);
+            totalSeconds += this->estimateIntegration(simulation, env, integrationRun, *shapeTraits, burstCycles);
+            lastIntegrationEnv = env;
+        } else if (std::holds_alternative<OverlapRelaxationRun>(run)) {
+            const auto &overlapRelaxationRun = std::get<OverlapRelaxationRun>(run);
+            totalSeconds += this->performOverlapRelaxation(simulation, env, overlapRelaxationRun, shapeTraits);
+        } else {
+            AssertThrow("Unimplemented run type");
+        }
+    }
+
+    this->logger.info() << "--------------------------------------------------------------------" << std::endl;
+    this->logger << "Projected total wall time : " << EstimateMode::formatDuration(totalSeconds) << std::endl;
+    this->logger << "--------------------------------------------------------------------" << std::endl;
+
+    if (lastIntegrationEnv.has_value())
+        this->recommendParallelization(simulation.getPacking(), *lastIntegrationEnv, baseParams, burstCycles);
+
+    return EXIT_SUCCESS;
+}
+
+double EstimateMode::estimateIntegration(Simulation &simulation, const Simulation::Environment &env,
+                                         const IntegrationRun &run, const ShapeTraits &shapeTraits,
+                                         std::size_t burstCycles)
+{
+    this->logger.setAdditionalText(run.runName);
+    this->logger.info() << "--------------------------------------------------------------------" << std::endl;
+    this->logger << "Estimating integration '" << run.runName << "'" << std::endl;
+    this->logger << "--------------------------------------------------------------------" << std::endl;
+
+    // On-the-fly outputs are not attached, so nothing is stored
+    Simulation::IntegrationParameters params;
+    params.stepSizeTuning = run.stepSizeTuning;
+    params.moveScheduling = run.moveScheduling;
+    params.speculativeMoves = run.speculativeMoves;
+    params.asynchronousAnalysis = run.asynchronousAnalysis;
+    params.overlapCheckEvery = run.overlapCheckEvery;
+    params.overlapCheckFraction = run.overlapCheckFraction;
+    params.rotationMatrixFixEvery = run.orientationFixEvery;
+    params.domainDivisionTuningEvery = this->domainDivisionTuningEvery;
+
+    std::size_t thermalisationCycles = run.thermalizationCycles.value_or(0);
+    std::size_t averagingCycles = run.averagingCycles.value_or(0);
+    double seconds{};
+
+    // Snapshots are taken more often in bursts, so that at least one is measured. The cost of observables is then
+    // projected per snapshot (averaging sample, inline info) using the real frequencies
+    if (thermalisationCycles > 0) {
+        Simulation::IntegrationParameters burstParams = params;
+        burstParams.thermalisationCycles = std::min(burstCycles, thermalisationCycles);
+        burstParams.snapshotEvery = std::min(run.snapshotEvery, burstParams.thermalisationCycles);
+        burstParams.inlineInfoEvery = burstParams.thermalisationCycles;
+        simulation.integrate(env, burstParams, shapeTraits, run.observablesCollector, {}, this->logger);
+        auto burst = EstimateMode::countPhase(0, burstParams.thermalisationCycles, burstParams.snapshotEvery, 0,
+                                              burstParams.inlineInfoEvery);
+        auto phase = EstimateMode::countPhase(0, thermalisationCycles, run.snapshotEvery, 0, run.inlineInfoEvery);
+        seconds += this->printPhaseEstimate(simulation, "Thermalisation", burst, phase);
+        this->printPhaseMemoryUsage(simulation, run, "Thermalisation", phase.snapshots, 0);
+    }
+
+    if (averagingCycles > 0) {
+        // Averaging is measured for at least one averaging period
+        Simulation::IntegrationParameters burstParams = params;
+        burstParams.averagingEvery = run.averagingEvery;
+        burstParams.bulkAveragingMaxEvery = run.bulkAveragingMaxEvery;
+        burstParams.averagingCycles = std::min(std::max(burstCycles, run.averagingEvery), averagingCycles);
+        burstParams.snapshotEvery = std::min(run.snapshotEvery, burstParams.averagingCycles);
+        burstParams.inlineInfoEvery = burstParams.averagingCycles;
+        // Dynamic parameters should have values from the averaging phase
+        burstParams.cycleOffset = thermalisationCycles;
+        simulation.integrate(env, burstParams, shapeTraits, run.observablesCollector, {}, this->logger);
+        auto burst = EstimateMode::countPhase(thermalisationCycles, burstParams.averagingCycles,
+                                              burstParams.snapshotEvery, burstParams.averagingEvery,
+                                              burstParams.inlineInfoEvery);
+        auto phase = EstimateMode::countPhase(thermalisationCycles, averagingCycles, run.snapshotEvery,
+                                              run.averagingEvery, run.inlineInfoEvery);
+        seconds += this->printPhaseEstimate(simulation, "Averaging", burst, phase);
+        // Snapshots from the thermalisation are still kept in memory
+        std::size_t numSnapshots = (thermalisationCycles + averagingCycles) / run.snapshotEvery;
+        this->printPhaseMemoryUsage(simulation, run, "Averaging", numSnapshots, phase.averagingSamples);
+    }
+
+    this->logger.setAdditionalText("");
+    return seconds;
+}
+
+double EstimateMode::performOverlapRelaxation(Simulation &simulation, const Simulation::Environment &env,
+                                              const OverlapRelaxationRun &run,
+                                              std::shared_ptr<ShapeTraits> shapeTraits)
+{
+    this->logger.setAdditionalText(run.runName);
+    this->logger.info() << "--------------------------------------------------------------------" << std::endl;
+    this->logger << "Performing overlap relaxation '" << run.runName << "'" << std::endl;
+    this->logger << "--------------------------------------------------------------------" << std::endl;
+
+    if (run.helperShapeTraits != nullptr)
+        shapeTraits = std::make_shared<CompoundShapeTraits>(shapeTraits, run.helperShapeTraits);
+
+    // The length of overlap relaxation is not known in advance, so it is performed fully
+    Simulation::OverlapRelaxationParameters params;
+    params.snapshotEvery = run.snapshotEvery;
+    params.moveScheduling = run.moveScheduling;
+    params.speculativeMoves = run.speculativeMoves;
+    params.overlapCheckEvery = run.overlapCheckEvery;
+    params.inlineInfoEvery = run.inlineInfoEvery;
+    params.rotationMatrixFixEvery = run.orientationFixEvery;
+    params.domainDivisionTuningEvery = this->domainDivisionTuningEvery;
+    simulation.relaxOverlaps(env, params, *shapeTraits, run.observablesCollector, {}, this->logger);
+
+    double seconds = simulation.getTotalMicroseconds() / 1e6;
+    this->logger.info() << "Overlap relaxation : " << simulation.getPerformedCycles() << " cycles performed in ";
+    this->logger << EstimateMode::formatDuration(seconds) << std::endl;
+    this->logger.setAdditionalText("");
+    return seconds;
+}
+
+double EstimateMode::printPhaseEstimate(const Simulation &simulation, const std::string &phaseName,
+                                        const PhaseCounts &burst, const PhaseCounts &phase)
+{
+    const auto &packing = simulation.getPacking();
+    const auto &collector = simulation.getObservablesCollector();
+    bool isAsynchronous = simulation.isAnalysisAsynchronous();
+
+    // Monte Carlo cycles are projected from the burst without the time spent on observables
+    double burstSeconds = simulation.getTotalMicroseconds() / 1e6;
+    double burstObservablesSeconds = isAsynchronous ? simulation.getAnalysisWaitingMicroseconds() / 1e6
+                                                    : simulation.getObservablesMicroseconds() / 1e6;
+    double cycleScale = static_cast<double>(phase.cycles) / static_cast<double>(simulation.getPerformedCycles());
+    double mcSeconds = std::max(0., burstSeconds - burstObservablesSeconds) * cycleScale;
+    double moveSeconds = simulation.getMoveMicroseconds() / 1e6 * cycleScale;
+    double scalingSeconds = simulation.getScalingMicroseconds() / 1e6 * cycleScale;
+    // NG rebuilds are a part of scaling moves
+    double ngRebuildSeconds = packing.getNeighbourGridRebuildMicroseconds() / 1e6 * cycleScale;
+
+    // Observables are projected from the cost of a single snapshot, averaging sample and inline info. In the
+    // asynchronous mode, inline info is generated by each analysis
+    auto project = [](double burstMicroseconds, std::size_t burstCount, std::size_t phaseCount) {
+        if (burstCount == 0)
+            return 0.;
+        return burstMicroseconds / 1e6 / static_cast<double>(burstCount) * static_cast<double>(phaseCount);
+    };
+    double analysisSeconds = project(collector.getSnapshotMicroseconds(), burst.snapshots, phase.snapshots)
+        + project(collector.getAveragingValuesMicroseconds(), burst.averagingSamples, phase.averagingSamples);
+    if (isAsynchronous)
+        analysisSeconds += project(collector.getInlineMicroseconds(), burst.analyses, phase.analyses);
+    else
+        analysisSeconds += project(collector.getInlineMicroseconds(), burst.inlineInfos, phase.inlineInfos);
+    // The asynchronous analysis runs in parallel with the cycles, so the simulation waits only for its excess
+    double observablesSeconds = isAsynchronous ? std::max(0., analysisSeconds - mcSeconds) : analysisSeconds;
+
+    double projectedSeconds = mcSeconds + observablesSeconds;
+    double otherSeconds = mcSeconds - moveSeconds - scalingSeconds;
+    double cyclesPerSecond = static_cast<double>(phase.cycles) / projectedSeconds;
+
+    auto percent = [projectedSeconds](double seconds) { return seconds / projectedSeconds * 100; };
+
+    this->logger.info() << "--------------------------------------------------------------------" << std::endl;
+    this->logger << phaseName << " : " << phase.cycles << " cycles, " << cyclesPerSecond << " cycles/s, projected ";
+    this->logger << "time: " << EstimateMode::formatDuration(projectedSeconds) << std::endl;
+    this->logger << "Moves " << percent(moveSeconds) << "%, scaling " << percent(scalingSeconds) << "% (NG rebuilds ";
+    this->logger << percent(ngRebuildSeconds) << "%), observables " << percent(observablesSeconds) << "% (";
+    this->logger << phase.snapshots << " snapshots, " << phase.averagingSamples << " averaging samples), other ";
+    this->logger << percent(otherSeconds) << "%" << std::endl;
+
+    return projectedSeconds;
+}
+
+void EstimateMode::printPhaseMemoryUsage(const Simulation &simulation, const IntegrationRun &run,
+                                         const std::string &phaseName, std::size_t numSnapshots,
+                                         std::size_t numAveragingSamples)
+{
+    const auto &packing = simulation.getPacking();
+    const auto &collector = simulation.getObservablesCollector();
+
+    // Snapshots and the averaging state grow with the number of cycles, so they are projected from the burst to the
+    // end of the phase. If snapshots are stored on the fly, CasinoMode keeps only a limited number of them in memory
+    if (run.observablesOut.has_value())
+        numSnapshots = std::min(numSnapshots, IO::DEFAULT_IN_MEMORY_SNAPSHOTS);
+    std::size_t burstSnapshots = collector.getNumSnapshots();
+    double bytesPerSnapshot = (burstSnapshots == 0) ? 0
+        : static_cast<double>(collector.getSnapshotMemoryUsage()) / static_cast<double>(burstSnapshots);
+
+    double shapesMB = static_cast<double>(packing.getShapesMemoryUsage()) / 1e6;
+    double ngMB = static_cast<double>(packing.getNeighbourGridMemoryUsage()) / 1e6;
+    double snapshotsMB = bytesPerSnapshot * static_cast<double>(numSnapshots) / 1e6;
+    double averagingMB = static_cast<double>(collector.estimateAveragingMemoryUsage(numAveragingSamples)) / 1e6;
+    double totalMB = shapesMB + ngMB + snapshotsMB + averagingMB;
+
+    this->logger.info() << phaseName << " peak memory : " << totalMB << " MB (shapes " << shapesMB << " MB, ";
+    this->logger << "neighbour grid " << ngMB << " MB, " << numSnapshots << " observable snapshots " << snapshotsMB;
+    this->logger << " MB, averaging " << averagingMB << " MB)" << std::endl;
+}
+
+void EstimateMode::recommendParallelization(const Packing &packing, const Simulation::Environment &env,
+                                            const BaseParameters &baseParams, std::size_t benchmarkCycles)
+{
+    const auto &interaction = baseParams.shapeTraits->getInteraction();
+    std::size_t maxThreads = OMP_MAXTHREADS;
+
+    // The number of threads is halved down to 1, so that the parallel efficiency can be assessed
+    std::vector<std::size_t> threadCounts;
+    for (std::size_t numThreads = maxThreads; numThreads > 0; numThreads /= 2)
+        threadCounts.push_back(numThreads);
+    std::reverse(threadCounts.begin(), threadCounts.end());
+
+    this->logger.info() << "Benchmarking parallelization for the final packing using up to " << maxThreads;
+    this->logger << " threads" << std::endl;
+
+    struct ParallelizationResult {
+        std::size_t numThreads{};
+        DomainDivisionTuner::Divisions divisions{};
+        double cyclesPerSecond{};
+    };
+
+    std::vector<ParallelizationResult> bestResults;
+    for (auto numThreads : threadCounts) {
+        auto candidates = DomainDivisionTuner::generateCandidates(packing, interaction, {1, 1, 1}, numThreads,
+                                                                  EstimateMode::MAX_DOMAIN_DIVISION_CANDIDATES);
+        ParallelizationResult bestResult{numThreads, {1, 1, 1}, 0};
+        for (const auto &divisions : candidates) {
+            double cyclesPerSecond = this->benchmarkParallelization(packing, env, baseParams, numThreads, divisions,
+                                                                    benchmarkCycles);
+            this->logger << "box_move_threads = " << numThreads << ", domain_divisions = [" << divisions[0] << ", ";
+            this->logger << divisions[1] << ", " << divisions[2] << "] : " << cyclesPerSecond << " cycles/s";
+            this->logger << std::endl;
+            if (cyclesPerSecond > bestResult.cyclesPerSecond)
+                bestResult = {numThreads, divisions, cyclesPerSecond};
+        }
+        bestResults.push_back(bestResult);
+    }
+
+    Assert(!bestResults.empty());
+    double serialCyclesPerSecond = bestResults.front().cyclesPerSecond;
+    auto fastest = std::max_element(bestResults.begin(), bestResults.end(), [](const auto &r1, const auto &r2) {
+        return r1.cyclesPerSecond < r2.cyclesPerSecond;
+    });
+    double bestCyclesPerSecond = fastest->cyclesPerSecond;
+    // The fewest threads, which are almost as fast as the fastest setting, so that no threads are wasted
+    auto recommended = std::find_if(bestResults.begin(), bestResults.end(), [bestCyclesPerSecond](const auto &result) {
+        return result.cyclesPerSecond >= EstimateMode::RECOMMENDED_SPEED_FRACTION * bestCyclesPerSecond;
+    });
+    Assert(recommended != bestResults.end());
+
+    this->logger << "--------------------------------------------------------------------" << std::endl;
+    this->logger << "Fastest settings for each number of threads:" << std::endl;
+    for (const auto &result : bestResults) {
+        double speedup = result.cyclesPerSecond / serialCyclesPerSecond;
+        this->logger << "  " << result.numThreads << " threads : domain_divisions = [" << result.divisions[0] << ", ";
+        this->logger << result.divisions[1] << ", " << result.divisions[2] << "], speedup " << speedup << ", ";
+        this->logger << "parallel efficiency " << (speedup / static_cast<double>(result.numThreads) * 100) << "%";
+        this->logger << std::endl;
+    }
+    this->logger << "--------------------------------------------------------------------" << std::endl;
+    this->logger << "Recommended settings : box_move_threads = " << recommended->numThreads << ", domain_divisions = [";
+    this->logger << recommended->divisions[0] << ", " << recommended->divisions[1] << ", ";
+    this->logger << recommended->divisions[2] << "]" << std::endl;
+    this->logger << "(the fewest threads reaching " << (EstimateMode::RECOMMENDED_SPEED_FRACTION * 100) << "% of the ";
+    this->logger << "best speed)" << std::endl;
+    this->logger << "--------------------------------------------------------------------" << std::endl;
+}
+
+double EstimateMode::benchmarkParallelization(const Packing &packing, const Simulation::Environment &env,
+                                              const BaseParameters &baseParams, std::size_t numThreads,
+                                              const DomainDivisionTuner::Divisions &divisions,
+                                              std::size_t benchmarkCycles)
+{
+    const auto &shapeTraits = *baseParams.shapeTraits;
+
+    // Simulations of the candidates are not logged - they would obscure the results
+    std::ostringstream discardedLog;
+    Logger candidateLogger(discardedLog);
+
+    // Same number of scaling and domain threads - see CasinoMode
+    std::vector<Shape> shapes(packing.begin(), packing.end());
+    auto candidatePacking = std::make_unique<Packing>(packing.getBox(), std::move(shapes),
+                                                      std::make_unique<PeriodicBoundaryConditions>(),
+                                                      shapeTraits.getInteraction(), numThreads, numThreads);
+    candidatePacking->toggleWalls(baseParams.walls);
+    candidatePacking->setIntraMoveThreads(std::min(baseParams.intraMoveThreads, numThreads));
+    Simulation candidateSimulation(std::move(candidatePacking), baseParams.seed, divisions);
+
+    // Averaging phase is used, so that step sizes are not changed between the candidates
+    Simulation::IntegrationParameters params;
+    params.averagingCycles = benchmarkCycles;
+    params.averagingEvery = benchmarkCycles;
+    params.snapshotEvery = benchmarkCycles;
+    params.inlineInfoEvery = benchmarkCycles;
+    candidateSimulation.integrate(env, params, shapeTraits, std::make_shared<ObservablesCollector>(), {},
+                                  candidateLogger);
+
+    return static_cast<double>(candidateSimulation.getPerformedCycles())
+           / (candidateSimulation.getTotalMicroseconds() / 1e6);
+}
+
+EstimateMode::PhaseCounts EstimateMode::countPhase(std::size_t cycleOffset, std::size_t cycles,
+                                                   std::size_t snapshotEvery, std::size_t averagingEvery,
+                                                   std::size_t inlineInfoEvery)
+{
+    // The same as in Simulation::integrate - an action is performed on cycles divisible by its period. 0 means never
+    auto countMultiples = [cycleOffset, cycles](std::size_t every) -> std::size_t {
+        if (every == 0)
+            return 0;
+        return (cycleOffset + cycles) / every - cycleOffset / every;
+    };
+
+    PhaseCounts counts;
+    counts.cycles = cycles;
+    counts.snapshots = countMultiples(snapshotEvery);
+    counts.averagingSamples = countMultiples(averagingEvery);
+    std::size_t commonEvery = (averagingEvery == 0) ? 0 : std::lcm(snapshotEvery, averagingEvery);
+    counts.analyses = counts.snapshots + counts.averagingSamples - countMultiples(commonEvery);
+    counts.inlineInfos = countMultiples(inlineInfoEvery);
+    return counts;
+}
+
+std::string EstimateMode::formatDuration(double seconds) {
+    auto totalSeconds = static_cast<std::size_t>(std::round(seconds));
+    std::size_t days = totalSeconds / 86400;
+    std::size_t hours = (totalSeconds % 86400) / 3600;
+    std::size_t minutes = (totalSeconds % 3600) / 60;
+
+    std::ostringstream out;
+    if (days > 0)
+        out << days << "d ";
+    out << std::setfill('0') << std::setw(2) << hours << ":" << std::setw(2) << minutes << ":";
+    out << std::setw(2) << (totalSeconds % 60);
+    return out.str();
+}
@@ -0,0 +1,54 @@
+#ifndef RAMPACK_ESTIMATEMODE_H
+#define RAMPACK_ESTIMATEMODE_H
+
+#include <memory>
+
+#include "frontend/ModeBase.h"
+#include "frontend/RampackParameters.h"
+#include "core/DomainDivisionTuner.h"
+
+
+class EstimateMode : public ModeBase {
+private:
+    static constexpr std::size_t MAX_DOMAIN_DIVISION_CANDIDATES = 4;
+    // The fewest threads reaching this fraction of the best speed are recommended
+    static constexpr double RECOMMENDED_SPEED_FRACTION = 0.9;
+
+    // How many times each kind of work is performed in a phase (or in its burst)
+    struct PhaseCounts {
+        std::size_t cycles{};
+        std::size_t snapshots{};
+        std::size_t averagingSamples{};
+        // Cycles, on which snapshots, averaging samples or both are taken
+        std::size_t analyses{};
+        std::size_t inlineInfos{};
+    };
+
+    // If non-zero, domain divisions are tuned as in CasinoMode
+    std::size_t domainDivisionTuningEvery{};
+
+    double estimateIntegration(Simulation &simulation, const Simulation::Environment &env, const IntegrationRun &run,
+                               const ShapeTraits &shapeTraits, std::size_t burstCycles);
+    double performOverlapRelaxation(Simulation &simulation, const Simulation::Environment &env,
+                                    const OverlapRelaxationRun &run, std::shared_ptr<ShapeTraits> shapeTraits);
+    double printPhaseEstimate(const Simulation &simulation, const std::string &phaseName, const PhaseCounts &burst,
+                              const PhaseCounts &phase);
+    void printPhaseMemoryUsage(const Simulation &simulation, const IntegrationRun &run, const std::string &phaseName,
+                               std::size_t numSnapshots, std::size_t numAveragingSamples);
+    void recommendParallelization(const Packing &packing, const Simulation::Environment &env,
+                                  const BaseParameters &baseParams, std::size_t benchmarkCycles);
+    double benchmarkParallelization(const Packing &packing, const Simulation::Environment &env,
+                                    const BaseParameters &baseParams, std::size_t numThreads,
+                                    const DomainDivisionTuner::Divisions &divisions, std::size_t benchmarkCycles);
+    static PhaseCounts countPhase(std::size_t cycleOffset, std::size_t cycles, std::size_t snapshotEvery,
+                                  std::size_t averagingEvery, std::size_t inlineInfoEvery);
+    static std::string formatDuration(double seconds);
+
+public:
+    explicit EstimateMode(Logger &logger) : ModeBase(logger) { }
+
+    int main(int argc, char **argv);
+};
+
+
+#endif //RAMPACK_ESTIMATEMODE_H
@@ -25,6 +25,9 @@ int HelpMode::main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) {
     rawOut << "trajectory" << std::endl;
     rawOut << Fold("Replays recorded simulation trajectory and performs some operations on it.")
               .width(80).margin(4) << std::endl;
+    rawOut << "estimate" << std::endl;
+    rawOut << Fold("Dry run projecting the wall time and memory usage of the simulation and recommending "
+                   "parallelization settings.").width(80).margin(4) << std::endl;
     rawOut << "-v, --version, version" << std::endl;
     rawOut << Fold("Shows current version.").width(80).margin(4) << std::endl;
     rawOut << "-h, --help, help" << std::endl;
@@ -8,6 +8,7 @@
 
 #include "ShapePreviewMode.h"
 #include "core/ShapeTraits.h"
+#include "core/interactions/CentralInteraction.h"
 #include "frontend/RampackParameters.h"
 #include "utils/Utils.h"
 #include "frontend/matchers/ShapeMatcher.h"
@@ -129,6 +130,12 @@ void ShapePreviewMode::printInteractionInfo(const Interaction &interaction) {
     this->logger << "Has wall part            : " << displayBool(interaction.hasWallPart()) << std::endl;
     this->logger << "Interaction center range : " << interaction.getRangeRadius() << std::endl;
     this->logger << "Total range              : " << interaction.getTotalRangeRadius() << std::endl;
+    const auto *centralInteraction = dynamic_cast<const CentralInteraction *>(&interaction);
+    if (centralInteraction != nullptr && centralInteraction->getTabulationAccuracy().has_value()) {
+        const auto &accuracy = *centralInteraction->getTabulationAccuracy();
+        this->logger << "Tabulation max error     : " << accuracy.maxAbsoluteError << " at r = ";
+        this->logger << accuracy.maxErrorDistance << std::endl;
+    }
     this->logger << "Interaction centers      :" << std::endl;
     auto interactionCentres = interaction.getInteractionCentres();
     if (interactionCentres.empty())
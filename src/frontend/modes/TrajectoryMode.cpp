@@ -252,6 +252,7 @@ int TrajectoryMode::main(int argc, char **argv) {
             auto observableData = ObservablesMatcher::matchObservable(observable, maxThreads);
             collector.addObservable(std::move(observableData.observable), observableData.scope);
         }
+        this->io.attachSnapshotSpillFile(collector);
 
         this->logger.info() << "Starting simulation replay for observables..." << std::endl;
 
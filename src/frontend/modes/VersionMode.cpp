@@ -4,12 +4,14 @@
 
 #include "VersionMode.h"
 #include "utils/Version.h"
+#include "utils/CpuDispatch.h"
 
 
 int VersionMode::main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) {
     std::ostream &rawOut = this->logger;
 
     rawOut << "RAMPACK v" << CURRENT_VERSION << std::endl;
+    rawOut << "Instruction set of hot kernels: " << describe_kernel_instruction_set() << std::endl;
 
     return 0;
 }
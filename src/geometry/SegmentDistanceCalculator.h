@@ -6,6 +6,7 @@
 #define RAMPACK_SEGMENTDISTANCECALCULATOR_H
 
 #include "geometry/Vector.h"
+#include "utils/CompilerMacros.h"
 
 class SegmentDistanceCalculator {
 private:
@@ -19,8 +20,8 @@ public:
     // SoftSurfer makes no warranty for this code, and cannot be held
     // liable for any real or imagined damage resulting from its use.
     // Users of this code must verify correctness for their application.
-    static double calculate(const Vector<3> &s11, const Vector<3> &s12, const Vector<3> &s21,
-                            const Vector<3> &s22)
+    RAMPACK_MULTIVERSIONED
+    static double calculate(const Vector<3> &s11, const Vector<3> &s12, const Vector<3> &s21, const Vector<3> &s22)
     {
         Vector<3> u = s12 - s11;
         Vector<3> v = s22 - s21;
@@ -29,6 +29,7 @@ not be misrepresented as being the original software.
 #include "geometry/Vector.h"
 #include "AbstractXCGeometry.h"
 #include "XCUtils.h"
+#include "utils/CompilerMacros.h"
 
 
 /**
@@ -69,8 +70,10 @@ public:
     /**
      * @brief Returns @a true, if two shapes, one with position @a pos1, orientation @a rot1 with geometry @a geom1 and
      * the second one with position @a pos2, orientation @a rot2 with geometry @a geom2 overlap.
-     * @details @a boundaryTolerance determines the numerical precision of reporting a missed overlap.
+     * @details @a boundaryTolerance determines the numerical precision of reporting a missed overlap. The function is
+     * multiversioned for different instruction sets (see RAMPACK_MULTIVERSIONED).
      */
+    RAMPACK_MULTIVERSIONED
     static bool Intersect(const XCGeometry &geom1, const Matrix<3, 3> &rot1, const Vector<3> &pos1,
                           const XCGeometry &geom2, const Matrix<3, 3> &rot2, const Vector<3> &pos2,
                           double boundaryTolerance)
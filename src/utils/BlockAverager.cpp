@@ -0,0 +1,136 @@
+#include <cmath>
+#include <istream>
+#include <ostream>
+#include <limits>
+
+#include "BlockAverager.h"
+#include "Utils.h"
+
+
+void BlockAverager::add(double value) {
+    this->addToLevel(0, value);
+}
+
+void BlockAverager::addToLevel(std::size_t levelIdx, double value) {
+    if (levelIdx == this->levels.size())
+        this->levels.emplace_back();
+
+    auto &level = this->levels[levelIdx];
+    level.numBlocks++;
+    double delta = value - level.mean;
+    level.mean += delta / static_cast<double>(level.numBlocks);
+    level.squareDeviationSum += delta * (value - level.mean);
+
+    if (level.pendingValue.has_value()) {
+        double blockValue = (*level.pendingValue + value) / 2;
+        level.pendingValue = std::nullopt;
+        // level reference may be invalidated by adding a new level, so it is not used below
+        this->addToLevel(levelIdx + 1, blockValue);
+    } else {
+        level.pendingValue = value;
+    }
+}
+
+double BlockAverager::getLevelError(std::size_t levelIdx) const {
+    const auto &level = this->levels[levelIdx];
+    if (level.numBlocks < 2)
+        return 0;
+
+    auto n = static_cast<double>(level.numBlocks);
+    return std::sqrt(level.squareDeviationSum / n / (n - 1));
+}
+
+Quantity BlockAverager::getQuantity() const {
+    if (this->levels.empty())
+        return Quantity{};
+
+    Quantity quantity;
+    quantity.value = this->levels.front().mean;
+    quantity.error = this->getLevelError(0);
+    return quantity;
+}
+
+Quantity BlockAverager::getBlockedQuantity() const {
+    std::vector<std::size_t> reliableLevels;
+    for (std::size_t levelIdx{}; levelIdx < this->levels.size(); levelIdx++)
+        if (this->levels[levelIdx].numBlocks >= MIN_BLOCKS_FOR_ERROR_ESTIMATION)
+            reliableLevels.push_back(levelIdx);
+
+    Quantity quantity = this->getQuantity();
+    if (reliableLevels.empty())
+        return quantity;
+
+    // Error of error estimation on a level with n blocks is error/sqrt(2(n - 1))
+    auto getErrorOfError = [this](std::size_t levelIdx, double error) {
+        return error / std::sqrt(2*(static_cast<double>(this->levels[levelIdx].numBlocks) - 1));
+    };
+
+    for (std::size_t i{}; i < reliableLevels.size(); i++) {
+        double error = this->getLevelError(reliableLevels[i]);
+        bool isPlateau = true;
+        for (std::size_t j = i + 1; j < reliableLevels.size(); j++) {
+            double nextError = this->getLevelError(reliableLevels[j]);
+            if (nextError - error > getErrorOfError(reliableLevels[j], nextError)) {
+                isPlateau = false;
+                break;
+            }
+        }
+
+        if (isPlateau) {
+            quantity.error = error;
+            break;
+        }
+    }
+
+    return quantity;
+}
+
+double BlockAverager::getIntegratedAutocorrelationTime() const {
+    double naiveError = this->getQuantity().error;
+    if (naiveError == 0)
+        return 0.5;
+
+    double blockedError = this->getBlockedQuantity().error;
+    return 0.5 * std::pow(blockedError / naiveError, 2);
+}
+
+std::size_t BlockAverager::getMemoryUsage() const {
+    return get_vector_memory_usage(this->levels);
+}
+
+std::size_t BlockAverager::estimateMemoryUsage(std::size_t numSamples) {
+    // Level k is created when 2^k samples are added
+    std::size_t numLevels{};
+    for (std::size_t samplesLeft = numSamples; samplesLeft > 0; samplesLeft /= 2)
+        numLevels++;
+    return numLevels * sizeof(Level);
+}
+
+void BlockAverager::store(std::ostream &out) const {
+    auto oldPrecision = out.precision(std::numeric_limits<double>::max_digits10);
+    out << this->levels.size() << std::endl;
+    for (const auto &level : this->levels) {
+        out << level.numBlocks << " " << level.mean << " " << level.squareDeviationSum << " ";
+        out << level.pendingValue.has_value() << " " << level.pendingValue.value_or(0) << std::endl;
+    }
+    out.precision(oldPrecision);
+}
+
+void BlockAverager::restore(std::istream &in) {
+    std::size_t numLevels{};
+    in >> numLevels;
+    ValidateMsg(in, "Broken block averager state: number of levels");
+
+    std::vector<Level> restoredLevels(numLevels);
+    for (std::size_t i{}; i < numLevels; i++) {
+        auto &level = restoredLevels[i];
+        bool hasPendingValue{};
+        double pendingValue{};
+        in >> level.numBlocks >> level.mean >> level.squareDeviationSum >> hasPendingValue >> pendingValue;
+        ValidateMsg(in, "Broken block averager state: level " + std::to_string(i));
+        if (hasPendingValue)
+            level.pendingValue = pendingValue;
+    }
+
+    this->levels = std::move(restoredLevels);
+}
@@ -0,0 +1,101 @@
+#ifndef RAMPACK_BLOCKAVERAGER_H
+#define RAMPACK_BLOCKAVERAGER_H
+
+#include <vector>
+#include <optional>
+#include <iosfwd>
+
+#include "Quantity.h"
+
+
+/**
+ * @brief Online estimator of the mean and its error, which does not store the samples.
+ * @details It performs Flyvbjerg-Petersen blocking on the fly: on level @a k, it accumulates the running mean and
+ * variance (Welford's algorithm) of averages of consecutive blocks of 2<sup>k</sup> samples. Thus, for @a n samples,
+ * only O(log @a n) state is kept. Level 0 gives the standard error of the mean of uncorrelated samples, while the
+ * blocking error estimate takes correlations between consecutive samples into account.
+ */
+class BlockAverager {
+private:
+    struct Level {
+        std::size_t numBlocks{};
+        double mean{};
+        double squareDeviationSum{};
+        std::optional<double> pendingValue;
+    };
+
+    std::vector<Level> levels;
+
+    void addToLevel(std::size_t levelIdx, double value);
+    [[nodiscard]] double getLevelError(std::size_t levelIdx) const;
+
+public:
+    /**
+     * @brief The minimal number of blocks on a level, for which its error estimate is taken into account in
+     * BlockAverager::getBlockedQuantity.
+     */
+    static constexpr std::size_t MIN_BLOCKS_FOR_ERROR_ESTIMATION = 16;
+
+    /**
+     * @brief Adds a next sample.
+     */
+    void add(double value);
+
+    /**
+     * @brief Returns the number of samples added so far.
+     */
+    [[nodiscard]] std::size_t getNumSamples() const { return this->levels.empty() ? 0 : this->levels.front().numBlocks; }
+
+    /**
+     * @brief Returns the mean of samples with the standard error of the mean, assuming the samples are uncorrelated.
+     * @details The result is the same (up to floating-point precision) as Quantity::calculateFromSamples for all
+     * samples.
+     */
+    [[nodiscard]] Quantity getQuantity() const;
+
+    /**
+     * @brief Returns the mean of samples with the error estimated using the blocking method.
+     * @details The error is taken from the first blocking level, from which (within the error of error estimation) it
+     * no longer grows, considering only levels with at least BlockAverager::MIN_BLOCKS_FOR_ERROR_ESTIMATION blocks. If
+     * there are no such levels, the error is the same as in BlockAverager::getQuantity.
+     */
+    [[nodiscard]] Quantity getBlockedQuantity() const;
+
+    /**
+     * @brief Returns an estimate of the integrated autocorrelation time of the samples, in units of the sampling
+     * interval.
+     * @details It is calculated as a half of the ratio of variances of the mean given by
+     * BlockAverager::getBlockedQuantity and BlockAverager::getQuantity, so it is 0.5 for uncorrelated samples.
+     */
+    [[nodiscard]] double getIntegratedAutocorrelationTime() const;
+
+    /**
+     * @brief Removes all samples.
+     */
+    void clear() { this->levels.clear(); }
+
+    /**
+     * @brief Returns the number of bytes used by the state.
+     */
+    [[nodiscard]] std::size_t getMemoryUsage() const;
+
+    /**
+     * @brief Returns the number of bytes, which will be used by the state after adding @a numSamples samples.
+     * @details The state grows logarithmically with the number of samples. Excess capacity of internal vectors, which
+     * is taken into account in BlockAverager::getMemoryUsage, is not included.
+     */
+    [[nodiscard]] static std::size_t estimateMemoryUsage(std::size_t numSamples);
+
+    /**
+     * @brief Stores the state of the averager to @a out stream in a textual form.
+     */
+    void store(std::ostream &out) const;
+
+    /**
+     * @brief Restores the state of the averager previously stored using BlockAverager::store from @a in stream.
+     */
+    void restore(std::istream &in);
+};
+
+
+#endif //RAMPACK_BLOCKAVERAGER_H
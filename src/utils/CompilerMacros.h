@@ -14,5 +14,25 @@
     #define RAMPACK_UNKNOWN_COMPILER
 #endif
 
+// Function multiversioning needs ifunc support (x86-64 ELF) and GCC or Clang 14+. If RAMPACK_CPU_DISPATCH is defined,
+// functions marked with RAMPACK_MULTIVERSIONED are compiled for a couple of instruction sets and the best one for the
+// CPU is chosen when the program is loaded. Virtual functions cannot be marked (they should delegate to marked ones)
+// and marked functions are never inlined, so only relatively heavy kernels should be marked
+#if defined(RAMPACK_CPU_DISPATCH) && defined(__x86_64__) && defined(__ELF__) \
+    && (defined(RAMPACK_GCC) || (defined(RAMPACK_CLANG) && RAMPACK_CLANG >= 140000))
+    #define RAMPACK_MULTIVERSIONING
+    #define RAMPACK_MULTIVERSIONED __attribute__((target_clones("avx512f", "avx2", "sse4.2", "default")))
+#else
+    #define RAMPACK_MULTIVERSIONED
+#endif
+
+// Functions marked with RAMPACK_BASELINE_TARGET are compiled for a generic x86-64 CPU, even if the rest of the program
+// uses -march=native, so they can safely check whether the CPU supports the instructions used elsewhere
+#if defined(__x86_64__) && (defined(RAMPACK_GCC) || defined(RAMPACK_CLANG))
+    #define RAMPACK_BASELINE_TARGET __attribute__((target("arch=x86-64")))
+#else
+    #define RAMPACK_BASELINE_TARGET
+#endif
+
 
 #endif //RAMPACK_COMPILERMACROS_H
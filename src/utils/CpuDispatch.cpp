@@ -0,0 +1,197 @@
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+
+#include "CpuDispatch.h"
+#include "CompilerMacros.h"
+#include "Exceptions.h"
+
+
+namespace {
+    // From the most advanced - in the same order as the clones are prioritized by RAMPACK_MULTIVERSIONED
+    constexpr std::array<InstructionSet, 4> INSTRUCTION_SETS = {
+        InstructionSet::AVX512, InstructionSet::AVX2, InstructionSet::SSE4_2, InstructionSet::BASELINE
+    };
+}
+
+std::string get_instruction_set_name(InstructionSet instructionSet) {
+    switch (instructionSet) {
+        case InstructionSet::BASELINE:
+            return "baseline";
+        case InstructionSet::SSE4_2:
+            return "SSE4.2";
+        case InstructionSet::AVX2:
+            return "AVX2";
+        case InstructionSet::AVX512:
+            return "AVX-512";
+        default:
+            AssertThrow("unreachable");
+    }
+}
+
+InstructionSet get_compiled_instruction_set() {
+#if defined(__AVX512F__)
+    return InstructionSet::AVX512;
+#elif defined(__AVX2__)
+    return InstructionSet::AVX2;
+#elif defined(__SSE4_2__)
+    return InstructionSet::SSE4_2;
+#else
+    return InstructionSet::BASELINE;
+#endif
+}
+
+bool is_instruction_set_supported(InstructionSet instructionSet) {
+#if defined(__x86_64__) && (defined(RAMPACK_GCC) || defined(RAMPACK_CLANG))
+    switch (instructionSet) {
+        case InstructionSet::BASELINE:
+            return true;
+        case InstructionSet::SSE4_2:
+            return __builtin_cpu_supports("sse4.2");
+        case InstructionSet::AVX2:
+            return __builtin_cpu_supports("avx2");
+        case InstructionSet::AVX512:
+            return __builtin_cpu_supports("avx512f");
+        default:
+            AssertThrow("unreachable");
+    }
+#else
+    return instructionSet == InstructionSet::BASELINE;
+#endif
+}
+
+// Records the first feature assumed by the compiler, which is not supported by the CPU (see
+// ensure_compiled_instruction_set_supported)
+#define RAMPACK_CHECK_CPU_FEATURE(feature, name)                        \
+    if (unsupportedName == nullptr && !__builtin_cpu_supports(feature)) \
+        unsupportedName = name
+
+void ensure_compiled_instruction_set_supported() {
+    const char *unsupportedName = nullptr;
+#if defined(__x86_64__) && (defined(RAMPACK_GCC) || defined(RAMPACK_CLANG))
+    // It may run before the constructor initializing the CPU model for __builtin_cpu_supports
+    __builtin_cpu_init();
+    // From the oldest - the first missing one is reported
+    #if defined(__SSE3__)
+        RAMPACK_CHECK_CPU_FEATURE("sse3", "SSE3");
+    #endif
+    #if defined(__SSSE3__)
+        RAMPACK_CHECK_CPU_FEATURE("ssse3", "SSSE3");
+    #endif
+    #if defined(__SSE4_1__)
+        RAMPACK_CHECK_CPU_FEATURE("sse4.1", "SSE4.1");
+    #endif
+    #if defined(__SSE4_2__)
+        RAMPACK_CHECK_CPU_FEATURE("sse4.2", "SSE4.2");
+    #endif
+    #if defined(__SSE4A__)
+        RAMPACK_CHECK_CPU_FEATURE("sse4a", "SSE4A");
+    #endif
+    #if defined(__POPCNT__)
+        RAMPACK_CHECK_CPU_FEATURE("popcnt", "POPCNT");
+    #endif
+    #if defined(__AES__)
+        RAMPACK_CHECK_CPU_FEATURE("aes", "AES");
+    #endif
+    #if defined(__PCLMUL__)
+        RAMPACK_CHECK_CPU_FEATURE("pclmul", "PCLMUL");
+    #endif
+    #if defined(__AVX__)
+        RAMPACK_CHECK_CPU_FEATURE("avx", "AVX");
+    #endif
+    #if defined(__AVX2__)
+        RAMPACK_CHECK_CPU_FEATURE("avx2", "AVX2");
+    #endif
+    #if defined(__FMA__)
+        RAMPACK_CHECK_CPU_FEATURE("fma", "FMA");
+    #endif
+    #if defined(__FMA4__)
+        RAMPACK_CHECK_CPU_FEATURE("fma4", "FMA4");
+    #endif
+    #if defined(__XOP__)
+        RAMPACK_CHECK_CPU_FEATURE("xop", "XOP");
+    #endif
+    #if defined(__BMI__)
+        RAMPACK_CHECK_CPU_FEATURE("bmi", "BMI");
+    #endif
+    #if defined(__BMI2__)
+        RAMPACK_CHECK_CPU_FEATURE("bmi2", "BMI2");
+    #endif
+    #if defined(__AVX512F__)
+        RAMPACK_CHECK_CPU_FEATURE("avx512f", "AVX-512F");
+    #endif
+    #if defined(__AVX512CD__)
+        RAMPACK_CHECK_CPU_FEATURE("avx512cd", "AVX-512CD");
+    #endif
+    #if defined(__AVX512VL__)
+        RAMPACK_CHECK_CPU_FEATURE("avx512vl", "AVX-512VL");
+    #endif
+    #if defined(__AVX512BW__)
+        RAMPACK_CHECK_CPU_FEATURE("avx512bw", "AVX-512BW");
+    #endif
+    #if defined(__AVX512DQ__)
+        RAMPACK_CHECK_CPU_FEATURE("avx512dq", "AVX-512DQ");
+    #endif
+    #if defined(__AVX512IFMA__)
+        RAMPACK_CHECK_CPU_FEATURE("avx512ifma", "AVX-512IFMA");
+    #endif
+    #if defined(__AVX512VBMI__)
+        RAMPACK_CHECK_CPU_FEATURE("avx512vbmi", "AVX-512VBMI");
+    #endif
+    #if defined(__AVX512VBMI2__)
+        RAMPACK_CHECK_CPU_FEATURE("avx512vbmi2", "AVX-512VBMI2");
+    #endif
+    #if defined(__AVX512VNNI__)
+        RAMPACK_CHECK_CPU_FEATURE("avx512vnni", "AVX-512VNNI");
+    #endif
+    #if defined(__AVX512BITALG__)
+        RAMPACK_CHECK_CPU_FEATURE("avx512bitalg", "AVX-512BITALG");
+    #endif
+    #if defined(__AVX512VPOPCNTDQ__)
+        RAMPACK_CHECK_CPU_FEATURE("avx512vpopcntdq", "AVX-512VPOPCNTDQ");
+    #endif
+    #if defined(__GFNI__)
+        RAMPACK_CHECK_CPU_FEATURE("gfni", "GFNI");
+    #endif
+    #if defined(__VPCLMULQDQ__)
+        RAMPACK_CHECK_CPU_FEATURE("vpclmulqdq", "VPCLMULQDQ");
+    #endif
+#endif
+
+    if (unsupportedName == nullptr)
+        return;
+
+    std::fputs("The program was compiled for ", stderr);
+    std::fputs(unsupportedName, stderr);
+    std::fputs(", which is not supported by this CPU. Rebuild it with -DRAMPACK_ARCH_NATIVE=OFF or "
+               "-DRAMPACK_CPU_DISPATCH=ON.\n", stderr);
+    std::_Exit(EXIT_FAILURE);
+}
+
+#undef RAMPACK_CHECK_CPU_FEATURE
+
+bool is_cpu_dispatch_enabled() {
+#ifdef RAMPACK_MULTIVERSIONING
+    return true;
+#else
+    return false;
+#endif
+}
+
+InstructionSet get_kernel_instruction_set() {
+    if (!is_cpu_dispatch_enabled())
+        return get_compiled_instruction_set();
+
+    for (auto instructionSet : INSTRUCTION_SETS)
+        if (is_instruction_set_supported(instructionSet))
+            return instructionSet;
+    AssertThrow("unreachable");
+}
+
+std::string describe_kernel_instruction_set() {
+    std::string name = get_instruction_set_name(get_kernel_instruction_set());
+    if (is_cpu_dispatch_enabled())
+        return name + " (selected at runtime)";
+    else
+        return name + " (fixed at compile time)";
+}
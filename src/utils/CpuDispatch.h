@@ -0,0 +1,68 @@
+#ifndef RAMPACK_CPUDISPATCH_H
+#define RAMPACK_CPUDISPATCH_H
+
+#include <string>
+
+#include "CompilerMacros.h"
+
+
+/**
+ * @brief x86 instruction sets, for which kernels marked with RAMPACK_MULTIVERSIONED are compiled (see
+ * CompilerMacros.h). InstructionSet::BASELINE denotes the lowest common denominator of the architecture.
+ */
+enum class InstructionSet {
+    BASELINE,
+    SSE4_2,
+    AVX2,
+    AVX512
+};
+
+/**
+ * @brief Returns a human-readable name of @a instructionSet, for example "AVX2".
+ */
+std::string get_instruction_set_name(InstructionSet instructionSet);
+
+/**
+ * @brief Returns the most advanced instruction set assumed by the compiler for the whole program (for example when
+ * using `-march=native`).
+ */
+InstructionSet get_compiled_instruction_set();
+
+/**
+ * @brief Returns @a true if the CPU the program runs on supports @a instructionSet.
+ */
+bool is_instruction_set_supported(InstructionSet instructionSet);
+
+/**
+ * @brief If the CPU does not support get_compiled_instruction_set(), prints an error to the standard error and
+ * terminates the program.
+ * @details The function is compiled for a generic CPU (see RAMPACK_BASELINE_TARGET) and does not use C++ streams, so
+ * it can be called before any code that may contain unsupported instructions, including static initializers. All
+ * vector and bit manipulation extensions enabled by the compiler (SSE, AVX, AVX-512 subsets, FMA, BMI, etc.) are
+ * verified. F16C, LZCNT and MOVBE cannot be queried by @a __builtin_cpu_supports on all supported compilers, so they
+ * are not verified, but they are present on all CPUs supporting AVX2. Extensions rarely emitted by the compiler (ADX,
+ * RDRND and the like) are not verified either.
+ */
+RAMPACK_BASELINE_TARGET void ensure_compiled_instruction_set_supported();
+
+/**
+ * @brief Returns @a true if the program was compiled with runtime dispatch of kernels marked with
+ * RAMPACK_MULTIVERSIONED.
+ */
+bool is_cpu_dispatch_enabled();
+
+/**
+ * @brief Returns the instruction set of kernels marked with RAMPACK_MULTIVERSIONED, which are executed on this CPU.
+ * @details If runtime dispatch is enabled, it is the same version, which is chosen by the loader. Otherwise, it is
+ * get_compiled_instruction_set().
+ */
+InstructionSet get_kernel_instruction_set();
+
+/**
+ * @brief Returns a one-line description of get_kernel_instruction_set() including the information whether it was
+ * chosen at runtime, for example "AVX2 (selected at runtime)".
+ */
+std::string describe_kernel_instruction_set();
+
+
+#endif //RAMPACK_CPUDISPATCH_H
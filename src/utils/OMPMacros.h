@@ -10,11 +10,15 @@
     #define OMP_MAXTHREADS              omp_get_max_threads()
     #define OMP_SET_NUM_THREADS(num)    omp_set_num_threads(num)
     #define OMP_THREAD_ID               omp_get_thread_num()
+    #define OMP_TEAM_SIZE               omp_get_num_threads()
+    #define OMP_IN_PARALLEL             omp_in_parallel()
     #define OMP_MAYBE_UNUSED
 #else
     #define OMP_MAXTHREADS              1
     #define OMP_SET_NUM_THREADS(num)    static_cast<void>(num)
     #define OMP_THREAD_ID               0
+    #define OMP_TEAM_SIZE               1
+    #define OMP_IN_PARALLEL             false
     #define OMP_MAYBE_UNUSED            [[maybe_unused]]
 #endif
 
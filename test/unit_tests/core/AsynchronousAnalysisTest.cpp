@@ -0,0 +1,74 @@
+#include <catch2/catch.hpp>
+#include <stdexcept>
+
+#include "matchers/VectorApproxMatcher.h"
+
+#include "core/AsynchronousAnalysis.h"
+#include "core/PeriodicBoundaryConditions.h"
+#include "core/shapes/SphereTraits.h"
+
+
+TEST_CASE("AsynchronousAnalysis: packing snapshot") {
+    SphereTraits traits(0.5);
+    const auto &interaction = traits.getInteraction();
+    Packing packing({5, 5, 5}, {Shape({1, 1, 1}), Shape({3, 3, 3}), Shape({2, 4, 1})},
+                    std::make_unique<PeriodicBoundaryConditions>(), interaction, 2, 2);
+
+    auto snapshot = packing.createSnapshot();
+    packing.tryTranslation(0, {0, 2, 0}, interaction);
+    packing.acceptTranslation();
+    packing.tryScaling(2, interaction);
+
+    REQUIRE(snapshot->size() == 3);
+    CHECK(snapshot->getBox().getHeights() == std::array<double, 3>{5, 5, 5});
+    CHECK((*snapshot)[0].getPosition() == Vector<3>{1, 1, 1});
+    CHECK((*snapshot)[1].getPosition() == Vector<3>{3, 3, 3});
+    CHECK(snapshot->getMoveThreads() == 2);
+    CHECK(snapshot->countTotalOverlaps(interaction) == 0);
+
+    SECTION("snapshot is fully functional") {
+        // Moving the 0th particle onto the 2nd one should be detected using the neighbour grid of the snapshot
+        CHECK(snapshot->tryTranslation(0, {1, 3, 0}, interaction) == std::numeric_limits<double>::infinity());
+        CHECK(snapshot->tryTranslation(0, {0.5, 0, 0}, interaction) == 0);
+    }
+
+    SECTION("retaking reuses the snapshot") {
+        packing.takeSnapshot(*snapshot);
+
+        CHECK(snapshot->getBox().getHeights() == std::array<double, 3>{10, 10, 10});
+        CHECK_THAT((*snapshot)[0].getPosition(), IsApproxEqual({2, 6, 2}, 1e-12));
+        CHECK_THAT((*snapshot)[2].getPosition(), IsApproxEqual({4, 8, 2}, 1e-12));
+    }
+}
+
+TEST_CASE("AsynchronousAnalysis") {
+    SphereTraits traits(0.5);
+    const auto &interaction = traits.getInteraction();
+    Packing packing({5, 5, 5}, {Shape({1, 1, 1}), Shape({3, 3, 3})}, std::make_unique<PeriodicBoundaryConditions>(),
+                    interaction);
+    AsynchronousAnalysis analysis;
+
+    SECTION("analyses see packing from the moment they were started") {
+        std::vector<Vector<3>> positions;
+        auto recordPosition = [&positions](const Packing &snapshot) { positions.push_back(snapshot[0].getPosition()); };
+
+        analysis.run(packing, recordPosition);
+        packing.tryTranslation(0, {1, 0, 0}, interaction);
+        packing.acceptTranslation();
+        analysis.run(packing, recordPosition);
+        packing.tryTranslation(0, {1, 0, 0}, interaction);
+        packing.acceptTranslation();
+        analysis.wait();
+
+        CHECK_FALSE(analysis.isRunning());
+        CHECK(analysis.getNumAnalyses() == 2);
+        CHECK(positions == std::vector<Vector<3>>{{1, 1, 1}, {2, 1, 1}});
+    }
+
+    SECTION("exceptions are propagated") {
+        analysis.run(packing, [](const Packing &) { throw std::runtime_error("error"); });
+
+        CHECK_THROWS_AS(analysis.wait(), std::runtime_error);
+        CHECK_NOTHROW(analysis.wait());
+    }
+}
@@ -73,4 +73,18 @@ TEST_CASE("DomainDecomposition") {
         CHECK(domain1.getBoundsForCoordinate(1).end == Approx(14./21));
         CHECK(domain1.getBoundsForCoordinate(2) == ActiveDomain::RegionBounds{-inf, inf});
     }
+
+    SECTION("active volume fraction") {
+        const auto &box = packing.getBox();
+        const auto &interaction = dimer.getInteraction();
+
+        // Ghost layers have width 5, so 2 domains in y direction leave 21 - 2*5 = 11 units of height active
+        CHECK(DomainDecomposition::calculateActiveVolumeFraction(box, interaction, {1, 1, 1}, {4, 7, 2}) == 1);
+        CHECK(DomainDecomposition::calculateActiveVolumeFraction(box, interaction, {1, 2, 1}, {4, 7, 2})
+              == Approx(11./21));
+        CHECK(DomainDecomposition::calculateActiveVolumeFraction(box, interaction, {1, 3, 1}, {4, 7, 2})
+              == std::nullopt);
+        CHECK(DomainDecomposition::calculateActiveVolumeFraction(box, interaction, {2, 1, 1}, {4, 7, 2})
+              == std::nullopt);
+    }
 }
\ No newline at end of file
@@ -0,0 +1,107 @@
+#include <catch2/catch.hpp>
+
+#include "core/DomainDivisionTuner.h"
+#include "core/PeriodicBoundaryConditions.h"
+#include "core/shapes/SphereTraits.h"
+
+
+namespace {
+    using Divisions = DomainDivisionTuner::Divisions;
+
+    // 10 x 10 x 10 simple cubic lattice of unit spheres - NG cells have size 1 and the ghost layers have width 1, so
+    // at most 4 domains fit in each direction
+    Packing create_lattice_packing(const Interaction &interaction, std::size_t moveThreads) {
+        std::vector<Shape> shapes;
+        for (std::size_t i{}; i < 1000; i++) {
+            shapes.emplace_back(Vector<3>{0.5 + static_cast<double>(i % 10), 0.5 + static_cast<double>((i / 10) % 10),
+                                          0.5 + static_cast<double>(i / 100)});
+        }
+        return Packing({10, 10, 10}, std::move(shapes), std::make_unique<PeriodicBoundaryConditions>(), interaction,
+                       moveThreads, 1);
+    }
+}
+
+TEST_CASE("DomainDivisionTuner: candidates") {
+    SphereTraits traits(0.5);
+    const auto &interaction = traits.getInteraction();
+    auto packing = create_lattice_packing(interaction, 4);
+    REQUIRE(packing.getNeighbourGridCellDivisions() == Divisions{10, 10, 10});
+
+    SECTION("current divisions first") {
+        // Scores: 2 x 2 domains - 4 * 0.8 * 0.8 = 2.56, 4 domains along one axis - 4 * 0.6 = 2.4, etc.
+        auto candidates = DomainDivisionTuner::generateCandidates(packing, interaction, {1, 1, 1}, 4, 3);
+
+        CHECK(candidates == std::vector<Divisions>{{1, 1, 1}, {1, 2, 2}, {2, 1, 2}});
+    }
+
+    SECTION("invalid current divisions are skipped") {
+        auto candidates = DomainDivisionTuner::generateCandidates(packing, interaction, {1, 1, 5}, 4, 4);
+
+        CHECK(candidates == std::vector<Divisions>{{1, 2, 2}, {2, 1, 2}, {2, 2, 1}, {1, 1, 4}});
+    }
+
+    SECTION("number of domains is limited") {
+        auto candidates = DomainDivisionTuner::generateCandidates(packing, interaction, {1, 1, 1}, 2, 4);
+
+        CHECK(candidates == std::vector<Divisions>{{1, 1, 1}, {1, 1, 2}, {1, 2, 1}, {2, 1, 1}});
+    }
+
+    SECTION("no neighbour grid") {
+        Packing smallPacking({3, 3, 3}, {Shape({1, 1, 1}), Shape({2, 2, 2})},
+                             std::make_unique<PeriodicBoundaryConditions>(), interaction, 4, 1);
+        REQUIRE_FALSE(smallPacking.isNeighbourGridUsed());
+
+        auto candidates = DomainDivisionTuner::generateCandidates(smallPacking, interaction, {1, 1, 1}, 4, 4);
+
+        CHECK(candidates == std::vector<Divisions>{{1, 1, 1}});
+    }
+}
+
+TEST_CASE("DomainDivisionTuner: benchmark") {
+    SphereTraits traits(0.5);
+    const auto &interaction = traits.getInteraction();
+    auto packing = create_lattice_packing(interaction, 4);
+    DomainDivisionTuner tuner(100, 2, 3);
+
+    // Candidates: {1, 1, 1}, {1, 2, 2}, {2, 1, 2}
+    CHECK(tuner.startCycle(packing, interaction, {1, 1, 1}) == Divisions{1, 1, 1});
+    CHECK(tuner.isBenchmarking());
+    CHECK_FALSE(tuner.finishCycle(100, 100));
+    CHECK(tuner.startCycle(packing, interaction, {1, 1, 1}) == std::nullopt);
+    CHECK_FALSE(tuner.finishCycle(100, 100));
+    CHECK(tuner.startCycle(packing, interaction, {1, 1, 1}) == Divisions{1, 2, 2});
+    CHECK_FALSE(tuner.finishCycle(100, 50));
+    CHECK(tuner.startCycle(packing, interaction, {1, 2, 2}) == std::nullopt);
+    CHECK_FALSE(tuner.finishCycle(100, 50));
+
+    SECTION("finishing") {
+        CHECK(tuner.startCycle(packing, interaction, {1, 2, 2}) == Divisions{2, 1, 2});
+        CHECK_FALSE(tuner.finishCycle(100, 80));
+        CHECK(tuner.startCycle(packing, interaction, {2, 1, 2}) == std::nullopt);
+        CHECK(tuner.finishCycle(100, 80));
+
+        CHECK_FALSE(tuner.isBenchmarking());
+        CHECK(tuner.getDivisionsBeforeBenchmark() == Divisions{1, 1, 1});
+        CHECK(tuner.getBestDivisions() == Divisions{1, 2, 2});
+        CHECK(tuner.getBestSpeedup() == Approx(2));
+
+        SECTION("next benchmark after tuningEvery cycles") {
+            for (std::size_t i{}; i < 94; i++) {
+                CHECK(tuner.startCycle(packing, interaction, {1, 2, 2}) == std::nullopt);
+                CHECK_FALSE(tuner.finishCycle(100, 50));
+            }
+
+            CHECK(tuner.startCycle(packing, interaction, {1, 2, 2}) == Divisions{1, 2, 2});
+            CHECK(tuner.isBenchmarking());
+            CHECK(tuner.getDivisionsBeforeBenchmark() == Divisions{1, 2, 2});
+        }
+    }
+
+    SECTION("aborting") {
+        tuner.abortBenchmark();
+
+        CHECK_FALSE(tuner.isBenchmarking());
+        CHECK(tuner.getBestDivisions() == Divisions{1, 2, 2});
+        CHECK_FALSE(tuner.finishCycle(100, 100));
+    }
+}
@@ -0,0 +1,37 @@
+#include <catch2/catch.hpp>
+
+#include "core/NamedPointCache.h"
+
+
+TEST_CASE("NamedPointCache") {
+    NamedPointCache cache;
+    std::vector<Vector<3>> points1{{1, 2, 3}, {4, 5, 6}};
+    std::vector<Vector<3>> points2{{7, 8, 9}};
+
+    CHECK(cache.find({1, 0, 0}) == nullptr);
+
+    const auto &stored1 = cache.insert({1, 0, 0}, points1);
+    const auto &stored2 = cache.insert({0, 1, 0}, points2);
+
+    SECTION("finding") {
+        CHECK(cache.find({1, 0, 0}) == &stored1);
+        CHECK(cache.find({0, 1, 0}) == &stored2);
+        CHECK(stored1 == points1);
+        CHECK(stored2 == points2);
+        CHECK(cache.find({0, 0, 1}) == nullptr);
+    }
+
+    SECTION("invalidation") {
+        cache.invalidate();
+
+        CHECK(cache.find({1, 0, 0}) == nullptr);
+        CHECK(cache.size() == 0);
+    }
+
+    SECTION("copying") {
+        NamedPointCache copy(cache);
+
+        CHECK(copy.find({1, 0, 0}) == nullptr);
+        CHECK(cache.find({1, 0, 0}) == &stored1);
+    }
+}
@@ -161,6 +161,21 @@ TEST_CASE("NeighbourGrid") {
             REQUIRE(neighbourGrid.getNeighbours({5, 9, 3}).empty());
         }
 
+        SECTION("rescaling") {
+            CHECK(neighbourGrid.getObjectCellNo(0) == neighbourGrid.positionToCellNo({4, 7.49, 3}));
+            CHECK_FALSE(neighbourGrid.canBeRescaled(TriclinicBox(std::array<double, 3>{16, 10, 10}), 2.4));
+            TriclinicBox scaledBox(std::array<double, 3>{13.65, 10.5, 10.5});
+            REQUIRE(neighbourGrid.canBeRescaled(scaledBox, 2.4));
+
+            neighbourGrid.rescale(scaledBox);
+
+            CHECK(neighbourGrid.getCellDivisions() == std::array<std::size_t, 3>{5, 4, 4});
+            CHECK_THAT(neighbourGrid.getNeighbours({3.15, 7.35, 3.15}),
+                       Catch::UnorderedEquals(std::vector<std::size_t>{0, 1, 2, 4}));
+            CHECK_THAT(neighbourGrid.getNeighbours({11.55, 9.45, 3.15}),
+                       Catch::UnorderedEquals(std::vector<std::size_t>{3, 5}));
+        }
+
         SECTION("swap") {
             NeighbourGrid neighbourGrid2(linearSize, 2.4, 7);
 
@@ -171,3 +186,115 @@ TEST_CASE("NeighbourGrid") {
         }
     }
 }
+
+TEST_CASE("NeighbourGrid: box thinner than cell size") {
+    // Box is 4 times thinner than the cell size in z direction, so there should be a single real cell and 4 layers of
+    // image cells on both sides
+    NeighbourGrid neighbourGrid({10, 10, 0.5}, 2, 3);
+    neighbourGrid.add(0, {1, 1, 0.25});
+    neighbourGrid.add(1, {2.5, 1, 0.4});
+    neighbourGrid.add(2, {7, 7, 0.1});
+
+    CHECK(neighbourGrid.getCellDivisions() == std::array<std::size_t, 3>{5, 5, 1});
+    CHECK(neighbourGrid.getImageLayers() == std::array<std::size_t, 3>{1, 1, 4});
+
+    SECTION("all images") {
+        std::vector<double> translationsOf1;
+        for (const auto &cell : neighbourGrid.getNeighbouringCells(Vector<3>{1, 1, 0.25})) {
+            for (auto idx : cell.getNeighbours()) {
+                CHECK(idx != 2);
+                if (idx == 1) {
+                    CHECK(cell.getTranslation()[0] == 0);
+                    CHECK(cell.getTranslation()[1] == 0);
+                    translationsOf1.push_back(cell.getTranslation()[2]);
+                }
+            }
+        }
+
+        CHECK_THAT(translationsOf1, Catch::UnorderedEquals(std::vector<double>{-2, -1.5, -1, -0.5, 0, 0.5, 1, 1.5, 2}));
+    }
+
+    SECTION("positive half of images") {
+        std::size_t numImagesOf0{};
+        std::size_t numImagesOf1{};
+        for (const auto &cell : neighbourGrid.getNeighbouringCells(std::array<std::size_t, 3>{0, 0, 0}, true)) {
+            for (auto idx : cell.getNeighbours()) {
+                if (idx == 0) numImagesOf0++;
+                if (idx == 1) numImagesOf1++;
+            }
+        }
+
+        CHECK(numImagesOf0 == 4);
+        CHECK(numImagesOf1 == 9);
+    }
+
+    SECTION("rescaling") {
+        CHECK(neighbourGrid.canBeRescaled(TriclinicBox(std::array<double, 3>{10.5, 10.5, 0.51}), 2));
+        CHECK_FALSE(neighbourGrid.canBeRescaled(TriclinicBox(std::array<double, 3>{10, 10, 0.45}), 2));
+    }
+}
+
+TEST_CASE("NeighbourGrid: nearest-first neighbouring cells") {
+    // A single object in the centre of each cell
+    NeighbourGrid neighbourGrid(5, 1, 125);
+    auto objectPosition = [](std::size_t idx) {
+        return Vector<3>{static_cast<double>(idx / 25) + 0.5, static_cast<double>((idx / 5) % 5) + 0.5,
+                         static_cast<double>(idx % 5) + 0.5};
+    };
+    for (std::size_t i{}; i < 125; i++)
+        neighbourGrid.add(i, objectPosition(i));
+
+    // The corner cell is used, so that the neighbours lie also in periodic images
+    Vector<3> position{0.5, 0.5, 0.5};
+    std::vector<std::size_t> defaultOrder;
+    for (const auto &cell : neighbourGrid.getNeighbouringCells(position))
+        for (auto idx : cell.getNeighbours())
+            defaultOrder.push_back(idx);
+    std::vector<std::size_t> nearestFirstOrder;
+    std::vector<double> distances2;
+    for (const auto &cell : neighbourGrid.getNeighbouringCellsNearestFirst(position)) {
+        for (auto idx : cell.getNeighbours()) {
+            nearestFirstOrder.push_back(idx);
+            distances2.push_back((objectPosition(idx) + cell.getTranslation() - position).norm2());
+        }
+    }
+
+    CHECK_THAT(nearestFirstOrder, Catch::UnorderedEquals(defaultOrder));
+    REQUIRE(distances2.size() == 27);
+    CHECK(distances2[0] == Approx(0));
+    for (std::size_t i = 1; i < 7; i++)
+        CHECK(distances2[i] == Approx(1));
+    for (std::size_t i = 7; i < 19; i++)
+        CHECK(distances2[i] == Approx(2));
+    for (std::size_t i = 19; i < 27; i++)
+        CHECK(distances2[i] == Approx(3));
+}
+
+TEST_CASE("NeighbourGrid: explicit cell divisions") {
+    // Neighbouring cells span 2 layers of cells of size 1
+    NeighbourGrid neighbourGrid(TriclinicBox(10), {10, 10, 10}, {2, 2, 2}, 3);
+    neighbourGrid.add(0, {0.5, 0.5, 0.5});
+    neighbourGrid.add(1, {8.5, 0.5, 0.5});
+    neighbourGrid.add(2, {7.5, 0.5, 0.5});
+
+    CHECK(neighbourGrid.getCellDivisions() == std::array<std::size_t, 3>{10, 10, 10});
+    CHECK(neighbourGrid.getImageLayers() == std::array<std::size_t, 3>{2, 2, 2});
+
+    std::vector<std::size_t> neighbours;
+    for (const auto &cell : neighbourGrid.getNeighbouringCells(Vector<3>{0.5, 0.5, 0.5})) {
+        for (auto idx : cell.getNeighbours()) {
+            neighbours.push_back(idx);
+            if (idx == 1)
+                CHECK(cell.getTranslation() == Vector<3>{-10, 0, 0});
+        }
+    }
+    CHECK_THAT(neighbours, Catch::UnorderedEquals(std::vector<std::size_t>{0, 1}));
+
+    SECTION("resizing") {
+        neighbourGrid.resize(TriclinicBox(10), {5, 5, 5}, {1, 1, 1});
+
+        CHECK(neighbourGrid.getCellDivisions() == std::array<std::size_t, 3>{5, 5, 5});
+        CHECK(neighbourGrid.getImageLayers() == std::array<std::size_t, 3>{1, 1, 1});
+        CHECK(neighbourGrid.getNeighbours({0.5, 0.5, 0.5}).empty());
+    }
+}
@@ -0,0 +1,120 @@
+#include <catch2/catch.hpp>
+#include <sstream>
+
+#include "core/ObservableSnapshotStorage.h"
+#include "utils/Exceptions.h"
+
+
+namespace {
+    using Snapshot = ObservableSnapshotStorage::Snapshot;
+
+    Snapshot make_snapshot(std::size_t cycleNumber) {
+        auto value = static_cast<double>(cycleNumber);
+        return Snapshot{cycleNumber, {value, value / 3}, {"a" + std::to_string(cycleNumber), ""}};
+    }
+
+    std::vector<Snapshot> get_all_snapshots(const ObservableSnapshotStorage &storage) {
+        std::vector<Snapshot> snapshots;
+        storage.visit([&snapshots](const Snapshot &snapshot) { snapshots.push_back(snapshot); });
+        return snapshots;
+    }
+
+    void check_snapshots(const std::vector<Snapshot> &snapshots, std::size_t expectedNumber) {
+        REQUIRE(snapshots.size() == expectedNumber);
+        for (std::size_t i{}; i < expectedNumber; i++) {
+            auto expected = make_snapshot(100*(i + 1));
+            CHECK(snapshots[i].cycleNumber == expected.cycleNumber);
+            CHECK(snapshots[i].intervalValues == expected.intervalValues);
+            CHECK(snapshots[i].nominalValues == expected.nominalValues);
+        }
+    }
+}
+
+TEST_CASE("ObservableSnapshotStorage: in memory") {
+    ObservableSnapshotStorage storage;
+    for (std::size_t i = 1; i <= 5; i++)
+        storage.add(make_snapshot(100*i));
+
+    CHECK(storage.size() == 5);
+    CHECK(storage.getNumInMemorySnapshots() == 5);
+    check_snapshots(get_all_snapshots(storage), 5);
+
+    SECTION("clearing") {
+        storage.clear();
+
+        CHECK(storage.size() == 0);
+        CHECK(get_all_snapshots(storage).empty());
+    }
+}
+
+TEST_CASE("ObservableSnapshotStorage: spilling") {
+    ObservableSnapshotStorage storage;
+    storage.add(make_snapshot(100));
+    auto spillStream = std::make_unique<std::stringstream>("some previous content");
+    auto spillStreamPtr = spillStream.get();
+    storage.attachSpillStream(std::move(spillStream), 2);
+    for (std::size_t i = 2; i <= 7; i++)
+        storage.add(make_snapshot(100*i));
+
+    CHECK(storage.hasSpillStream());
+    CHECK(storage.size() == 7);
+    CHECK(storage.getNumInMemorySnapshots() == 1);
+    check_snapshots(get_all_snapshots(storage), 7);
+
+    SECTION("adding after reading") {
+        storage.add(make_snapshot(800));
+        storage.add(make_snapshot(900));
+
+        CHECK(storage.getNumInMemorySnapshots() == 0);
+        check_snapshots(get_all_snapshots(storage), 9);
+    }
+
+    SECTION("clearing") {
+        storage.clear();
+        for (std::size_t i = 1; i <= 4; i++)
+            storage.add(make_snapshot(100*i));
+
+        CHECK(storage.size() == 4);
+        check_snapshots(get_all_snapshots(storage), 4);
+    }
+
+    SECTION("detaching") {
+        auto detachedStream = storage.detachSpillStream();
+
+        CHECK(detachedStream.get() == spillStreamPtr);
+        CHECK_FALSE(storage.hasSpillStream());
+        CHECK(storage.getNumInMemorySnapshots() == 7);
+        check_snapshots(get_all_snapshots(storage), 7);
+    }
+
+    SECTION("broken spill stream") {
+        spillStreamPtr->str("");
+
+        CHECK_THROWS_AS(get_all_snapshots(storage), ValidationException);
+    }
+}
+
+TEST_CASE("ObservableSnapshotStorage: limiting to recent snapshots") {
+    ObservableSnapshotStorage storage;
+    for (std::size_t i = 1; i <= 3; i++)
+        storage.add(make_snapshot(100*i));
+
+    storage.limitToRecentSnapshots(2);
+    for (std::size_t i = 4; i <= 5; i++)
+        storage.add(make_snapshot(100*i));
+
+    CHECK(storage.size() == 2);
+    auto snapshots = get_all_snapshots(storage);
+    REQUIRE(snapshots.size() == 2);
+    CHECK(snapshots[0].cycleNumber == 400);
+    CHECK(snapshots[1].cycleNumber == 500);
+
+    SECTION("detaching the spill stream") {
+        storage.attachSpillStream(std::make_unique<std::stringstream>(), 1);
+        storage.limitToRecentSnapshots(1);
+
+        CHECK_FALSE(storage.hasSpillStream());
+        REQUIRE(storage.size() == 1);
+        CHECK(get_all_snapshots(storage).front().cycleNumber == 500);
+    }
+}
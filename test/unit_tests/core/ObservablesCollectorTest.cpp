@@ -8,12 +8,15 @@
 #include "mocks/MockShapeTraits.h"
 #include "mocks/MockObservable.h"
 #include "mocks/MockBulkObservable.h"
+#include "mocks/MockPairEnumerator.h"
 
 #include "core/ObservablesCollector.h"
 
 #include "core/observables/BoxDimensions.h"
 #include "core/observables/CompressibilityFactor.h"
 #include "core/observables/NumberDensity.h"
+#include "core/observables/correlation/PairDensityCorrelation.h"
+#include "core/observables/time_correlation/MeanSquaredDisplacement.h"
 #include "core/PeriodicBoundaryConditions.h"
 
 TEST_CASE("ObservablesCollector") {
@@ -94,6 +97,19 @@ TEST_CASE("ObservablesCollector") {
             }
         }
 
+        SECTION("spilling snapshots") {
+            collector.attachSnapshotSpillStream(std::make_unique<std::stringstream>(), 0);
+            collector.addSnapshot(packing, 100, mockShapeTraits);
+            packing.tryScaling(2, mockShapeTraits.getInteraction());
+            collector.addSnapshot(packing, 200, mockShapeTraits);
+            std::ostringstream out;
+
+            collector.printSnapshots(out);
+
+            CHECK(collector.getNumSnapshots() == 2);
+            CHECK(out.str() == expectedSnapshotOut);
+        }
+
         SECTION("on the fly snapshots") {
             std::stringbuf buf(std::ios::in | std::ios::out);
 
@@ -164,6 +180,22 @@ TEST_CASE("ObservablesCollector") {
             CHECK(values[1].observableData[0].quantity.value == Approx(45));
         }
 
+        SECTION("storing and restoring averaging state") {
+            std::stringstream state;
+            collector.storeAveragingState(state);
+            collector.clear();
+
+            collector.restoreAveragingState(state);
+
+            auto values = collector.getFlattenedAverageValues();
+            REQUIRE(values.size() == 4);
+            CHECK(values[0].quantity.value == Approx(4.5));
+            CHECK(values[1].quantity.value == Approx(6));
+            CHECK(values[2].quantity.value == Approx(7.5));
+            CHECK(values[3].quantity.value == Approx(45));
+            CHECK(values[3].quantity.error == Approx(35));
+        }
+
         SECTION("bulk observable") {
             std::ostringstream bulkOut;
             bool alreadyUsed = false;
@@ -189,9 +221,102 @@ TEST_CASE("ObservablesCollector") {
         }
     }
 
+    SECTION("adaptive bulk sampling") {
+        CHECK(collector.getBulkSamplingInterval() == 1);
+
+        // Box alternates every 64 snapshots, so the values are strongly correlated
+        collector.setBulkSamplingMaxInterval(4);
+        for (std::size_t block{}; block < 32; block++) {
+            for (std::size_t i{}; i < 64; i++)
+                collector.addAveragingValues(packing, mockShapeTraits);
+            packing.tryScaling(block % 2 == 0 ? 2 : 0.5, mockShapeTraits.getInteraction());
+        }
+
+        CHECK(collector.getBulkSamplingInterval() == 4);
+        CHECK(volumes.size() < 2048);
+        CHECK(volumes.size() >= 2048/4);
+
+        SECTION("sampling efficiency") {
+            auto efficiency = collector.getSamplingEfficiency();
+
+            REQUIRE(efficiency.size() == 3);
+            CHECK(efficiency[0].name == "box dimensions");
+            CHECK(efficiency[0].numSamples == 2048);
+            CHECK(efficiency[0].autocorrelationTime > 2);
+            CHECK(efficiency[1].name == "compressibility factor");
+            CHECK(efficiency[1].numSamples == 2048);
+            CHECK(efficiency[2].name == "vol_history");
+            CHECK(efficiency[2].numSamples == volumes.size());
+            CHECK(efficiency[2].autocorrelationTime == Approx(efficiency[0].autocorrelationTime));
+        }
+
+        SECTION("clearing") {
+            collector.clear();
+
+            CHECK(collector.getBulkSamplingInterval() == 1);
+        }
+    }
+
+    SECTION("adaptive bulk sampling with equally spaced snapshots required") {
+        collector.addBulkObservable(std::make_shared<MeanSquaredDisplacement>());
+        collector.setBulkSamplingMaxInterval(4);
+        for (std::size_t block{}; block < 32; block++) {
+            for (std::size_t i{}; i < 64; i++)
+                collector.addAveragingValues(packing, mockShapeTraits);
+            packing.tryScaling(block % 2 == 0 ? 2 : 0.5, mockShapeTraits.getInteraction());
+        }
+
+        CHECK(collector.getBulkSamplingInterval() == 1);
+        CHECK(volumes.size() == 2048);
+    }
+
     SECTION("inline string") {
         std::string inlineString = collector.generateInlineObservablesString(packing, mockShapeTraits);
 
         CHECK(inlineString == "L_X: 3, L_Y: 4, L_Z: 5, dim: 3x4x5, rho: 0.05");
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("ObservablesCollector: shared pair enumeration") {
+    using trompeloeil::_;
+
+    MockShapeTraits mockShapeTraits;
+    ALLOW_CALL(mockShapeTraits, getRangeRadius()).RETURN(1);
+    ALLOW_CALL(mockShapeTraits, getInteractionCentres()).RETURN(std::vector<Vector<3>>{});
+    ALLOW_CALL(mockShapeTraits, getTotalRangeRadius()).RETURN(1);
+
+    auto pbc = std::make_unique<PeriodicBoundaryConditions>();
+    Packing packing({10, 10, 10}, {Shape({1, 1, 1}), Shape({2, 1, 1}), Shape({5, 5, 5})}, std::move(pbc),
+                    mockShapeTraits.getInteraction(), 1, 1);
+
+    auto sharedEnumerator = std::make_shared<MockPairEnumerator>();
+    ALLOW_CALL(*sharedEnumerator, getSignatureName()).RETURN("shared");
+    ALLOW_CALL(*sharedEnumerator, getExpectedNumOfMoleculesInShells(_, _)).RETURN(std::vector<double>{1, 1});
+    REQUIRE_CALL(*sharedEnumerator, enumeratePairs(_, _, _))
+        .TIMES(1)
+        .SIDE_EFFECT(_3.consumePair(_1, {0, 1}, {0.5, 0, 0}, _2));
+    auto otherEnumerator = std::make_shared<MockPairEnumerator>();
+    ALLOW_CALL(*otherEnumerator, getSignatureName()).RETURN("shared");
+    ALLOW_CALL(*otherEnumerator, getExpectedNumOfMoleculesInShells(_, _)).RETURN(std::vector<double>{1, 1});
+    REQUIRE_CALL(*otherEnumerator, enumeratePairs(_, _, _))
+        .TIMES(1)
+        .SIDE_EFFECT(_3.consumePair(_1, {0, 1}, {1.5, 0, 0}, _2));
+
+    ObservablesCollector collector;
+    collector.addBulkObservable(std::make_shared<PairDensityCorrelation>(sharedEnumerator, 2, 2));
+    collector.addBulkObservable(std::make_shared<PairDensityCorrelation>(otherEnumerator, 2, 2));
+    collector.addBulkObservable(std::make_shared<PairDensityCorrelation>(sharedEnumerator, 2, 2));
+    collector.setThermodynamicParameters(1, 1);
+
+    collector.addAveragingValues(packing, mockShapeTraits);
+
+    std::vector<std::string> outputs;
+    collector.visitBulkObservables([&outputs](const BulkObservable &observable) {
+        std::ostringstream out;
+        observable.print(out);
+        outputs.push_back(out.str());
+    });
+    // Bins are renormalized by 2/N = 2/3
+    CHECK(outputs == std::vector<std::string>{"0.5 0.666667\n1.5 0\n", "0.5 0\n1.5 0.666667\n",
+                                              "0.5 0.666667\n1.5 0\n"});
+}
@@ -0,0 +1,76 @@
+#include <catch2/catch.hpp>
+
+#include "core/OverlapSanitizer.h"
+#include "core/PeriodicBoundaryConditions.h"
+#include "core/shapes/SphereTraits.h"
+
+
+TEST_CASE("OverlapSanitizer") {
+    SphereTraits traits(0.5);
+    const auto &interaction = traits.getInteraction();
+
+    SECTION("checking every n cycles") {
+        Packing packing({5, 5, 5}, {Shape({1, 1, 1}), Shape({3, 3, 3})},
+                        std::make_unique<PeriodicBoundaryConditions>(), interaction);
+        OverlapSanitizer sanitizer(10, 1, 1234);
+
+        for (std::size_t cycle = 1; cycle <= 25; cycle++)
+            sanitizer.check(packing, interaction, cycle);
+
+        CHECK_NOTHROW(sanitizer.wait());
+        CHECK(sanitizer.getNumChecks() == 2);
+    }
+
+    SECTION("detecting overlaps") {
+        // Particle 1 overlaps with particle 2 only through periodic boundary conditions
+        Packing packing({5, 5, 5}, {Shape({1, 1, 1}), Shape({0.2, 3, 3}), Shape({4.6, 3, 3})},
+                        std::make_unique<PeriodicBoundaryConditions>(), interaction);
+        OverlapSanitizer sanitizer(1, 1, 1234);
+
+        sanitizer.check(packing, interaction, 1);
+
+        CHECK_THROWS_AS(sanitizer.wait(), AssertionException);
+    }
+
+    SECTION("detecting overlaps with walls") {
+        Packing packing({5, 5, 5}, {Shape({0.2, 1, 1}), Shape({3, 3, 3})},
+                        std::make_unique<PeriodicBoundaryConditions>(), interaction);
+        packing.toggleWall(0, true);
+        OverlapSanitizer sanitizer(1, 1, 1234);
+
+        sanitizer.check(packing, interaction, 1);
+
+        CHECK_THROWS_AS(sanitizer.wait(), AssertionException);
+    }
+
+    SECTION("sampled particles") {
+        // 3 particles out of 100 are checked in each cycle, so after 200 cycles, the overlapping pair is found with
+        // an overwhelming probability
+        std::vector<Shape> shapes;
+        for (std::size_t i{}; i < 100; i++)
+            shapes.emplace_back(Vector<3>{0.5 + static_cast<double>(i % 10), 0.5 + static_cast<double>(i / 10), 1});
+        shapes[55].setPosition({5.5, 5.8, 1});
+        Packing packing({10, 10, 10}, std::move(shapes), std::make_unique<PeriodicBoundaryConditions>(), interaction);
+        OverlapSanitizer sanitizer(1, 0.025, 1234);
+
+        auto runChecks = [&]() {
+            for (std::size_t cycle = 1; cycle <= 200; cycle++)
+                sanitizer.check(packing, interaction, cycle);
+            sanitizer.wait();
+        };
+
+        CHECK_THROWS_AS(runChecks(), AssertionException);
+    }
+
+    SECTION("overlap counting") {
+        Packing packing({5, 5, 5}, {Shape({1, 1, 1}), Shape({1.5, 1, 1}), Shape({3, 3, 3})},
+                        std::make_unique<PeriodicBoundaryConditions>(), interaction);
+        packing.toggleOverlapCounting(true, interaction);
+        OverlapSanitizer sanitizer(1, 0.1, 1234);
+
+        sanitizer.check(packing, interaction, 1);
+
+        // Cached number of overlaps is consistent, so the overlaps are not reported
+        CHECK_NOTHROW(sanitizer.wait());
+    }
+}
@@ -4,6 +4,7 @@
 
 #include <catch2/catch.hpp>
 #include <cmath>
+#include <random>
 #include <sstream>
 
 #include "matchers/PackingApproxPositionsCatchMatcher.h"
@@ -13,6 +14,7 @@
 
 #include "core/Packing.h"
 #include "core/PeriodicBoundaryConditions.h"
+#include "core/FreeBoundaryConditions.h"
 #include "core/Interaction.h"
 
 namespace {
@@ -70,6 +72,32 @@ namespace {
         }
     };
 
+    class SphereSoftCoreInteraction : public Interaction {
+    private:
+        double range;
+
+    public:
+        explicit SphereSoftCoreInteraction(double range) : range{range} { }
+
+        [[nodiscard]] bool hasHardPart() const override { return false; }
+        [[nodiscard]] bool hasSoftPart() const override { return true; }
+        [[nodiscard]] bool hasWallPart() const override { return false; }
+        [[nodiscard]] bool isConvex() const override { return false; }
+
+        [[nodiscard]] double calculateEnergyBetween(const Vector<3> &pos1,
+                                                    [[maybe_unused]] const Matrix<3, 3> &orientaton1,
+                                                    [[maybe_unused]] std::size_t idx1,
+                                                    const Vector<3> &pos2,
+                                                    [[maybe_unused]] const Matrix<3, 3> &orientaton2,
+                                                    [[maybe_unused]] std::size_t idx2,
+                                                    const BoundaryConditions &bc) const override
+        {
+            return std::max(this->range - std::sqrt(bc.getDistance2(pos1, pos2)), 0.);
+        }
+
+        [[nodiscard]] double getRangeRadius() const override { return this->range; }
+    };
+
     class DimerDistanceInteraction : public SphereDistanceInteraction {
     public:
         [[nodiscard]] std::vector<Vector<3>> getInteractionCentres() const override { return {{0, 0, 0}, {1, 0, 0}}; }
@@ -81,6 +109,88 @@ namespace {
 
         [[nodiscard]] std::vector<Vector<3>> getInteractionCentres() const override { return {{0, 0, 0}, {1, 0, 0}}; }
     };
+
+    /**
+     * A lollipop made of a large sphere and 3 small ones. Centres overlap below the half of the sum of radii and
+     * interact softly up to the sum of radii.
+     */
+    class LollipopInteraction : public Interaction {
+    private:
+        std::vector<double> radii{0.5, 0.1, 0.1, 0.1};
+        bool reportCentreRanges{};
+
+    public:
+        explicit LollipopInteraction(bool reportCentreRanges) : reportCentreRanges{reportCentreRanges} { }
+
+        [[nodiscard]] bool hasHardPart() const override { return true; }
+        [[nodiscard]] bool hasSoftPart() const override { return true; }
+        [[nodiscard]] bool hasWallPart() const override { return false; }
+        [[nodiscard]] bool isConvex() const override { return false; }
+
+        [[nodiscard]] bool overlapBetween(const Vector<3> &pos1,
+                                          [[maybe_unused]] const Matrix<3, 3> &orientaton1,
+                                          std::size_t idx1,
+                                          const Vector<3> &pos2,
+                                          [[maybe_unused]] const Matrix<3, 3> &orientaton2,
+                                          std::size_t idx2,
+                                          const BoundaryConditions &bc) const override
+        {
+            return bc.getDistance2(pos1, pos2) < std::pow((this->radii[idx1] + this->radii[idx2]) / 2, 2);
+        }
+
+        [[nodiscard]] double calculateEnergyBetween(const Vector<3> &pos1,
+                                                    [[maybe_unused]] const Matrix<3, 3> &orientaton1,
+                                                    std::size_t idx1,
+                                                    const Vector<3> &pos2,
+                                                    [[maybe_unused]] const Matrix<3, 3> &orientaton2,
+                                                    std::size_t idx2,
+                                                    const BoundaryConditions &bc) const override
+        {
+            double distance = std::sqrt(bc.getDistance2(pos1, pos2));
+            return std::max(this->radii[idx1] + this->radii[idx2] - distance, 0.);
+        }
+
+        [[nodiscard]] std::vector<Vector<3>> getInteractionCentres() const override {
+            return {{0, 0, 0}, {0.6, 0, 0}, {0.8, 0, 0}, {1, 0, 0}};
+        }
+
+        [[nodiscard]] std::vector<double> getInteractionCentreRangeRadii() const override {
+            if (!this->reportCentreRanges)
+                return {};
+            return {1, 0.2, 0.2, 0.2};
+        }
+
+        [[nodiscard]] double getRangeRadius() const override { return 1; }
+    };
+
+    class RecordingPackingListener : public PackingListener {
+    public:
+        std::vector<std::size_t> movedParticles;
+        std::vector<Shape> oldShapes;
+        std::vector<Shape> newShapes;
+        std::vector<double> moveEnergyDeltas;
+        std::vector<TriclinicBox> oldBoxes;
+        std::vector<double> scalingEnergyDeltas;
+        std::size_t numResets{};
+
+        void particleMoved([[maybe_unused]] const Packing &packing, std::size_t particleIdx, const Shape &oldShape,
+                           const Shape &newShape, double energyDelta) override
+        {
+            this->movedParticles.push_back(particleIdx);
+            this->oldShapes.push_back(oldShape);
+            this->newShapes.push_back(newShape);
+            this->moveEnergyDeltas.push_back(energyDelta);
+        }
+
+        void boxScaled([[maybe_unused]] const Packing &packing, const TriclinicBox &oldBox,
+                       double energyDelta) override
+        {
+            this->oldBoxes.push_back(oldBox);
+            this->scalingEnergyDeltas.push_back(energyDelta);
+        }
+
+        void packingReset([[maybe_unused]] const Packing &packing) override { this->numResets++; }
+    };
 }
 
 TEST_CASE("Packing: single interaction center operations") {
@@ -597,6 +707,191 @@ TEST_CASE("Packing: too big NG cell bug") {
     REQUIRE_NOTHROW(Packing({1.1, 100, 100}, std::move(shapes), std::move(pbc), hardCore));
 }
 
+TEST_CASE("Packing: neighbour grid rescaling") {
+    constexpr double inf = std::numeric_limits<double>::infinity();
+    SphereHardCoreInteraction hardCore(0.5);
+    auto pbc = std::make_unique<PeriodicBoundaryConditions>();
+    std::vector<Shape> shapes;
+    for (std::size_t i{}; i < 4; i++)
+        for (std::size_t j{}; j < 4; j++)
+            for (std::size_t k{}; k < 4; k++)
+                shapes.emplace_back(2.5 * Vector<3>{i + 0.5, j + 0.5, k + 0.5});
+    Packing packing(TriclinicBox(10), std::move(shapes), std::move(pbc), hardCore);
+    std::size_t initialRebuilds = packing.getNeighbourGridRebuilds();
+
+    SECTION("same cell divisions") {
+        REQUIRE(packing.tryScaling(1.05, hardCore) == 0);
+
+        CHECK(packing.getNeighbourGridRebuilds() == initialRebuilds);
+        // Particle 0 moved 0.5 away from particle 1
+        CHECK(packing.tryTranslation(0, {0, 0, 2.125}, hardCore) == inf);
+
+        SECTION("reverting") {
+            packing.revertScaling();
+
+            CHECK(packing.getNeighbourGridRebuilds() == initialRebuilds);
+            // Particle 0 moved 0.5 away from particle 1
+            CHECK(packing.tryTranslation(0, {0, 0, 2}, hardCore) == inf);
+            CHECK(packing.tryTranslation(0, {0, 0, 1.4}, hardCore) == 0);
+        }
+    }
+
+    SECTION("different cell divisions") {
+        REQUIRE(packing.tryScaling(1.2, hardCore) == 0);
+
+        CHECK(packing.getNeighbourGridRebuilds() == initialRebuilds + 1);
+        // Particle 0 moved 0.5 away from particle 1
+        CHECK(packing.tryTranslation(0, {0, 0, 2.5}, hardCore) == inf);
+    }
+}
+
+TEST_CASE("Packing: box thinner than interaction range") {
+    constexpr double inf = std::numeric_limits<double>::infinity();
+    SphereHardCoreInteraction hardCore(0.5);
+    auto pbc = std::make_unique<PeriodicBoundaryConditions>();
+    std::vector<Shape> shapes;
+    for (std::size_t i{}; i < 4; i++)
+        for (std::size_t j{}; j < 4; j++)
+            shapes.emplace_back(Vector<3>{2.5 * (i + 0.5), 2.5 * (j + 0.5), 0.3});
+    Packing packing({10, 10, 0.6}, std::move(shapes), std::move(pbc), hardCore);
+
+    REQUIRE(packing.isNeighbourGridUsed());
+    CHECK(packing.getNeighbourGridImageLayers() == std::array<std::size_t, 3>{1, 1, 2});
+
+    SECTION("periodic images of the particle itself are ignored") {
+        CHECK(packing.countTotalOverlaps(hardCore, false) == 0);
+    }
+
+    SECTION("moves") {
+        CHECK(packing.tryTranslation(0, {2, 0, 0.2}, hardCore) == inf);
+        CHECK(packing.tryTranslation(0, {1, 0, 0.2}, hardCore) == 0);
+    }
+
+    SECTION("scaling") {
+        std::size_t initialRebuilds = packing.getNeighbourGridRebuilds();
+
+        REQUIRE(packing.tryScaling(1.01, hardCore) == 0);
+
+        CHECK(packing.getNeighbourGridRebuilds() == initialRebuilds);
+        CHECK(packing.getNeighbourGridImageLayers() == std::array<std::size_t, 3>{1, 1, 2});
+    }
+}
+
+TEST_CASE("Packing: energy in a box thinner than twice the interaction range") {
+    // Previously, such small boxes were handled without NG, which checks only the nearest periodic image, while for
+    // the range larger than half of the box height, more images interact. The energy is compared with the sum over all
+    // images calculated directly
+    double range = 1.2;
+    SphereSoftCoreInteraction softCore(range);
+    auto boxSize = GENERATE(std::array<double, 3>{3, 3, 0.5}, std::array<double, 3>{3, 3, 2},
+                            std::array<double, 3>{3, 3, 3});
+    DYNAMIC_SECTION("box " << boxSize[0] << " x " << boxSize[1] << " x " << boxSize[2]) {
+        std::mt19937 mt(1234);
+        std::uniform_real_distribution<double> unitDistribution;
+        std::vector<Shape> shapes;
+        for (std::size_t i{}; i < 10; i++) {
+            shapes.emplace_back(Vector<3>{boxSize[0] * unitDistribution(mt), boxSize[1] * unitDistribution(mt),
+                                          boxSize[2] * unitDistribution(mt)});
+        }
+
+        // Sum over all periodic images within the range (but not images of a particle itself)
+        auto calculateExpectedEnergy = [&](std::size_t particleIdx, const Vector<3> &pos) {
+            FreeBoundaryConditions fbc;
+            double energy{};
+            int maxImage = static_cast<int>(std::ceil(range / boxSize[2])) + 1;
+            for (std::size_t j{}; j < shapes.size(); j++) {
+                if (j == particleIdx)
+                    continue;
+                for (int ix = -1; ix <= 1; ix++) {
+                    for (int iy = -1; iy <= 1; iy++) {
+                        for (int iz = -maxImage; iz <= maxImage; iz++) {
+                            Vector<3> translation{ix * boxSize[0], iy * boxSize[1], iz * boxSize[2]};
+                            energy += softCore.calculateEnergyBetween(pos, Matrix<3, 3>::identity(), 0,
+                                                                      shapes[j].getPosition() + translation,
+                                                                      Matrix<3, 3>::identity(), 0, fbc);
+                        }
+                    }
+                }
+            }
+            return energy;
+        };
+        double expectedTotalEnergy{};
+        for (std::size_t i{}; i < shapes.size(); i++)
+            expectedTotalEnergy += calculateExpectedEnergy(i, shapes[i].getPosition()) / 2;
+        Vector<3> translation{0.1, 0.2, 0.05};
+        Vector<3> movedPos = shapes[0].getPosition() + translation;
+        double expectedMoveEnergy = calculateExpectedEnergy(0, movedPos)
+                                    - calculateExpectedEnergy(0, shapes[0].getPosition());
+
+        Packing packing(boxSize, shapes, std::make_unique<PeriodicBoundaryConditions>(), softCore);
+
+        // Only for the last box the nearest image is enough - then, NG would not be efficient for such a small box
+        CHECK(packing.isNeighbourGridUsed() == (2 * range > boxSize[2]));
+        CHECK(packing.getTotalEnergy(softCore) == Approx(expectedTotalEnergy));
+        CHECK(packing.tryTranslation(0, translation, softCore) == Approx(expectedMoveEnergy).margin(1e-12));
+    }
+}
+
+TEST_CASE("Packing: last overlap partner") {
+    constexpr double inf = std::numeric_limits<double>::infinity();
+    SphereHardCoreInteraction hardCore(0.25);
+    auto pbc = std::make_unique<PeriodicBoundaryConditions>();
+    std::vector<Shape> shapes;
+    shapes.emplace_back(Vector<3>{0.5, 0.5, 0.5});
+    shapes.emplace_back(Vector<3>{1.5, 0.5, 0.5});
+    shapes.emplace_back(Vector<3>{3.5, 3.5, 3.5});
+    Packing packing({5, 5, 5}, std::move(shapes), std::move(pbc), hardCore);
+    REQUIRE(packing.isNeighbourGridUsed());
+
+    REQUIRE(packing.tryTranslation(0, {0.7, 0, 0}, hardCore) == inf);
+    auto statistics = packing.getOverlapRejectionStatistics();
+    CHECK(statistics.rejectedMoves == 1);
+    CHECK(statistics.partnerHits == 0);
+    CHECK(statistics.pairChecks == 1);
+
+    SECTION("partner is checked first") {
+        CHECK(packing.tryTranslation(0, {0.8, 0, 0}, hardCore) == inf);
+
+        statistics = packing.getOverlapRejectionStatistics();
+        CHECK(statistics.rejectedMoves == 2);
+        CHECK(statistics.partnerHits == 1);
+        CHECK(statistics.pairChecks == 2);
+    }
+
+    SECTION("overlap with another particle") {
+        CHECK(packing.tryTranslation(0, {2.8, 2.8, 2.8}, hardCore) == inf);
+
+        statistics = packing.getOverlapRejectionStatistics();
+        CHECK(statistics.rejectedMoves == 2);
+        CHECK(statistics.partnerHits == 0);
+        CHECK(statistics.pairChecks == 3);      // partner 1 + found 2
+
+        CHECK(packing.tryTranslation(0, {2.9, 2.9, 2.9}, hardCore) == inf);
+        CHECK(packing.getOverlapRejectionStatistics().partnerHits == 1);
+    }
+
+    SECTION("no overlap") {
+        CHECK(packing.tryTranslation(0, {0, 0.1, 0}, hardCore) == 0);
+
+        CHECK(packing.getOverlapRejectionStatistics().rejectedMoves == 1);
+    }
+
+    SECTION("resetting partners") {
+        packing.resetOverlapPartners();
+
+        CHECK(packing.tryTranslation(0, {0.8, 0, 0}, hardCore) == inf);
+        CHECK(packing.getOverlapRejectionStatistics().partnerHits == 0);
+    }
+
+    SECTION("resetting counters") {
+        packing.resetCounters();
+
+        statistics = packing.getOverlapRejectionStatistics();
+        CHECK(statistics.rejectedMoves == 0);
+        CHECK(statistics.pairChecks == 0);
+    }
+}
+
 TEST_CASE("Packing: named points dumping") {
     double radius = 0.5;
     SphereHardCoreInteraction hardCore(radius);
@@ -607,9 +902,232 @@ TEST_CASE("Packing: named points dumping") {
     MockShapeGeometry geometry;
     geometry.addNamedPoints({{"point", {1, 0, 0}}});
 
-    auto points = packing.dumpNamedPoints(geometry, "point");
+    const auto &points = packing.dumpNamedPoints(geometry, "point");
 
     REQUIRE(points.size() == 2);
     CHECK_THAT(points[0], IsApproxEqual({1.5, 0.5, 0.5}, 1e-12));
     CHECK_THAT(points[1], IsApproxEqual({0.5, 4.5, 0.5}, 1e-12));
+
+    SECTION("caching") {
+        CHECK(&packing.dumpNamedPoints(geometry, "point") == &points);
+    }
+
+    SECTION("invalidation after move") {
+        packing.tryTranslation(0, {1, 0, 0}, hardCore);
+        packing.acceptTranslation();
+
+        const auto &newPoints = packing.dumpNamedPoints(geometry, "point");
+
+        REQUIRE(newPoints.size() == 2);
+        CHECK_THAT(newPoints[0], IsApproxEqual({2.5, 0.5, 0.5}, 1e-12));
+        CHECK_THAT(newPoints[1], IsApproxEqual({0.5, 4.5, 0.5}, 1e-12));
+    }
+}
+
+TEST_CASE("Packing: listeners") {
+    SphereDistanceInteraction distanceInteraction{};
+    auto pbc = std::make_unique<PeriodicBoundaryConditions>();
+    std::vector<Shape> shapes;
+    shapes.emplace_back(Vector<3>{0.5, 0.5, 0.5});
+    shapes.emplace_back(Vector<3>{4.5, 0.5, 0.5});
+    shapes.emplace_back(Vector<3>{2.5, 2.5, 4.0});
+    Packing packing({5, 5, 5}, std::move(shapes), std::move(pbc), distanceInteraction);
+    RecordingPackingListener listener;
+
+    packing.attachListener(listener);
+
+    REQUIRE(packing.isListenerAttached(listener));
+    CHECK(listener.numResets == 1);
+
+    SECTION("accepted move") {
+        double dE = packing.tryMove(1, {-0.5, 0, 0}, Matrix<3, 3>::rotation(0, 0, M_PI/2), distanceInteraction);
+        packing.acceptMove();
+
+        REQUIRE(listener.movedParticles == std::vector<std::size_t>{1});
+        CHECK(listener.oldShapes.front() == Shape(Vector<3>{4.5, 0.5, 0.5}));
+        CHECK(listener.newShapes.front() == packing[1]);
+        CHECK(listener.moveEnergyDeltas.front() == Approx(dE));
+    }
+
+    SECTION("not accepted move") {
+        static_cast<void>(packing.tryTranslation(1, {-0.5, 0, 0}, distanceInteraction));
+
+        CHECK(listener.movedParticles.empty());
+    }
+
+    SECTION("scaling and reverting") {
+        double initialEnergy = packing.getTotalEnergy(distanceInteraction);
+        double dE = packing.tryScaling(1.1, distanceInteraction);
+
+        REQUIRE(listener.oldBoxes.size() == 1);
+        CHECK(listener.oldBoxes[0].getHeights() == std::array<double, 3>{5, 5, 5});
+        CHECK(listener.scalingEnergyDeltas[0] == Approx(dE));
+
+        packing.revertScaling();
+
+        REQUIRE(listener.oldBoxes.size() == 2);
+        CHECK(listener.oldBoxes[1].getHeights()[0] == Approx(5.5));
+        CHECK(listener.scalingEnergyDeltas[1] == Approx(-dE));
+        CHECK(packing.getTotalEnergy(distanceInteraction) == Approx(initialEnergy));
+    }
+
+    SECTION("reset") {
+        packing.setupForInteraction(distanceInteraction);
+
+        CHECK(listener.numResets == 2);
+    }
+
+    SECTION("detaching") {
+        packing.detachListener(listener);
+
+        CHECK_FALSE(packing.isListenerAttached(listener));
+        CHECK(listener.numResets == 2);
+        static_cast<void>(packing.tryTranslation(1, {-0.5, 0, 0}, distanceInteraction));
+        packing.acceptTranslation();
+        CHECK(listener.movedParticles.empty());
+    }
+}
+
+TEST_CASE("Packing: size class neighbour grids") {
+    // Size class grids are used only with interaction centre ranges reported - the reference packing uses a single
+    // neighbour grid and the results should be the same
+    LollipopInteraction interaction(true);
+    LollipopInteraction referenceInteraction(false);
+    std::mt19937 mt(1234);
+    std::uniform_real_distribution<double> angleDistribution(0, 2*M_PI);
+    std::uniform_real_distribution<double> translationDistribution(-0.5, 0.5);
+    std::vector<Shape> shapes;
+    for (std::size_t i{}; i < 4; i++) {
+        for (std::size_t j{}; j < 4; j++) {
+            for (std::size_t k{}; k < 4; k++) {
+                auto rotation = Matrix<3, 3>::rotation(angleDistribution(mt), angleDistribution(mt),
+                                                       angleDistribution(mt));
+                shapes.emplace_back(1.5 * Vector<3>{i + 0.5, j + 0.5, k + 0.5}, rotation);
+            }
+        }
+    }
+    Packing packing({6, 6, 6}, shapes, std::make_unique<PeriodicBoundaryConditions>(), interaction);
+    Packing referencePacking({6, 6, 6}, shapes, std::make_unique<PeriodicBoundaryConditions>(),
+                             referenceInteraction);
+    REQUIRE(packing.getNumSizeClassGrids() == 2);
+    REQUIRE(referencePacking.getNumSizeClassGrids() == 0);
+
+    auto checkOverlaps = [&]() {
+        for (std::size_t i{}; i < packing.size(); i++) {
+            CHECK(packing.countParticleOverlaps(i, interaction, false)
+                  == referencePacking.countParticleOverlaps(i, referenceInteraction, false));
+        }
+    };
+
+    SECTION("fewer neighbours") {
+        checkOverlaps();
+        CHECK(packing.getAverageNumberOfNeighbours() < referencePacking.getAverageNumberOfNeighbours() / 2);
+    }
+
+    SECTION("moves") {
+        for (std::size_t i{}; i < packing.size(); i++) {
+            Vector<3> translation{translationDistribution(mt), translationDistribution(mt),
+                                  translationDistribution(mt)};
+            auto rotation = Matrix<3, 3>::rotation(angleDistribution(mt), angleDistribution(mt),
+                                                   angleDistribution(mt));
+            double energy = packing.tryMove(i, translation, rotation, interaction);
+            double referenceEnergy = referencePacking.tryMove(i, translation, rotation, referenceInteraction);
+            if (std::isinf(referenceEnergy)) {
+                CHECK(energy == referenceEnergy);
+                continue;
+            }
+
+            CHECK(energy == Approx(referenceEnergy).margin(1e-12));
+            packing.acceptMove();
+            referencePacking.acceptMove();
+        }
+        checkOverlaps();
+    }
+
+    SECTION("scaling") {
+        std::size_t initialRebuilds = packing.getNeighbourGridRebuilds();
+
+        SECTION("rescaling neighbour grids") {
+            // Interaction centres are not scaled, so the scaling has to be small enough for them to remain in their
+            // cells
+            static_cast<void>(packing.tryScaling(1.001, interaction));
+            static_cast<void>(referencePacking.tryScaling(1.001, referenceInteraction));
+
+            CHECK(packing.getNeighbourGridRebuilds() == initialRebuilds);
+            checkOverlaps();
+        }
+
+        SECTION("rebuilding neighbour grids") {
+            static_cast<void>(packing.tryScaling(1.3, interaction));
+            static_cast<void>(referencePacking.tryScaling(1.3, referenceInteraction));
+
+            CHECK(packing.getNeighbourGridRebuilds() == initialRebuilds + 1);
+            checkOverlaps();
+        }
+
+        packing.revertScaling();
+        referencePacking.revertScaling();
+        checkOverlaps();
+    }
+}
+
+TEST_CASE("Packing: intra-move threads") {
+    // Single particle computations split between threads should give exactly the same results as the serial ones
+    bool reportCentreRanges = GENERATE(false, true);
+    LollipopInteraction interaction(reportCentreRanges);
+    std::mt19937 mt(1234);
+    std::uniform_real_distribution<double> angleDistribution(0, 2*M_PI);
+    std::uniform_real_distribution<double> translationDistribution(-0.5, 0.5);
+    std::vector<Shape> shapes;
+    for (std::size_t i{}; i < 4; i++) {
+        for (std::size_t j{}; j < 4; j++) {
+            for (std::size_t k{}; k < 4; k++) {
+                auto rotation = Matrix<3, 3>::rotation(angleDistribution(mt), angleDistribution(mt),
+                                                       angleDistribution(mt));
+                shapes.emplace_back(1.5 * Vector<3>{i + 0.5, j + 0.5, k + 0.5}, rotation);
+            }
+        }
+    }
+    Packing packing({6, 6, 6}, shapes, std::make_unique<PeriodicBoundaryConditions>(), interaction);
+    Packing referencePacking({6, 6, 6}, shapes, std::make_unique<PeriodicBoundaryConditions>(), interaction);
+    packing.setIntraMoveThreads(4);
+    REQUIRE(packing.getIntraMoveThreads() == 4);
+
+    auto performMoves = [&]() {
+        for (std::size_t i{}; i < packing.size(); i++) {
+            Vector<3> translation{translationDistribution(mt), translationDistribution(mt),
+                                  translationDistribution(mt)};
+            auto rotation = Matrix<3, 3>::rotation(angleDistribution(mt), angleDistribution(mt),
+                                                   angleDistribution(mt));
+            double energy = packing.tryMove(i, translation, rotation, interaction);
+            double referenceEnergy = referencePacking.tryMove(i, translation, rotation, interaction);
+            CHECK(energy == referenceEnergy);
+            if (std::isinf(referenceEnergy))
+                continue;
+
+            packing.acceptMove();
+            referencePacking.acceptMove();
+        }
+    };
+
+    SECTION("moves") {
+        performMoves();
+
+        for (std::size_t i{}; i < packing.size(); i++) {
+            CHECK(packing.countParticleOverlaps(i, interaction, false)
+                  == referencePacking.countParticleOverlaps(i, interaction, false));
+            CHECK(packing.countParticleOverlaps(i, interaction, true)
+                  == referencePacking.countParticleOverlaps(i, interaction, true));
+        }
+    }
+
+    SECTION("overlap counting") {
+        packing.toggleOverlapCounting(true, interaction);
+        referencePacking.toggleOverlapCounting(true, interaction);
+
+        performMoves();
+
+        CHECK(packing.getCachedNumberOfOverlaps() == referencePacking.getCachedNumberOfOverlaps());
+        CHECK(packing.getCachedNumberOfOverlaps() == packing.countTotalOverlaps(interaction, false));
+    }
 }
@@ -0,0 +1,146 @@
+#include <catch2/catch.hpp>
+#include <algorithm>
+
+#include "core/ParticleSweep.h"
+#include "core/PeriodicBoundaryConditions.h"
+#include "core/shapes/SphereTraits.h"
+
+
+namespace {
+    // Particles lie on a line along x axis, however their indices are shuffled: particle i is at x = xs[i]
+    Packing make_line_packing(const SphereTraits &traits) {
+        std::vector<double> xs{5.5, 0.5, 7.5, 2.5, 6.5, 1.5, 3.5, 4.5};
+        std::vector<Shape> shapes;
+        for (double x : xs)
+            shapes.emplace_back(Vector<3>{x, 0.5, 0.5});
+        return Packing({8, 1, 1}, std::move(shapes), std::make_unique<PeriodicBoundaryConditions>(),
+                       traits.getInteraction());
+    }
+
+    std::vector<std::size_t> do_sweep(ParticleSweep &sweep, std::mt19937 &mt, std::size_t numParticles) {
+        std::vector<std::size_t> visited(numParticles);
+        std::generate(visited.begin(), visited.end(), [&]() { return sweep.next(mt); });
+        return visited;
+    }
+}
+
+TEST_CASE("ParticleSweep: random") {
+    SphereTraits traits(0.1);
+    auto packing = make_line_packing(traits);
+    std::mt19937 mt(1234ul);
+    ParticleSweep sweep(ParticleSweep::Order::RANDOM, packing, {1, 3, 5});
+
+    for (std::size_t i{}; i < 100; i++) {
+        auto particleIdx = sweep.next(mt);
+        CHECK((particleIdx == 1 || particleIdx == 3 || particleIdx == 5));
+    }
+}
+
+TEST_CASE("ParticleSweep: sequential") {
+    SphereTraits traits(0.1);
+    auto packing = make_line_packing(traits);
+    std::mt19937 mt(1234ul);
+    ParticleSweep sweep(ParticleSweep::Order::SEQUENTIAL, packing, {6, 2, 4});
+
+    CHECK(do_sweep(sweep, mt, 7) == std::vector<std::size_t>{6, 2, 4, 6, 2, 4, 6});
+}
+
+TEST_CASE("ParticleSweep: spatial") {
+    SphereTraits traits(0.1);
+    auto packing = make_line_packing(traits);
+    std::mt19937 mt(1234ul);
+    ParticleSweep sweep(ParticleSweep::Order::SPATIAL, packing, {0, 1, 2, 3, 4, 5, 6, 7});
+
+    std::vector<std::size_t> expected{1, 5, 3, 6, 7, 0, 4, 2};
+    CHECK(do_sweep(sweep, mt, 8) == expected);
+
+    SECTION("order does not depend on the configuration in the next sweep") {
+        packing.tryTranslation(1, {3.7, 0, 0}, traits.getInteraction());    // x: 0.5 -> 4.2
+        packing.acceptTranslation();
+
+        CHECK(do_sweep(sweep, mt, 8) == expected);
+    }
+}
+
+TEST_CASE("ParticleSweep: shuffled blocks") {
+    SphereTraits traits(0.1);
+    auto packing = make_line_packing(traits);
+    std::mt19937 mt(1234ul);
+    ParticleSweep sweep(ParticleSweep::Order::SHUFFLED_BLOCKS, packing, {0, 1, 2, 3, 4, 5, 6, 7}, 3);
+
+    for (std::size_t sweepIdx{}; sweepIdx < 5; sweepIdx++) {
+        auto visited = do_sweep(sweep, mt, 8);
+
+        // Blocks of the spatial order: {1, 5, 3}, {6, 7, 0}, {4, 2} in any order
+        std::vector<std::vector<std::size_t>> blocks{{1, 5, 3}, {6, 7, 0}, {4, 2}};
+        std::size_t position{};
+        while (position < visited.size()) {
+            auto block = std::find_if(blocks.begin(), blocks.end(), [&](const auto &b) {
+                return b.front() == visited[position];
+            });
+            REQUIRE(block != blocks.end());
+            REQUIRE(position + block->size() <= visited.size());
+            CHECK(std::equal(block->begin(), block->end(), visited.begin() + static_cast<std::ptrdiff_t>(position)));
+            position += block->size();
+            blocks.erase(block);
+        }
+        CHECK(blocks.empty());
+    }
+}
+
+TEST_CASE("ParticleSweep: position is kept between calls") {
+    SphereTraits traits(0.1);
+    auto packing = make_line_packing(traits);
+    std::mt19937 mt(1234ul);
+    ParticleSweep sweep(ParticleSweep::Order::SEQUENTIAL, packing, {0, 1, 2, 3, 4});
+
+    // As in cycles with fewer moves than particles - the tail particles are also visited
+    CHECK(do_sweep(sweep, mt, 3) == std::vector<std::size_t>{0, 1, 2});
+    CHECK(do_sweep(sweep, mt, 3) == std::vector<std::size_t>{3, 4, 0});
+}
+
+TEST_CASE("ParticleSweep: subset") {
+    SphereTraits traits(0.1);
+    auto packing = make_line_packing(traits);
+    std::mt19937 mt(1234ul);
+    ParticleSweep sweep(ParticleSweep::Order::SPATIAL, packing, {0, 1, 2, 3, 4, 5, 6, 7});
+    ParticleSweep::SubsetBuffers buffers;
+
+    SECTION("particles are in the spatial order, starting from a random one") {
+        // Spatial order of the subset: 1, 3, 0, 2
+        std::vector<std::vector<std::size_t>> rotations{{1, 3, 0, 2}, {3, 0, 2, 1}, {0, 2, 1, 3}, {2, 1, 3, 0}};
+        std::vector<bool> rotationsFound(rotations.size(), false);
+        for (std::size_t i{}; i < 100; i++) {
+            auto subsetSweep = sweep.arrangeSubset({0, 1, 2, 3}, mt, buffers);
+            auto rotation = std::find(rotations.begin(), rotations.end(), subsetSweep);
+            REQUIRE(rotation != rotations.end());
+            rotationsFound[rotation - rotations.begin()] = true;
+        }
+        CHECK(std::all_of(rotationsFound.begin(), rotationsFound.end(), [](bool found) { return found; }));
+    }
+
+    SECTION("empty subset") {
+        sweep.arrangeSubset({0, 1}, mt, buffers);
+
+        CHECK(sweep.arrangeSubset({}, mt, buffers).empty());
+    }
+
+    SECTION("shuffled blocks with reused buffers") {
+        ParticleSweep blockSweep(ParticleSweep::Order::SHUFFLED_BLOCKS, packing, {0, 1, 2, 3, 4, 5, 6, 7}, 2);
+
+        // Each sweep visits all particles of a subset exactly once
+        for (auto subset : {std::vector<std::size_t>{0, 1, 2, 3, 4, 5}, std::vector<std::size_t>{6, 7, 0}}) {
+            auto subsetSweep = blockSweep.arrangeSubset(subset, mt, buffers);
+            std::sort(subset.begin(), subset.end());
+            std::sort(subsetSweep.begin(), subsetSweep.end());
+            CHECK(subsetSweep == subset);
+        }
+    }
+
+    SECTION("particle outside the sweep") {
+        ParticleSweep partialSweep(ParticleSweep::Order::SEQUENTIAL, packing, {0, 2, 4});
+
+        CHECK_THROWS(partialSweep.arrangeSubset({0, 1}, mt, buffers));
+        CHECK_THROWS(partialSweep.arrangeSubset({0, 6}, mt, buffers));
+    }
+}
@@ -0,0 +1,51 @@
+#include <catch2/catch.hpp>
+
+#include "core/StepSizeEfficiencyTuner.h"
+
+
+namespace {
+    using Direction = StepSizeEfficiencyTuner::Direction;
+}
+
+TEST_CASE("StepSizeEfficiencyTuner") {
+    StepSizeEfficiencyTuner tuner;
+
+    SECTION("first evaluation increases") {
+        CHECK(tuner.evaluate(1) == Direction::INCREASE);
+        CHECK(tuner.getLastEfficiency() == 1);
+    }
+
+    SECTION("growing efficiency keeps direction") {
+        CHECK(tuner.evaluate(1) == Direction::INCREASE);
+        CHECK(tuner.evaluate(2) == Direction::INCREASE);
+        CHECK(tuner.evaluate(3) == Direction::INCREASE);
+    }
+
+    SECTION("dropping efficiency reverses direction") {
+        CHECK(tuner.evaluate(1) == Direction::INCREASE);
+        CHECK(tuner.evaluate(2) == Direction::INCREASE);
+        CHECK(tuner.evaluate(1.5) == Direction::DECREASE);
+        CHECK(tuner.evaluate(1.8) == Direction::DECREASE);
+        CHECK(tuner.evaluate(1.7) == Direction::INCREASE);
+    }
+
+    SECTION("zero efficiency decreases") {
+        CHECK(tuner.evaluate(0) == Direction::DECREASE);
+        CHECK(tuner.evaluate(0) == Direction::DECREASE);
+        CHECK(tuner.evaluate(1) == Direction::DECREASE);
+    }
+
+    SECTION("aborted change reverses direction") {
+        CHECK(tuner.evaluate(1) == Direction::INCREASE);
+        tuner.notifyChangeAborted();
+        CHECK(tuner.evaluate(1) == Direction::DECREASE);
+    }
+
+    SECTION("reset") {
+        tuner.evaluate(0);
+        tuner.reset();
+
+        CHECK_FALSE(tuner.getLastEfficiency().has_value());
+        CHECK(tuner.evaluate(1) == Direction::INCREASE);
+    }
+}
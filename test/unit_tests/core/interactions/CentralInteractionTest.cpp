@@ -14,6 +14,16 @@ namespace {
             return std::sqrt(distance2);
         }
     };
+
+    class RangedDummyInteraction : public CentralInteraction {
+    protected:
+        [[nodiscard]] double calculateEnergyForDistance2(double distance2) const override {
+            return 1 / distance2 - 1 / 4.;
+        }
+
+    public:
+        [[nodiscard]] double getRangeRadius() const override { return 2; }
+    };
 }
 
 TEST_CASE("CentralInteraction: basics") {
@@ -49,4 +59,43 @@ TEST_CASE("CentralInteraction: calculating energy") {
     PeriodicBoundaryConditions pbc(10);
 
     CHECK(interaction.calculateEnergyBetweenShapes(shape1, shape2, pbc) == Approx(2));
-}
\ No newline at end of file
+}
+
+TEST_CASE("CentralInteraction: tabulation") {
+    RangedDummyInteraction interaction;
+    REQUIRE(interaction.getPotentialTable() == nullptr);
+    REQUIRE_FALSE(interaction.getTabulationAccuracy().has_value());
+
+    auto accuracy = interaction.tabulate(0.5, 500, PotentialTable::Interpolation::CUBIC_SPLINE);
+
+    REQUIRE(interaction.getPotentialTable() != nullptr);
+    CHECK(interaction.getPotentialTable()->getMinDistance2() == Approx(0.25));
+    CHECK(interaction.getPotentialTable()->getMaxDistance2() == Approx(4));
+    CHECK(accuracy.maxAbsoluteError < 1e-5);
+    CHECK(accuracy.maxErrorDistance >= 0.5);
+    CHECK(accuracy.maxErrorDistance <= 2);
+    REQUIRE(interaction.getTabulationAccuracy().has_value());
+    CHECK(interaction.getTabulationAccuracy()->maxAbsoluteError == accuracy.maxAbsoluteError);
+    CHECK(interaction.getTabulationAccuracy()->maxErrorDistance == accuracy.maxErrorDistance);
+
+    SECTION("energy between shapes") {
+        interaction.installOnSphere();
+        Shape shape1({1, 5, 5});
+        Shape shape2({9.5, 5, 5});
+        PeriodicBoundaryConditions pbc(10);
+
+        CHECK(interaction.calculateEnergyBetweenShapes(shape1, shape2, pbc) == Approx(1 / 2.25 - 1 / 4.).margin(1e-5));
+    }
+}
+
+TEST_CASE("CentralInteraction: tabulation errors") {
+    SECTION("infinite range") {
+        DummyInteraction interaction;
+        CHECK_THROWS(interaction.tabulate(0.5, 100, PotentialTable::Interpolation::LINEAR));
+    }
+
+    SECTION("minimal distance beyond range") {
+        RangedDummyInteraction interaction;
+        CHECK_THROWS(interaction.tabulate(2.5, 100, PotentialTable::Interpolation::LINEAR));
+    }
+}
@@ -13,4 +13,18 @@ TEST_CASE("LennardJonesInteraction") {
     FreeBoundaryConditions fbc;
 
     CHECK(interaction.calculateEnergyBetweenShapes(shape1, shape2, fbc) == Approx(-0.1845703125000000));
-}
\ No newline at end of file
+}
+
+TEST_CASE("LennardJonesInteraction: tabulation") {
+    LennardJonesInteraction interaction(1, 1);
+    FreeBoundaryConditions fbc;
+    Shape shape1({0, 0, 0});
+
+    auto accuracy = interaction.tabulate(0.8, 1000, PotentialTable::Interpolation::CUBIC_SPLINE);
+
+    CHECK(accuracy.maxAbsoluteError < 1e-3);
+    // Within the table (near the minimum) and below it
+    CHECK(interaction.calculateEnergyBetweenShapes(shape1, Shape({1.12246204830937, 0, 0}), fbc)
+          == Approx(-1).margin(1e-3));
+    CHECK(interaction.calculateEnergyBetweenShapes(shape1, Shape({0.7, 0, 0}), fbc) == Approx(254.991024226779));
+}
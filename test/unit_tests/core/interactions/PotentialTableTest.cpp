@@ -0,0 +1,84 @@
+#include <catch2/catch.hpp>
+#include <cmath>
+
+#include "core/interactions/PotentialTable.h"
+
+
+namespace {
+    std::vector<double> tabulate(double (*function)(double), double min, double max, std::size_t numNodes) {
+        std::vector<double> values(numNodes);
+        double step = (max - min) / static_cast<double>(numNodes - 1);
+        for (std::size_t i{}; i < numNodes; i++)
+            values[i] = function(min + step * static_cast<double>(i));
+        return values;
+    }
+
+    double linear(double x) { return 3*x - 2; }
+    double cubic(double x) { return x*x*x - 2*x*x + x - 1; }
+    double smooth(double x) { return std::exp(-x) * std::cos(3*x); }
+}
+
+TEST_CASE("PotentialTable: linear interpolation") {
+    PotentialTable table(1, 3, tabulate(linear, 1, 3, 5), PotentialTable::Interpolation::LINEAR);
+
+    CHECK(table.getNumNodes() == 5);
+    CHECK(table.getMinDistance2() == 1);
+    CHECK(table.getMaxDistance2() == 3);
+    CHECK(table.getInterpolation() == PotentialTable::Interpolation::LINEAR);
+    CHECK(table.evaluate(1) == Approx(linear(1)));
+    CHECK(table.evaluate(1.3) == Approx(linear(1.3)));
+    CHECK(table.evaluate(2.5) == Approx(linear(2.5)));
+    CHECK(table.evaluate(3) == Approx(linear(3)));
+}
+
+TEST_CASE("PotentialTable: cubic spline") {
+    SECTION("cubic polynomial is reproduced exactly (not-a-knot conditions)") {
+        PotentialTable table(0, 2, tabulate(cubic, 0, 2, 9), PotentialTable::Interpolation::CUBIC_SPLINE);
+
+        for (double x : {0., 0.1, 0.55, 1., 1.37, 1.99, 2.})
+            CHECK(table.evaluate(x) == Approx(cubic(x)).margin(1e-12));
+    }
+
+    SECTION("smooth function - values in nodes are exact and the error decreases as h^4") {
+        auto nodeValues = tabulate(smooth, 0, 2, 21);
+        PotentialTable coarse(0, 2, nodeValues, PotentialTable::Interpolation::CUBIC_SPLINE);
+        PotentialTable fine(0, 2, tabulate(smooth, 0, 2, 41), PotentialTable::Interpolation::CUBIC_SPLINE);
+
+        for (std::size_t i{}; i < nodeValues.size(); i++)
+            CHECK(coarse.evaluate(0.1 * static_cast<double>(i)) == Approx(nodeValues[i]).margin(1e-12));
+        double coarseError{}, fineError{};
+        for (double x = 0.0125; x < 2; x += 0.025) {
+            coarseError = std::max(coarseError, std::abs(coarse.evaluate(x) - smooth(x)));
+            fineError = std::max(fineError, std::abs(fine.evaluate(x) - smooth(x)));
+        }
+        CHECK(coarseError < 1e-4);
+        CHECK(coarseError / fineError > 10);
+    }
+
+    SECTION("3 nodes (natural conditions)") {
+        PotentialTable table(0, 2, {0, 1, 0}, PotentialTable::Interpolation::CUBIC_SPLINE);
+
+        CHECK(table.evaluate(0) == Approx(0).margin(1e-12));
+        CHECK(table.evaluate(1) == Approx(1));
+        CHECK(table.evaluate(2) == Approx(0).margin(1e-12));
+        CHECK(table.evaluate(0.5) == Approx(table.evaluate(1.5)));
+    }
+}
+
+TEST_CASE("PotentialTable: batch evaluation") {
+    auto interpolation = GENERATE(PotentialTable::Interpolation::LINEAR, PotentialTable::Interpolation::CUBIC_SPLINE);
+    PotentialTable table(0.5, 2.5, tabulate(smooth, 0.5, 2.5, 30), interpolation);
+    std::vector<double> distances2{0.5, 2.5, 1.7, 0.83, 2.1, 1.0, 2.49, 0.6, 1.2};
+    std::vector<double> energies(distances2.size());
+
+    table.evaluate(distances2.data(), energies.data(), distances2.size());
+
+    for (std::size_t i{}; i < distances2.size(); i++)
+        CHECK(energies[i] == Approx(table.evaluate(distances2[i])));
+}
+
+TEST_CASE("PotentialTable: errors") {
+    CHECK_THROWS(PotentialTable(1, 1, {1, 2}, PotentialTable::Interpolation::LINEAR));
+    CHECK_THROWS(PotentialTable(-1, 1, {1, 2}, PotentialTable::Interpolation::LINEAR));
+    CHECK_THROWS(PotentialTable(0, 1, {1}, PotentialTable::Interpolation::LINEAR));
+}
@@ -0,0 +1,51 @@
+#include <catch2/catch.hpp>
+#include <sstream>
+
+#include "core/interactions/TabulatedInteraction.h"
+#include "core/FreeBoundaryConditions.h"
+#include "utils/Exceptions.h"
+
+
+TEST_CASE("TabulatedInteraction") {
+    // Energies tabulated for r^2 = 1, 2, 3, 4
+    TabulatedInteraction interaction(1, 2, {3, 2, 1, 0}, PotentialTable::Interpolation::LINEAR);
+    FreeBoundaryConditions fbc;
+    Shape shape1({0, 0, 0});
+
+    CHECK(interaction.getRangeRadius() == Approx(2));
+    // Below the table, the energy grows with the slope of the first interval
+    CHECK(interaction.calculateEnergyBetweenShapes(shape1, Shape({0, 0, 0}), fbc) == Approx(4));
+    CHECK(interaction.calculateEnergyBetweenShapes(shape1, Shape({0.5, 0, 0}), fbc) == Approx(3.75));
+    CHECK(interaction.calculateEnergyBetweenShapes(shape1, Shape({1, 0, 0}), fbc) == Approx(3));
+    CHECK(interaction.calculateEnergyBetweenShapes(shape1, Shape({0, 1.5, 0}), fbc) == Approx(4 - 2.25));
+    CHECK(interaction.calculateEnergyBetweenShapes(shape1, Shape({0, 0, 2}), fbc) == Approx(0).margin(1e-12));
+    CHECK(interaction.calculateEnergyBetweenShapes(shape1, Shape({0, 0, 2.5}), fbc) == 0);
+}
+
+TEST_CASE("TabulatedInteraction: reading energies") {
+    SECTION("correct") {
+        std::istringstream in(R"(# r^2 from 1 to 4
+3 2.5
+
+  # comment
+2 1e-1
+)");
+
+        CHECK(TabulatedInteraction::readEnergies(in) == std::vector<double>{3, 2.5, 2, 0.1});
+    }
+
+    SECTION("malformed") {
+        std::istringstream in("3 2\n1 abc\n");
+
+        CHECK_THROWS_AS(TabulatedInteraction::readEnergies(in), ValidationException);
+    }
+}
+
+TEST_CASE("TabulatedInteraction: non-zero energy at the cutoff") {
+    CHECK_THROWS(TabulatedInteraction(1, 2, {3, 2, 1, 0.5}, PotentialTable::Interpolation::LINEAR));
+}
+
+TEST_CASE("TabulatedInteraction: non-repulsive first node") {
+    CHECK_THROWS(TabulatedInteraction(1, 2, {1, 2, 1, 0}, PotentialTable::Interpolation::LINEAR));
+    CHECK_THROWS(TabulatedInteraction(1, 2, {2, 2, 1, 0}, PotentialTable::Interpolation::LINEAR));
+}
@@ -93,6 +93,48 @@ TEST_CASE("Lattice: operations") {
             CHECK_THROWS(lattice.getUnitCellMolecules());
             CHECK_THROWS(lattice.modifyUnitCellMolecules());
         }
+
+        SECTION("generating shapes in a given axis order") {
+            // y is the outermost loop and x the innermost one; the last shape is cut off
+            auto shapes = lattice.generateMolecules({1, 2, 0}, 10);
+            std::vector<Vector<3>> pos;
+            std::transform(shapes.begin(), shapes.end(), std::back_inserter(pos), [](const auto &shape) {
+                return shape.getPosition();
+            });
+
+            auto expected = std::vector<Vector<3>>{
+                {0.25, 1.0, 2.25}, {1, 0.5, 1.5}, {1.25, 1.0, 2.25},
+                {0.5, 3.0, 1.5}, {0.25, 3.0, 2.25}, {1, 2.5, 1.5}, {1.25, 3.0, 2.25},
+                {0, 4.5, 1.5}, {0.25, 5.0, 2.25}, {1, 4.5, 1.5}
+            };
+            CHECK(pos == expected);
+        }
+    }
+
+    SECTION("making irregular") {
+        lattice.makeIrregular();
+
+        CHECK_FALSE(lattice.isRegular());
+        CHECK(lattice.size() == 12);
+        CHECK(lattice.getSpecificCellMolecules(1, 2, 0) == molecules);
+        CHECK(lattice.getSpecificCell(1, 2, 0).getBox() == cellBox);
+    }
+
+    SECTION("modifying each molecule") {
+        auto shapesBefore = lattice.generateMolecules();
+        std::vector<std::size_t> visitedIdxs(lattice.size());
+
+        lattice.forEachMolecule([&visitedIdxs](Shape &shape, std::size_t moleculeIdx) {
+            shape.setPosition(shape.getPosition() + Vector<3>{0.5, 0, 0});
+            visitedIdxs[moleculeIdx]++;
+        });
+
+        CHECK_FALSE(lattice.isRegular());
+        CHECK(std::all_of(visitedIdxs.begin(), visitedIdxs.end(), [](std::size_t count) { return count == 1; }));
+        auto shapesAfter = lattice.generateMolecules();
+        REQUIRE(shapesAfter.size() == shapesBefore.size());
+        for (std::size_t i{}; i < shapesBefore.size(); i++)
+            CHECK(shapesAfter[i].getPosition() == shapesBefore[i].getPosition() + Vector<3>{0.5, 0, 0});
     }
 }
 
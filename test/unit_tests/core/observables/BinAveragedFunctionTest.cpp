@@ -42,6 +42,7 @@ TEST_CASE("BinAveragedFunction") {
     ALLOW_CALL(*mockShapeFunction, calculate(std::ref(packing[3]), _)).LR_SIDE_EFFECT(functionValue = 5);
     ALLOW_CALL(*mockShapeFunction, getValues()).LR_RETURN(std::vector<double>{functionValue});
     ALLOW_CALL(*mockShapeFunction, getPrimaryName()).RETURN("func");
+    ALLOW_CALL(*mockShapeFunction, getNames()).RETURN(std::vector<std::string>{"func"});
 
     auto densityFunction = std::make_shared<ConstantShapeFunction>();
     auto tracker = std::make_unique<FourierTracker>(std::array<std::size_t, 3>{1, 0, 0}, densityFunction);
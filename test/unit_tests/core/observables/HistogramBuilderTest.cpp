@@ -4,6 +4,7 @@
 
 #include <catch2/catch.hpp>
 #include <valarray>
+#include <random>
 
 #include "core/observables/HistogramBuilder.h"
 #include "utils/OMPMacros.h"
@@ -175,6 +176,172 @@ TEST_CASE("Histogram 1D: renormalization") {
     CHECK(values == std::vector<Histogram1D::BinValue>{{1.5, 8, 1}, {2.5, 33, 2}});
 }
 
+TEST_CASE("Histogram: tiled storage") {
+    // Bins: { [0, 1), ..., [99, 100] } X { [0, 1), ..., [99, 100] } - 3 tiles, the last one partial
+    HistogramBuilder<2> tiled({0, 0}, {100, 100}, {100, 100}, 1, 0, HistogramStorage::TILED);
+    HistogramBuilder<2> dense({0, 0}, {100, 100}, {100, 100}, 1, 0, HistogramStorage::DENSE);
+    REQUIRE(tiled.isTiled());
+    REQUIRE_FALSE(dense.isTiled());
+    auto addToBoth = [&](const Vector<2> &pos, double value) {
+        tiled.add(pos, value);
+        dense.add(pos, value);
+    };
+
+    addToBoth({0.5, 0.5}, 1);
+    addToBoth({0.5, 0.7}, 2);
+    addToBoth({50.5, 20.5}, 3);
+    addToBoth({100, 100}, 4);
+    tiled.nextSnapshot();
+    dense.nextSnapshot();
+    addToBoth({99.5, 99.5}, 5);
+    addToBoth({40, 0}, 6);
+    tiled.nextSnapshot();
+    dense.nextSnapshot();
+
+    SECTION("sum reduction") {
+        auto tiledValues = tiled.dumpValues(ReductionMethod::SUM);
+        auto denseValues = dense.dumpValues(ReductionMethod::SUM);
+
+        CHECK(tiledValues == denseValues);
+        CHECK(tiledValues[0] == Histogram2D::BinValue{{0.5, 0.5}, 1.5, 2});
+        CHECK(tiledValues.back() == Histogram2D::BinValue{{99.5, 99.5}, 4.5, 2});
+    }
+
+    SECTION("average reduction") {
+        auto values = tiled.dumpValues(ReductionMethod::AVERAGE);
+
+        CHECK(values[0] == Histogram2D::BinValue{{0.5, 0.5}, 1.5, 2});
+        CHECK(values[4000] == Histogram2D::BinValue{{40.5, 0.5}, 6, 1});
+        CHECK(values.back() == Histogram2D::BinValue{{99.5, 99.5}, 4.5, 2});
+    }
+
+    SECTION("clearing") {
+        tiled.clear();
+        tiled.add({0.5, 0.5}, 7);
+        tiled.nextSnapshot();
+
+        auto values = tiled.dumpValues(ReductionMethod::SUM);
+        CHECK(values[0] == Histogram2D::BinValue{{0.5, 0.5}, 7, 1});
+        CHECK(values[5020] == Histogram2D::BinValue{{50.5, 20.5}, 0, 0});
+    }
+
+    SECTION("errors") {
+        CHECK_THROWS(tiled.add({-0.1, 5}, 5));
+        CHECK_THROWS(tiled.add({5, 100.1}, 5));
+    }
+}
+
+TEST_CASE("Histogram: automatic storage") {
+    using ValarrayBuilder = HistogramBuilder<1, std::valarray<double>>;
+    std::size_t tiledNumBins = HistogramBuilder<1>::AUTO_TILED_STORAGE_THRESHOLD;
+    std::size_t atomicNumBins = HistogramBuilder<1>::AUTO_ATOMIC_STORAGE_THRESHOLD;
+    std::valarray<double> valarray(0.0, 2);
+
+    CHECK(HistogramBuilder<1>(0, 1, tiledNumBins, 1, 0, HistogramStorage::AUTO).isTiled());
+    CHECK(HistogramBuilder<1>(0, 1, tiledNumBins / 2, 2, 0, HistogramStorage::AUTO).isTiled());
+    CHECK_FALSE(HistogramBuilder<1>(0, 1, tiledNumBins / 2, 1, 0, HistogramStorage::AUTO).isTiled());
+    CHECK(ValarrayBuilder(0, 1, tiledNumBins / 2, 2, valarray, HistogramStorage::AUTO).isTiled());
+
+    CHECK(HistogramBuilder<1>(0, 1, atomicNumBins / 2, 2, 0, HistogramStorage::AUTO).isAtomic());
+    CHECK(HistogramBuilder<1>(0, 1, tiledNumBins / 2 - 1, 2, 0, HistogramStorage::AUTO).isAtomic());
+    CHECK_FALSE(HistogramBuilder<1>(0, 1, tiledNumBins / 2, 2, 0, HistogramStorage::AUTO).isAtomic());
+    CHECK_FALSE(HistogramBuilder<1>(0, 1, atomicNumBins / 2 - 1, 2, 0, HistogramStorage::AUTO).isAtomic());
+    CHECK_FALSE(HistogramBuilder<1>(0, 1, atomicNumBins, 1, 0, HistogramStorage::AUTO).isAtomic());
+    CHECK_FALSE(ValarrayBuilder(0, 1, atomicNumBins / 2, 2, valarray, HistogramStorage::AUTO).isAtomic());
+}
+
+TEST_CASE("Histogram: atomic storage") {
+    using ValarrayBuilder = HistogramBuilder<1, std::valarray<double>>;
+
+    CHECK_THROWS(ValarrayBuilder(0, 1, 2, 2, std::valarray<double>(0.0, 2), HistogramStorage::ATOMIC));
+
+    // The same as in "Histogram 1D: reduction methods"
+    HistogramBuilder<1> histogram(1, 3, 2, 1, 0, HistogramStorage::ATOMIC);
+    REQUIRE(histogram.isAtomic());
+    histogram.add(1.1, 2);
+    histogram.add(2.1, 4);
+    histogram.add(2.9, 5);
+    histogram.nextSnapshot();
+    histogram.add(1.9, 6);
+    histogram.add(2.5, 15);
+    histogram.renormalizeBins({1, 1});
+    histogram.nextSnapshot();
+
+    auto values = histogram.dumpValues(ReductionMethod::SUM);
+
+    CHECK(values == std::vector<Histogram1D::BinValue>{{1.5, 4, 2}, {2.5, 12, 3}});
+}
+
+#ifdef _OPENMP
+TEST_CASE("Histogram: all storages with OpenMP") {
+    // Results of parallel storages are compared with a single-threaded dense histogram. Values are integers, so that
+    // the result does not depend on the order of summation
+    std::vector<Vector<2>> positions;
+    std::vector<double> values;
+    std::mt19937 mt(1234);
+    std::uniform_real_distribution<double> posDistribution(0, 1);
+    std::uniform_int_distribution<int> valueDistribution(-10, 10);
+    for (std::size_t i{}; i < 20000; i++) {
+        positions.push_back({posDistribution(mt), posDistribution(mt)});
+        values.push_back(valueDistribution(mt));
+    }
+
+    auto fillHistogram = [&](HistogramBuilder<2> &histogram, int numThreads) {
+        for (std::size_t snapshot{}; snapshot < 2; snapshot++) {
+            #pragma omp parallel for num_threads(numThreads) shared(histogram, positions, values, snapshot) \
+                    default(none)
+            for (std::size_t i = 0; i < positions.size() / 2; i++) {
+                std::size_t idx = snapshot * (positions.size() / 2) + i;
+                histogram.add(positions[idx], values[idx]);
+            }
+            histogram.nextSnapshot();
+        }
+    };
+
+    HistogramBuilder<2> reference({0, 0}, {1, 1}, {150, 150}, 1, 0, HistogramStorage::DENSE);
+    fillHistogram(reference, 1);
+    auto storage = GENERATE(HistogramStorage::DENSE, HistogramStorage::TILED, HistogramStorage::ATOMIC,
+                            HistogramStorage::AUTO);
+    HistogramBuilder<2> histogram({0, 0}, {1, 1}, {150, 150}, 4, 0, storage);
+
+    fillHistogram(histogram, 4);
+
+    CHECK(histogram.dumpValues(ReductionMethod::SUM) == reference.dumpValues(ReductionMethod::SUM));
+}
+
+TEST_CASE("Histogram: tiled storage with OpenMP") {
+    HistogramBuilder<1> histogram(0, 10000, 10000, 4, 0, HistogramStorage::TILED);
+
+    for (std::size_t snapshot{}; snapshot < 2; snapshot++) {
+        #pragma omp parallel for num_threads(4) shared(histogram) default(none)
+        for (std::size_t i = 0; i < 10000; i++)
+            histogram.add(static_cast<double>(i) + 0.5, static_cast<double>(i));
+        histogram.nextSnapshot();
+    }
+
+    auto values = histogram.dumpValues(ReductionMethod::SUM);
+    REQUIRE(values.size() == 10000);
+    for (std::size_t i{}; i < 10000; i++) {
+        CHECK(values[i].value == static_cast<double>(i));
+        CHECK(values[i].count == 2);
+    }
+}
+#endif // _OPENMP
+
+TEST_CASE("Histogram 1D: tiled renormalization") {
+    HistogramBuilder<1> histogram(1, 3, 2, 1, 0, HistogramStorage::TILED);
+
+    histogram.add(1.5, 4);
+    histogram.add(2.5, 5);
+    histogram.add(2.5, 6);
+    histogram.renormalizeBins({2, 3});
+    histogram.nextSnapshot();
+
+    auto values = histogram.dumpValues(ReductionMethod::SUM);
+
+    CHECK(values == std::vector<Histogram1D::BinValue>{{1.5, 8, 1}, {2.5, 33, 2}});
+}
+
 TEST_CASE("Histogram: non-trivial initial value") {
     HistogramBuilder<1, std::valarray<double>> histogram(0, 1, 2, 1, std::valarray<double>(0.0, 2));
 
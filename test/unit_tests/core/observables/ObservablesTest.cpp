@@ -126,6 +126,40 @@ TEST_CASE("Observables") {
         }
     }
 
+    SECTION("incremental observables") {
+        NematicOrder nematicOrder(true);
+        EnergyPerParticle energyPerParticle;
+        packing.attachListener(nematicOrder);
+        packing.attachListener(energyPerParticle);
+        nematicOrder.calculate(packing, 1, 1, mockShapeTraits);
+        energyPerParticle.calculate(packing, 1, 1, mockShapeTraits);
+        const auto &interaction = mockShapeTraits.getInteraction();
+
+        static_cast<void>(packing.tryMove(0, {0.1, 0.2, 0.3}, Matrix<3, 3>::rotation(0.1, 0.2, 0.3), interaction));
+        packing.acceptMove();
+        static_cast<void>(packing.tryRotation(2, Matrix<3, 3>::rotation(0.3, 0.2, 0.1), interaction));
+        packing.acceptRotation();
+        static_cast<void>(packing.tryScaling(1.1, interaction));
+        nematicOrder.calculate(packing, 1, 1, mockShapeTraits);
+        energyPerParticle.calculate(packing, 1, 1, mockShapeTraits);
+
+        // Not attached to the packing, so calculated from scratch
+        NematicOrder expectedNematicOrder(true);
+        EnergyPerParticle expectedEnergyPerParticle;
+        expectedNematicOrder.calculate(packing, 1, 1, mockShapeTraits);
+        expectedEnergyPerParticle.calculate(packing, 1, 1, mockShapeTraits);
+        auto nematicOrderValues = nematicOrder.getIntervalValues();
+        auto expectedNematicOrderValues = expectedNematicOrder.getIntervalValues();
+        REQUIRE(nematicOrderValues.size() == expectedNematicOrderValues.size());
+        for (std::size_t i{}; i < nematicOrderValues.size(); i++)
+            CHECK(nematicOrderValues[i] == Approx(expectedNematicOrderValues[i]));
+        CHECK(energyPerParticle.getIntervalValues().front()
+              == Approx(expectedEnergyPerParticle.getIntervalValues().front()));
+
+        packing.detachListener(nematicOrder);
+        packing.detachListener(energyPerParticle);
+    }
+
     SECTION("NumberDensity") {
         NumberDensity numberDensity;
 
@@ -0,0 +1,46 @@
+#include <catch2/catch.hpp>
+
+#include "PairCollector.h"
+
+#include "core/observables/correlation/CompoundPairConsumer.h"
+#include "core/shapes/SphereTraits.h"
+#include "core/PeriodicBoundaryConditions.h"
+
+
+namespace {
+    class NullPairConsumer : public PairConsumer {
+    public:
+        explicit NullPairConsumer(std::size_t numThreads) : PairConsumer(numThreads) { }
+
+        void consumePair([[maybe_unused]] const Packing &packing,
+                         [[maybe_unused]] const std::pair<std::size_t, std::size_t> &idxPair,
+                         [[maybe_unused]] const Vector<3> &distanceVector,
+                         [[maybe_unused]] const ShapeTraits &shapeTraits) override
+        { }
+    };
+}
+
+TEST_CASE("CompoundPairConsumer") {
+    SphereTraits traits(0.5);
+    Packing packing(TriclinicBox(5), {Shape({1, 1, 1}), Shape({2, 2, 2})},
+                    std::make_unique<PeriodicBoundaryConditions>(), traits.getInteraction());
+
+    SECTION("consuming pairs") {
+        PairCollector collector1, collector2;
+        CompoundPairConsumer consumer({&collector1, &collector2});
+
+        consumer.consumePair(packing, {0, 1}, {1, 1, 1}, traits);
+        consumer.consumePair(packing, {1, 1}, {0, 0, 0}, traits);
+
+        PairCollector::PairMap expected{{{0, 1}, {1, 1, 1}}, {{1, 1}, {0, 0, 0}}};
+        CHECK(collector1.pairData == expected);
+        CHECK(collector2.pairData == expected);
+    }
+
+    SECTION("max threads") {
+        NullPairConsumer consumer1(4), consumer2(2), consumer3(3);
+        CompoundPairConsumer consumer({&consumer1, &consumer2, &consumer3});
+
+        CHECK(consumer.getMaxThreads() == 2);
+    }
+}
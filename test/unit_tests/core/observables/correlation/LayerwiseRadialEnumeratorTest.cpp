@@ -10,6 +10,7 @@
 #include "PairCollector.h"
 
 #include "core/observables/correlation/LayerwiseRadialEnumerator.h"
+#include "core/observables/correlation/RadialEnumerator.h"
 #include "core/PeriodicBoundaryConditions.h"
 
 
@@ -70,4 +71,11 @@ TEST_CASE("LayerwiseRadialEnumerator") {
     SECTION("signature name") {
         CHECK(enumerator.getSignatureName() == "lr");
     }
+
+    SECTION("equivalence") {
+        CHECK(enumerator.isEquivalent(LayerwiseRadialEnumerator({1, -2, 0}, "o")));
+        CHECK_FALSE(enumerator.isEquivalent(LayerwiseRadialEnumerator({1, 2, 0}, "o")));
+        CHECK_FALSE(enumerator.isEquivalent(LayerwiseRadialEnumerator({1, -2, 0}, "cm")));
+        CHECK_FALSE(enumerator.isEquivalent(RadialEnumerator("o")));
+    }
 }
\ No newline at end of file
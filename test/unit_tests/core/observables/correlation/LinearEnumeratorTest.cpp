@@ -64,4 +64,10 @@ TEST_CASE("LinearEnumerator") {
     SECTION("signature name") {
         CHECK(enumerator.getSignatureName() == "y");
     }
+
+    SECTION("equivalence") {
+        CHECK(enumerator.isEquivalent(LinearEnumerator(LinearEnumerator::Axis::Y, "o")));
+        CHECK_FALSE(enumerator.isEquivalent(LinearEnumerator(LinearEnumerator::Axis::X, "o")));
+        CHECK_FALSE(enumerator.isEquivalent(LinearEnumerator(LinearEnumerator::Axis::Y, "cm")));
+    }
 }
\ No newline at end of file
@@ -58,4 +58,9 @@ TEST_CASE("RadialEnumerator") {
     SECTION("signature name") {
         CHECK(enumerator.getSignatureName() == "r");
     }
+
+    SECTION("equivalence") {
+        CHECK(enumerator.isEquivalent(RadialEnumerator("o")));
+        CHECK_FALSE(enumerator.isEquivalent(RadialEnumerator("cm")));
+    }
 }
\ No newline at end of file
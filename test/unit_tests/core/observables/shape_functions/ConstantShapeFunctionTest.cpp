@@ -28,4 +28,15 @@ TEST_CASE("ConstantShapeFunction") {
 
         CHECK(constantShapeFunction.getValues() == std::vector<double>{3});
     }
+
+    SECTION("batch calculation") {
+        ConstantShapeFunction constantShapeFunction(3);
+        std::vector<Shape> shapes(100, shape);
+        std::vector<double> values;
+
+        constantShapeFunction.calculateBatchConcurrently(shapes.begin(), shapes.end(), traits, values, 4);
+
+        CHECK(constantShapeFunction.isStateless());
+        CHECK(values == std::vector<double>(100, 3));
+    }
 }
\ No newline at end of file
@@ -39,4 +39,15 @@ TEST_CASE("ShapeAxisCoordinate") {
 
         CHECK_THAT(shapeAxisCoordinate.getValues(), Catch::Matchers::Approx(std::vector<double>{1}));
     }
+
+    SECTION("batch calculation") {
+        ShapeAxisCoordinate shapeAxisCoordinate(ShapeGeometry::Axis::SECONDARY, 0);
+        std::vector<Shape> shapes{shape, Shape{}, shape};
+        std::vector<double> values;
+
+        shapeAxisCoordinate.calculateBatchConcurrently(shapes.begin(), shapes.end(), traits, values);
+
+        CHECK(shapeAxisCoordinate.isStateless());
+        CHECK_THAT(values, Catch::Matchers::Approx(std::vector<double>{-M_SQRT1_2, 0, -M_SQRT1_2}));
+    }
 }
\ No newline at end of file
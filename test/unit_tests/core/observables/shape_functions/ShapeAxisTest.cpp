@@ -49,4 +49,17 @@ TEST_CASE("ShapeAxis") {
         std::vector<std::string> expected = {"x", "y", "z"};
         CHECK(ShapeAxis(ShapeGeometry::Axis::PRIMARY).getNames() == expected);
     }
+
+    SECTION("batch calculation") {
+        ShapeAxis shapeAxis(ShapeGeometry::Axis::PRIMARY);
+        std::vector<Shape> shapes{shape, Shape{}};
+        std::vector<double> values;
+
+        shapeAxis.calculateBatchConcurrently(shapes.begin(), shapes.end(), traits, values);
+
+        // Columns x, y, z; Shape{} has the identity orientation
+        CHECK(shapeAxis.isStateless());
+        CHECK(shapeAxis.getNumValues() == 3);
+        CHECK_THAT(values, Catch::Matchers::Approx(vd{2./3, 1, 2./3, 0, -1./3, 0}));
+    }
 }
\ No newline at end of file
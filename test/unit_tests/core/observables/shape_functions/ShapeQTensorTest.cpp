@@ -49,4 +49,17 @@ TEST_CASE("ShapeQTensor") {
         std::vector<std::string> expected = {"xx", "xy", "xz", "yy", "yz", "zz"};
         CHECK(ShapeQTensor(ShapeGeometry::Axis::PRIMARY).getNames() == expected);
     }
+
+    SECTION("batch calculation") {
+        ShapeQTensor shapeQTensor(ShapeGeometry::Axis::PRIMARY);
+        std::vector<Shape> shapes{shape, Shape{}};
+        std::vector<double> values;
+
+        shapeQTensor.calculateBatchConcurrently(shapes.begin(), shapes.end(), traits, values);
+
+        // Columns xx, xy, xz, yy, yz, zz; Shape{} has the identity orientation
+        CHECK(shapeQTensor.isStateless());
+        CHECK(shapeQTensor.getNumValues() == 6);
+        CHECK_THAT(values, Catch::Matchers::Approx(vd{1./6, 1, 2./3, 0, -1./3, 0, 1./6, -0.5, -1./3, 0, -1./3, -0.5}));
+    }
 }
\ No newline at end of file
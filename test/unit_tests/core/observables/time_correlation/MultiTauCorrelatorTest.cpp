@@ -0,0 +1,74 @@
+#include <catch2/catch.hpp>
+#include <random>
+
+#include "core/observables/time_correlation/MultiTauCorrelator.h"
+
+
+TEST_CASE("MultiTauCorrelator: lag layout") {
+    MultiTauCorrelator correlator(1, MultiTauCorrelator::Mode::PRODUCT, 8, 2);
+    for (std::size_t i{}; i < 64; i++)
+        correlator.addSample({1});
+
+    auto correlation = correlator.getCorrelation();
+
+    std::vector<std::size_t> lags;
+    for (const auto &point : correlation)
+        lags.push_back(point.lag);
+    std::vector<std::size_t> expectedLags{0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 14, 16, 20, 24, 28, 32, 40, 48, 56};
+    CHECK(lags == expectedLags);
+    CHECK(correlator.getNumSamples() == 64);
+    // 64 samples give 64 - lag time origins on level 0 and 32 - 4 on level 1
+    CHECK(correlation[0].count == 64);
+    CHECK(correlation[7].count == 57);
+    CHECK(correlation[8].count == 28);
+    for (const auto &point : correlation)
+        CHECK(point.value == Approx(1));
+}
+
+TEST_CASE("MultiTauCorrelator: product agrees with direct calculation for small lags") {
+    std::mt19937 mt(1234);
+    std::normal_distribution<double> distribution;
+    std::size_t numSamples = 200;
+    std::vector<std::vector<double>> samples(numSamples, std::vector<double>(3));
+    for (auto &sample : samples)
+        for (auto &value : sample)
+            value = distribution(mt);
+
+    MultiTauCorrelator correlator(3, MultiTauCorrelator::Mode::PRODUCT, 16);
+    for (const auto &sample : samples)
+        correlator.addSample(sample);
+
+    auto correlation = correlator.getCorrelation();
+    REQUIRE(correlation.size() >= 16);
+    for (std::size_t lag{}; lag < 16; lag++) {
+        double expected{};
+        for (std::size_t t{}; t + lag < numSamples; t++)
+            for (std::size_t channel{}; channel < 3; channel++)
+                expected += samples[t][channel] * samples[t + lag][channel];
+        expected /= static_cast<double>(3 * (numSamples - lag));
+
+        CHECK(correlation[lag].lag == lag);
+        CHECK(correlation[lag].value == Approx(expected));
+    }
+}
+
+TEST_CASE("MultiTauCorrelator: squared difference of linear signal") {
+    // Block averages of a linear signal are linear with the same slope, so all levels are exact
+    MultiTauCorrelator correlator(2, MultiTauCorrelator::Mode::SQUARED_DIFFERENCE, 4, 2);
+    for (std::size_t i{}; i < 100; i++) {
+        auto t = static_cast<double>(i);
+        correlator.addSample({0.5 * t, -2 * t});
+    }
+
+    for (const auto &point : correlator.getCorrelation()) {
+        auto lag = static_cast<double>(point.lag);
+        CHECK(point.value == Approx((0.25 + 4) / 2 * lag * lag));
+    }
+
+    SECTION("clearing") {
+        correlator.clear();
+
+        CHECK(correlator.getNumSamples() == 0);
+        CHECK(correlator.getCorrelation().empty());
+    }
+}
@@ -0,0 +1,83 @@
+#include <catch2/catch.hpp>
+#include <cmath>
+
+#include "core/observables/time_correlation/MeanSquaredDisplacement.h"
+#include "core/observables/time_correlation/SelfIntermediateScattering.h"
+#include "core/observables/time_correlation/OrientationAutocorrelation.h"
+#include "core/PeriodicBoundaryConditions.h"
+#include "core/shapes/SphereTraits.h"
+#include "core/shapes/SpherocylinderTraits.h"
+
+
+namespace {
+    // Particles moving along x with constant velocity 0.3, wrapped into the box
+    Packing create_moving_packing(std::size_t step, const Interaction &interaction) {
+        std::vector<Shape> shapes;
+        for (double y : {1., 4., 7.}) {
+            double x = std::fmod(1 + 0.3 * static_cast<double>(step), 10);
+            shapes.emplace_back(Vector<3>{x, y, 5});
+        }
+        return Packing(TriclinicBox(10), std::move(shapes), std::make_unique<PeriodicBoundaryConditions>(),
+                       interaction);
+    }
+}
+
+TEST_CASE("MeanSquaredDisplacement") {
+    SphereTraits traits(0.5);
+    MeanSquaredDisplacement msd(4);
+    for (std::size_t step{}; step < 50; step++)
+        msd.addSnapshot(create_moving_packing(step, traits.getInteraction()), 1, 1, traits);
+
+    auto values = msd.getValues();
+    REQUIRE(values.size() > 4);
+    for (const auto &[lag, value] : values) {
+        double displacement = 0.3 * static_cast<double>(lag);
+        CHECK(value == Approx(displacement * displacement));
+    }
+    CHECK(msd.getSignatureName() == "msd");
+    CHECK(msd.requiresEquallySpacedSnapshots());
+
+    SECTION("clearing") {
+        msd.clear();
+
+        CHECK(msd.getValues().empty());
+    }
+}
+
+TEST_CASE("SelfIntermediateScattering") {
+    SphereTraits traits(0.5);
+    SelfIntermediateScattering scattering(2, 8);
+    for (std::size_t step{}; step < 50; step++)
+        scattering.addSnapshot(create_moving_packing(step, traits.getInteraction()), 1, 1, traits);
+
+    auto values = scattering.getValues();
+    REQUIRE(values.size() > 8);
+    // Only the first level is exact; motion only along x, so y and z terms give 1
+    for (std::size_t lag{}; lag < 8; lag++) {
+        double expected = (std::cos(2 * 0.3 * static_cast<double>(lag)) + 2) / 3;
+        CHECK(values[lag].first == lag);
+        CHECK(values[lag].second == Approx(expected).margin(1e-12));
+    }
+}
+
+TEST_CASE("OrientationAutocorrelation") {
+    SpherocylinderTraits traits(1, 0.5);
+    OrientationAutocorrelation autocorrelation(ShapeGeometry::Axis::PRIMARY, 8);
+    double angleStep = 0.2;
+    for (std::size_t step{}; step < 30; step++) {
+        std::vector<Shape> shapes;
+        double angle = angleStep * static_cast<double>(step);
+        shapes.emplace_back(Vector<3>{2, 2, 2}, Matrix<3, 3>::rotation(angle, 0, 0));
+        shapes.emplace_back(Vector<3>{6, 6, 6}, Matrix<3, 3>::rotation(0, -angle, 0));
+        Packing packing(TriclinicBox(10), std::move(shapes), std::make_unique<PeriodicBoundaryConditions>(),
+                        traits.getInteraction());
+        autocorrelation.addSnapshot(packing, 1, 1, traits);
+    }
+
+    auto values = autocorrelation.getValues();
+    REQUIRE(values.size() > 8);
+    for (std::size_t lag{}; lag < 8; lag++) {
+        double cosine = std::cos(angleStep * static_cast<double>(lag));
+        CHECK(values[lag].second == Approx(1.5 * cosine * cosine - 0.5).margin(1e-12));
+    }
+}
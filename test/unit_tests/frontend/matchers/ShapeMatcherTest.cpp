@@ -0,0 +1,75 @@
+#include <catch2/catch.hpp>
+
+#include "frontend/matchers/ShapeMatcher.h"
+#include "core/interactions/CentralInteraction.h"
+#include "core/FreeBoundaryConditions.h"
+#include "utils/Exceptions.h"
+
+
+namespace {
+    const CentralInteraction &get_central_interaction(const ShapeTraits &traits) {
+        const auto *interaction = dynamic_cast<const CentralInteraction *>(&traits.getInteraction());
+        REQUIRE(interaction != nullptr);
+        return *interaction;
+    }
+}
+
+TEST_CASE("ShapeMatcher: soft interaction without tabulation") {
+    auto traits = ShapeMatcher::match("sphere(r=0.5, interaction=lj(epsilon=1, sigma=1))");
+
+    const auto &interaction = get_central_interaction(*traits);
+    CHECK(interaction.getPotentialTable() == nullptr);
+}
+
+TEST_CASE("ShapeMatcher: tabulation of soft interactions") {
+    auto interactionExpression = GENERATE(as<std::string>{}, "lj", "wca", "square_inverse_core");
+    DYNAMIC_SECTION(interactionExpression) {
+        auto traits = ShapeMatcher::match(
+            "sphere(r=0.5, interaction=" + interactionExpression
+            + "(epsilon=1, sigma=1, tabulation=table(min_r=0.8, points=500, interpolation=\"linear\")))"
+        );
+
+        const auto &interaction = get_central_interaction(*traits);
+        const auto *table = interaction.getPotentialTable();
+        REQUIRE(table != nullptr);
+        CHECK(table->getMinDistance2() == Approx(0.64));
+        CHECK(table->getNumNodes() == 500);
+        CHECK(table->getInterpolation() == PotentialTable::Interpolation::LINEAR);
+    }
+}
+
+TEST_CASE("ShapeMatcher: tabulated interaction energy") {
+    auto traits = ShapeMatcher::match("sphere(r=0.5, interaction=lj(epsilon=1, sigma=1, tabulation=table(min_r=0.8)))");
+    FreeBoundaryConditions fbc;
+    Shape shape1({0, 0, 0}), shape2({1.12246204830937, 0, 0});
+
+    CHECK(traits->getInteraction().calculateEnergyBetweenShapes(shape1, shape2, fbc) == Approx(-1).margin(1e-3));
+}
+
+TEST_CASE("ShapeMatcher: tabulation accuracy") {
+    SECTION("within tolerance") {
+        auto traits = ShapeMatcher::match(
+            "sphere(r=0.5, interaction=lj(epsilon=1, sigma=1, tabulation=table(min_r=0.8, max_error=1e-3)))"
+        );
+
+        const auto &accuracy = get_central_interaction(*traits).getTabulationAccuracy();
+        REQUIRE(accuracy.has_value());
+        CHECK(accuracy->maxAbsoluteError < 1e-3);
+    }
+
+    SECTION("exceeding tolerance") {
+        CHECK_THROWS_AS(ShapeMatcher::match("sphere(r=0.5, interaction=lj(epsilon=1, sigma=1, "
+                                            "tabulation=table(min_r=0.8, interpolation=\"linear\", max_error=1e-3)))"),
+                        ValidationException);
+    }
+}
+
+TEST_CASE("ShapeMatcher: tabulated interaction with non-zero energy at the cutoff") {
+    CHECK_THROWS_AS(ShapeMatcher::match("sphere(r=0.5, interaction=tabulated(min_r=0.5, max_r=1, energies=[2, 1]))"),
+                    ValidationException);
+}
+
+TEST_CASE("ShapeMatcher: tabulated interaction non-repulsive at min_r") {
+    CHECK_THROWS_AS(ShapeMatcher::match("sphere(r=0.5, interaction=tabulated(min_r=0.5, max_r=1, energies=[1, 2, 0]))"),
+                    ValidationException);
+}
@@ -0,0 +1,113 @@
+#include <catch2/catch.hpp>
+#include <sstream>
+#include <random>
+
+#include "utils/BlockAverager.h"
+
+
+TEST_CASE("BlockAverager: empty") {
+    BlockAverager averager;
+
+    CHECK(averager.getNumSamples() == 0);
+    CHECK(averager.getQuantity().value == 0);
+    CHECK(averager.getQuantity().error == 0);
+    CHECK(averager.getBlockedQuantity().value == 0);
+    CHECK(averager.getBlockedQuantity().error == 0);
+}
+
+TEST_CASE("BlockAverager: agreement with Quantity") {
+    std::vector<double> samples{1, 5, 2, 8, 3, 3, 7};
+    BlockAverager averager;
+    for (double sample : samples)
+        averager.add(sample);
+    Quantity expected;
+    expected.calculateFromSamples(samples);
+
+    auto quantity = averager.getQuantity();
+
+    CHECK(averager.getNumSamples() == 7);
+    CHECK(quantity.value == Approx(expected.value));
+    CHECK(quantity.error == Approx(expected.error));
+}
+
+TEST_CASE("BlockAverager: blocking") {
+    SECTION("uncorrelated samples") {
+        BlockAverager averager;
+        std::mt19937 mt(1234);
+        for (std::size_t i{}; i < 4096; i++)
+            averager.add(static_cast<double>(mt()) / static_cast<double>(std::mt19937::max()));
+
+        auto quantity = averager.getBlockedQuantity();
+
+        CHECK(quantity.value == averager.getQuantity().value);
+        CHECK(quantity.error == Approx(averager.getQuantity().error).epsilon(0.3));
+        CHECK(averager.getIntegratedAutocorrelationTime() == Approx(0.5).epsilon(0.6));
+    }
+
+    SECTION("strongly correlated samples") {
+        // Blocks of 64 identical samples - the error is underestimated on levels below 6
+        BlockAverager averager;
+        std::vector<double> blockValues{1, 3, 2, 5, 4, 1, 2, 3, 5, 4, 2, 1, 3, 4, 5, 2, 1, 3, 2, 4, 5, 1, 3, 2, 4,
+                                        5, 3, 1, 2, 4, 3, 5};
+        std::vector<double> samples;
+        for (double blockValue : blockValues)
+            for (std::size_t i{}; i < 64; i++)
+                samples.push_back(blockValue);
+        for (double sample : samples)
+            averager.add(sample);
+        Quantity blockQuantity;
+        blockQuantity.calculateFromSamples(blockValues);
+
+        auto quantity = averager.getBlockedQuantity();
+
+        CHECK(quantity.value == Approx(blockQuantity.value));
+        CHECK(quantity.error == Approx(blockQuantity.error));
+        CHECK(quantity.error > averager.getQuantity().error);
+        CHECK(averager.getIntegratedAutocorrelationTime() > 10);
+    }
+}
+
+TEST_CASE("BlockAverager: storing and restoring") {
+    BlockAverager averager;
+    for (std::size_t i{}; i < 100; i++)
+        averager.add(static_cast<double>(i % 7) / 3);
+    std::stringstream state;
+
+    averager.store(state);
+    BlockAverager restored;
+    restored.restore(state);
+
+    SECTION("restored values") {
+        CHECK(restored.getNumSamples() == 100);
+        CHECK(restored.getQuantity().value == averager.getQuantity().value);
+        CHECK(restored.getQuantity().error == averager.getQuantity().error);
+        CHECK(restored.getBlockedQuantity().error == averager.getBlockedQuantity().error);
+    }
+
+    SECTION("continuing") {
+        averager.add(5);
+        restored.add(5);
+
+        CHECK(restored.getNumSamples() == 101);
+        CHECK(restored.getQuantity().value == averager.getQuantity().value);
+        CHECK(restored.getBlockedQuantity().error == averager.getBlockedQuantity().error);
+    }
+
+    SECTION("broken state") {
+        std::istringstream in("3\n1 2 3 0 0\n");
+
+        CHECK_THROWS_AS(restored.restore(in), ValidationException);
+    }
+}
+
+TEST_CASE("BlockAverager: memory usage estimation") {
+    BlockAverager averager;
+    for (std::size_t i{}; i < 1000; i++)
+        averager.add(static_cast<double>(i % 7));
+
+    // 1000 samples give 10 blocking levels
+    CHECK(BlockAverager::estimateMemoryUsage(0) == 0);
+    CHECK(BlockAverager::estimateMemoryUsage(1000) == 10 * BlockAverager::estimateMemoryUsage(1));
+    CHECK(BlockAverager::estimateMemoryUsage(1024) == 11 * BlockAverager::estimateMemoryUsage(1));
+    CHECK(averager.getMemoryUsage() >= BlockAverager::estimateMemoryUsage(1000));
+}
@@ -0,0 +1,29 @@
+#include <catch2/catch.hpp>
+
+#include "utils/CpuDispatch.h"
+
+
+TEST_CASE("CpuDispatch: instruction set names") {
+    CHECK(get_instruction_set_name(InstructionSet::BASELINE) == "baseline");
+    CHECK(get_instruction_set_name(InstructionSet::SSE4_2) == "SSE4.2");
+    CHECK(get_instruction_set_name(InstructionSet::AVX2) == "AVX2");
+    CHECK(get_instruction_set_name(InstructionSet::AVX512) == "AVX-512");
+}
+
+TEST_CASE("CpuDispatch: supported instruction sets") {
+    CHECK(is_instruction_set_supported(InstructionSet::BASELINE));
+    // The tests themselves would not run otherwise
+    CHECK(is_instruction_set_supported(get_compiled_instruction_set()));
+    CHECK(is_instruction_set_supported(get_kernel_instruction_set()));
+    // Returns without terminating the program
+    ensure_compiled_instruction_set_supported();
+}
+
+TEST_CASE("CpuDispatch: kernel instruction set description") {
+    std::string expectedName = get_instruction_set_name(get_kernel_instruction_set());
+
+    if (is_cpu_dispatch_enabled())
+        CHECK(describe_kernel_instruction_set() == expectedName + " (selected at runtime)");
+    else
+        CHECK(describe_kernel_instruction_set() == expectedName + " (fixed at compile time)");
+}
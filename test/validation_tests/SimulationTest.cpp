@@ -291,6 +291,51 @@ TEST_CASE("Simulation: hard sphere domain decomposition", "[medium]") {
     CHECK(density.error == density2.error);
 }
 
+TEST_CASE("Simulation: hard sphere sweep move scheduling", "[medium]") {
+    OMP_SET_NUM_THREADS(4);
+    auto [moveScheduling, domainDivisions] = GENERATE(
+        std::make_pair(ParticleSweep::Order::SEQUENTIAL, std::array<std::size_t, 3>{1, 1, 1}),
+        std::make_pair(ParticleSweep::Order::SPATIAL, std::array<std::size_t, 3>{1, 1, 1}),
+        std::make_pair(ParticleSweep::Order::SHUFFLED_BLOCKS, std::array<std::size_t, 3>{2, 2, 1})
+    );
+    double V = 1000;
+    double linearSize = std::cbrt(V);
+    std::array<double, 3> dimensions = {linearSize, linearSize, linearSize};
+    auto shapes = OrthorhombicArrangingModel{}.arrange(200, dimensions);
+    SphereTraits sphereTraits(0.5);
+    auto packing = std::make_unique<Packing>(dimensions, std::move(shapes),
+                                             std::make_unique<PeriodicBoundaryConditions>(),
+                                             sphereTraits.getInteraction(), 4, 4);
+    auto volumeScaler = std::make_unique<TriclinicAdapter>(std::make_unique<DeltaVolumeScaler>(), 1);
+    Simulation simulation(std::move(packing), 1, 0.1, 1234, std::move(volumeScaler), domainDivisions);
+    auto collector = std::make_unique<ObservablesCollector>();
+    collector->addObservable(std::make_unique<NumberDensity>(), ObservablesCollector::AVERAGING);
+    std::ostringstream loggerStream;
+    Logger logger(loggerStream);
+    Simulation::Environment env;
+    env.setTemperature(1);
+    env.setPressure(1);
+    Simulation::IntegrationParameters params;
+    params.thermalisationCycles = 5000;
+    params.averagingCycles = 10000;
+    params.averagingEvery = 100;
+    params.snapshotEvery = 1000;
+    params.inlineInfoEvery = 1000;
+    params.moveScheduling = moveScheduling;
+
+    simulation.integrate(std::move(env), params, sphereTraits, std::move(collector), {}, logger);
+
+    // Sweeps preserve the Boltzmann distribution, so the equation of state should be the same as for random moves.
+    // The error underestimates slow volume fluctuations of such a small system - for random moves, densities obtained
+    // for different seeds differ by about 1%, so a fixed tolerance is used instead
+    Quantity density = simulation.getObservablesCollector().getFlattenedAverageValues().front().quantity;
+    double expected = 0.398574;
+    INFO("Carnahan-Starling density: " << expected);
+    INFO("Monte Carlo density: " << density);
+    CHECK(density.value == Approx(expected).epsilon(0.02)); // up to 2%
+    CHECK(density.error / density.value < 0.03); // up to 3%
+}
+
 TEST_CASE("Simulation: domain number auto-reduction", "[medium]") {
     OMP_SET_NUM_THREADS(4);
     auto pbc = std::make_unique<PeriodicBoundaryConditions>();
@@ -398,4 +443,142 @@ TEST_CASE("Simulation: hard dumbbell NVT relaxation", "[short]") {
     Quantity P2 = simulation.getObservablesCollector().getFlattenedAverageValues().front().quantity;
     CHECK(std::abs(P2.value) < 0.05);
     CHECK(simulation.getPacking().getNumberDensity() == Approx(108/7.2/7.2/7.2));
-}
\ No newline at end of file
+}
+
+TEST_CASE("Simulation: asynchronous analysis and overlap checks", "[short]") {
+    OMP_SET_NUM_THREADS(1);
+    SphereTraits sphereTraits(0.5);
+    std::ostringstream loggerStream;
+    Logger logger(loggerStream);
+
+    auto simulate = [&](bool asynchronousAnalysis) {
+        double V = 1000;
+        double linearSize = std::cbrt(V);
+        std::array<double, 3> dimensions = {linearSize, linearSize, linearSize};
+        auto shapes = OrthorhombicArrangingModel{}.arrange(100, dimensions);
+        auto packing = std::make_unique<Packing>(dimensions, std::move(shapes),
+                                                 std::make_unique<PeriodicBoundaryConditions>(),
+                                                 sphereTraits.getInteraction());
+        auto volumeScaler = std::make_unique<TriclinicAdapter>(std::make_unique<DeltaVolumeScaler>(), 1);
+        Simulation simulation(std::move(packing), 1, 0.1, 1234, std::move(volumeScaler));
+        auto collector = std::make_unique<ObservablesCollector>();
+        collector->addObservable(std::make_unique<NumberDensity>(), ObservablesCollector::AVERAGING_INLINE);
+        collector->addObservable(std::make_unique<OverlapGuard>(), ObservablesCollector::SNAPSHOT);
+        Simulation::Environment env;
+        env.setTemperature(1);
+        env.setPressure(1);
+        Simulation::IntegrationParameters params;
+        params.thermalisationCycles = 2000;
+        params.averagingCycles = 2000;
+        params.averagingEvery = 20;
+        params.snapshotEvery = 50;
+        params.inlineInfoEvery = 500;
+        params.asynchronousAnalysis = asynchronousAnalysis;
+        // Overlap checks should not influence the results
+        if (asynchronousAnalysis) {
+            params.overlapCheckEvery = 10;
+            params.overlapCheckFraction = 0.1;
+        }
+
+        simulation.integrate(std::move(env), params, sphereTraits, std::move(collector), {}, logger);
+
+        CHECK(simulation.isAnalysisAsynchronous() == asynchronousAnalysis);
+        CHECK((simulation.getOverlapCheckWaitingMicroseconds() > 0) == asynchronousAnalysis);
+        const auto &collectorOut = simulation.getObservablesCollector();
+        return std::make_pair(collectorOut.getFlattenedAverageValues().front().quantity,
+                              collectorOut.getNumSnapshots());
+    };
+
+    auto [density, numSnapshots] = simulate(false);
+    loggerStream.str("");
+    auto [asyncDensity, asyncNumSnapshots] = simulate(true);
+
+    CHECK(density.value == asyncDensity.value);
+    CHECK(density.error == asyncDensity.error);
+    CHECK(numSnapshots == 80);
+    CHECK(asyncNumSnapshots == 80);
+    // Inline info does not wait for the analysis started in the same cycle - the last completed one is printed, which
+    // is the current one only if it managed to finish in the meantime
+    std::string log = loggerStream.str();
+    bool isPreviousPrinted = log.find("Performed 1000 cycles; analysed cycle 950: rho: ") != std::string::npos;
+    bool isCurrentPrinted = log.find("Performed 1000 cycles; rho: ") != std::string::npos;
+    CHECK((isPreviousPrinted || isCurrentPrinted));
+}
+
+TEST_CASE("Simulation: speculative moves", "[short]") {
+    OMP_SET_NUM_THREADS(4);
+    KMerTraits kmerTraits(2, 0.5, 1);
+    std::ostringstream loggerStream;
+    Logger logger(loggerStream);
+
+    auto simulate = [&](bool speculativeMoves) {
+        Lattice lattice(UnitCellFactory::createScCell({1.5, 1.5, 2.5}), {4, 4, 2});
+        auto shapes = lattice.generateMolecules();
+        std::size_t moveThreads = speculativeMoves ? 4 : 1;
+        auto packing = std::make_unique<Packing>(lattice.getLatticeBox(), std::move(shapes),
+                                                 std::make_unique<PeriodicBoundaryConditions>(),
+                                                 kmerTraits.getInteraction(), moveThreads);
+        auto volumeScaler = std::make_unique<TriclinicAdapter>(std::make_unique<DeltaVolumeScaler>(), 1);
+        Simulation simulation(std::move(packing), 0.3, 0.3, 1234, std::move(volumeScaler));
+        Simulation::Environment env;
+        env.setTemperature(1);
+        env.setPressure(5);
+        Simulation::IntegrationParameters params;
+        params.thermalisationCycles = 200;
+        params.snapshotEvery = 100;
+        params.inlineInfoEvery = 100;
+        params.speculativeMoves = speculativeMoves;
+
+        simulation.integrate(std::move(env), params, kmerTraits, std::make_unique<ObservablesCollector>(), {}, logger);
+
+        return simulation.getPacking().createSnapshot();
+    };
+
+    // Hard interactions are evaluated exactly, so the Markov chain should be exactly the same as the serial one
+    auto serialPacking = simulate(false);
+    auto speculativePacking = simulate(true);
+
+    CHECK(serialPacking->getBox() == speculativePacking->getBox());
+    REQUIRE(serialPacking->size() == speculativePacking->size());
+    for (std::size_t i{}; i < serialPacking->size(); i++) {
+        CHECK((*serialPacking)[i].getPosition() == (*speculativePacking)[i].getPosition());
+        CHECK((*serialPacking)[i].getOrientation() == (*speculativePacking)[i].getOrientation());
+    }
+    CHECK(speculativePacking->countTotalOverlaps(kmerTraits.getInteraction()) == 0);
+}
+
+TEST_CASE("Simulation: domain division tuning", "[short]") {
+    OMP_SET_NUM_THREADS(4);
+    SphereTraits sphereTraits(0.5);
+    std::ostringstream loggerStream;
+    Logger logger(loggerStream);
+
+    Lattice lattice(UnitCellFactory::createScCell(1.2), {8, 8, 8});
+    auto shapes = lattice.generateMolecules();
+    auto packing = std::make_unique<Packing>(lattice.getLatticeBox(), std::move(shapes),
+                                             std::make_unique<PeriodicBoundaryConditions>(),
+                                             sphereTraits.getInteraction(), 4, 4);
+    auto volumeScaler = std::make_unique<TriclinicAdapter>(std::make_unique<DeltaVolumeScaler>(), 1);
+    Simulation simulation(std::move(packing), 0.3, 0.3, 1234, std::move(volumeScaler));
+    Simulation::Environment env;
+    env.setTemperature(1);
+    env.setPressure(5);
+    Simulation::IntegrationParameters params;
+    params.thermalisationCycles = 150;
+    params.averagingCycles = 50;
+    params.averagingEvery = 10;
+    params.snapshotEvery = 50;
+    params.inlineInfoEvery = 50;
+    params.domainDivisionTuningEvery = 50;
+
+    simulation.integrate(std::move(env), params, sphereTraits, std::make_unique<ObservablesCollector>(), {}, logger);
+
+    // Tuned divisions depend on timings, so only their validity is checked
+    const auto &domainDivisions = simulation.getDomainDivisions();
+    CHECK(domainDivisions[0] * domainDivisions[1] * domainDivisions[2] <= 4);
+    CHECK(DomainDecomposition::calculateActiveVolumeFraction(simulation.getPacking().getBox(),
+                                                             sphereTraits.getInteraction(), domainDivisions,
+                                                             simulation.getPacking().getNeighbourGridCellDivisions())
+          .has_value());
+    CHECK(simulation.getPacking().countTotalOverlaps(sphereTraits.getInteraction()) == 0);
+}